@@ -0,0 +1,233 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+///Accuracy test for btCapsuleTriangleDetector.
+///Capsules in random poses around a triangle are collided with the detector. While the capsule segment does not touch the
+///triangle, the deepest contact has to match the exact distance and direction, computed by a search along the segment.
+///When the segment passes through the triangle, the depth is checked against the generic convex-convex path
+///(btGjkPairDetector with EPA). Beyond the contact breaking threshold no contact may be reported.
+///The test runs with and without a triangle margin.
+///Built and run by the CMakeLists.txt of this directory: cmake -S Tests -B build && cmake --build build && ctest --test-dir build
+///It prints the first mismatch and returns 1 on failure.
+
+#include "btBulletCollisionCommon.h"
+#include "BulletCollision/CollisionShapes/btTriangleShape.h"
+#include "BulletCollision/CollisionDispatch/btCapsuleTriangleDetector.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+#include "BulletCollision/NarrowPhaseCollision/btPointCollector.h"
+#include <stdio.h>
+
+static const int	NUM_POSES = 100000;
+static const btScalar	CONTACT_BREAKING_THRESHOLD = btScalar(0.02);
+static const btScalar	SEPARATED_TOLERANCE = btScalar(0.0001);
+static const btScalar	NORMAL_TOLERANCE = btScalar(0.9999);
+static const btScalar	PENETRATION_TOLERANCE = btScalar(0.001);
+
+static unsigned int	gSeed = 12345;
+
+static btScalar	randomRange(btScalar low,btScalar high)
+{
+	gSeed = gSeed*1664525u + 1013904223u;
+	return low + (high-low)*btScalar(gSeed>>8)/btScalar(1<<24);
+}
+
+static btTransform	randomCapsulePose()
+{
+	btQuaternion orientation(randomRange(-1,1),randomRange(-1,1),randomRange(-1,1),randomRange(-1,1));
+	if (orientation.length2() < btScalar(0.01))
+	{
+		orientation.setValue(0,0,0,1);
+	}
+	orientation.normalize();
+	btTransform pose;
+	pose.setRotation(orientation);
+	pose.setOrigin(btVector3(randomRange(-1.5,2.5),randomRange(-1,1),randomRange(-1.5,2.5)));
+	return pose;
+}
+
+//closest point on the triangle abc to p, see Ericson, Real-Time Collision Detection 5.1.5
+static btVector3	closestPointOnTriangle(const btVector3& p,const btVector3& a,const btVector3& b,const btVector3& c)
+{
+	btVector3 ab = b - a;
+	btVector3 ac = c - a;
+	btVector3 ap = p - a;
+	btScalar d1 = ab.dot(ap);
+	btScalar d2 = ac.dot(ap);
+	if (d1 <= btScalar(0.) && d2 <= btScalar(0.))
+		return a;
+	btVector3 bp = p - b;
+	btScalar d3 = ab.dot(bp);
+	btScalar d4 = ac.dot(bp);
+	if (d3 >= btScalar(0.) && d4 <= d3)
+		return b;
+	btScalar vc = d1*d4 - d3*d2;
+	if (vc <= btScalar(0.) && d1 >= btScalar(0.) && d3 <= btScalar(0.))
+		return a + ab*(d1/(d1-d3));
+	btVector3 cp = p - c;
+	btScalar d5 = ab.dot(cp);
+	btScalar d6 = ac.dot(cp);
+	if (d6 >= btScalar(0.) && d5 <= d6)
+		return c;
+	btScalar vb = d5*d2 - d1*d6;
+	if (vb <= btScalar(0.) && d2 >= btScalar(0.) && d6 <= btScalar(0.))
+		return a + ac*(d2/(d2-d6));
+	btScalar va = d3*d6 - d5*d4;
+	if (va <= btScalar(0.) && (d4-d3) >= btScalar(0.) && (d5-d6) >= btScalar(0.))
+		return b + (c-b)*((d4-d3)/((d4-d3)+(d5-d6)));
+	btScalar denom = btScalar(1.)/(va+vb+vc);
+	return a + ab*(vb*denom) + ac*(vc*denom);
+}
+
+///exact distance between the capsule segment and the triangle, the distance to a convex set is convex along the segment
+static btScalar	segmentTriangleDistance(const btVector3& from,const btVector3& to,const btVector3* vertices,btVector3& triangleToSegment)
+{
+	btScalar low = btScalar(0.);
+	btScalar high = btScalar(1.);
+	for (int i=0;i<100;i++)
+	{
+		btScalar t0 = (low*2+high)/3;
+		btScalar t1 = (low+high*2)/3;
+		btVector3 p0 = from.lerp(to,t0);
+		btVector3 p1 = from.lerp(to,t1);
+		if ((p0-closestPointOnTriangle(p0,vertices[0],vertices[1],vertices[2])).length2() < (p1-closestPointOnTriangle(p1,vertices[0],vertices[1],vertices[2])).length2())
+			high = t1;
+		else
+			low = t0;
+	}
+	btVector3 p = from.lerp(to,(low+high)/2);
+	triangleToSegment = p-closestPointOnTriangle(p,vertices[0],vertices[1],vertices[2]);
+	return triangleToSegment.length();
+}
+
+static int	checkPose(btCapsuleShape* capsule,btTriangleShape* triangle,const btTransform& capsulePose,const btTransform& trianglePose,int poseIndex)
+{
+	btDiscreteCollisionDetectorInterface::ClosestPointInput input;
+	input.m_transformA = capsulePose;
+	input.m_transformB = trianglePose;
+
+	btCapsuleTriangleDetector detector(capsule,triangle,CONTACT_BREAKING_THRESHOLD);
+	btPointCollector result;
+	detector.getClosestPoints(input,result,0);
+
+	//the exact distance, in triangle space
+	btTransform capsuleInTr = trianglePose.inverseTimes(capsulePose);
+	btVector3 halfAxis = capsuleInTr.getBasis().getColumn(capsule->getUpAxis()) * capsule->getHalfHeight();
+	btVector3 triangleToSegment;
+	btScalar segmentDistance = segmentTriangleDistance(capsuleInTr.getOrigin()+halfAxis,capsuleInTr.getOrigin()-halfAxis,&triangle->getVertexPtr(0),triangleToSegment);
+	btScalar distance = segmentDistance - capsule->getRadius() - triangle->getMargin();
+
+	//near the threshold either answer is fine
+	if (btFabs(distance-CONTACT_BREAKING_THRESHOLD) < SEPARATED_TOLERANCE)
+	{
+		return 0;
+	}
+	if (distance >= CONTACT_BREAKING_THRESHOLD)
+	{
+		if (result.m_hasResult && result.m_distance < CONTACT_BREAKING_THRESHOLD)
+		{
+			printf("pose %d: the detector reports distance %f, the exact distance is %f\n",poseIndex,result.m_distance,distance);
+			return 1;
+		}
+		return 0;
+	}
+	if (!result.m_hasResult)
+	{
+		printf("pose %d: no contact, the exact distance is %f\n",poseIndex,distance);
+		return 1;
+	}
+
+	btVector3 faceNormal = trianglePose.getBasis()*triangle->getVertexPtr(1)-trianglePose.getBasis()*triangle->getVertexPtr(0);
+	faceNormal = faceNormal.cross(trianglePose.getBasis()*triangle->getVertexPtr(2)-trianglePose.getBasis()*triangle->getVertexPtr(0)).normalized();
+	bool faceNormalUsed = btFabs(result.m_normalOnBInWorld.dot(faceNormal)) >= NORMAL_TOLERANCE;
+
+	if (segmentDistance > SEPARATED_TOLERANCE)
+	{
+		//separated cores, the distance and the direction of the closest points are known exactly. The detector prefers the face
+		//when it is within 1% of the contact breaking threshold of an edge, the distance and normal may be off by that much.
+		btScalar tolerance = SEPARATED_TOLERANCE + (faceNormalUsed ? CONTACT_BREAKING_THRESHOLD*btScalar(0.01) : btScalar(0.));
+		if (btFabs(result.m_distance-distance) > tolerance)
+		{
+			printf("pose %d: the detector reports distance %f, the exact distance is %f\n",poseIndex,result.m_distance,distance);
+			return 1;
+		}
+		//a segment parallel to the face has a range of closest points, but they all share the direction
+		btVector3 normal = trianglePose.getBasis()*(triangleToSegment/segmentDistance);
+		if (!faceNormalUsed && result.m_normalOnBInWorld.dot(normal) < NORMAL_TOLERANCE)
+		{
+			printf("pose %d: the normal differs by %f degrees from the exact one at distance %f\n",poseIndex,
+				btDegrees(btAcos(btMin(btScalar(1.),result.m_normalOnBInWorld.dot(normal)))),distance);
+			return 1;
+		}
+		return 0;
+	}
+
+	//the segment passes through the triangle. The detector pushes the capsule out along the face normal, which is never
+	//shallower than the minimum translation that the convex-convex path finds with EPA.
+	if (segmentDistance > btScalar(0.))
+	{
+		return 0;
+	}
+	if (!faceNormalUsed)
+	{
+		printf("pose %d: the segment crosses the triangle but the normal is not the face normal\n",poseIndex);
+		return 1;
+	}
+	btVoronoiSimplexSolver simplexSolver;
+	btGjkEpaPenetrationDepthSolver penetrationSolver;
+	btGjkPairDetector gjk(capsule,triangle,&simplexSolver,&penetrationSolver);
+	btPointCollector reference;
+	gjk.getClosestPoints(input,reference,0);
+	if (reference.m_hasResult && result.m_distance > reference.m_distance + PENETRATION_TOLERANCE)
+	{
+		printf("pose %d: the detector reports penetration %f, EPA %f\n",poseIndex,result.m_distance,reference.m_distance);
+		return 1;
+	}
+	return 0;
+}
+
+static int	runPoses(btScalar triangleMargin,const char* name)
+{
+	btCapsuleShape capsule(btScalar(0.25),btScalar(1.));
+	btTriangleShape triangle(btVector3(0,0,0),btVector3(2,0,0),btVector3(btScalar(0.3),0,2));
+	triangle.setMargin(triangleMargin);
+
+	btTransform trianglePose;
+	trianglePose.setIdentity();
+	trianglePose.setRotation(btQuaternion(btVector3(1,1,0).normalized(),btScalar(0.4)));
+	trianglePose.setOrigin(btVector3(1,2,3));
+
+	int failures = 0;
+	for (int i=0;i<NUM_POSES && !failures;i++)
+	{
+		failures += checkPose(&capsule,&triangle,trianglePose*randomCapsulePose(),trianglePose,i);
+	}
+	if (failures)
+	{
+		printf("%s failed\n",name);
+	}
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	failures += runPoses(btScalar(0.),"triangle without margin");
+	failures += runPoses(btScalar(0.04),"triangle with margin");
+
+	printf("%s\n",failures ? "FAILED" : "passed");
+	return failures ? 1 : 0;
+}
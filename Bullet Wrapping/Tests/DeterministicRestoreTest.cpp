@@ -0,0 +1,266 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+///Regression test for btDiscreteDynamicsWorld::setDeterministic and restoreSnapshot.
+///A scene of compound stacks, boxes, spheres and hulls is stepped 10000 times while the world state is hashed after every step.
+///A second world built the same way, stepped with a task scheduler that runs the btParallelFor ranges in reverse order, has to
+///reproduce every hash. Then snapshots taken along the first run are restored and re-simulated for 100 steps each, and again
+///every hash has to match the first run bit for bit.
+///Built and run by the CMakeLists.txt of this directory: cmake -S Tests -B build && cmake --build build && ctest --test-dir build
+///It prints the first mismatch and returns 1 on failure.
+
+#include "btBulletDynamicsCommon.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorldSnapshot.h"
+#include "LinearMath/btThreads.h"
+#include <stdio.h>
+
+static const int	NUM_STEPS = 10000;
+static const int	NUM_RESIMULATED_STEPS = 100;
+static const btScalar	TIME_STEP = btScalar(1.)/btScalar(60.);
+
+///runs the ranges of a btParallelFor last to first, so results that depend on the scheduling order show up
+class ReverseTaskScheduler : public btITaskScheduler
+{
+public:
+	virtual const char*	getName() const
+	{
+		return "Reverse";
+	}
+
+	virtual void	parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+	{
+		int rangeSize = btMax(grainSize,1);
+		int start = iBegin + ((iEnd-iBegin-1)/rangeSize)*rangeSize;
+		for (;start>=iBegin;start-=rangeSize)
+		{
+			body.forLoop(start,btMin(start+rangeSize,iEnd));
+		}
+	}
+};
+
+class DeterministicScene
+{
+	btDefaultCollisionConfiguration*	m_collisionConfiguration;
+	btCollisionDispatcher*				m_dispatcher;
+	btBroadphaseInterface*				m_broadphase;
+	btSequentialImpulseConstraintSolver*	m_solver;
+	btAlignedObjectArray<btCollisionShape*>	m_shapes;
+
+	btRigidBody*	addBody(btScalar mass,btCollisionShape* shape,const btVector3& position)
+	{
+		btVector3 localInertia(0,0,0);
+		if (mass != btScalar(0.))
+			shape->calculateLocalInertia(mass,localInertia);
+		btTransform startTransform;
+		startTransform.setIdentity();
+		startTransform.setOrigin(position);
+		btRigidBody::btRigidBodyConstructionInfo info(mass,0,shape,localInertia);
+		info.m_startWorldTransform = startTransform;
+		btRigidBody* body = new btRigidBody(info);
+		m_world->addRigidBody(body);
+		return body;
+	}
+
+public:
+
+	btDiscreteDynamicsWorld*			m_world;
+
+	DeterministicScene()
+	{
+		m_collisionConfiguration = new btDefaultCollisionConfiguration();
+		m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+		m_broadphase = new btDbvtBroadphase();
+		m_solver = new btSequentialImpulseConstraintSolver();
+		m_world = new btDiscreteDynamicsWorld(m_dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
+		m_world->setDeterministic(true);
+		m_world->getSolverInfo().m_solverMode |= SOLVER_RANDMIZE_ORDER;
+
+		btCollisionShape* ground = new btBoxShape(btVector3(50,1,50));
+		m_shapes.push_back(ground);
+		addBody(0,ground,btVector3(0,-1,0));
+
+		//an L shaped compound, and a compound that nests it
+		btBoxShape* plank = new btBoxShape(btVector3(btScalar(0.6),btScalar(0.15),btScalar(0.3)));
+		btBoxShape* post = new btBoxShape(btVector3(btScalar(0.15),btScalar(0.4),btScalar(0.3)));
+		m_shapes.push_back(plank);
+		m_shapes.push_back(post);
+		btCompoundShape* bracket = new btCompoundShape();
+		btTransform childTransform;
+		childTransform.setIdentity();
+		childTransform.setOrigin(btVector3(0,btScalar(-0.25),0));
+		bracket->addChildShape(childTransform,plank);
+		childTransform.setOrigin(btVector3(btScalar(-0.45),btScalar(0.3),0));
+		bracket->addChildShape(childTransform,post);
+		m_shapes.push_back(bracket);
+
+		btCompoundShape* nested = new btCompoundShape();
+		childTransform.setIdentity();
+		nested->addChildShape(childTransform,bracket);
+		childTransform.setOrigin(btVector3(btScalar(0.45),btScalar(0.3),0));
+		nested->addChildShape(childTransform,post);
+		m_shapes.push_back(nested);
+
+		btSphereShape* sphere = new btSphereShape(btScalar(0.3));
+		m_shapes.push_back(sphere);
+		btBoxShape* box = new btBoxShape(btVector3(btScalar(0.3),btScalar(0.3),btScalar(0.3)));
+		m_shapes.push_back(box);
+		btConvexHullShape* hull = new btConvexHullShape();
+		hull->addPoint(btVector3(btScalar(-0.4),0,btScalar(-0.3)));
+		hull->addPoint(btVector3(btScalar(0.4),0,btScalar(-0.3)));
+		hull->addPoint(btVector3(0,0,btScalar(0.4)));
+		hull->addPoint(btVector3(0,btScalar(0.5),0));
+		m_shapes.push_back(hull);
+
+		int i,j;
+		for (i=0;i<4;i++)
+		{
+			for (j=0;j<6;j++)
+			{
+				btCollisionShape* shape = (j&1) ? (btCollisionShape*)nested : (btCollisionShape*)bracket;
+				btRigidBody* body = addBody(1,shape,btVector3(btScalar(i*2.5-3.75),btScalar(0.6+j*0.9),btScalar(j*0.05)));
+				body->setActivationState(DISABLE_DEACTIVATION);
+			}
+		}
+		for (i=0;i<12;i++)
+		{
+			btCollisionShape* shape = (i%3==0) ? (btCollisionShape*)sphere : ((i%3==1) ? (btCollisionShape*)box : (btCollisionShape*)hull);
+			btRigidBody* body = addBody(1,shape,btVector3(btScalar(i-5.5),btScalar(6+i*0.3),btScalar(2+(i&3)*0.2)));
+			body->setActivationState(DISABLE_DEACTIVATION);
+		}
+	}
+
+	~DeterministicScene()
+	{
+		int i;
+		for (i=m_world->getNumCollisionObjects()-1;i>=0;i--)
+		{
+			btCollisionObject* obj = m_world->getCollisionObjectArray()[i];
+			m_world->removeCollisionObject(obj);
+			delete obj;
+		}
+		for (i=0;i<m_shapes.size();i++)
+		{
+			delete m_shapes[i];
+		}
+		delete m_world;
+		delete m_solver;
+		delete m_broadphase;
+		delete m_dispatcher;
+		delete m_collisionConfiguration;
+	}
+
+	///steps the world, every 150 steps a body is kicked so the stacks keep colliding
+	void	step(int stepIndex)
+	{
+		if (stepIndex % 150 == 0)
+		{
+			int numObjects = m_world->getNumCollisionObjects();
+			btRigidBody* body = btRigidBody::upcast(m_world->getCollisionObjectArray()[1 + (stepIndex/150)%(numObjects-1)]);
+			body->applyCentralImpulse(btVector3(btScalar(((stepIndex/150)%5)-2),btScalar(6.),btScalar(((stepIndex/150)%3)-1)));
+			body->applyTorqueImpulse(btVector3(btScalar(0.3),btScalar(-0.2),btScalar(0.1)));
+		}
+		m_world->stepSimulation(TIME_STEP,1,TIME_STEP);
+	}
+
+	unsigned int	hashState() const
+	{
+		//FNV-1a over the bits of the transforms and velocities
+		unsigned int hash = 2166136261u;
+		for (int i=0;i<m_world->getNumCollisionObjects();i++)
+		{
+			const btRigidBody* body = btRigidBody::upcast(m_world->getCollisionObjectArray()[i]);
+			btScalar values[18];
+			const btTransform& transform = body->getWorldTransform();
+			for (int k=0;k<3;k++)
+			{
+				values[k] = transform.getOrigin()[k];
+				values[3+k] = transform.getBasis()[0][k];
+				values[6+k] = transform.getBasis()[1][k];
+				values[9+k] = transform.getBasis()[2][k];
+				values[12+k] = body->getLinearVelocity()[k];
+				values[15+k] = body->getAngularVelocity()[k];
+			}
+			const unsigned char* bytes = (const unsigned char*)values;
+			for (unsigned int b=0;b<sizeof(values);b++)
+			{
+				hash = (hash ^ bytes[b]) * 16777619u;
+			}
+		}
+		return hash;
+	}
+};
+
+static int	checkRun(DeterministicScene& scene,int firstStep,int numSteps,const btAlignedObjectArray<unsigned int>& hashes,const char* name)
+{
+	for (int i=firstStep;i<firstStep+numSteps;i++)
+	{
+		scene.step(i);
+		if (scene.hashState() != hashes[i])
+		{
+			printf("%s: state differs from the first run after step %d\n",name,i);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main()
+{
+	const int snapshotSteps[] = {60,200,1000,5000,9000};
+	const int numSnapshots = sizeof(snapshotSteps)/sizeof(snapshotSteps[0]);
+	btDynamicsWorldSnapshot snapshots[numSnapshots];
+
+	btAlignedObjectArray<unsigned int> hashes;
+	hashes.resize(NUM_STEPS);
+
+	DeterministicScene scene;
+	int i;
+	int snapshot = 0;
+	for (i=0;i<NUM_STEPS;i++)
+	{
+		//snapshots[s] holds the state before step snapshotSteps[s]
+		if (snapshot < numSnapshots && snapshotSteps[snapshot] == i)
+		{
+			scene.m_world->saveSnapshot(snapshots[snapshot++]);
+		}
+		scene.step(i);
+		hashes[i] = scene.hashState();
+	}
+
+	int failures = 0;
+	{
+		ReverseTaskScheduler reverseScheduler;
+		btSetTaskScheduler(&reverseScheduler);
+		DeterministicScene secondScene;
+		failures += checkRun(secondScene,0,NUM_STEPS,hashes,"second run");
+		btSetTaskScheduler(0);
+	}
+
+	for (i=0;i<numSnapshots;i++)
+	{
+		if (!scene.m_world->restoreSnapshot(snapshots[i]))
+		{
+			printf("restore of the snapshot at step %d failed\n",snapshotSteps[i]);
+			failures++;
+			continue;
+		}
+		char name[64];
+		sprintf(name,"restore at step %d",snapshotSteps[i]);
+		failures += checkRun(scene,snapshotSteps[i],NUM_RESIMULATED_STEPS,hashes,name);
+	}
+
+	printf("%s\n",failures ? "FAILED" : "passed");
+	return failures ? 1 : 0;
+}
@@ -37,7 +37,8 @@ class btRigidBody;
  * the physicaly object and its rendered peer.
  * 
  * Note that when the CC3PhysicsObject3D is deleted, the associated btRigidBody, the btCollisionShape and
- * the btMotionState are also deleted. During construction, The CC3Node is retained and when the
+ * the btMotionState are also deleted. A btCollisionShape that is shared through the shape registry of the
+ * CC3PhysicsWorld is only deleted with its last physics object. During construction, The CC3Node is retained and when the
  * CC3PhysicsObject3D is deleted the CC3Node is released.
  */
 @interface CC3PhysicsObject3D : NSObject {
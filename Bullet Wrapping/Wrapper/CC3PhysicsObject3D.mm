@@ -31,6 +31,7 @@ extern "C" {
 #import "CC3Node.h"
 
 #import "btBulletDynamicsCommon.h"
+#import "BulletCollision/CollisionShapes/btCollisionShapeRegistry.h"
 
 @implementation CC3PhysicsObject3D
 
@@ -61,7 +62,10 @@ extern "C" {
 	[_node release];
 	
 	delete _rigidBody->getMotionState();
-	delete _shape;
+	// Shapes interned by the physics world are shared with other objects
+	if (![CC3PhysicsWorld shapeRegistry]->releaseShape(_shape)) {
+		delete _shape;
+	}
 	delete _rigidBody;
     delete p2p;
 	[super dealloc];
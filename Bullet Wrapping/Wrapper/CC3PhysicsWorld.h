@@ -31,6 +31,7 @@
 class btRigidBody;
 class btDiscreteDynamicsWorld;
 class btCollisionShape;
+class btCollisionShapeRegistry;
 
 /**
  * The CC3PhysicsWorld provides a wrapper to the btDiscreteDynamicsWorld and contains all the CC3PhysicsObject3D objects. 
@@ -56,11 +57,29 @@ class btCollisionShape;
     CC3PhysicsObject3D *_collisionObject2;
     
     BOOL isstatic;
+    float _stepBudget;
 
 }
 
 @property (readonly) btDiscreteDynamicsWorld * _discreteDynamicsWorld;
 
+/**
+ * The wall clock time in seconds that synchTransformation may spend on physics substeps per frame, 0.008 by default.
+ * Substeps that don't fit in the budget are caught up in later frames, so a slow frame doesn't slow down the simulation
+ * or drop the frame rate further. When the simulation falls more than a quarter second behind, the extra time is dropped.
+ */
+@property (nonatomic, assign) float stepBudget;
+
+/**
+ * The simulation time in seconds that is due but not simulated yet. It grows when the step budget is too small for the scene.
+ */
+@property (readonly) float timeDebt;
+
+/**
+ * The fraction of a fixed time step, in [0,1), that the transformations are interpolated beyond the last substep.
+ */
+@property (readonly) float interpolationAlpha;
+
 /**
  * Initialises the CC3PhysicsWorld;
  */
@@ -74,7 +93,7 @@ class btCollisionShape;
 
 /**
  *steps physics simulation and updates meshes to match the physics simulation. YOU NEED TO CALL THIS IN AN
- *UPDATE METHOD!
+ *UPDATE METHOD! The simulation runs at a fixed 60 Hz, within the stepBudget, and the meshes are interpolated between the substeps.
  */
 -(void) synchTransformation;
 
@@ -104,6 +123,8 @@ class btCollisionShape;
 /**
  * Utility method to create an CC3PhysicsObject3D from an CC3Node and a btCollisionShape. A btRigidBody is created for
  * the shape with an CC3MotionShape containing the node. Both btRigidBody and CC3Node are returned in the CC3PhysicsObject3D.
+ * The shape is interned in the shape registry: when an equal shape exists already, the shape is deleted and the
+ * physics object uses the existing shape. Use the shape property of the physics object after this call.
  * @param node The CC3Node to be manipulated as a result of the physics simulation.
  * @param shape The shape of the object.
  * @param mass The mass of the object.
@@ -114,4 +135,10 @@ class btCollisionShape;
 
 - (NSMutableArray *) getCollidingObjects;
 
+/**
+ * Returns the btCollisionShapeRegistry shared by all physics worlds. Equal shapes of the physics objects are stored once,
+ * and the registry reports the number of shared shapes and the memory saved.
+ */
++ (btCollisionShapeRegistry *) shapeRegistry;
+
 @end
@@ -29,10 +29,12 @@ extern "C" {
 #import "CC3PhysicsWorld.h"
 #import "CC3PhysicsObject3D.h"
 #import "cocos2d.h"
+#import "BulletCollision/CollisionShapes/btCollisionShapeRegistry.h"
 
 
 @implementation CC3PhysicsWorld
 @synthesize _discreteDynamicsWorld;
+@synthesize stepBudget = _stepBudget;
 
 - (id) init {
     if ((self = [super init])) 
@@ -48,6 +50,7 @@ extern "C" {
 		[self setDiscreteDynamicsWorld:dynamicsWorld];
         _collidingObjects = [[NSMutableArray alloc] init];
         _thisCollidingObjects = [[NSMutableArray alloc] init];
+        _stepBudget = 0.008;
     }
 	
     return self;
@@ -68,6 +71,14 @@ extern "C" {
 	[super dealloc];
 }
 
+- (float) timeDebt {
+	return _discreteDynamicsWorld->getTimeDebt();
+}
+
+- (float) interpolationAlpha {
+	return _discreteDynamicsWorld->getInterpolationAlpha();
+}
+
 - (void) setDiscreteDynamicsWorld:(btDiscreteDynamicsWorld *)discreteDynamicsWorld {
 	_discreteDynamicsWorld = discreteDynamicsWorld;
 }
@@ -117,8 +128,8 @@ extern "C" {
 //		timeInterval = optimalInterval;
 //	}
 	
-	// Update the simulation
-	_discreteDynamicsWorld->stepSimulation(timeInterval, 2);
+	// Update the simulation, catching up the substeps that didn't fit in the budget of earlier frames
+	_discreteDynamicsWorld->stepSimulationWithBudget(timeInterval, _stepBudget);
 	[_lastStepTime release];
 	_lastStepTime = currentTime;
 
@@ -190,7 +201,16 @@ extern "C" {
     return _collidingObjects;
 }
 
++ (btCollisionShapeRegistry *) shapeRegistry
+{
+    static btCollisionShapeRegistry * shapeRegistry = new btCollisionShapeRegistry();
+    return shapeRegistry;
+}
+
 - (CC3PhysicsObject3D *) createPhysicsObject:(CC3Node *)node shape:(btCollisionShape *)shape mass:(float)mass restitution:(float)restitution position:(CC3Vector)position {
+	// Share the shape with equal shapes of other objects
+	shape = [CC3PhysicsWorld shapeRegistry]->internShape(shape);
+
 	// Create a motion state for the object
 	btDefaultMotionState* motionState = new btDefaultMotionState(btTransform(btQuaternion(0,0,0,1), btVector3(position.x, position.y, position.z)));
 	
@@ -158,6 +158,66 @@ extern "C" {
 
 	extern  int plRayCast(plDynamicsWorldHandle world, const plVector3 rayStart, const plVector3 rayEnd, plRayCastResult res);
 
+/* Bulk operations, so a binding needs a constant number of calls per frame instead of one call per body */
+
+	/* stepping parameters used by plStepSimulation, the defaults are 1 substep of 1/60 second and 10 solver iterations */
+	extern	void	plSetStepParameters(plDynamicsWorldHandle world, int maxSubSteps, plReal fixedTimeStep, int numSolverIterations);
+	extern	void	plSetGravity(plDynamicsWorldHandle world, const plVector3 gravity);
+
+	typedef struct plStepCounters {
+		int		m_numSubSteps;			/* substeps taken by the last plStepSimulation */
+		int		m_numRigidBodies;
+		int		m_numActiveRigidBodies;
+		int		m_numOverlappingPairs;
+		int		m_numManifolds;
+		int		m_numContacts;
+	} plStepCounters;
+
+	extern	void	plGetStepCounters(plDynamicsWorldHandle world, plStepCounters* counters);
+
+	/*	Creates count rigid bodies and adds them to the world, unless world is 0.
+		A pose is a position followed by an orientation quaternion (x,y,z,w), 7 plReals per body.
+		userData may be 0. */
+	extern	void	plCreateRigidBodies(plDynamicsWorldHandle world, int count, const plCollisionShapeHandle* shapes, const plReal* masses, const plReal* poses, void** userData, plRigidBodyHandle* bodies);
+
+	/* removes the bodies from the world, unless world is 0, and deletes them */
+	extern	void	plDeleteRigidBodies(plDynamicsWorldHandle world, int count, const plRigidBodyHandle* bodies);
+
+	extern	void	plGetPoses(int count, const plRigidBodyHandle* bodies, plReal* poses);
+	extern	void	plSetPoses(int count, const plRigidBodyHandle* bodies, const plReal* poses);
+
+	/* 16 plReals per body */
+	extern	void	plGetOpenGLMatrices(int count, const plRigidBodyHandle* bodies, plReal* matrices);
+
+	/* linear velocity followed by angular velocity, 6 plReals per body */
+	extern	void	plGetVelocities(int count, const plRigidBodyHandle* bodies, plReal* velocities);
+	extern	void	plSetVelocities(int count, const plRigidBodyHandle* bodies, const plReal* velocities);
+
+	/* 3 plReals per body, relativePositions (relative to the center of mass) may be 0. Wakes up the bodies. */
+	extern	void	plApplyImpulses(int count, const plRigidBodyHandle* bodies, const plReal* impulses, const plReal* relativePositions);
+
+	/* closest hit of each ray, 3 plReals per ray start and end. m_body is 0 for a miss. Returns the number of hits. */
+	extern	int		plRayCasts(plDynamicsWorldHandle world, int count, const plReal* rayStarts, const plReal* rayEnds, plRayCastResult* results);
+
+	enum plContactEventType {
+		PL_CONTACT_BEGIN = 0,
+		PL_CONTACT_END
+	};
+
+	typedef struct plContactEvent {
+		plRigidBodyHandle	m_body0;
+		plRigidBodyHandle	m_body1;
+		int					m_type;			/* plContactEventType */
+		int					m_numContacts;	/* the deepest contact is in m_positionWorld and m_normalWorld, unused for PL_CONTACT_END */
+		plVector3			m_positionWorld;
+		plVector3			m_normalWorld;
+		plReal				m_distance;
+	} plContactEvent;
+
+	/*	Copies at most maxEvents of the pairs of rigid bodies that started or stopped touching since the previous call, and returns the amount copied.
+		Call it until it returns less than maxEvents to drain all events. */
+	extern	int		plGetContactEvents(plDynamicsWorldHandle world, plContactEvent* events, int maxEvents);
+
 	/* Sweep API */
 
 	/* extern  plRigidBodyHandle plObjectCast(plDynamicsWorldHandle world, const plVector3 rayStart, const plVector3 rayEnd, plVector3 hitpoint, plVector3 normal); */
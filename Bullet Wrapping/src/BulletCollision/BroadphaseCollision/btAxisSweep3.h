@@ -141,6 +141,9 @@ public:
 
 	virtual void resetPool(btDispatcher* dispatcher);
 
+	///moves the world bounds along with the proxies, so the quantized edges stay valid and nothing is resorted
+	virtual void	shiftOrigin(const btVector3& shift, btDispatcher* dispatcher);
+
 	void	processAllOverlappingPairs(btOverlapCallback* callback);
 
 	//Broadphase Interface
@@ -628,6 +631,23 @@ void btAxisSweep3Internal<BP_FP_INT_TYPE>::resetPool(btDispatcher* dispatcher)
 	}
 }       
 
+template <typename BP_FP_INT_TYPE>
+void btAxisSweep3Internal<BP_FP_INT_TYPE>::shiftOrigin(const btVector3& shift, btDispatcher* dispatcher)
+{
+	m_worldAabbMin -= shift;
+	m_worldAabbMax -= shift;
+	for (BP_FP_INT_TYPE i = 1; i < m_numHandles * 2 + 1; i++)
+	{
+		if (m_pEdges[0][i].IsMax())
+			continue;
+		Handle* pHandle = getHandle(m_pEdges[0][i].m_handle);
+		pHandle->m_aabbMin -= shift;
+		pHandle->m_aabbMax -= shift;
+	}
+	if (m_raycastAccelerator)
+		m_raycastAccelerator->shiftOrigin(shift,dispatcher);
+}
+
 
 extern int gOverlappingPairs;
 //#include <stdio.h>
@@ -696,7 +716,7 @@ void	btAxisSweep3Internal<BP_FP_INT_TYPE>::calculateOverlappingPairs(btDispatche
 				pair.m_pProxy0 = 0;
 				pair.m_pProxy1 = 0;
 				m_invalidPair++;
-				gOverlappingPairs--;
+				btAtomicAdd(gOverlappingPairs,-1);
 			} 
 			
 		}
@@ -55,6 +55,26 @@ public:
 
 	virtual btBroadphaseProxy*	createProxy(  const btVector3& aabbMin,  const btVector3& aabbMax,int shapeType,void* userPtr, short int collisionFilterGroup,short int collisionFilterMask, btDispatcher* dispatcher,void* multiSapProxy) =0;
 	virtual void	destroyProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher)=0;
+
+	///creates numProxies proxies at once and stores them in proxies. The arrays hold one entry per proxy, like the createProxy arguments.
+	///Broadphases can override this to build their structures for the whole set in one pass.
+	virtual void	createProxies(int numProxies,const btVector3* aabbMins,const btVector3* aabbMaxs,const int* shapeTypes,void* const* userPtrs,const short int* collisionFilterGroups,const short int* collisionFilterMasks,btDispatcher* dispatcher,btBroadphaseProxy** proxies)
+	{
+		for (int i=0;i<numProxies;i++)
+		{
+			proxies[i] = createProxy(aabbMins[i],aabbMaxs[i],shapeTypes[i],userPtrs[i],collisionFilterGroups[i],collisionFilterMasks[i],dispatcher,0);
+		}
+	}
+
+	///destroys numProxies proxies at once. Broadphases can override this to remove the pairs of all proxies in a single sweep over the pair cache.
+	virtual void	destroyProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher)
+	{
+		for (int i=0;i<numProxies;i++)
+		{
+			destroyProxy(proxies[i],dispatcher);
+		}
+	}
+
 	virtual void	setAabb(btBroadphaseProxy* proxy,const btVector3& aabbMin,const btVector3& aabbMax, btDispatcher* dispatcher)=0;
 	virtual void	getAabb(btBroadphaseProxy* proxy,btVector3& aabbMin, btVector3& aabbMax ) const =0;
 
@@ -75,6 +95,10 @@ public:
 	///reset broadphase internal structures, to ensure determinism/reproducability
 	virtual void resetPool(btDispatcher* dispatcher) { (void) dispatcher; };
 
+	///moves the broadphase by -shift, see btCollisionWorld::shiftOrigin. The caller updates the AABBs of all proxies afterwards, so this is
+	///only needed to keep the internal structures (and the fixed bounds of quantized broadphases) in place without rebuilding them.
+	virtual void	shiftOrigin(const btVector3& shift, btDispatcher* dispatcher) { (void) shift; (void) dispatcher; }
+
 	virtual void	printStats() = 0;
 
 };
@@ -33,6 +33,15 @@ static DBVT_INLINE int			indexof(const btDbvtNode* node)
 	return(node->parent->childs[1]==node);
 }
 
+//
+struct btDbvtNodeAddressPredicate
+{
+	bool operator()(const btDbvtNode* a,const btDbvtNode* b) const
+	{
+		return(a<b);
+	}
+};
+
 //
 static DBVT_INLINE btDbvtVolume	merge(	const btDbvtVolume& a,
 									  const btDbvtVolume& b)
@@ -69,10 +78,30 @@ static void						getmaxdepth(const btDbvtNode* node,int depth,int& maxdepth)
 static DBVT_INLINE void			deletenode(	btDbvt* pdbvt,
 										   btDbvtNode* node)
 {
+	if(pdbvt->m_poolBlockSize)
+	{
+		node->parent=pdbvt->m_free;
+		pdbvt->m_free=node;
+		return;
+	}
 	btAlignedFree(pdbvt->m_free);
 	pdbvt->m_free=node;
 }
 
+//
+static void						allocateblock(btDbvt* pdbvt)
+{
+	const int	count=pdbvt->m_poolBlockSize;
+	btDbvtNode*	block=(btDbvtNode*)btAlignedAlloc(sizeof(btDbvtNode)*count,16);
+	for(int i=0;i<count;++i)
+	{
+		new(&block[i]) btDbvtNode();
+		block[i].parent=(i+1<count)?&block[i+1]:pdbvt->m_free;
+	}
+	pdbvt->m_poolBlocks.push_back(block);
+	pdbvt->m_free=block;
+}
+
 //
 static void						recursedeletenode(	btDbvt* pdbvt,
 												  btDbvtNode* node)
@@ -92,7 +121,12 @@ static DBVT_INLINE btDbvtNode*	createnode(	btDbvt* pdbvt,
 										   void* data)
 {
 	btDbvtNode*	node;
-	if(pdbvt->m_free)
+	if(pdbvt->m_poolBlockSize)
+	{
+		if(!pdbvt->m_free) allocateblock(pdbvt);
+		node=pdbvt->m_free;pdbvt->m_free=node->parent;
+	}
+	else if(pdbvt->m_free)
 	{ node=pdbvt->m_free;pdbvt->m_free=0; }
 	else
 	{ node=new(btAlignedAlloc(sizeof(btDbvtNode),16)) btDbvtNode(); }
@@ -238,10 +272,11 @@ static void						split(	const tNodeArray& leaves,
 	right.resize(0);
 	for(int i=0,ni=leaves.size();i<ni;++i)
 	{
-		if(btDot(axis,leaves[i]->volume.Center()-org)<0)
-			left.push_back(leaves[i]);
-		else
+		//same test as the split counts in topdown, so a center on the split plane can't leave a side empty
+		if(btDot(axis,leaves[i]->volume.Center()-org)>0)
 			right.push_back(leaves[i]);
+		else
+			left.push_back(leaves[i]);
 	}
 }
 
@@ -401,6 +436,17 @@ static DBVT_INLINE btDbvtNode*	walkup(btDbvtNode* n,int count)
 }
 #endif
 
+//
+static void						translatenode(btDbvtNode* node,const btVector3& shift)
+{
+	node->volume=btDbvtVolume::FromMM(node->volume.Mins()+shift,node->volume.Maxs()+shift);
+	if(node->isinternal())
+	{
+		translatenode(node->childs[0],shift);
+		translatenode(node->childs[1],shift);
+	}
+}
+
 //
 // Api
 //
@@ -413,6 +459,7 @@ btDbvt::btDbvt()
 	m_lkhd		=	-1;
 	m_leaves	=	0;
 	m_opath		=	0;
+	m_poolBlockSize	=	0;
 }
 
 //
@@ -424,9 +471,18 @@ btDbvt::~btDbvt()
 //
 void			btDbvt::clear()
 {
-	if(m_root)	
+	if(m_poolBlockSize)
+	{
+		for(int i=0;i<m_poolBlocks.size();++i)
+		{
+			btAlignedFree(m_poolBlocks[i]);
+		}
+		m_poolBlocks.clear();
+		m_root=0;
+	}
+	else if(m_root)	
 		recursedeletenode(this,m_root);
-	btAlignedFree(m_free);
+	if(!m_poolBlockSize) btAlignedFree(m_free);
 	m_free=0;
 	m_lkhd		=	-1;
 	m_stkStack.clear();
@@ -488,6 +544,39 @@ btDbvtNode*	btDbvt::insert(const btDbvtVolume& volume,void* data)
 	return(leaf);
 }
 
+//
+void			btDbvt::insertTopDown(const btDbvtVolume* volumes,void* const* datas,int count,btDbvtNode** leaves,int bu_treshold)
+{
+	if(count<=0) return;
+	tNodeArray	nodes;
+	const bool	rebuild=m_leaves<=count;
+	nodes.reserve(rebuild?m_leaves+count:count);
+	if(rebuild&&m_root)
+	{
+		fetchleaves(this,m_root,nodes);
+		m_root=0;
+	}
+	for(int i=0;i<count;++i)
+	{
+		leaves[i]=createnode(this,0,volumes[i],datas[i]);
+		nodes.push_back(leaves[i]);
+	}
+	btDbvtNode*	subtree=topdown(this,nodes,bu_treshold);
+	if(m_root)
+	{
+		btDbvtNode*	node=createnode(this,0,m_root->volume,subtree->volume,0);
+		node->childs[0]=m_root;m_root->parent=node;
+		node->childs[1]=subtree;subtree->parent=node;
+		m_root=node;
+	}
+	else
+	{
+		m_root=subtree;
+		m_root->parent=0;
+	}
+	m_leaves+=count;
+}
+
 //
 void			btDbvt::update(btDbvtNode* leaf,int lookahead)
 {
@@ -559,6 +648,12 @@ void			btDbvt::remove(btDbvtNode* leaf)
 	--m_leaves;
 }
 
+//
+void			btDbvt::translate(const btVector3& shift)
+{
+	if(m_root) translatenode(m_root,shift);
+}
+
 //
 void			btDbvt::write(IWriter* iwriter) const
 {
@@ -615,6 +710,113 @@ void			btDbvt::clone(btDbvt& dest,IClone* iclone) const
 	}
 }
 
+//
+void			btDbvt::setPoolBlockSize(int blockSize)
+{
+	btAssert(m_root==0);
+	clear();
+	m_poolBlockSize=btMax(blockSize,0);
+}
+
+//
+void			btDbvt::relinearize(IRelocate* irelocate)
+{
+	if(!m_root||m_root->isleaf()) return;
+	const bool		moveleaves=irelocate!=0;
+	/* depth-first order, both children of a node are emitted together	*/ 
+	tNodeArray		order;
+	btAlignedObjectArray<int>	parents;
+	btAlignedObjectArray<int>	stack;
+	order.reserve(moveleaves?m_leaves*2:m_leaves);
+	parents.reserve(order.capacity());
+	stack.reserve(SIMPLE_STACKSIZE);
+	order.push_back(m_root);
+	parents.push_back(-1);
+	stack.push_back(0);
+	do	{
+		const int		index=stack[stack.size()-1];
+		btDbvtNode*		node=order[index];
+		stack.pop_back();
+		for(int j=0;j<2;++j)
+		{
+			btDbvtNode*	child=node->childs[j];
+			if(moveleaves||child->isinternal())
+			{
+				order.push_back(child);
+				parents.push_back(index);
+			}
+		}
+		for(int j=order.size()-1;j>=0&&parents[j]==index;--j)
+		{
+			if(order[j]->isinternal()) stack.push_back(j);
+		}
+	} while(stack.size()>0);
+	/* target slots		*/ 
+	const int		count=order.size();
+	tNodeArray		slots;
+	slots.resize(count);
+	const bool		compact=moveleaves&&(m_poolBlockSize>0);
+	if(compact)
+	{
+		/* compact to the front of the pool	*/ 
+		for(int i=0;i<count;++i)
+		{
+			slots[i]=&m_poolBlocks[i/m_poolBlockSize][i%m_poolBlockSize];
+		}
+	}
+	else
+	{
+		/* reuse the storage of the moved nodes, in address order	*/ 
+		for(int i=0;i<count;++i) slots[i]=order[i];
+		slots.quickSort(btDbvtNodeAddressPredicate());
+	}
+	/* copy and relink		*/ 
+	btAlignedObjectArray<btDbvtNode>	nodes;
+	nodes.resize(count);
+	for(int i=0;i<count;++i)
+	{
+		nodes[i]=*order[i];
+		nodes[i].parent=parents[i]>=0?slots[parents[i]]:0;
+	}
+	for(int i=1;i<count;++i)
+	{
+		btDbvtNode&	parent=nodes[parents[i]];
+		parent.childs[indexof(order[i])]=slots[i];
+	}
+	for(int i=0;i<count;++i)
+	{
+		*slots[i]=nodes[i];
+	}
+	m_root=slots[0];
+	if(compact)
+	{
+		/* everything past the tree goes back to the free list, in address order	*/ 
+		m_free=0;
+		for(int i=m_poolBlocks.size()*m_poolBlockSize-1;i>=count;--i)
+		{
+			btDbvtNode*	slot=&m_poolBlocks[i/m_poolBlockSize][i%m_poolBlockSize];
+			slot->parent=m_free;
+			m_free=slot;
+		}
+	}
+	for(int i=0;i<count;++i)
+	{
+		btDbvtNode*	node=slots[i];
+		if(node->isleaf())
+		{
+			if(node!=order[i]) irelocate->RelocateLeaf(node);
+		}
+		else if(!moveleaves)
+		{
+			/* leaves stayed in place, point them to their moved parent	*/ 
+			for(int j=0;j<2;++j)
+			{
+				if(node->childs[j]->isleaf()) node->childs[j]->parent=node;
+			}
+		}
+	}
+}
+
 //
 int				btDbvt::maxdepth(const btDbvtNode* node)
 {
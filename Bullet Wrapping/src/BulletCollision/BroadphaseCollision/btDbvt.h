@@ -51,6 +51,9 @@ subject to the following restrictions:
 // Enable benchmarking code
 #define	DBVT_ENABLE_BENCHMARK	0
 
+// Default number of nodes per block in pooled storage mode
+#define DBVT_POOL_BLOCKSIZE		256
+
 // Inlining
 #define DBVT_INLINE				SIMD_FORCE_INLINE
 
@@ -243,6 +246,13 @@ struct	btDbvt
 		virtual ~IClone()	{}
 		virtual void		CloneLeaf(btDbvtNode*) {}
 	};
+	/* IRelocate	*/ 
+	struct	IRelocate
+	{
+		virtual ~IRelocate()	{}
+		///called by relinearize after a leaf moved, leaf->data is preserved so the owner can update its handle
+		virtual void		RelocateLeaf(btDbvtNode*) {}
+	};
 
 	// Constants
 	enum	{
@@ -257,6 +267,11 @@ struct	btDbvt
 	int				m_leaves;
 	unsigned		m_opath;
 
+	///pooled storage mode: nodes are carved from blocks of m_poolBlockSize nodes, unused nodes are kept
+	///in a free list (linked through btDbvtNode::parent) starting at m_free. Zero means one allocation per node.
+	int								m_poolBlockSize;
+	btAlignedObjectArray<btDbvtNode*>	m_poolBlocks;
+
 	
 	btAlignedObjectArray<sStkNN>	m_stkStack;
 
@@ -270,14 +285,26 @@ struct	btDbvt
 	void			optimizeTopDown(int bu_treshold=128);
 	void			optimizeIncremental(int passes);
 	btDbvtNode*		insert(const btDbvtVolume& box,void* data);
+	///inserts count leaves at once and stores them in leaves. The new leaves are built into a subtree top down, which becomes a child of the root.
+	///When the tree has no more leaves than the batch, the whole tree is rebuilt top down instead.
+	void			insertTopDown(const btDbvtVolume* volumes,void* const* datas,int count,btDbvtNode** leaves,int bu_treshold=8);
 	void			update(btDbvtNode* leaf,int lookahead=-1);
 	void			update(btDbvtNode* leaf,btDbvtVolume& volume);
 	bool			update(btDbvtNode* leaf,btDbvtVolume& volume,const btVector3& velocity,btScalar margin);
 	bool			update(btDbvtNode* leaf,btDbvtVolume& volume,const btVector3& velocity);
 	bool			update(btDbvtNode* leaf,btDbvtVolume& volume,btScalar margin);	
 	void			remove(btDbvtNode* leaf);
+	///move all volumes by shift, the structure of the tree doesn't change
+	void			translate(const btVector3& shift);
 	void			write(IWriter* iwriter) const;
 	void			clone(btDbvt& dest,IClone* iclone=0) const;
+	///switch between per node allocation (0) and pooled storage, only valid while the tree is empty
+	void			setPoolBlockSize(int blockSize=DBVT_POOL_BLOCKSIZE);
+	bool			isPooled() const { return(m_poolBlockSize>0); }
+	///rewrite the tree in depth-first order with sibling nodes next to each other.
+	///Without an IRelocate, leaves stay in place (external code holds leaf pointers) and only internal nodes move.
+	///With an IRelocate, leaves move too, and in pooled mode the whole tree is compacted to the front of the pool.
+	void			relinearize(IRelocate* irelocate=0);
 	static int		maxdepth(const btDbvtNode* node);
 	static int		countLeaves(const btDbvtNode* node);
 	static void		extractLeaves(const btDbvtNode* node,btAlignedObjectArray<const btDbvtNode*>& leaves);
@@ -114,6 +114,17 @@ struct	btDbvtTreeCollider : btDbvt::ICollide
 	}
 };
 
+//
+// btDbvtLeafRelocator
+//
+struct	btDbvtLeafRelocator : btDbvt::IRelocate
+{
+	void	RelocateLeaf(btDbvtNode* leaf)
+	{
+		((btDbvtProxy*)leaf->data)->leaf=leaf;
+	}
+};
+
 //
 // btDbvtBroadphase
 //
@@ -142,6 +153,8 @@ btDbvtBroadphase::btDbvtBroadphase(btOverlappingPairCache* paircache)
 	{
 		m_stageRoots[i]=0;
 	}
+	m_sets[0].setPoolBlockSize(DBVT_BP_POOLBLOCKSIZE);
+	m_sets[1].setPoolBlockSize(DBVT_BP_POOLBLOCKSIZE);
 #if DBVT_BP_PROFILE
 	clear(m_profiling);
 #endif
@@ -203,6 +216,79 @@ void							btDbvtBroadphase::destroyProxy(	btBroadphaseProxy* absproxy,
 	m_needcleanup=true;
 }
 
+//
+void							btDbvtBroadphase::createProxies(int numProxies,
+																const btVector3* aabbMins,
+																const btVector3* aabbMaxs,
+																const int* /*shapeTypes*/,
+																void* const* userPtrs,
+																const short int* collisionFilterGroups,
+																const short int* collisionFilterMasks,
+																btDispatcher* /*dispatcher*/,
+																btBroadphaseProxy** proxies)
+{
+	if(numProxies<=0) return;
+	btAlignedObjectArray<btDbvtVolume>	volumes;
+	btAlignedObjectArray<void*>			datas;
+	btAlignedObjectArray<btDbvtNode*>	leaves;
+	volumes.resize(numProxies);
+	datas.resize(numProxies);
+	leaves.resize(numProxies);
+	int i;
+	for(i=0;i<numProxies;++i)
+	{
+		btDbvtProxy*		proxy=new(btAlignedAlloc(sizeof(btDbvtProxy),16)) btDbvtProxy(	aabbMins[i],aabbMaxs[i],userPtrs[i],
+			collisionFilterGroups[i],
+			collisionFilterMasks[i]);
+		proxy->stage		=	m_stageCurrent;
+		proxy->m_uniqueId	=	++m_gid;
+		listappend(proxy,m_stageRoots[m_stageCurrent]);
+		volumes[i]			=	btDbvtVolume::FromMM(aabbMins[i],aabbMaxs[i]);
+		datas[i]			=	proxy;
+		proxies[i]			=	proxy;
+	}
+	m_sets[0].insertTopDown(&volumes[0],&datas[0],numProxies,&leaves[0]);
+	for(i=0;i<numProxies;++i)
+	{
+		btDbvtProxy*	proxy=(btDbvtProxy*)proxies[i];
+		proxy->leaf=leaves[i];
+	}
+	if(!m_deferedcollide)
+	{
+		btDbvtTreeCollider	collider(this);
+		for(i=0;i<numProxies;++i)
+		{
+			collider.proxy=(btDbvtProxy*)proxies[i];
+			m_sets[0].collideTV(m_sets[0].m_root,volumes[i],collider);
+			m_sets[1].collideTV(m_sets[1].m_root,volumes[i],collider);
+		}
+	}
+}
+
+//
+void							btDbvtBroadphase::destroyProxies(btBroadphaseProxy** absproxies,
+																 int numProxies,
+																 btDispatcher* dispatcher)
+{
+	if(numProxies<=0) return;
+	int i;
+	for(i=0;i<numProxies;++i)
+	{
+		btDbvtProxy*	proxy=(btDbvtProxy*)absproxies[i];
+		if(proxy->stage==STAGECOUNT)
+			m_sets[1].remove(proxy->leaf);
+		else
+			m_sets[0].remove(proxy->leaf);
+		listremove(proxy,m_stageRoots[proxy->stage]);
+	}
+	m_paircache->removeOverlappingPairsContainingProxies(absproxies,numProxies,dispatcher);
+	for(i=0;i<numProxies;++i)
+	{
+		btAlignedFree(absproxies[i]);
+	}
+	m_needcleanup=true;
+}
+
 void	btDbvtBroadphase::getAabb(btBroadphaseProxy* absproxy,btVector3& aabbMin, btVector3& aabbMax ) const
 {
 	btDbvtProxy*						proxy=(btDbvtProxy*)absproxy;
@@ -581,6 +667,15 @@ void							btDbvtBroadphase::collide(btDispatcher* dispatcher)
 			if(pairs.size()>0) m_cid=(m_cid+ni)%pairs.size(); else m_cid=0;
 		}
 	}
+#if DBVT_BP_RELINEARIZE_RATE
+	/* relinearize			*/ 
+	if(0==(m_pid%DBVT_BP_RELINEARIZE_RATE))
+	{
+		btDbvtLeafRelocator	relocator;
+		m_sets[0].relinearize(&relocator);
+		m_sets[1].relinearize(&relocator);
+	}
+#endif
 	++m_pid;
 	m_newpairs=1;
 	m_needcleanup=false;
@@ -661,6 +756,23 @@ void btDbvtBroadphase::resetPool(btDispatcher* dispatcher)
 	}
 }
 
+//
+void							btDbvtBroadphase::shiftOrigin(const btVector3& shift,btDispatcher* /*dispatcher*/)
+{
+	m_sets[0].translate(-shift);
+	m_sets[1].translate(-shift);
+	for(int i=0;i<=STAGECOUNT;++i)
+	{
+		btDbvtProxy*	current=m_stageRoots[i];
+		while(current)
+		{
+			current->m_aabbMin-=shift;
+			current->m_aabbMax-=shift;
+			current=current->links[1];
+		}
+	}
+}
+
 //
 void							btDbvtBroadphase::printStats()
 {}
@@ -30,6 +30,8 @@ subject to the following restrictions:
 #define DBVT_BP_ACCURATESLEEPING		0
 #define DBVT_BP_ENABLE_BENCHMARK		0
 #define DBVT_BP_MARGIN					(btScalar)0.05
+#define DBVT_BP_POOLBLOCKSIZE			DBVT_POOL_BLOCKSIZE	// 0 to allocate tree nodes one by one
+#define DBVT_BP_RELINEARIZE_RATE		64					// re-linearize the trees every n collide calls, 0 to disable
 
 #if DBVT_BP_PROFILE
 #define	DBVT_BP_PROFILING_RATE	256
@@ -106,6 +108,10 @@ struct	btDbvtBroadphase : btBroadphaseInterface
 	/* btBroadphaseInterface Implementation	*/
 	btBroadphaseProxy*				createProxy(const btVector3& aabbMin,const btVector3& aabbMax,int shapeType,void* userPtr,short int collisionFilterGroup,short int collisionFilterMask,btDispatcher* dispatcher,void* multiSapProxy);
 	virtual void					destroyProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher);
+	///inserts the new proxies into the dynamic tree as one subtree built top down
+	virtual void					createProxies(int numProxies,const btVector3* aabbMins,const btVector3* aabbMaxs,const int* shapeTypes,void* const* userPtrs,const short int* collisionFilterGroups,const short int* collisionFilterMasks,btDispatcher* dispatcher,btBroadphaseProxy** proxies);
+	///removes the pairs of all proxies in a single sweep over the pair cache
+	virtual void					destroyProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher);
 	virtual void					setAabb(btBroadphaseProxy* proxy,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* dispatcher);
 	virtual void					rayTest(const btVector3& rayFrom,const btVector3& rayTo, btBroadphaseRayCallback& rayCallback, const btVector3& aabbMin=btVector3(0,0,0), const btVector3& aabbMax = btVector3(0,0,0));
 	virtual void					aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback);
@@ -121,6 +127,9 @@ struct	btDbvtBroadphase : btBroadphaseInterface
 	///reset broadphase internal structures, to ensure determinism/reproducability
 	virtual void resetPool(btDispatcher* dispatcher);
 
+	///translates both trees and the proxy AABBs, without reinserting any leaves
+	virtual void	shiftOrigin(const btVector3& shift, btDispatcher* dispatcher);
+
 	void	performDeferredRemoval(btDispatcher* dispatcher);
 	
 	void	setVelocityPrediction(btScalar prediction)
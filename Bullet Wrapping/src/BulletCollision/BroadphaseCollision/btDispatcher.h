@@ -48,7 +48,9 @@ struct btDispatcherInfo
 		m_allowedCcdPenetration(btScalar(0.04)),
 		m_useConvexConservativeDistanceUtil(false),
 		m_convexConservativeDistanceThreshold(0.0f),
-		m_stackAllocator(0)
+		m_stackAllocator(0),
+		m_deterministicOrder(false),
+		m_processAllCompoundChildren(false)
 	{
 
 	}
@@ -65,6 +67,12 @@ struct btDispatcherInfo
 	bool		m_useConvexConservativeDistanceUtil;
 	btScalar	m_convexConservativeDistanceThreshold;
 	btStackAlloc*	m_stackAllocator;
+	///sort the overlapping pairs and contact manifolds by broadphase proxy uid each step, so the results don't depend on pointer values,
+	///allocation order or the history of the pair cache. See btDiscreteDynamicsWorld::setDeterministic.
+	bool		m_deterministicOrder;
+	///btCompoundCollisionAlgorithm tests every child against the other object, instead of culling them with the compound's AABB tree.
+	///Child manifolds outlive the tree culling until their world space AABBs separate, restoreSnapshot uses this to recreate them.
+	bool		m_processAllCompoundChildren;
 };
 
 ///The btDispatcher interface class can be used in combination with broadphase to dispatch calculations for overlapping pairs.
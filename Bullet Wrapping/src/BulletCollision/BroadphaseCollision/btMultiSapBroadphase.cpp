@@ -17,6 +17,7 @@ subject to the following restrictions:
 
 #include "btSimpleBroadphase.h"
 #include "LinearMath/btAabbUtil2.h"
+#include "LinearMath/btThreads.h"
 #include "btQuantizedBvh.h"
 
 ///	btSapBroadphaseArray	m_sapBroadphases;
@@ -429,7 +430,7 @@ void    btMultiSapBroadphase::calculateOverlappingPairs(btDispatcher* dispatcher
 				pair.m_pProxy0 = 0;
 				pair.m_pProxy1 = 0;
 				m_invalidPair++;
-				gOverlappingPairs--;
+				btAtomicAdd(gOverlappingPairs,-1);
 			} 
 			
 		}
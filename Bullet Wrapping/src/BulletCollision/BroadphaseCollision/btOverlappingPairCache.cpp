@@ -30,11 +30,38 @@ int gAddedPairs =0;
 int gFindPairs =0;
 
 
+///removes the pairs that contain any of the proxies, found by a binary search in the sorted proxies
+class	btRemovePairsContainingProxiesCallback : public btOverlapCallback
+{
+	btAlignedObjectArray<btBroadphaseProxy*>	m_obsoleteProxies;
+
+public:
+	btRemovePairsContainingProxiesCallback(btBroadphaseProxy** proxies,int numProxies)
+	{
+		m_obsoleteProxies.resize(numProxies);
+		for (int i=0;i<numProxies;i++)
+		{
+			m_obsoleteProxies[i] = proxies[i];
+		}
+		m_obsoleteProxies.quickSort(btAlignedObjectArray<btBroadphaseProxy*>::less());
+	}
+	virtual	bool	processOverlap(btBroadphasePair& pair)
+	{
+		return (m_obsoleteProxies.findBinarySearch(pair.m_pProxy0) < m_obsoleteProxies.size()) ||
+			(m_obsoleteProxies.findBinarySearch(pair.m_pProxy1) < m_obsoleteProxies.size());
+	}
+};
+
+
 
 
 btHashedOverlappingPairCache::btHashedOverlappingPairCache():
 	m_overlapFilterCallback(0),
 	m_blockedForChanges(false),
+	m_currentTable(0),
+	m_numEntries(0),
+	m_numOldEntries(0),
+	m_migrateCursor(0),
 	m_ghostPairCallback(0)
 {
 	int initialAllocatedSize= 2;
@@ -129,85 +156,134 @@ void	btHashedOverlappingPairCache::removeOverlappingPairsContainingProxy(btBroad
 	processAllOverlappingPairs(&removeCallback,dispatcher);
 }
 
+void	btHashedOverlappingPairCache::removeOverlappingPairsContainingProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher)
+{
+	if (!numProxies)
+		return;
+	btRemovePairsContainingProxiesCallback removeCallback(proxies,numProxies);
+	processAllOverlappingPairs(&removeCallback,dispatcher);
+}
+
 
 
 
 
 btBroadphasePair* btHashedOverlappingPairCache::findPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1)
 {
-	gFindPairs++;
+	btAtomicAdd(gFindPairs,1);
 	if(proxy0->m_uniqueId>proxy1->m_uniqueId) 
 		btSwap(proxy0,proxy1);
-	int proxyId1 = proxy0->getUid();
-	int proxyId2 = proxy1->getUid();
 
-	/*if (proxyId1 > proxyId2) 
-		btSwap(proxyId1, proxyId2);*/
-
-	int hash = static_cast<int>(getHash(static_cast<unsigned int>(proxyId1), static_cast<unsigned int>(proxyId2)) & (m_overlappingPairArray.capacity()-1));
-
-	if (hash >= m_hashTable.size())
+	btPairKey key = getPairKey(proxy0->getUid(),proxy1->getUid());
+	btPairHashEntry* entry = internalFindEntry(key,getHash(key));
+	if (!entry)
 	{
 		return NULL;
 	}
 
-	int index = m_hashTable[hash];
-	while (index != BT_NULL_PAIR && equalsPair(m_overlappingPairArray[index], proxyId1, proxyId2) == false)
+	btAssert(entry->m_pairIndex < m_overlappingPairArray.size());
+
+	return &m_overlappingPairArray[entry->m_pairIndex];
+}
+
+///number of old table slots moved to the new table per add/remove, while a resize is in progress.
+///The table grows at 50% load, so 4 slots per call finishes the migration long before the next resize.
+#define BT_PAIR_HASH_MIGRATE_STEP 4
+
+void	btHashedOverlappingPairCache::insertEntry(const btPairHashEntry& entry)
+{
+	btAlignedObjectArray<btPairHashEntry>& table = m_hashTables[m_currentTable];
+	int mask = table.size()-1;
+	int slot = int(entry.m_hash & mask);
+	while (table[slot].m_pairIndex != BT_NULL_PAIR)
 	{
-		index = m_next[index];
+		slot = (slot+1) & mask;
 	}
+	table[slot] = entry;
+	m_numEntries++;
+}
 
-	if (index == BT_NULL_PAIR)
+void	btHashedOverlappingPairCache::removeEntry(btPairHashEntry* entry)
+{
+	btAlignedObjectArray<btPairHashEntry>& table = m_hashTables[m_currentTable];
+	if (!table.size() || entry < &table[0] || entry > &table[table.size()-1])
 	{
-		return NULL;
+		//entries that are not migrated yet are marked removed, the old table is discarded once drained
+		entry->m_pairIndex = BT_REMOVED_PAIR;
+		m_numOldEntries--;
+		return;
 	}
 
-	btAssert(index < m_overlappingPairArray.size());
+	int slot = int(entry - &table[0]);
 
-	return &m_overlappingPairArray[index];
+	//backward shift deletion, keeps the current table free of tombstones
+	int mask = table.size()-1;
+	int next = slot;
+	for (;;)
+	{
+		next = (next+1) & mask;
+		const btPairHashEntry& probe = table[next];
+		if (probe.m_pairIndex == BT_NULL_PAIR)
+			break;
+		int home = int(probe.m_hash & mask);
+		bool canMove = (next > slot) ? (home <= slot || home > next) : (home <= slot && home > next);
+		if (canMove)
+		{
+			table[slot] = probe;
+			slot = next;
+		}
+	}
+	table[slot] = btPairHashEntry();
+	m_numEntries--;
 }
 
-//#include <stdio.h>
-
-void	btHashedOverlappingPairCache::growTables()
+void	btHashedOverlappingPairCache::migrateEntries(int numSlots)
 {
+	btAlignedObjectArray<btPairHashEntry>& oldTable = m_hashTables[1-m_currentTable];
+	if (!oldTable.size())
+		return;
 
-	int newCapacity = m_overlappingPairArray.capacity();
-
-	if (m_hashTable.size() < newCapacity)
+	while (numSlots-- > 0 && m_migrateCursor < oldTable.size())
 	{
-		//grow hashtable and next table
-		int curHashtableSize = m_hashTable.size();
-
-		m_hashTable.resize(newCapacity);
-		m_next.resize(newCapacity);
-
-
-		int i;
-
-		for (i= 0; i < newCapacity; ++i)
-		{
-			m_hashTable[i] = BT_NULL_PAIR;
-		}
-		for (i = 0; i < newCapacity; ++i)
+		btPairHashEntry& entry = oldTable[m_migrateCursor++];
+		if (entry.m_pairIndex >= 0)
 		{
-			m_next[i] = BT_NULL_PAIR;
+			insertEntry(entry);
+			//leave a tombstone, so probe sequences of the remaining old entries stay intact
+			entry.m_pairIndex = BT_REMOVED_PAIR;
+			m_numOldEntries--;
 		}
+	}
 
-		for(i=0;i<curHashtableSize;i++)
-		{
-	
-			const btBroadphasePair& pair = m_overlappingPairArray[i];
-			int proxyId1 = pair.m_pProxy0->getUid();
-			int proxyId2 = pair.m_pProxy1->getUid();
-			/*if (proxyId1 > proxyId2) 
-				btSwap(proxyId1, proxyId2);*/
-			int	hashValue = static_cast<int>(getHash(static_cast<unsigned int>(proxyId1),static_cast<unsigned int>(proxyId2)) & (m_overlappingPairArray.capacity()-1));	// New hash value with new mask
-			m_next[i] = m_hashTable[hashValue];
-			m_hashTable[hashValue] = i;
-		}
+	if (m_migrateCursor == oldTable.size())
+	{
+		btAssert(m_numOldEntries==0);
+		oldTable.clear();
+		m_migrateCursor = 0;
+	}
+}
 
+void	btHashedOverlappingPairCache::growTables()
+{
+	//a resize during a migration is not expected, finish the pending one first
+	if (m_hashTables[1-m_currentTable].size())
+	{
+		migrateEntries(m_hashTables[1-m_currentTable].size());
+	}
+
+	int curHashtableSize = m_hashTables[m_currentTable].size();
+	int newCapacity = curHashtableSize ? curHashtableSize*2 : 16;
 
+	m_currentTable = 1-m_currentTable;
+	m_hashTables[m_currentTable].resize(0);
+	m_hashTables[m_currentTable].resize(newCapacity,btPairHashEntry());
+
+	m_numOldEntries = m_numEntries;
+	m_numEntries = 0;
+	m_migrateCursor = 0;
+	if (!m_numOldEntries)
+	{
+		m_hashTables[1-m_currentTable].clear();
 	}
 }
 
@@ -215,55 +291,40 @@ btBroadphasePair* btHashedOverlappingPairCache::internalAddPair(btBroadphaseProx
 {
 	if(proxy0->m_uniqueId>proxy1->m_uniqueId) 
 		btSwap(proxy0,proxy1);
-	int proxyId1 = proxy0->getUid();
-	int proxyId2 = proxy1->getUid();
-
-	/*if (proxyId1 > proxyId2) 
-		btSwap(proxyId1, proxyId2);*/
 
-	int	hash = static_cast<int>(getHash(static_cast<unsigned int>(proxyId1),static_cast<unsigned int>(proxyId2)) & (m_overlappingPairArray.capacity()-1));	// New hash value with new mask
+	btPairKey key = getPairKey(proxy0->getUid(),proxy1->getUid());
+	unsigned int hash = getHash(key);
 
-
-	btBroadphasePair* pair = internalFindPair(proxy0, proxy1, hash);
-	if (pair != NULL)
+	btPairHashEntry* entry = internalFindEntry(key,hash);
+	if (entry)
 	{
-		return pair;
+		return &m_overlappingPairArray[entry->m_pairIndex];
 	}
-	/*for(int i=0;i<m_overlappingPairArray.size();++i)
-		{
-		if(	(m_overlappingPairArray[i].m_pProxy0==proxy0)&&
-			(m_overlappingPairArray[i].m_pProxy1==proxy1))
-			{
-			printf("Adding duplicated %u<>%u\r\n",proxyId1,proxyId2);
-			internalFindPair(proxy0, proxy1, hash);
-			}
-		}*/
+
 	int count = m_overlappingPairArray.size();
-	int oldCapacity = m_overlappingPairArray.capacity();
 	void* mem = &m_overlappingPairArray.expandNonInitializing();
 
 	//this is where we add an actual pair, so also call the 'ghost'
 	if (m_ghostPairCallback)
 		m_ghostPairCallback->addOverlappingPair(proxy0,proxy1);
 
-	int newCapacity = m_overlappingPairArray.capacity();
-
-	if (oldCapacity < newCapacity)
+	//keep the load factor at or below 50%, so linear probe sequences stay short
+	if ((m_numEntries+m_numOldEntries+1)*2 > m_hashTables[m_currentTable].size())
 	{
 		growTables();
-		//hash with new capacity
-		hash = static_cast<int>(getHash(static_cast<unsigned int>(proxyId1),static_cast<unsigned int>(proxyId2)) & (m_overlappingPairArray.capacity()-1));
 	}
 	
-	pair = new (mem) btBroadphasePair(*proxy0,*proxy1);
-//	pair->m_pProxy0 = proxy0;
-//	pair->m_pProxy1 = proxy1;
+	btBroadphasePair* pair = new (mem) btBroadphasePair(*proxy0,*proxy1);
 	pair->m_algorithm = 0;
 	pair->m_internalTmpValue = 0;
-	
 
-	m_next[count] = m_hashTable[hash];
-	m_hashTable[hash] = count;
+	btPairHashEntry newEntry;
+	newEntry.m_key = key;
+	newEntry.m_pairIndex = count;
+	newEntry.m_hash = hash;
+	insertEntry(newEntry);
+
+	migrateEntries(BT_PAIR_HASH_MIGRATE_STEP);
 
 	return pair;
 }
@@ -272,104 +333,56 @@ btBroadphasePair* btHashedOverlappingPairCache::internalAddPair(btBroadphaseProx
 
 void* btHashedOverlappingPairCache::removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1,btDispatcher* dispatcher)
 {
-	gRemovePairs++;
+	btAtomicAdd(gRemovePairs,1);
 	if(proxy0->m_uniqueId>proxy1->m_uniqueId) 
 		btSwap(proxy0,proxy1);
-	int proxyId1 = proxy0->getUid();
-	int proxyId2 = proxy1->getUid();
-
-	/*if (proxyId1 > proxyId2) 
-		btSwap(proxyId1, proxyId2);*/
 
-	int	hash = static_cast<int>(getHash(static_cast<unsigned int>(proxyId1),static_cast<unsigned int>(proxyId2)) & (m_overlappingPairArray.capacity()-1));
-
-	btBroadphasePair* pair = internalFindPair(proxy0, proxy1, hash);
-	if (pair == NULL)
+	btPairKey key = getPairKey(proxy0->getUid(),proxy1->getUid());
+	btPairHashEntry* entry = internalFindEntry(key,getHash(key));
+	if (entry == NULL)
 	{
 		return 0;
 	}
 
+	int pairIndex = entry->m_pairIndex;
+	btAssert(pairIndex < m_overlappingPairArray.size());
+	btBroadphasePair* pair = &m_overlappingPairArray[pairIndex];
+
 	cleanOverlappingPair(*pair,dispatcher);
 
 	void* userData = pair->m_internalInfo1;
 
-	btAssert(pair->m_pProxy0->getUid() == proxyId1);
-	btAssert(pair->m_pProxy1->getUid() == proxyId2);
-
-	int pairIndex = int(pair - &m_overlappingPairArray[0]);
-	btAssert(pairIndex < m_overlappingPairArray.size());
+	btAssert(pair->m_pProxy0->getUid() == proxy0->getUid());
+	btAssert(pair->m_pProxy1->getUid() == proxy1->getUid());
 
 	// Remove the pair from the hash table.
-	int index = m_hashTable[hash];
-	btAssert(index != BT_NULL_PAIR);
-
-	int previous = BT_NULL_PAIR;
-	while (index != pairIndex)
-	{
-		previous = index;
-		index = m_next[index];
-	}
-
-	if (previous != BT_NULL_PAIR)
-	{
-		btAssert(m_next[previous] == pairIndex);
-		m_next[previous] = m_next[pairIndex];
-	}
-	else
-	{
-		m_hashTable[hash] = m_next[pairIndex];
-	}
+	removeEntry(entry);
 
 	// We now move the last pair into spot of the
 	// pair being removed. We need to fix the hash
-	// table indices to support the move.
+	// table index to support the move.
 
 	int lastPairIndex = m_overlappingPairArray.size() - 1;
 
 	if (m_ghostPairCallback)
 		m_ghostPairCallback->removeOverlappingPair(proxy0, proxy1,dispatcher);
 
-	// If the removed pair is the last pair, we are done.
-	if (lastPairIndex == pairIndex)
+	if (lastPairIndex != pairIndex)
 	{
-		m_overlappingPairArray.pop_back();
-		return userData;
+		const btBroadphasePair& last = m_overlappingPairArray[lastPairIndex];
+		btPairKey lastKey = getPairKey(last.m_pProxy0->getUid(),last.m_pProxy1->getUid());
+		btPairHashEntry* lastEntry = internalFindEntry(lastKey,getHash(lastKey));
+		btAssert(lastEntry && lastEntry->m_pairIndex == lastPairIndex);
+		lastEntry->m_pairIndex = pairIndex;
+
+		// Copy the last pair into the remove pair's spot.
+		m_overlappingPairArray[pairIndex] = m_overlappingPairArray[lastPairIndex];
 	}
 
-	// Remove the last pair from the hash table.
-	const btBroadphasePair* last = &m_overlappingPairArray[lastPairIndex];
-		/* missing swap here too, Nat. */ 
-	int lastHash = static_cast<int>(getHash(static_cast<unsigned int>(last->m_pProxy0->getUid()), static_cast<unsigned int>(last->m_pProxy1->getUid())) & (m_overlappingPairArray.capacity()-1));
-
-	index = m_hashTable[lastHash];
-	btAssert(index != BT_NULL_PAIR);
-
-	previous = BT_NULL_PAIR;
-	while (index != lastPairIndex)
-	{
-		previous = index;
-		index = m_next[index];
-	}
-
-	if (previous != BT_NULL_PAIR)
-	{
-		btAssert(m_next[previous] == lastPairIndex);
-		m_next[previous] = m_next[lastPairIndex];
-	}
-	else
-	{
-		m_hashTable[lastHash] = m_next[lastPairIndex];
-	}
-
-	// Copy the last pair into the remove pair's spot.
-	m_overlappingPairArray[pairIndex] = m_overlappingPairArray[lastPairIndex];
-
-	// Insert the last pair into the hash table
-	m_next[pairIndex] = m_hashTable[lastHash];
-	m_hashTable[lastHash] = pairIndex;
-
 	m_overlappingPairArray.pop_back();
 
+	migrateEntries(BT_PAIR_HASH_MIGRATE_STEP);
+
 	return userData;
 }
 //#include <stdio.h>
@@ -388,7 +401,7 @@ void	btHashedOverlappingPairCache::processAllOverlappingPairs(btOverlapCallback*
 		{
 			removeOverlappingPair(pair->m_pProxy0,pair->m_pProxy1,dispatcher);
 
-			gOverlappingPairs--;
+			btAtomicAdd(gOverlappingPairs,-1);
 		} else
 		{
 			i++;
@@ -396,34 +409,19 @@ void	btHashedOverlappingPairCache::processAllOverlappingPairs(btOverlapCallback*
 	}
 }
 
-void	btHashedOverlappingPairCache::sortOverlappingPairs(btDispatcher* dispatcher)
+void	btHashedOverlappingPairCache::sortOverlappingPairs(btDispatcher* /*dispatcher*/)
 {
-	///need to keep hashmap in sync with pair address, so rebuild all
-	btBroadphasePairArray tmpPairs;
-	int i;
-	for (i=0;i<m_overlappingPairArray.size();i++)
-	{
-		tmpPairs.push_back(m_overlappingPairArray[i]);
-	}
+	///sort in place and point the hash entries to the new pair indices, so the collision algorithms and their manifolds are kept
+	m_overlappingPairArray.quickSort(btBroadphasePairSortPredicate());
 
-	for (i=0;i<tmpPairs.size();i++)
+	for (int i=0;i<m_overlappingPairArray.size();i++)
 	{
-		removeOverlappingPair(tmpPairs[i].m_pProxy0,tmpPairs[i].m_pProxy1,dispatcher);
+		const btBroadphasePair& pair = m_overlappingPairArray[i];
+		btPairKey key = getPairKey(pair.m_pProxy0->getUid(),pair.m_pProxy1->getUid());
+		btPairHashEntry* entry = internalFindEntry(key,getHash(key));
+		btAssert(entry);
+		entry->m_pairIndex = i;
 	}
-	
-	for (i = 0; i < m_next.size(); i++)
-	{
-		m_next[i] = BT_NULL_PAIR;
-	}
-
-	tmpPairs.quickSort(btBroadphasePairSortPredicate());
-
-	for (i=0;i<tmpPairs.size();i++)
-	{
-		addOverlappingPair(tmpPairs[i].m_pProxy0,tmpPairs[i].m_pProxy1);
-	}
-
-	
 }
 
 
@@ -436,7 +434,7 @@ void*	btSortedOverlappingPairCache::removeOverlappingPair(btBroadphaseProxy* pro
 		int findIndex = m_overlappingPairArray.findLinearSearch(findPair);
 		if (findIndex < m_overlappingPairArray.size())
 		{
-			gOverlappingPairs--;
+			btAtomicAdd(gOverlappingPairs,-1);
 			btBroadphasePair& pair = m_overlappingPairArray[findIndex];
 			void* userData = pair.m_internalInfo1;
 			cleanOverlappingPair(pair,dispatcher);
@@ -470,8 +468,8 @@ btBroadphasePair*	btSortedOverlappingPairCache::addOverlappingPair(btBroadphaseP
 	void* mem = &m_overlappingPairArray.expandNonInitializing();
 	btBroadphasePair* pair = new (mem) btBroadphasePair(*proxy0,*proxy1);
 	
-	gOverlappingPairs++;
-	gAddedPairs++;
+	btAtomicAdd(gOverlappingPairs,1);
+	btAtomicAdd(gAddedPairs,1);
 	
 	if (m_ghostPairCallback)
 		m_ghostPairCallback->addOverlappingPair(proxy0, proxy1);
@@ -527,7 +525,7 @@ void	btSortedOverlappingPairCache::processAllOverlappingPairs(btOverlapCallback*
 			pair->m_pProxy1 = 0;
 			m_overlappingPairArray.swap(i,m_overlappingPairArray.size()-1);
 			m_overlappingPairArray.pop_back();
-			gOverlappingPairs--;
+			btAtomicAdd(gOverlappingPairs,-1);
 		} else
 		{
 			i++;
@@ -560,7 +558,7 @@ void	btSortedOverlappingPairCache::cleanOverlappingPair(btBroadphasePair& pair,b
 			pair.m_algorithm->~btCollisionAlgorithm();
 			dispatcher->freeCollisionAlgorithm(pair.m_algorithm);
 			pair.m_algorithm=0;
-			gRemovePairs--;
+			btAtomicAdd(gRemovePairs,-1);
 		}
 	}
 }
@@ -626,8 +624,17 @@ void	btSortedOverlappingPairCache::removeOverlappingPairsContainingProxy(btBroad
 	processAllOverlappingPairs(&removeCallback,dispatcher);
 }
 
-void	btSortedOverlappingPairCache::sortOverlappingPairs(btDispatcher* dispatcher)
+void	btSortedOverlappingPairCache::removeOverlappingPairsContainingProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher)
+{
+	if (!numProxies)
+		return;
+	btRemovePairsContainingProxiesCallback removeCallback(proxies,numProxies);
+	processAllOverlappingPairs(&removeCallback,dispatcher);
+}
+
+void	btSortedOverlappingPairCache::sortOverlappingPairs(btDispatcher* /*dispatcher*/)
 {
-	//should already be sorted
+	//only sorted by the broadphase when it uses deferred removal
+	m_overlappingPairArray.quickSort(btBroadphasePairSortPredicate());
 }
 
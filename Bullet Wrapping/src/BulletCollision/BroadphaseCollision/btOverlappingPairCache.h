@@ -22,6 +22,7 @@ subject to the following restrictions:
 #include "btOverlappingPairCallback.h"
 
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btThreads.h"
 class btDispatcher;
 
 typedef btAlignedObjectArray<btBroadphasePair>	btBroadphasePairArray;
@@ -54,6 +55,25 @@ extern int gAddedPairs;
 extern int gFindPairs;
 
 const int BT_NULL_PAIR=0xffffffff;
+const int BT_REMOVED_PAIR=0xfffffffe;
+
+typedef unsigned long long int btPairKey;
+
+///btPairHashEntry is a slot of the btHashedOverlappingPairCache hash table. The key is stored inline,
+///so probing doesn't need to touch the pair array.
+struct btPairHashEntry
+{
+	btPairKey		m_key;
+	int				m_pairIndex;
+	unsigned int	m_hash;
+
+	btPairHashEntry()
+		:m_key(0),
+		m_pairIndex(BT_NULL_PAIR),
+		m_hash(0)
+	{
+	}
+};
 
 ///The btOverlappingPairCache provides an interface for overlapping pair management (add, remove, storage), used by the btBroadphaseInterface broadphases.
 ///The btHashedOverlappingPairCache and btSortedOverlappingPairCache classes are two implementations.
@@ -90,6 +110,9 @@ public:
 };
 
 /// Hash-space based Pair Cache, thanks to Erin Catto, Box2D, http://www.box2d.org, and Pierre Terdiman, Codercorner, http://codercorner.com
+/// The pairs are stored contiguously in m_overlappingPairArray, indexed by an open addressing (linear probing) hash table
+/// keyed on both 32-bit proxy uids. When the table grows, entries are moved to the new table incrementally
+/// during subsequent add/remove calls instead of rehashing everything at once.
 class btHashedOverlappingPairCache : public btOverlappingPairCache
 {
 	btBroadphasePairArray	m_overlappingPairArray;
@@ -104,6 +127,8 @@ public:
 	
 	void	removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher);
 
+	virtual void	removeOverlappingPairsContainingProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher);
+
 	virtual void*	removeOverlappingPair(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1,btDispatcher* dispatcher);
 	
 	SIMD_FORCE_INLINE bool needsBroadphaseCollision(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1) const
@@ -121,7 +146,7 @@ public:
 	// no new pair is created and the old one is returned.
 	virtual btBroadphasePair* 	addOverlappingPair(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1)
 	{
-		gAddedPairs++;
+		btAtomicAdd(gAddedPairs,1);
 
 		if (!needsBroadphaseCollision(proxy0,proxy1))
 			return 0;
@@ -183,74 +208,68 @@ private:
 	
 	btBroadphasePair* 	internalAddPair(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1);
 
-	void	growTables();
-
-	SIMD_FORCE_INLINE bool equalsPair(const btBroadphasePair& pair, int proxyId1, int proxyId2)
-	{	
-		return pair.m_pProxy0->getUid() == proxyId1 && pair.m_pProxy1->getUid() == proxyId2;
-	}
-
-	/*
-	// Thomas Wang's hash, see: http://www.concentric.net/~Ttwang/tech/inthash.htm
-	// This assumes proxyId1 and proxyId2 are 16-bit.
-	SIMD_FORCE_INLINE int getHash(int proxyId1, int proxyId2)
+	///full 64-bit pair key, the smaller uid goes in the high word (proxies are sorted by uid before hashing)
+	SIMD_FORCE_INLINE btPairKey getPairKey(int proxyId1, int proxyId2) const
 	{
-		int key = (proxyId2 << 16) | proxyId1;
-		key = ~key + (key << 15);
-		key = key ^ (key >> 12);
-		key = key + (key << 2);
-		key = key ^ (key >> 4);
-		key = key * 2057;
-		key = key ^ (key >> 16);
-		return key;
+		return (btPairKey(unsigned(proxyId1))<<32) | btPairKey(unsigned(proxyId2));
 	}
-	*/
-
 
-	
-	SIMD_FORCE_INLINE	unsigned int getHash(unsigned int proxyId1, unsigned int proxyId2)
+	// Thomas Wang's 64 bit integer hash, see: http://www.concentric.net/~Ttwang/tech/inthash.htm
+	// Unlike the old 32 bit variant, this uses both uids in full so uids above 65535 don't collide.
+	SIMD_FORCE_INLINE unsigned int getHash(btPairKey key) const
 	{
-		int key = static_cast<int>(((unsigned int)proxyId1) | (((unsigned int)proxyId2) <<16));
-		// Thomas Wang's hash
-
-		key += ~(key << 15);
-		key ^=  (key >> 10);
-		key +=  (key << 3);
-		key ^=  (key >> 6);
-		key += ~(key << 11);
-		key ^=  (key >> 16);
-		return static_cast<unsigned int>(key);
+		key = (~key) + (key << 21);
+		key = key ^ (key >> 24);
+		key = (key + (key << 3)) + (key << 8);
+		key = key ^ (key >> 14);
+		key = (key + (key << 2)) + (key << 4);
+		key = key ^ (key >> 28);
+		key = key + (key << 31);
+		return static_cast<unsigned int>(key ^ (key >> 32));
 	}
-	
-
 
-
-
-	SIMD_FORCE_INLINE btBroadphasePair* internalFindPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, int hash)
+	///returns the slot in 'table' holding 'key', or -1. Linear probing, tombstones are skipped.
+	SIMD_FORCE_INLINE int findSlot(const btAlignedObjectArray<btPairHashEntry>& table, btPairKey key, unsigned int hash) const
 	{
-		int proxyId1 = proxy0->getUid();
-		int proxyId2 = proxy1->getUid();
-		#if 0 // wrong, 'equalsPair' use unsorted uids, copy-past devil striked again. Nat.
-		if (proxyId1 > proxyId2) 
-			btSwap(proxyId1, proxyId2);
-		#endif
-
-		int index = m_hashTable[hash];
-		
-		while( index != BT_NULL_PAIR && equalsPair(m_overlappingPairArray[index], proxyId1, proxyId2) == false)
+		if (!table.size())
+			return -1;
+		int mask = table.size()-1;
+		int slot = int(hash & mask);
+		for (;;)
 		{
-			index = m_next[index];
+			const btPairHashEntry& entry = table[slot];
+			if (entry.m_pairIndex == BT_NULL_PAIR)
+				return -1;
+			if (entry.m_key == key && entry.m_pairIndex != BT_REMOVED_PAIR)
+				return slot;
+			slot = (slot+1) & mask;
 		}
+	}
 
-		if ( index == BT_NULL_PAIR )
+	SIMD_FORCE_INLINE btPairHashEntry* internalFindEntry(btPairKey key, unsigned int hash)
+	{
+		btAlignedObjectArray<btPairHashEntry>& table = m_hashTables[m_currentTable];
+		int slot = findSlot(table,key,hash);
+		if (slot >= 0)
+			return &table[slot];
+		if (m_numOldEntries)
 		{
-			return NULL;
+			btAlignedObjectArray<btPairHashEntry>& oldTable = m_hashTables[1-m_currentTable];
+			slot = findSlot(oldTable,key,hash);
+			if (slot >= 0)
+				return &oldTable[slot];
 		}
+		return 0;
+	}
 
-		btAssert(index < m_overlappingPairArray.size());
+	void	insertEntry(const btPairHashEntry& entry);
 
-		return &m_overlappingPairArray[index];
-	}
+	void	removeEntry(btPairHashEntry* entry);
+
+	///starts an incremental resize, the old table is drained a few slots at a time by migrateEntries
+	void	growTables();
+
+	void	migrateEntries(int numSlots);
 
 	virtual bool	hasDeferredRemoval()
 	{
@@ -267,8 +286,13 @@ private:
 
 protected:
 	
-	btAlignedObjectArray<int>	m_hashTable;
-	btAlignedObjectArray<int>	m_next;
+	///open addressing tables: m_hashTables[m_currentTable] receives all inserts, the other one is
+	///only non-empty while it is being migrated after a resize
+	btAlignedObjectArray<btPairHashEntry>	m_hashTables[2];
+	int							m_currentTable;
+	int							m_numEntries;
+	int							m_numOldEntries;
+	int							m_migrateCursor;
 	btOverlappingPairCallback*	m_ghostPairCallback;
 	
 };
@@ -315,6 +339,8 @@ class	btSortedOverlappingPairCache : public btOverlappingPairCache
 
 		void	removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher);
 
+		virtual void	removeOverlappingPairsContainingProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher);
+
 
 		inline bool needsBroadphaseCollision(btBroadphaseProxy* proxy0,btBroadphaseProxy* proxy1) const
 		{
@@ -454,6 +480,10 @@ public:
 	virtual void	removeOverlappingPairsContainingProxy(btBroadphaseProxy* /*proxy0*/,btDispatcher* /*dispatcher*/)
 	{
 	}
+
+	virtual void	removeOverlappingPairsContainingProxies(btBroadphaseProxy** /*proxies*/,int /*numProxies*/,btDispatcher* /*dispatcher*/)
+	{
+	}
 	
 	virtual void	sortOverlappingPairs(btDispatcher* dispatcher)
 	{
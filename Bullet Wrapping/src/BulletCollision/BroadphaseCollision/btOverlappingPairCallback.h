@@ -35,6 +35,15 @@ public:
 
 	virtual void	removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy0,btDispatcher* dispatcher) = 0;
 
+	///removes the pairs of several proxies at once, the pair caches override this with a single sweep over their pairs
+	virtual void	removeOverlappingPairsContainingProxies(btBroadphaseProxy** proxies,int numProxies,btDispatcher* dispatcher)
+	{
+		for (int i=0;i<numProxies;i++)
+		{
+			removeOverlappingPairsContainingProxy(proxies[i],dispatcher);
+		}
+	}
+
 };
 
 #endif //OVERLAPPING_PAIR_CALLBACK_H
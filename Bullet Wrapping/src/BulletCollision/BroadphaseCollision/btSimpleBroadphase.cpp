@@ -21,6 +21,7 @@ subject to the following restrictions:
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btMatrix3x3.h"
 #include "LinearMath/btAabbUtil2.h"
+#include "LinearMath/btThreads.h"
 
 #include <new>
 
@@ -315,7 +316,7 @@ void	btSimpleBroadphase::calculateOverlappingPairs(btDispatcher* dispatcher)
 					pair.m_pProxy0 = 0;
 					pair.m_pProxy1 = 0;
 					m_invalidPair++;
-					gOverlappingPairs--;
+					btAtomicAdd(gOverlappingPairs,-1);
 				} 
 
 			}
@@ -52,6 +52,11 @@ public:
 
 	struct CreateFunc :public 	btCollisionAlgorithmCreateFunc
 	{
+		CreateFunc()
+		{
+			m_concurrentProcessing = true;
+		}
+
 		virtual	btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, btCollisionObject* body0,btCollisionObject* body1)
 		{
 			int bbsize = sizeof(btBoxBoxCollisionAlgorithm);
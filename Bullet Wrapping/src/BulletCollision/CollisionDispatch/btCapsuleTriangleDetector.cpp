@@ -0,0 +1,248 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "LinearMath/btScalar.h"
+#include "btCapsuleTriangleDetector.h"
+#include "BulletCollision/CollisionShapes/btTriangleShape.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+
+
+btCapsuleTriangleDetector::btCapsuleTriangleDetector(btCapsuleShape* capsule,btTriangleShape* triangle,btScalar contactBreakingThreshold)
+:m_capsule(capsule),
+m_triangle(triangle),
+m_contactBreakingThreshold(contactBreakingThreshold)
+{
+
+}
+
+void	btCapsuleTriangleDetector::getClosestPoints(const ClosestPointInput& input,Result& output,class btIDebugDraw* debugDraw,bool swapResults)
+{
+
+	(void)debugDraw;
+	const btTransform& transformA = input.m_transformA;
+	const btTransform& transformB = input.m_transformB;
+
+	btVector3 points[2];
+	btVector3 normals[2];
+	btScalar depths[2];
+
+	//move capsule into triangle space
+	btTransform	capsuleInTr = transformB.inverseTimes(transformA);
+
+	int numContacts = collide(capsuleInTr,points,normals,depths);
+	for (int i=0;i<numContacts;i++)
+	{
+		btVector3 normalOnB = transformB.getBasis()*normals[i];
+		btVector3 pointOnB = transformB*points[i];
+		if (swapResults)
+		{
+			btVector3 normalOnA = -normalOnB;
+			btVector3 pointOnA = pointOnB+normalOnB*depths[i];
+			output.addContactPoint(normalOnA,pointOnA,depths[i]);
+		} else
+		{
+			output.addContactPoint(normalOnB,pointOnB,depths[i]);
+		}
+	}
+
+}
+
+
+
+// closest points between the segments p0-p1 and q0-q1, see also Ericson, Real-Time Collision Detection 5.1.9
+static void	closestPointsSegmentSegment(const btVector3& p0,const btVector3& p1,const btVector3& q0,const btVector3& q1,btVector3& pointOnP,btVector3& pointOnQ)
+{
+	btVector3 d1 = p1 - p0;
+	btVector3 d2 = q1 - q0;
+	btVector3 r = p0 - q0;
+	btScalar a = d1.dot(d1);
+	btScalar e = d2.dot(d2);
+	btScalar f = d2.dot(r);
+	btScalar s = btScalar(0.);
+	btScalar t = btScalar(0.);
+
+	if (a <= SIMD_EPSILON && e <= SIMD_EPSILON)
+	{
+		pointOnP = p0;
+		pointOnQ = q0;
+		return;
+	}
+	if (a <= SIMD_EPSILON)
+	{
+		t = btMin(btMax(f / e,btScalar(0.)),btScalar(1.));
+	} else
+	{
+		btScalar c = d1.dot(r);
+		if (e <= SIMD_EPSILON)
+		{
+			s = btMin(btMax(-c / a,btScalar(0.)),btScalar(1.));
+		} else
+		{
+			btScalar b = d1.dot(d2);
+			btScalar denom = a*e - b*b;
+			if (denom != btScalar(0.))
+			{
+				s = btMin(btMax((b*f - c*e) / denom,btScalar(0.)),btScalar(1.));
+			}
+			t = (b*s + f) / e;
+			if (t < btScalar(0.))
+			{
+				t = btScalar(0.);
+				s = btMin(btMax(-c / a,btScalar(0.)),btScalar(1.));
+			} else if (t > btScalar(1.))
+			{
+				t = btScalar(1.);
+				s = btMin(btMax((b - c) / a,btScalar(0.)),btScalar(1.));
+			}
+		}
+	}
+	pointOnP = p0 + d1*s;
+	pointOnQ = q0 + d2*t;
+}
+
+int btCapsuleTriangleDetector::collide(const btTransform& capsuleInTr,btVector3* points,btVector3* resultNormals,btScalar* depths)
+{
+
+	const btVector3* vertices = &m_triangle->getVertexPtr(0);
+
+	btScalar triangleMargin = m_triangle->getMargin();
+	btScalar radius = m_capsule->getRadius() + triangleMargin;
+	btScalar radiusWithThreshold = radius + m_contactBreakingThreshold;
+
+	btVector3 normal = (vertices[1]-vertices[0]).cross(vertices[2]-vertices[0]);
+	btScalar normalLength2 = normal.length2();
+	if (normalLength2 < SIMD_EPSILON*SIMD_EPSILON)
+	{
+		//degenerate triangle, the neighbouring triangles will generate the contacts
+		return 0;
+	}
+	normal /= btSqrt(normalLength2);
+
+	btVector3 halfAxis = capsuleInTr.getBasis().getColumn(m_capsule->getUpAxis()) * m_capsule->getHalfHeight();
+	const btVector3& capsuleCenter = capsuleInTr.getOrigin();
+	btVector3 segmentFrom = capsuleCenter + halfAxis;
+	btVector3 segmentTo = capsuleCenter - halfAxis;
+
+	//clip the capsule segment against the planes through the triangle edges, the edge normals point inwards
+	btScalar tMin = btScalar(0.);
+	btScalar tMax = btScalar(1.);
+	for (int i=0;i<3;i++)
+	{
+		const btVector3& va = vertices[i];
+		const btVector3& vb = vertices[(i+1)%3];
+		btVector3 edgeNormal = normal.cross(vb-va);
+		btScalar distFrom = edgeNormal.dot(segmentFrom-va);
+		btScalar distTo = edgeNormal.dot(segmentTo-va);
+		if (distFrom < btScalar(0.))
+		{
+			if (distTo < btScalar(0.))
+			{
+				tMin = btScalar(1.);
+				tMax = btScalar(0.);
+				break;
+			}
+			tMin = btMax(tMin,distFrom/(distFrom-distTo));
+		} else if (distTo < btScalar(0.))
+		{
+			tMax = btMin(tMax,distFrom/(distFrom-distTo));
+		}
+	}
+	bool overlapsFace = tMin <= tMax;
+
+	btVector3 clipped[2];
+	btScalar planeDistance[2];
+	btScalar faceDistance = btScalar(BT_LARGE_FLOAT);
+	if (overlapsFace)
+	{
+		clipped[0] = segmentFrom.lerp(segmentTo,tMin);
+		clipped[1] = segmentFrom.lerp(segmentTo,tMax);
+		planeDistance[0] = normal.dot(clipped[0]-vertices[0]);
+		planeDistance[1] = normal.dot(clipped[1]-vertices[0]);
+		if (planeDistance[0]+planeDistance[1] < btScalar(0.))
+		{
+			//triangle facing the other way
+			normal *= btScalar(-1.);
+			planeDistance[0] *= btScalar(-1.);
+			planeDistance[1] *= btScalar(-1.);
+		}
+		faceDistance = btMin(planeDistance[0],planeDistance[1]);
+	}
+
+	btScalar edgeDistanceSqr = btScalar(BT_LARGE_FLOAT);
+	btVector3 edgePoint(btScalar(0.),btScalar(0.),btScalar(0.));
+	btVector3 edgeToCapsule(btScalar(0.),btScalar(0.),btScalar(0.));
+	for (int i=0;i<3;i++)
+	{
+		btVector3 pointOnEdge,pointOnSegment;
+		closestPointsSegmentSegment(vertices[i],vertices[(i+1)%3],segmentFrom,segmentTo,pointOnEdge,pointOnSegment);
+		btVector3 diff = pointOnSegment - pointOnEdge;
+		btScalar distanceSqr = diff.length2();
+		if (distanceSqr < edgeDistanceSqr)
+		{
+			edgeDistanceSqr = distanceSqr;
+			edgePoint = pointOnEdge;
+			edgeToCapsule = diff;
+		}
+	}
+	btScalar edgeDistance = btSqrt(edgeDistanceSqr);
+
+	int numContacts = 0;
+
+	//a segment lying across the triangle touches the face and the edges at the same distance, prefer the face
+	if (overlapsFace && (faceDistance <= edgeDistance + m_contactBreakingThreshold*btScalar(0.01)))
+	{
+		for (int i=0;i<2;i++)
+		{
+			if (planeDistance[i] < radiusWithThreshold)
+			{
+				btVector3 pointOnFace = clipped[i] - normal*planeDistance[i];
+				if (numContacts && ((pointOnFace-points[0]+normal*triangleMargin).length2() < m_contactBreakingThreshold*m_contactBreakingThreshold))
+				{
+					//both ends of the clipped segment project onto the same point, keep the deepest
+					if (planeDistance[i]-radius < depths[0])
+					{
+						depths[0] = planeDistance[i]-radius;
+					}
+					continue;
+				}
+				points[numContacts] = pointOnFace + normal*triangleMargin;
+				resultNormals[numContacts] = normal;
+				depths[numContacts] = planeDistance[i]-radius;
+				numContacts++;
+			}
+		}
+	} else if (edgeDistance < radiusWithThreshold)
+	{
+		btVector3 edgeNormal;
+		if (edgeDistance > SIMD_EPSILON)
+		{
+			edgeNormal = edgeToCapsule / edgeDistance;
+		} else
+		{
+			//the segment touches the edge, push the capsule out along the face normal
+			edgeNormal = normal;
+			if (edgeNormal.dot(capsuleCenter-vertices[0]) < btScalar(0.))
+			{
+				edgeNormal *= btScalar(-1.);
+			}
+		}
+		points[0] = edgePoint + edgeNormal*triangleMargin;
+		resultNormals[0] = edgeNormal;
+		depths[0] = edgeDistance-radius;
+		numContacts = 1;
+	}
+
+	return numContacts;
+}
@@ -0,0 +1,51 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_CAPSULE_TRIANGLE_DETECTOR_H
+#define BT_CAPSULE_TRIANGLE_DETECTOR_H
+
+#include "BulletCollision/NarrowPhaseCollision/btDiscreteCollisionDetectorInterface.h"
+
+
+
+class btCapsuleShape;
+class btTriangleShape;
+
+
+
+/// capsule-triangle to match the btDiscreteCollisionDetectorInterface
+/// The capsule segment is clipped against the prism of the triangle. When the face is the closest feature, each end of
+/// the clipped segment gives a contact, so a capsule lying on the triangle gets two. Otherwise the closest points between
+/// the segment and the triangle edges give one contact.
+struct btCapsuleTriangleDetector : public btDiscreteCollisionDetectorInterface
+{
+	virtual void	getClosestPoints(const ClosestPointInput& input,Result& output,class btIDebugDraw* debugDraw,bool swapResults=false);
+
+	btCapsuleTriangleDetector(btCapsuleShape* capsule,btTriangleShape* triangle, btScalar contactBreakingThreshold);
+
+	virtual ~btCapsuleTriangleDetector() {};
+
+	///computes up to two contacts in triangle space. The points are on the triangle and the normals point towards the capsule.
+	int	collide(const btTransform& capsuleInTr,btVector3* points,btVector3* resultNormals,btScalar* depths);
+
+private:
+
+	btCapsuleShape* m_capsule;
+	btTriangleShape* m_triangle;
+	btScalar	m_contactBreakingThreshold;
+
+};
+#endif //BT_CAPSULE_TRIANGLE_DETECTOR_H
+
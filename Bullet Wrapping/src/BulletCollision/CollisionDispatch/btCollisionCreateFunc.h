@@ -26,9 +26,14 @@ struct btCollisionAlgorithmConstructionInfo;
 struct btCollisionAlgorithmCreateFunc
 {
 	bool m_swapped;
+
+	///the processCollision of the created algorithms can run concurrently for different pairs, once their contact manifold exists.
+	///See btCollisionDispatcher::CD_PARALLEL_BUCKETS
+	bool m_concurrentProcessing;
 	
 	btCollisionAlgorithmCreateFunc()
-		:m_swapped(false)
+		:m_swapped(false),
+		m_concurrentProcessing(false)
 	{
 	}
 	virtual ~btCollisionAlgorithmCreateFunc(){};
@@ -24,7 +24,9 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btCollisionObject.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 #include "LinearMath/btPoolAllocator.h"
+#include "LinearMath/btAabbUtil2.h"
 #include "BulletCollision/CollisionDispatch/btCollisionConfiguration.h"
+#include "LinearMath/btThreads.h"
 
 int gNumManifold = 0;
 
@@ -35,7 +37,8 @@ int gNumManifold = 0;
 
 btCollisionDispatcher::btCollisionDispatcher (btCollisionConfiguration* collisionConfiguration): 
 m_dispatcherFlags(btCollisionDispatcher::CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD),
-	m_collisionConfiguration(collisionConfiguration)
+	m_collisionConfiguration(collisionConfiguration),
+	m_bucketGrainSize(32)
 {
 	int i;
 
@@ -51,6 +54,7 @@ m_dispatcherFlags(btCollisionDispatcher::CD_USE_RELATIVE_CONTACT_BREAKING_THRESH
 		{
 			m_doubleDispatch[i][j] = m_collisionConfiguration->getCollisionAlgorithmCreateFunc(i,j);
 			btAssert(m_doubleDispatch[i][j]);
+			m_bucketOfShapeTypes[i][j] = -1;
 		}
 	}
 	
@@ -69,7 +73,7 @@ btCollisionDispatcher::~btCollisionDispatcher()
 
 btPersistentManifold*	btCollisionDispatcher::getNewManifold(void* b0,void* b1) 
 { 
-	gNumManifold++;
+	btAtomicAdd(gNumManifold,1);
 	
 	//btAssert(gNumManifold < 65535);
 	
@@ -87,7 +91,7 @@ btPersistentManifold*	btCollisionDispatcher::getNewManifold(void* b0,void* b1)
 		
 	void* mem = 0;
 	
-	if (m_persistentManifoldPoolAllocator->getFreeCount())
+	if (m_persistentManifoldPoolAllocator->canAllocate())
 	{
 		mem = m_persistentManifoldPoolAllocator->allocate(sizeof(btPersistentManifold));
 	} else
@@ -119,7 +123,7 @@ void btCollisionDispatcher::clearManifold(btPersistentManifold* manifold)
 void btCollisionDispatcher::releaseManifold(btPersistentManifold* manifold)
 {
 	
-	gNumManifold--;
+	btAtomicAdd(gNumManifold,-1);
 
 	//printf("releaseManifold: gNumManifold %d\n",gNumManifold);
 	clearManifold(manifold);
@@ -169,6 +173,11 @@ bool	btCollisionDispatcher::needsResponse(btCollisionObject* body0,btCollisionOb
 	return hasResponse;
 }
 
+static SIMD_FORCE_INLINE bool	btIsLodResting(const btCollisionObject* colObj)
+{
+	return !colObj->isActive() || colObj->isStaticObject() || (colObj->getCollisionFlags() & btCollisionObject::CF_LOD_SKIPPED);
+}
+
 bool	btCollisionDispatcher::needsCollision(btCollisionObject* body0,btCollisionObject* body1)
 {
 	btAssert(body0);
@@ -192,6 +201,11 @@ bool	btCollisionDispatcher::needsCollision(btCollisionObject* body0,btCollisionO
 		needsCollision = false;
 	else if (!body0->checkCollideWith(body1))
 		needsCollision = false;
+	else if ((body0->getCollisionFlags() | body1->getCollisionFlags()) & btCollisionObject::CF_AABB_OVERLAP_ONLY)
+		needsCollision = false;
+	else if (((body0->getCollisionFlags() | body1->getCollisionFlags()) & btCollisionObject::CF_LOD_SKIPPED) && btIsLodResting(body0) && btIsLodResting(body1))
+		///neither object moves in this substep, the contact manifold stays valid
+		needsCollision = false;
 	
 	return needsCollision ;
 
@@ -199,12 +213,55 @@ bool	btCollisionDispatcher::needsCollision(btCollisionObject* body0,btCollisionO
 
 
 
+///a broadphase can keep pairs of enlarged bounds (btDbvtBroadphase) that depend on its history. In deterministic mode
+///only pairs whose current bounds overlap are processed, the others drop their contacts as if the pair didn't exist.
+static bool	btSkipNonOverlappingPair(btBroadphasePair& pair,const btDispatcherInfo& dispatchInfo,btManifoldArray& manifoldArray)
+{
+	if (dispatchInfo.m_deterministicOrder && !TestAabbAgainstAabb2(pair.m_pProxy0->m_aabbMin,pair.m_pProxy0->m_aabbMax,
+		pair.m_pProxy1->m_aabbMin,pair.m_pProxy1->m_aabbMax))
+	{
+		if (pair.m_algorithm)
+		{
+			manifoldArray.resize(0);
+			pair.m_algorithm->getAllContactManifolds(manifoldArray);
+			for (int i=0;i<manifoldArray.size();i++)
+			{
+				manifoldArray[i]->clearManifold();
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+static SIMD_FORCE_INLINE void	btProcessPairAlgorithm(btBroadphasePair& collisionPair,const btDispatcherInfo& dispatchInfo)
+{
+	btCollisionObject* colObj0 = (btCollisionObject*)collisionPair.m_pProxy0->m_clientObject;
+	btCollisionObject* colObj1 = (btCollisionObject*)collisionPair.m_pProxy1->m_clientObject;
+
+	btManifoldResult contactPointResult(colObj0,colObj1);
+	
+	if (dispatchInfo.m_dispatchFunc == 		btDispatcherInfo::DISPATCH_DISCRETE)
+	{
+		//discrete collision detection query
+		collisionPair.m_algorithm->processCollision(colObj0,colObj1,dispatchInfo,&contactPointResult);
+	} else
+	{
+		//continuous collision detection query, time of impact (toi)
+		btScalar toi = collisionPair.m_algorithm->calculateTimeOfImpact(colObj0,colObj1,dispatchInfo,&contactPointResult);
+		if (dispatchInfo.m_timeOfImpact > toi)
+			dispatchInfo.m_timeOfImpact = toi;
+
+	}
+}
+
 ///interface for iterating all overlapping collision pairs, no matter how those pairs are stored (array, set, map etc)
 ///this is useful for the collision dispatcher.
 class btCollisionPairCallback : public btOverlapCallback
 {
 	const btDispatcherInfo& m_dispatchInfo;
 	btCollisionDispatcher*	m_dispatcher;
+	btManifoldArray			m_manifoldArray;
 
 public:
 
@@ -228,26 +285,264 @@ public:
 
 	virtual bool	processOverlap(btBroadphasePair& pair)
 	{
+		if (btSkipNonOverlappingPair(pair,m_dispatchInfo,m_manifoldArray))
+		{
+			return false;
+		}
+
 		(*m_dispatcher->getNearCallback())(pair,*m_dispatcher,m_dispatchInfo);
 
 		return false;
 	}
 };
 
+///collects the pairs that need collision for the type bucketed dispatch, and creates their collision algorithms
+class btCollisionPairGatherCallback : public btOverlapCallback
+{
+	const btDispatcherInfo& m_dispatchInfo;
+	btCollisionDispatcher*	m_dispatcher;
+	btManifoldArray			m_manifoldArray;
+	btAlignedObjectArray<btBroadphasePair*>&	m_pairs;
+	btAlignedObjectArray<bool>&	m_newPairs;
+
+public:
+
+	btCollisionPairGatherCallback(const btDispatcherInfo& dispatchInfo,btCollisionDispatcher* dispatcher,btAlignedObjectArray<btBroadphasePair*>& pairs,btAlignedObjectArray<bool>& newPairs)
+	:m_dispatchInfo(dispatchInfo),
+	m_dispatcher(dispatcher),
+	m_pairs(pairs),
+	m_newPairs(newPairs)
+	{
+	}
+
+	virtual ~btCollisionPairGatherCallback() {}
+
+	virtual bool	processOverlap(btBroadphasePair& pair)
+	{
+		if (btSkipNonOverlappingPair(pair,m_dispatchInfo,m_manifoldArray))
+		{
+			return false;
+		}
+
+		btCollisionObject* colObj0 = (btCollisionObject*)pair.m_pProxy0->m_clientObject;
+		btCollisionObject* colObj1 = (btCollisionObject*)pair.m_pProxy1->m_clientObject;
+
+		if (m_dispatcher->needsCollision(colObj0,colObj1))
+		{
+			bool newPair = false;
+			if (!pair.m_algorithm)
+			{
+				pair.m_algorithm = m_dispatcher->findAlgorithm(colObj0,colObj1);
+				newPair = true;
+			}
+			if (pair.m_algorithm)
+			{
+				m_pairs.push_back(&pair);
+				m_newPairs.push_back(newPair);
+			}
+		}
+		return false;
+	}
+};
+
+struct btProcessPairsLoop : public btIParallelForBody
+{
+	btBroadphasePair* const*	m_pairs;
+	const btDispatcherInfo&	m_dispatchInfo;
+
+	btProcessPairsLoop(btBroadphasePair* const* pairs,const btDispatcherInfo& dispatchInfo)
+		:m_pairs(pairs),
+		m_dispatchInfo(dispatchInfo)
+	{
+	}
+
+	virtual void	forLoop(int iBegin, int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			btProcessPairAlgorithm(*m_pairs[i],m_dispatchInfo);
+		}
+	}
+};
+
+class btDispatchBucketSortPredicate
+{
+	public:
+
+		bool operator() ( const btDispatchBucketStats& lhs, const btDispatchBucketStats& rhs ) const
+		{
+			return (lhs.m_shapeType0 < rhs.m_shapeType0) ||
+				((lhs.m_shapeType0 == rhs.m_shapeType0) && (lhs.m_shapeType1 < rhs.m_shapeType1));
+		}
+};
+
 
 
 void	btCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache,const btDispatcherInfo& dispatchInfo,btDispatcher* dispatcher) 
 {
 	//m_blockedForChanges = true;
 
-	btCollisionPairCallback	collisionCallback(dispatchInfo,this);
+	m_bucketStats.resize(0);
 
-	pairCache->processAllOverlappingPairs(&collisionCallback,dispatcher);
+	if ((m_dispatcherFlags & CD_BUCKET_PAIRS_BY_TYPE) && (m_nearCallback == defaultNearCallback))
+	{
+		dispatchBucketedPairs(pairCache,dispatchInfo,dispatcher);
+	} else
+	{
+		btCollisionPairCallback	collisionCallback(dispatchInfo,this);
+
+		pairCache->processAllOverlappingPairs(&collisionCallback,dispatcher);
+	}
 
 	//m_blockedForChanges = false;
 
 }
 
+void	btCollisionDispatcher::dispatchBucketedPairs(btOverlappingPairCache* pairCache,const btDispatcherInfo& dispatchInfo,btDispatcher* dispatcher)
+{
+	int i;
+
+	m_gatheredPairs.resize(0);
+	m_gatheredNewPairs.resize(0);
+	btCollisionPairGatherCallback gatherCallback(dispatchInfo,this,m_gatheredPairs,m_gatheredNewPairs);
+	pairCache->processAllOverlappingPairs(&gatherCallback,dispatcher);
+
+	int numPairs = m_gatheredPairs.size();
+	if (!numPairs)
+	{
+		return;
+	}
+
+	//creating a contact manifold isn't thread safe, and time of impact queries share dispatchInfo.m_timeOfImpact
+	bool parallel = (m_dispatcherFlags & CD_PARALLEL_BUCKETS) && (dispatchInfo.m_dispatchFunc == btDispatcherInfo::DISPATCH_DISCRETE) &&
+		(btGetTaskScheduler() != btGetSequentialTaskScheduler());
+
+	btManifoldArray manifoldArray;
+	for (i=0;i<numPairs;i++)
+	{
+		btBroadphasePair* pair = m_gatheredPairs[i];
+		int shapeType0 = ((btCollisionObject*)pair->m_pProxy0->m_clientObject)->getCollisionShape()->getShapeType();
+		int shapeType1 = ((btCollisionObject*)pair->m_pProxy1->m_clientObject)->getCollisionShape()->getShapeType();
+		btCollisionAlgorithmCreateFunc* createFunc = m_doubleDispatch[shapeType0][shapeType1];
+
+		int& bucket = m_bucketOfShapeTypes[shapeType0][shapeType1];
+		if (bucket < 0)
+		{
+			//first pair of these shape types, several combinations can share a collision algorithm
+			m_bucketedShapeTypes.push_back(shapeType0*MAX_BROADPHASE_COLLISION_TYPES+shapeType1);
+			for (bucket=0;bucket<m_bucketStats.size();bucket++)
+			{
+				if (m_bucketStats[bucket].m_createFunc == createFunc)
+					break;
+			}
+			if (bucket == m_bucketStats.size())
+			{
+				btDispatchBucketStats& stats = m_bucketStats.expand();
+				stats.m_createFunc = createFunc;
+				stats.m_shapeType0 = shapeType0;
+				stats.m_shapeType1 = shapeType1;
+				stats.m_numPairs = 0;
+				stats.m_numNewPairs = 0;
+				stats.m_concurrent = parallel && createFunc->m_concurrentProcessing;
+				stats.m_timeMicroseconds = 0;
+			} else
+			{
+				btDispatchBucketStats& stats = m_bucketStats[bucket];
+				if ((shapeType0 < stats.m_shapeType0) || ((shapeType0 == stats.m_shapeType0) && (shapeType1 < stats.m_shapeType1)))
+				{
+					stats.m_shapeType0 = shapeType0;
+					stats.m_shapeType1 = shapeType1;
+				}
+			}
+		}
+
+		//an algorithm created during a time of impact query can still lack its contact manifold
+		if (!m_gatheredNewPairs[i] && createFunc->m_concurrentProcessing)
+		{
+			manifoldArray.resize(0);
+			pair->m_algorithm->getAllContactManifolds(manifoldArray);
+			m_gatheredNewPairs[i] = (manifoldArray.size() == 0);
+		}
+
+		btDispatchBucketStats& stats = m_bucketStats[bucket];
+		stats.m_numPairs++;
+		if (m_gatheredNewPairs[i])
+		{
+			stats.m_numNewPairs++;
+		}
+	}
+
+	//order the buckets by their lowest shape types, so the processing order doesn't depend on which pair comes first in the pair cache
+	int numBuckets = m_bucketStats.size();
+	m_bucketStats.quickSort(btDispatchBucketSortPredicate());
+	for (i=0;i<m_bucketedShapeTypes.size();i++)
+	{
+		int shapeType0 = m_bucketedShapeTypes[i] / MAX_BROADPHASE_COLLISION_TYPES;
+		int shapeType1 = m_bucketedShapeTypes[i] % MAX_BROADPHASE_COLLISION_TYPES;
+		int bucket = 0;
+		while (m_bucketStats[bucket].m_createFunc != m_doubleDispatch[shapeType0][shapeType1])
+		{
+			bucket++;
+		}
+		m_bucketOfShapeTypes[shapeType0][shapeType1] = bucket;
+	}
+
+	//counting sort of the pairs into their buckets, new pairs first
+	m_bucketOffsets.resize(2*numBuckets);
+	int offset = 0;
+	for (i=0;i<numBuckets;i++)
+	{
+		const btDispatchBucketStats& stats = m_bucketStats[i];
+		m_bucketOffsets[2*i] = offset;
+		m_bucketOffsets[2*i+1] = offset+stats.m_numNewPairs;
+		offset += stats.m_numPairs;
+	}
+	m_bucketedPairs.resize(numPairs);
+	for (i=0;i<numPairs;i++)
+	{
+		btBroadphasePair* pair = m_gatheredPairs[i];
+		int shapeType0 = ((btCollisionObject*)pair->m_pProxy0->m_clientObject)->getCollisionShape()->getShapeType();
+		int shapeType1 = ((btCollisionObject*)pair->m_pProxy1->m_clientObject)->getCollisionShape()->getShapeType();
+		int bucket = m_bucketOfShapeTypes[shapeType0][shapeType1];
+		m_bucketedPairs[m_bucketOffsets[2*bucket+(m_gatheredNewPairs[i]?0:1)]++] = pair;
+	}
+	for (i=0;i<m_bucketedShapeTypes.size();i++)
+	{
+		m_bucketOfShapeTypes[m_bucketedShapeTypes[i] / MAX_BROADPHASE_COLLISION_TYPES][m_bucketedShapeTypes[i] % MAX_BROADPHASE_COLLISION_TYPES] = -1;
+	}
+	m_bucketedShapeTypes.resize(0);
+
+	offset = 0;
+	for (i=0;i<numBuckets;i++)
+	{
+		btDispatchBucketStats& stats = m_bucketStats[i];
+
+		int begin = offset;
+		int end = offset+stats.m_numPairs;
+		int sequentialEnd = stats.m_concurrent ? begin+stats.m_numNewPairs : end;
+		offset = end;
+
+#ifdef USE_BT_CLOCK
+		m_bucketClock.reset();
+#endif //USE_BT_CLOCK
+
+		int j;
+		for (j=begin;j<sequentialEnd;j++)
+		{
+			btProcessPairAlgorithm(*m_bucketedPairs[j],dispatchInfo);
+		}
+		if (sequentialEnd < end)
+		{
+			btProcessPairsLoop processLoop(&m_bucketedPairs[0],dispatchInfo);
+			btParallelFor(sequentialEnd,end,m_bucketGrainSize,processLoop);
+		}
+
+#ifdef USE_BT_CLOCK
+		stats.m_timeMicroseconds = m_bucketClock.getTimeMicroseconds();
+#endif //USE_BT_CLOCK
+	}
+}
+
 
 
 
@@ -267,20 +562,7 @@ void btCollisionDispatcher::defaultNearCallback(btBroadphasePair& collisionPair,
 
 			if (collisionPair.m_algorithm)
 			{
-				btManifoldResult contactPointResult(colObj0,colObj1);
-				
-				if (dispatchInfo.m_dispatchFunc == 		btDispatcherInfo::DISPATCH_DISCRETE)
-				{
-					//discrete collision detection query
-					collisionPair.m_algorithm->processCollision(colObj0,colObj1,dispatchInfo,&contactPointResult);
-				} else
-				{
-					//continuous collision detection query, time of impact (toi)
-					btScalar toi = collisionPair.m_algorithm->calculateTimeOfImpact(colObj0,colObj1,dispatchInfo,&contactPointResult);
-					if (dispatchInfo.m_timeOfImpact > toi)
-						dispatchInfo.m_timeOfImpact = toi;
-
-				}
+				btProcessPairAlgorithm(collisionPair,dispatchInfo);
 			}
 		}
 
@@ -289,7 +571,7 @@ void btCollisionDispatcher::defaultNearCallback(btBroadphasePair& collisionPair,
 
 void* btCollisionDispatcher::allocateCollisionAlgorithm(int size)
 {
-	if (m_collisionAlgorithmPoolAllocator->getFreeCount())
+	if (m_collisionAlgorithmPoolAllocator->canAllocate())
 	{
 		return m_collisionAlgorithmPoolAllocator->allocate(size);
 	}
@@ -23,6 +23,7 @@ subject to the following restrictions:
 
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btQuickprof.h"
 
 class btIDebugDraw;
 class btOverlappingPairCache;
@@ -37,6 +38,23 @@ class btCollisionDispatcher;
 ///user can override this nearcallback for collision filtering and more finegrained control over collision detection
 typedef void (*btNearCallback)(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
 
+///statistics of the pairs of one collision algorithm type in the last dispatchAllCollisionPairs, see btCollisionDispatcher::CD_BUCKET_PAIRS_BY_TYPE
+struct btDispatchBucketStats
+{
+	///the pairs are bucketed by the create function of their collision algorithm
+	btCollisionAlgorithmCreateFunc*	m_createFunc;
+	///the lowest combination of shape types among the pairs of the bucket
+	int		m_shapeType0;
+	int		m_shapeType1;
+	int		m_numPairs;
+	///pairs without a contact manifold yet, usually because their collision algorithm was just created. They are processed first, on the calling thread.
+	int		m_numNewPairs;
+	///the other pairs of the bucket were processed with btParallelFor
+	bool	m_concurrent;
+	///wall clock time spent in the collision algorithms of the bucket, 0 when btClock isn't available
+	unsigned long int	m_timeMicroseconds;
+};
+
 
 ///btCollisionDispatcher supports algorithms that handle ConvexConvex and ConvexConcave collision pairs.
 ///Time of Impact, Closest Points and Penetration Depth.
@@ -61,6 +79,20 @@ protected:
 
 	btCollisionConfiguration*	m_collisionConfiguration;
 
+	///type bucketed dispatch, see CD_BUCKET_PAIRS_BY_TYPE
+	btAlignedObjectArray<btBroadphasePair*>	m_gatheredPairs;
+	btAlignedObjectArray<bool>				m_gatheredNewPairs;
+	btAlignedObjectArray<btBroadphasePair*>	m_bucketedPairs;
+	btAlignedObjectArray<int>				m_bucketOffsets;
+	btAlignedObjectArray<btDispatchBucketStats>	m_bucketStats;
+	btAlignedObjectArray<int>				m_bucketedShapeTypes;
+	int		m_bucketOfShapeTypes[MAX_BROADPHASE_COLLISION_TYPES][MAX_BROADPHASE_COLLISION_TYPES];
+	int		m_bucketGrainSize;
+#ifdef USE_BT_CLOCK
+	btClock	m_bucketClock;
+#endif //USE_BT_CLOCK
+
+	void	dispatchBucketedPairs(btOverlappingPairCache* pairCache,const btDispatcherInfo& dispatchInfo,btDispatcher* dispatcher);
 
 public:
 
@@ -68,7 +100,22 @@ public:
 	{
 		CD_STATIC_STATIC_REPORTED = 1,
 		CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD = 2,
-		CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION = 4
+		CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION = 4,
+		///gather the pairs first and run them grouped by the type of their collision algorithm, so each algorithm runs in a tight loop
+		///that keeps its code and data in the caches. The pairs of an algorithm are processed together instead of in the order of
+		///the pair cache. Only used with the defaultNearCallback.
+		CD_BUCKET_PAIRS_BY_TYPE = 8,
+		///together with CD_BUCKET_PAIRS_BY_TYPE, process the buckets of algorithms with btCollisionAlgorithmCreateFunc::m_concurrentProcessing
+		///using btParallelFor. The contacts are the same as without this flag. New pairs still run on the calling thread,
+		///because creating their contact manifold isn't thread safe. The following can be called from several threads at once and have to be thread safe:
+		///- gContactAddedCallback, from btManifoldResult::addContactPoint for objects with CF_CUSTOM_MATERIAL_CALLBACK
+		///- gContactProcessedCallback, from btPersistentManifold::refreshContactPoints
+		///- gContactDestroyedCallback, when a contact with m_userPersistentData is replaced or removed
+		///- the support functions of user defined convex shapes, and the penetration depth solver of the collision configuration
+		///The near callback is never called from the worker threads: the buckets are only used with defaultNearCallback, and needsCollision
+		///and findAlgorithm run on the calling thread while the pairs are gathered. The statistics counters like gNumGjkChecks are updated
+		///with btAtomicAdd and are exact once the dispatch has returned.
+		CD_PARALLEL_BUCKETS = 16
 	};
 
 	int	getDispatcherFlags() const
@@ -91,7 +138,7 @@ public:
 
 	btPersistentManifold**	getInternalManifoldPointer()
 	{
-		return &m_manifoldsPtr[0];
+		return m_manifoldsPtr.size()? &m_manifoldsPtr[0] : 0;
 	}
 
 	 btPersistentManifold* getManifoldByIndexInternal(int index)
@@ -134,6 +181,28 @@ public:
 		return m_nearCallback;
 	}
 
+	///number of pairs per btParallelFor task with CD_PARALLEL_BUCKETS
+	void	setBucketGrainSize(int grainSize)
+	{
+		m_bucketGrainSize = grainSize;
+	}
+
+	int		getBucketGrainSize() const
+	{
+		return m_bucketGrainSize;
+	}
+
+	///the buckets of the last dispatchAllCollisionPairs, ordered by their lowest shape types. Only filled with CD_BUCKET_PAIRS_BY_TYPE.
+	int		getNumDispatchBuckets() const
+	{
+		return m_bucketStats.size();
+	}
+
+	const btDispatchBucketStats&	getDispatchBucketStats(int bucket) const
+	{
+		return m_bucketStats[bucket];
+	}
+
 	//by default, Bullet will use this near callback
 	static void  defaultNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
 
@@ -122,7 +122,9 @@ public:
 		CF_CUSTOM_MATERIAL_CALLBACK = 8,//this allows per-triangle material (friction/restitution)
 		CF_CHARACTER_OBJECT = 16,
 		CF_DISABLE_VISUALIZE_OBJECT = 32, //disable debug drawing
-		CF_DISABLE_SPU_COLLISION_PROCESSING = 64//disable parallel/SPU processing
+		CF_DISABLE_SPU_COLLISION_PROCESSING = 64,//disable parallel/SPU processing
+		CF_AABB_OVERLAP_ONLY = 128,//pairs involving this object are reported by the broadphase but never reach the narrowphase
+		CF_LOD_SKIPPED = 256//set by btDiscreteDynamicsWorld on rigid bodies that skip the current substep because of their level of detail
 	};
 
 	enum	CollisionObjectTypes
@@ -134,7 +136,8 @@ public:
 		CO_GHOST_OBJECT=4,
 		CO_SOFT_BODY=8,
 		CO_HF_FLUID=16,
-		CO_USER_TYPE=32
+		CO_USER_TYPE=32,
+		CO_FEATHERSTONE_LINK=64
 	};
 
 	SIMD_FORCE_INLINE bool mergesSimulationIslands() const
@@ -34,6 +34,8 @@ subject to the following restrictions:
 #include "LinearMath/btStackAlloc.h"
 #include "LinearMath/btSerializer.h"
 #include "BulletCollision/CollisionShapes/btConvexPolyhedron.h"
+#include "LinearMath/btDebugDrawBuffer.h"
+#include "LinearMath/btThreads.h"
 
 //#define DISABLE_DBVT_COMPOUNDSHAPE_RAYCAST_ACCELERATION
 
@@ -70,7 +72,8 @@ btCollisionWorld::btCollisionWorld(btDispatcher* dispatcher,btBroadphaseInterfac
 :m_dispatcher1(dispatcher),
 m_broadphasePairCache(pairCache),
 m_debugDrawer(0),
-m_forceUpdateAllAabbs(true)
+m_forceUpdateAllAabbs(true),
+m_worldOrigin(btScalar(0.),btScalar(0.),btScalar(0.))
 {
 	m_stackAlloc = collisionConfiguration->getStackAllocator();
 	m_dispatchInfo.m_stackAllocator = m_stackAlloc;
@@ -208,6 +211,63 @@ void	btCollisionWorld::updateAabbs()
 
 
 
+void	btCollisionWorld::shiftOrigin(const btVector3& shift)
+{
+	BT_PROFILE("shiftOrigin");
+
+	int i;
+	for (i=0;i<m_collisionObjects.size();i++)
+	{
+		btCollisionObject* colObj = m_collisionObjects[i];
+		//soft bodies keep their nodes in world space, see btSoftRigidDynamicsWorld::shiftOrigin
+		if (colObj->getInternalType() == btCollisionObject::CO_SOFT_BODY)
+			continue;
+		colObj->getWorldTransform().getOrigin() -= shift;
+		colObj->getInterpolationWorldTransform().getOrigin() -= shift;
+	}
+
+	m_broadphasePairCache->shiftOrigin(shift,m_dispatcher1);
+	for (i=0;i<m_collisionObjects.size();i++)
+	{
+		btCollisionObject* colObj = m_collisionObjects[i];
+		if (colObj->getBroadphaseHandle())
+		{
+			updateSingleAabb(colObj);
+		}
+	}
+
+	//the world positions of the contacts are refreshed from their local points in the next step,
+	//shift them anyway for code that reads the manifolds before that
+	if (m_dispatcher1)
+	{
+		int numManifolds = m_dispatcher1->getNumManifolds();
+		for (i=0;i<numManifolds;i++)
+		{
+			btPersistentManifold* manifold = m_dispatcher1->getManifoldByIndexInternal(i);
+			for (int j=0;j<manifold->getNumContacts();j++)
+			{
+				btManifoldPoint& pt = manifold->getContactPoint(j);
+				pt.m_positionWorldOnA -= shift;
+				pt.m_positionWorldOnB -= shift;
+			}
+		}
+	}
+
+	m_worldOrigin += shift;
+}
+
+bool	btCollisionWorld::rebaseOrigin(const btVector3& focusPosition, btScalar cellSize)
+{
+	btAssert(cellSize > btScalar(0.));
+	btVector3 cells(btScalar(floor(focusPosition.getX()/cellSize + btScalar(0.5))),
+		btScalar(floor(focusPosition.getY()/cellSize + btScalar(0.5))),
+		btScalar(floor(focusPosition.getZ()/cellSize + btScalar(0.5))));
+	if (cells.isZero())
+		return false;
+	shiftOrigin(cells*cellSize);
+	return true;
+}
+
 void	btCollisionWorld::performDiscreteCollisionDetection()
 {
 	BT_PROFILE("performDiscreteCollisionDetection");
@@ -219,6 +279,8 @@ void	btCollisionWorld::performDiscreteCollisionDetection()
 	{
 		BT_PROFILE("calculateOverlappingPairs");
 		m_broadphasePairCache->calculateOverlappingPairs(m_dispatcher1);
+		if (dispatchInfo.m_deterministicOrder)
+			m_broadphasePairCache->getOverlappingPairCache()->sortOverlappingPairs(m_dispatcher1);
 	}
 
 
@@ -261,6 +323,97 @@ void	btCollisionWorld::removeCollisionObject(btCollisionObject* collisionObject)
 
 
 
+void	btCollisionWorld::addCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects,const short int* collisionFilterGroups,const short int* collisionFilterMasks)
+{
+	if (numObjects<=0)
+		return;
+
+	btAlignedObjectArray<btVector3>	aabbMins;
+	btAlignedObjectArray<btVector3>	aabbMaxs;
+	btAlignedObjectArray<int>		shapeTypes;
+	btAlignedObjectArray<void*>		userPtrs;
+	btAlignedObjectArray<btBroadphaseProxy*>	proxies;
+	aabbMins.resize(numObjects);
+	aabbMaxs.resize(numObjects);
+	shapeTypes.resize(numObjects);
+	userPtrs.resize(numObjects);
+	proxies.resize(numObjects);
+
+	m_collisionObjects.reserve(m_collisionObjects.size()+numObjects);
+	int i;
+	for (i=0;i<numObjects;i++)
+	{
+		btCollisionObject* collisionObject = collisionObjects[i];
+		btAssert(collisionObject);
+		//an object that was already added has a broadphase handle
+		btAssert(!collisionObject->getBroadphaseHandle());
+
+		m_collisionObjects.push_back(collisionObject);
+		collisionObject->getCollisionShape()->getAabb(collisionObject->getWorldTransform(),aabbMins[i],aabbMaxs[i]);
+		shapeTypes[i] = collisionObject->getCollisionShape()->getShapeType();
+		userPtrs[i] = collisionObject;
+	}
+
+	getBroadphase()->createProxies(numObjects,&aabbMins[0],&aabbMaxs[0],&shapeTypes[0],&userPtrs[0],collisionFilterGroups,collisionFilterMasks,m_dispatcher1,&proxies[0]);
+
+	for (i=0;i<numObjects;i++)
+	{
+		collisionObjects[i]->setBroadphaseHandle(proxies[i]);
+	}
+}
+
+void	btCollisionWorld::removeCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects)
+{
+	if (numObjects<=0)
+		return;
+
+	btAlignedObjectArray<btCollisionObject*>	removedObjects;
+	btAlignedObjectArray<btBroadphaseProxy*>	proxies;
+	removedObjects.resize(numObjects);
+	proxies.reserve(numObjects);
+	int i;
+	for (i=0;i<numObjects;i++)
+	{
+		btCollisionObject* collisionObject = collisionObjects[i];
+		removedObjects[i] = collisionObject;
+		btBroadphaseProxy* bp = collisionObject->getBroadphaseHandle();
+		if (bp)
+		{
+			proxies.push_back(bp);
+			collisionObject->setBroadphaseHandle(0);
+		}
+	}
+
+	///destroying the proxies removes their pairs, which releases the cached algorithms. A pair cache with deferred removal
+	///keeps the pairs until the broadphase update, so their algorithms are cleaned first, like in removeCollisionObject.
+	if (proxies.size())
+	{
+		btOverlappingPairCache* pairCache = getBroadphase()->getOverlappingPairCache();
+		if (pairCache->hasDeferredRemoval())
+		{
+			for (i=0;i<proxies.size();i++)
+			{
+				pairCache->cleanProxyFromPairs(proxies[i],m_dispatcher1);
+			}
+		}
+		getBroadphase()->destroyProxies(&proxies[0],proxies.size(),m_dispatcher1);
+	}
+
+	removedObjects.quickSort(btAlignedObjectArray<btCollisionObject*>::less());
+	int numRemaining = 0;
+	for (i=0;i<m_collisionObjects.size();i++)
+	{
+		btCollisionObject* collisionObject = m_collisionObjects[i];
+		if (removedObjects.findBinarySearch(collisionObject) == removedObjects.size())
+		{
+			m_collisionObjects[numRemaining++] = collisionObject;
+		}
+	}
+	m_collisionObjects.resize(numRemaining);
+}
+
+
+
 void	btCollisionWorld::rayTestSingle(const btTransform& rayFromTrans,const btTransform& rayToTrans,
 										btCollisionObject* collisionObject,
 										const btCollisionShape* collisionShape,
@@ -1214,10 +1367,10 @@ public:
 };
 
 
-void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const btCollisionShape* shape, const btVector3& color)
+static void debugDrawShape(btIDebugDraw* debugDrawer, const btTransform& worldTransform, const btCollisionShape* shape, const btVector3& color)
 {
 	// Draw a small simplex at the center of the object
-	getDebugDrawer()->drawTransform(worldTransform,1);
+	debugDrawer->drawTransform(worldTransform,1);
 
 	if (shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
 	{
@@ -1226,7 +1379,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 		{
 			btTransform childTrans = compoundShape->getChildTransform(i);
 			const btCollisionShape* colShape = compoundShape->getChildShape(i);
-			debugDrawObject(worldTransform*childTrans,colShape,color);
+			debugDrawShape(debugDrawer,worldTransform*childTrans,colShape,color);
 		}
 
 	} else
@@ -1252,7 +1405,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 						{
 							int curVert = poly->m_faces[i].m_indices[v];
 							centroid+=poly->m_vertices[curVert];
-							getDebugDrawer()->drawLine(worldTransform*poly->m_vertices[lastV],worldTransform*poly->m_vertices[curVert],color);
+							debugDrawer->drawLine(worldTransform*poly->m_vertices[lastV],worldTransform*poly->m_vertices[curVert],color);
 							lastV = curVert;
 						}
 					}
@@ -1260,7 +1413,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 
 					btVector3 normalColor(1,1,0);
 					btVector3 faceNormal(poly->m_faces[i].m_plane[0],poly->m_faces[i].m_plane[1],poly->m_faces[i].m_plane[2]);
-					//getDebugDrawer()->drawLine(worldTransform*centroid,worldTransform*(centroid+faceNormal),normalColor);
+					//debugDrawer->drawLine(worldTransform*centroid,worldTransform*(centroid+faceNormal),normalColor);
 					
 					
 				}
@@ -1274,7 +1427,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					polyshape->getEdge(i,a,b);
 					btVector3 wa = worldTransform * a;
 					btVector3 wb = worldTransform * b;
-					getDebugDrawer()->drawLine(wa,wb,color);
+					debugDrawer->drawLine(wa,wb,color);
 				}
 			}
 
@@ -1289,7 +1442,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 				{
 					const btBoxShape* boxShape = static_cast<const btBoxShape*>(shape);
 					btVector3 halfExtents = boxShape->getHalfExtentsWithMargin();
-					getDebugDrawer()->drawBox(-halfExtents,halfExtents,worldTransform,color);
+					debugDrawer->drawBox(-halfExtents,halfExtents,worldTransform,color);
 					break;
 				}
 
@@ -1298,7 +1451,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					const btSphereShape* sphereShape = static_cast<const btSphereShape*>(shape);
 					btScalar radius = sphereShape->getMargin();//radius doesn't include the margin, so draw with margin
 
-					getDebugDrawer()->drawSphere(radius, worldTransform, color);
+					debugDrawer->drawSphere(radius, worldTransform, color);
 					break;
 				}
 			case MULTI_SPHERE_SHAPE_PROXYTYPE:
@@ -1311,7 +1464,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					for (int i = multiSphereShape->getSphereCount()-1; i>=0;i--)
 					{
 						childTransform.setOrigin(multiSphereShape->getSpherePosition(i));
-						getDebugDrawer()->drawSphere(multiSphereShape->getSphereRadius(i), worldTransform*childTransform, color);
+						debugDrawer->drawSphere(multiSphereShape->getSphereRadius(i), worldTransform*childTransform, color);
 					}
 
 					break;
@@ -1324,7 +1477,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					btScalar halfHeight = capsuleShape->getHalfHeight();
 
 					int upAxis = capsuleShape->getUpAxis();
-					getDebugDrawer()->drawCapsule(radius, halfHeight, upAxis, worldTransform, color);
+					debugDrawer->drawCapsule(radius, halfHeight, upAxis, worldTransform, color);
 					break;
 				}
 			case CONE_SHAPE_PROXYTYPE:
@@ -1334,7 +1487,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					btScalar height = coneShape->getHeight();//+coneShape->getMargin();
 
 					int upAxis= coneShape->getConeUpIndex();
-					getDebugDrawer()->drawCone(radius, height, upAxis, worldTransform, color);
+					debugDrawer->drawCone(radius, height, upAxis, worldTransform, color);
 					break;
 
 				}
@@ -1344,7 +1497,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					int upAxis = cylinder->getUpAxis();
 					btScalar radius = cylinder->getRadius();
 					btScalar halfHeight = cylinder->getHalfExtentsWithMargin()[upAxis];
-					getDebugDrawer()->drawCylinder(radius, halfHeight, upAxis, worldTransform, color);
+					debugDrawer->drawCylinder(radius, halfHeight, upAxis, worldTransform, color);
 					break;
 				}
 
@@ -1353,7 +1506,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 					const btStaticPlaneShape* staticPlaneShape = static_cast<const btStaticPlaneShape*>(shape);
 					btScalar planeConst = staticPlaneShape->getPlaneConstant();
 					const btVector3& planeNormal = staticPlaneShape->getPlaneNormal();
-					getDebugDrawer()->drawPlane(planeNormal, planeConst,worldTransform, color);
+					debugDrawer->drawPlane(planeNormal, planeConst,worldTransform, color);
 					break;
 
 				}
@@ -1368,7 +1521,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 						btVector3 aabbMax(btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT));
 						btVector3 aabbMin(btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT));
 
-						DebugDrawcallback drawCallback(getDebugDrawer(),worldTransform,color);
+						DebugDrawcallback drawCallback(debugDrawer,worldTransform,color);
 						concaveMesh->processAllTriangles(&drawCallback,aabbMin,aabbMax);
 
 					}
@@ -1380,7 +1533,7 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 						btVector3 aabbMax(btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT));
 						btVector3 aabbMin(btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT));
 						//DebugDrawcallback drawCallback;
-						DebugDrawcallback drawCallback(getDebugDrawer(),worldTransform,color);
+						DebugDrawcallback drawCallback(debugDrawer,worldTransform,color);
 						convexMesh->getMeshInterface()->InternalProcessAllTriangles(&drawCallback,aabbMin,aabbMax);
 					}
 
@@ -1392,6 +1545,244 @@ void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const
 	}
 }
 
+void btCollisionWorld::debugDrawObject(const btTransform& worldTransform, const btCollisionShape* shape, const btVector3& color)
+{
+	if (shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
+	{
+		// Draw a small simplex at the center of the object
+		getDebugDrawer()->drawTransform(worldTransform,1);
+
+		const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shape);
+		for (int i=compoundShape->getNumChildShapes()-1;i>=0;i--)
+		{
+			btTransform childTrans = compoundShape->getChildTransform(i);
+			const btCollisionShape* colShape = compoundShape->getChildShape(i);
+			debugDrawObject(worldTransform*childTrans,colShape,color);
+		}
+	} else
+	{
+		debugDrawShape(getDebugDrawer(),worldTransform,shape,color);
+	}
+}
+
+
+static btVector3 getDebugDrawColor(const btCollisionObject* colObj)
+{
+	btVector3 color(btScalar(1.),btScalar(1.),btScalar(1.));
+	switch(colObj->getActivationState())
+	{
+	case  ACTIVE_TAG:
+		color = btVector3(btScalar(1.),btScalar(1.),btScalar(1.)); break;
+	case ISLAND_SLEEPING:
+		color =  btVector3(btScalar(0.),btScalar(1.),btScalar(0.));break;
+	case WANTS_DEACTIVATION:
+		color = btVector3(btScalar(0.),btScalar(1.),btScalar(1.));break;
+	case DISABLE_DEACTIVATION:
+		color = btVector3(btScalar(1.),btScalar(0.),btScalar(0.));break;
+	case DISABLE_SIMULATION:
+		color = btVector3(btScalar(1.),btScalar(1.),btScalar(0.));break;
+	default:
+		{
+			color = btVector3(btScalar(1),btScalar(0.),btScalar(0.));
+		}
+	};
+	return color;
+}
+
+static void debugDrawObjectAabb(btIDebugDraw* debugDrawer, const btCollisionObject* colObj)
+{
+	btVector3 minAabb,maxAabb;
+	btVector3 colorvec(1,0,0);
+	colObj->getCollisionShape()->getAabb(colObj->getWorldTransform(), minAabb,maxAabb);
+	btVector3 contactThreshold(gContactBreakingThreshold,gContactBreakingThreshold,gContactBreakingThreshold);
+	minAabb -= contactThreshold;
+	maxAabb += contactThreshold;
+
+	btVector3 minAabb2,maxAabb2;
+
+	if(colObj->getInternalType()==btCollisionObject::CO_RIGID_BODY)
+	{
+		colObj->getCollisionShape()->getAabb(colObj->getInterpolationWorldTransform(),minAabb2,maxAabb2);
+		minAabb2 -= contactThreshold;
+		maxAabb2 += contactThreshold;
+		minAabb.setMin(minAabb2);
+		maxAabb.setMax(maxAabb2);
+	}
+
+	debugDrawer->drawAabb(minAabb,maxAabb,colorvec);
+}
+
+///debugDrawShape only reads the shape for these shape types, so they can be drawn from several threads at once.
+///Other shapes, such as GImpact meshes that lock their child shapes while processing triangles, are drawn on the calling thread.
+static bool isDebugDrawConcurrent(const btCollisionShape* shape)
+{
+	if (shape->isConvex())
+		return true;
+	switch (shape->getShapeType())
+	{
+	case COMPOUND_SHAPE_PROXYTYPE:
+		{
+			const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shape);
+			for (int i=0;i<compoundShape->getNumChildShapes();i++)
+			{
+				if (!isDebugDrawConcurrent(compoundShape->getChildShape(i)))
+					return false;
+			}
+			return true;
+		}
+	case TRIANGLE_MESH_SHAPE_PROXYTYPE:
+	case SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE:
+	case MULTIMATERIAL_TRIANGLE_MESH_PROXYTYPE:
+	case TERRAIN_SHAPE_PROXYTYPE:
+	case STATIC_PLANE_PROXYTYPE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void debugDrawCollisionObject(btIDebugDraw* debugDrawer, const btCollisionObject* colObj, int debugMode)
+{
+	if (debugMode & btIDebugDraw::DBG_DrawWireframe)
+	{
+		debugDrawShape(debugDrawer,colObj->getWorldTransform(),colObj->getCollisionShape(),getDebugDrawColor(colObj));
+	}
+	if (debugMode & btIDebugDraw::DBG_DrawAabb)
+	{
+		debugDrawObjectAabb(debugDrawer,colObj);
+	}
+}
+
+///number of collision objects drawn by a single task. The tasks don't depend on the amount of threads, so the line order is reproducible.
+#define BT_DEBUG_DRAW_OBJECTS_PER_TASK 32
+
+struct btDebugDrawObjectsLoop : public btIParallelForBody
+{
+	btCollisionObject* const*	m_objects;
+	int		m_numObjects;
+	int		m_debugMode;
+	btDebugDrawBuffer*	m_drawBuffer;
+
+	btDebugDrawObjectsLoop(btCollisionObject* const* objects,int numObjects,int debugMode,btDebugDrawBuffer* drawBuffer)
+		:m_objects(objects),
+		m_numObjects(numObjects),
+		m_debugMode(debugMode),
+		m_drawBuffer(drawBuffer)
+	{
+	}
+
+	virtual void	forLoop(int iBegin, int iEnd) const
+	{
+		for (int task=iBegin;task<iEnd;task++)
+		{
+			btDebugDrawLineArray* lines = m_drawBuffer->getTaskLines(task);
+			int begin = task*BT_DEBUG_DRAW_OBJECTS_PER_TASK;
+			int end = btMin(begin+BT_DEBUG_DRAW_OBJECTS_PER_TASK,m_numObjects);
+			for (int i=begin;i<end;i++)
+			{
+				debugDrawCollisionObject(lines,m_objects[i],m_debugMode);
+			}
+		}
+	}
+};
+
+static unsigned int hashDebugDrawBytes(unsigned int hash, const void* data, int numBytes)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (int i=0;i<numBytes;i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+///hashes x, y and z only, the unused fourth component may hold anything
+static unsigned int hashDebugDrawVector(unsigned int hash, const btVector3& v)
+{
+	return hashDebugDrawBytes(hash,&v[0],3*sizeof(btScalar));
+}
+
+static unsigned int hashDebugDrawTransform(unsigned int hash, const btTransform& t)
+{
+	hash = hashDebugDrawVector(hash,t.getBasis()[0]);
+	hash = hashDebugDrawVector(hash,t.getBasis()[1]);
+	hash = hashDebugDrawVector(hash,t.getBasis()[2]);
+	return hashDebugDrawVector(hash,t.getOrigin());
+}
+
+void	btCollisionWorld::debugDrawObjectsToBuffer(btDebugDrawBuffer* drawBuffer, bool staticObjects, btDebugDrawLineArray& target)
+{
+	int debugMode = drawBuffer->getDebugMode();
+	int i;
+
+	//objects that can be drawn concurrently first, followed by the others
+	m_debugDrawObjects.resize(0);
+	for (int pass=0;pass<2;pass++)
+	{
+		for (i=0;i<m_collisionObjects.size();i++)
+		{
+			btCollisionObject* colObj = m_collisionObjects[i];
+			if ((colObj->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT)==0 &&
+				colObj->isStaticObject() == staticObjects &&
+				isDebugDrawConcurrent(colObj->getCollisionShape()) == (pass==0))
+			{
+				m_debugDrawObjects.push_back(colObj);
+			}
+		}
+		if (pass==0)
+		{
+			int numConcurrent = m_debugDrawObjects.size();
+			int numTasks = (numConcurrent+BT_DEBUG_DRAW_OBJECTS_PER_TASK-1)/BT_DEBUG_DRAW_OBJECTS_PER_TASK;
+			if (numTasks)
+			{
+				drawBuffer->prepareTaskLines(numTasks);
+				btDebugDrawObjectsLoop drawLoop(&m_debugDrawObjects[0],numConcurrent,debugMode,drawBuffer);
+				btParallelFor(0,numTasks,1,drawLoop);
+				drawBuffer->gatherTaskLines(numTasks,target);
+			}
+			m_debugDrawObjects.resize(0);
+		}
+	}
+	target.setDebugMode(debugMode);
+	for (i=0;i<m_debugDrawObjects.size();i++)
+	{
+		debugDrawCollisionObject(&target,m_debugDrawObjects[i],debugMode);
+	}
+}
+
+void	btCollisionWorld::debugDrawToBuffer(btDebugDrawBuffer* drawBuffer)
+{
+	BT_PROFILE("debugDrawToBuffer");
+
+	//the static lines only depend on these objects and modes, and the contact breaking threshold for the AABBs
+	int staticMode = drawBuffer->getDebugMode() & (btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb);
+	unsigned int key = 2166136261u;
+	key = hashDebugDrawBytes(key,&staticMode,sizeof(int));
+	key = hashDebugDrawBytes(key,&gContactBreakingThreshold,sizeof(btScalar));
+	for (int i=0;i<m_collisionObjects.size();i++)
+	{
+		const btCollisionObject* colObj = m_collisionObjects[i];
+		if ((colObj->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT)==0 && colObj->isStaticObject())
+		{
+			const btCollisionShape* shape = colObj->getCollisionShape();
+			int activationState = colObj->getActivationState();
+			key = hashDebugDrawBytes(key,&colObj,sizeof(colObj));
+			key = hashDebugDrawBytes(key,&shape,sizeof(shape));
+			key = hashDebugDrawBytes(key,&activationState,sizeof(int));
+			key = hashDebugDrawVector(key,shape->getLocalScaling());
+			key = hashDebugDrawTransform(key,colObj->getWorldTransform());
+			key = hashDebugDrawTransform(key,colObj->getInterpolationWorldTransform());
+		}
+	}
+	if (!drawBuffer->isStaticLinesValid(key))
+	{
+		drawBuffer->getStaticLines().clear();
+		debugDrawObjectsToBuffer(drawBuffer,true,drawBuffer->getStaticLines());
+		drawBuffer->setStaticLinesKey(key);
+	}
+
+	debugDrawObjectsToBuffer(drawBuffer,false,*drawBuffer);
+}
 
 void	btCollisionWorld::debugDrawWorld()
 {
@@ -1416,6 +1807,13 @@ void	btCollisionWorld::debugDrawWorld()
 
 	if (getDebugDrawer() && getDebugDrawer()->getDebugMode() & (btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb))
 	{
+		btDebugDrawBuffer* drawBuffer = getDebugDrawer()->getDebugDrawBuffer();
+		if (drawBuffer)
+		{
+			debugDrawToBuffer(drawBuffer);
+			return;
+		}
+
 		int i;
 
 		for (  i=0;i<m_collisionObjects.size();i++)
@@ -1425,48 +1823,11 @@ void	btCollisionWorld::debugDrawWorld()
 			{
 				if (getDebugDrawer() && getDebugDrawer()->getDebugMode() & btIDebugDraw::DBG_DrawWireframe)
 				{
-					btVector3 color(btScalar(1.),btScalar(1.),btScalar(1.));
-					switch(colObj->getActivationState())
-					{
-					case  ACTIVE_TAG:
-						color = btVector3(btScalar(1.),btScalar(1.),btScalar(1.)); break;
-					case ISLAND_SLEEPING:
-						color =  btVector3(btScalar(0.),btScalar(1.),btScalar(0.));break;
-					case WANTS_DEACTIVATION:
-						color = btVector3(btScalar(0.),btScalar(1.),btScalar(1.));break;
-					case DISABLE_DEACTIVATION:
-						color = btVector3(btScalar(1.),btScalar(0.),btScalar(0.));break;
-					case DISABLE_SIMULATION:
-						color = btVector3(btScalar(1.),btScalar(1.),btScalar(0.));break;
-					default:
-						{
-							color = btVector3(btScalar(1),btScalar(0.),btScalar(0.));
-						}
-					};
-
-					debugDrawObject(colObj->getWorldTransform(),colObj->getCollisionShape(),color);
+					debugDrawObject(colObj->getWorldTransform(),colObj->getCollisionShape(),getDebugDrawColor(colObj));
 				}
 				if (m_debugDrawer && (m_debugDrawer->getDebugMode() & btIDebugDraw::DBG_DrawAabb))
 				{
-					btVector3 minAabb,maxAabb;
-					btVector3 colorvec(1,0,0);
-					colObj->getCollisionShape()->getAabb(colObj->getWorldTransform(), minAabb,maxAabb);
-					btVector3 contactThreshold(gContactBreakingThreshold,gContactBreakingThreshold,gContactBreakingThreshold);
-					minAabb -= contactThreshold;
-					maxAabb += contactThreshold;
-
-					btVector3 minAabb2,maxAabb2;
-
-					if(colObj->getInternalType()==btCollisionObject::CO_RIGID_BODY)
-					{
-						colObj->getCollisionShape()->getAabb(colObj->getInterpolationWorldTransform(),minAabb2,maxAabb2);
-						minAabb2 -= contactThreshold;
-						maxAabb2 += contactThreshold;
-						minAabb.setMin(minAabb2);
-						maxAabb.setMax(maxAabb2);
-					}
-
-					m_debugDrawer->drawAabb(minAabb,maxAabb,colorvec);
+					debugDrawObjectAabb(m_debugDrawer,colObj);
 				}
 			}
 
@@ -70,6 +70,8 @@ class btCollisionShape;
 class btConvexShape;
 class btBroadphaseInterface;
 class btSerializer;
+class btDebugDrawBuffer;
+class btDebugDrawLineArray;
 
 #include "LinearMath/btVector3.h"
 #include "LinearMath/btTransform.h"
@@ -101,8 +103,20 @@ protected:
 	///it is true by default, because it is error-prone (setting the position of static objects wouldn't update their AABB)
 	bool m_forceUpdateAllAabbs;
 
+	///sum of the shifts passed to shiftOrigin
+	btVector3	m_worldOrigin;
+
+	///scratch list of the collision objects drawn by debugDrawToBuffer
+	btAlignedObjectArray<btCollisionObject*>	m_debugDrawObjects;
+
 	void	serializeCollisionObjects(btSerializer* serializer);
 
+	void	debugDrawObjectsToBuffer(btDebugDrawBuffer* drawBuffer, bool staticObjects, btDebugDrawLineArray& target);
+
+	///draws the collision objects in parallel into a btDebugDrawBuffer. The lines of static objects are cached in the buffer until
+	///a static object is added, removed, moved or rescaled. Note that this doesn't call debugDrawObject.
+	void	debugDrawToBuffer(btDebugDrawBuffer* drawBuffer);
+
 public:
 
 	//this constructor doesn't own the dispatcher and paircache/broadphase
@@ -479,6 +493,14 @@ public:
 
 	virtual void	removeCollisionObject(btCollisionObject* collisionObject);
 
+	///adds numObjects collision objects with a single btBroadphaseInterface::createProxies call, for spawning many objects at once.
+	///The filter groups and masks hold one entry per object.
+	void	addCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects,const short int* collisionFilterGroups,const short int* collisionFilterMasks);
+
+	///removes numObjects collision objects with a single btBroadphaseInterface::destroyProxies call and one pass over the collision object array.
+	///The remaining objects keep their order.
+	virtual void	removeCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects);
+
 	virtual void	performDiscreteCollisionDetection();
 
 	btDispatcherInfo& getDispatchInfo()
@@ -500,6 +522,20 @@ public:
 		m_forceUpdateAllAabbs = forceUpdateAllAabbs;
 	}
 
+	///shiftOrigin moves all collision objects and contacts by -shift, so a large world can be simulated around a floating origin
+	///with the precision of coordinates near zero. Object positions in the large world are getWorldOrigin() plus their world transform.
+	///The application has to move its own world space data, such as kinematic targets, by the same amount.
+	virtual void	shiftOrigin(const btVector3& shift);
+
+	///shifts the origin by whole cells, when focusPosition (for example the camera or the player) is more than half a cell away from it.
+	///With a power of two cellSize the accumulated world origin stays exact in single precision. Returns true if the origin moved.
+	bool	rebaseOrigin(const btVector3& focusPosition, btScalar cellSize);
+
+	const btVector3&	getWorldOrigin() const
+	{
+		return m_worldOrigin;
+	}
+
 	///Preliminary serialization test for Bullet 2.76. Loading those files requires a separate parser (Bullet/Demos/SerializeDemo)
 	virtual	void	serialize(btSerializer* serializer);
 
@@ -87,6 +87,14 @@ btCompoundCollisionAlgorithm::~btCompoundCollisionAlgorithm()
 
 
 
+///the key of child index of a compound nested in the child with parentKey, the index itself at the top level
+static SIMD_FORCE_INLINE int	btCompoundChildKey(int parentKey,int index)
+{
+	if (parentKey < 0)
+		return index;
+	return int(((unsigned int)(parentKey+1)*2654435761u ^ (unsigned int)index) & 0x7fffffff);
+}
+
 struct	btCompoundLeafCallback : btDbvt::ICollide
 {
 
@@ -99,14 +107,16 @@ public:
 	btManifoldResult*	m_resultOut;
 	btCollisionAlgorithm**	m_childCollisionAlgorithms;
 	btPersistentManifold*	m_sharedManifold;
+	btManifoldArray&		m_childManifolds;
 
 
 
 
-	btCompoundLeafCallback (btCollisionObject* compoundObj,btCollisionObject* otherObj,btDispatcher* dispatcher,const btDispatcherInfo& dispatchInfo,btManifoldResult*	resultOut,btCollisionAlgorithm**	childCollisionAlgorithms,btPersistentManifold*	sharedManifold)
+	btCompoundLeafCallback (btCollisionObject* compoundObj,btCollisionObject* otherObj,btDispatcher* dispatcher,const btDispatcherInfo& dispatchInfo,btManifoldResult*	resultOut,btCollisionAlgorithm**	childCollisionAlgorithms,btPersistentManifold*	sharedManifold,btManifoldArray& childManifolds)
 		:m_compoundColObj(compoundObj),m_otherObj(otherObj),m_dispatcher(dispatcher),m_dispatchInfo(dispatchInfo),m_resultOut(resultOut),
 		m_childCollisionAlgorithms(childCollisionAlgorithms),
-		m_sharedManifold(sharedManifold)
+		m_sharedManifold(sharedManifold),
+		m_childManifolds(childManifolds)
 	{
 
 	}
@@ -144,15 +154,38 @@ public:
 				m_childCollisionAlgorithms[index] = m_dispatcher->findAlgorithm(m_compoundColObj,m_otherObj,m_sharedManifold);
 
 			///detect swapping case
-			if (m_resultOut->getBody0Internal() == m_compoundColObj)
+			bool isBody0 = (m_resultOut->getBody0Internal() == m_compoundColObj);
+			if (isBody0)
 			{
 				m_resultOut->setShapeIdentifiersA(-1,index);
 			} else
 			{
 				m_resultOut->setShapeIdentifiersB(-1,index);
 			}
+			int& childKey = isBody0 ? m_resultOut->m_childKey0 : m_resultOut->m_childKey1;
+			int parentKey = childKey;
+			childKey = btCompoundChildKey(parentKey,index);
 
 			m_childCollisionAlgorithms[index]->processCollision(m_compoundColObj,m_otherObj,m_dispatchInfo,m_resultOut);
+
+			//tag the manifolds of a leaf child with its key, a nested compound child tags them with its own longer key
+			if (!childShape->isCompound())
+			{
+				m_childManifolds.resize(0);
+				m_childCollisionAlgorithms[index]->getAllContactManifolds(m_childManifolds);
+				for (int m=0;m<m_childManifolds.size();m++)
+				{
+					btPersistentManifold* manifold = m_childManifolds[m];
+					if (manifold->getBody0() == m_compoundColObj)
+					{
+						manifold->m_childIndex0 = childKey;
+					} else
+					{
+						manifold->m_childIndex1 = childKey;
+					}
+				}
+			}
+			childKey = parentKey;
 			if (m_dispatchInfo.m_debugDraw && (m_dispatchInfo.m_debugDraw->getDebugMode() & btIDebugDraw::DBG_DrawAabb))
 			{
 				btVector3 worldAabbMin,worldAabbMax;
@@ -212,7 +245,7 @@ void btCompoundCollisionAlgorithm::processCollision (btCollisionObject* body0,bt
 
 	btDbvt* tree = compoundShape->getDynamicAabbTree();
 	//use a dynamic aabb tree to cull potential child-overlaps
-	btCompoundLeafCallback  callback(colObj,otherObj,m_dispatcher,dispatchInfo,resultOut,&m_childCollisionAlgorithms[0],m_sharedManifold);
+	btCompoundLeafCallback  callback(colObj,otherObj,m_dispatcher,dispatchInfo,resultOut,&m_childCollisionAlgorithms[0],m_sharedManifold,m_childManifolds);
 
 	///we need to refresh all contact manifolds
 	///note that we should actually recursively traverse all children, btCompoundShape can nested more then 1 level deep
@@ -239,7 +272,7 @@ void btCompoundCollisionAlgorithm::processCollision (btCollisionObject* body0,bt
 		}
 	}
 
-	if (tree)
+	if (tree && !dispatchInfo.m_processAllCompoundChildren)
 	{
 
 		btVector3 localAabbMin,localAabbMax;
@@ -38,6 +38,8 @@ class btCompoundCollisionAlgorithm  : public btActivatingCollisionAlgorithm
 	bool					m_ownsManifold;
 
 	int	m_compoundShapeRevision;//to keep track of changes, so that childAlgorithm array can be updated
+
+	btManifoldArray	m_childManifolds;//scratch array used to tag the child manifolds with their child index
 	
 	void	removeChildAlgorithms();
 	
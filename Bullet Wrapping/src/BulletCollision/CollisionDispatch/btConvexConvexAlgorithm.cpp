@@ -185,13 +185,14 @@ btConvexConvexAlgorithm::CreateFunc::CreateFunc(btSimplexSolverInterface*			simp
 	m_minimumPointsPerturbationThreshold = 3;
 	m_simplexSolver = simplexSolver;
 	m_pdSolver = pdSolver;
+	m_closestPointsKernel = &btGjkPairDetector::getClosestPointsNonVirtual;
 }
 
 btConvexConvexAlgorithm::CreateFunc::~CreateFunc() 
 { 
 }
 
-btConvexConvexAlgorithm::btConvexConvexAlgorithm(btPersistentManifold* mf,const btCollisionAlgorithmConstructionInfo& ci,btCollisionObject* body0,btCollisionObject* body1,btSimplexSolverInterface* simplexSolver, btConvexPenetrationDepthSolver* pdSolver,int numPerturbationIterations, int minimumPointsPerturbationThreshold)
+btConvexConvexAlgorithm::btConvexConvexAlgorithm(btPersistentManifold* mf,const btCollisionAlgorithmConstructionInfo& ci,btCollisionObject* body0,btCollisionObject* body1,btSimplexSolverInterface* simplexSolver, btConvexPenetrationDepthSolver* pdSolver,int numPerturbationIterations, int minimumPointsPerturbationThreshold,btGjkClosestPointsKernel closestPointsKernel)
 : btActivatingCollisionAlgorithm(ci,body0,body1),
 m_simplexSolver(simplexSolver),
 m_pdSolver(pdSolver),
@@ -203,7 +204,8 @@ m_sepDistance((static_cast<btConvexShape*>(body0->getCollisionShape()))->getAngu
 			  (static_cast<btConvexShape*>(body1->getCollisionShape()))->getAngularMotionDisc()),
 #endif
 m_numPerturbationIterations(numPerturbationIterations),
-m_minimumPointsPerturbationThreshold(minimumPointsPerturbationThreshold)
+m_minimumPointsPerturbationThreshold(minimumPointsPerturbationThreshold),
+m_closestPointsKernel(closestPointsKernel)
 {
 	(void)body0;
 	(void)body1;
@@ -350,7 +352,10 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 	
 	btGjkPairDetector::ClosestPointInput input;
 
-	btGjkPairDetector	gjkPairDetector(min0,min1,m_simplexSolver,m_pdSolver);
+	//the simplex solver of the configuration is shared by all pairs, a local copy allows processing pairs concurrently
+	btVoronoiSimplexSolver	simplexSolver;
+	simplexSolver.setEqualVertexThreshold(m_simplexSolver->getEqualVertexThreshold());
+	btGjkPairDetector	gjkPairDetector(min0,min1,&simplexSolver,m_pdSolver);
 	//TODO: if (dispatchInfo.m_useContinuous)
 	gjkPairDetector.setMinkowskiA(min0);
 	gjkPairDetector.setMinkowskiB(min1);
@@ -377,6 +382,31 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 	input.m_transformA = body0->getWorldTransform();
 	input.m_transformB = body1->getWorldTransform();
 
+	if (dispatchInfo.m_deterministicOrder)
+	{
+		m_gjkWarmStart.reset();
+	} else
+	{
+		//the cached axis points from B to A. If the supporting vertices (including margin) along it are still further
+		//apart than the maximum distance, GJK can't report a point, so skip it. Perturbed queries could still find one.
+		if (!m_numPerturbationIterations && m_gjkWarmStart.m_valid)
+		{
+			btVector3 axis = input.m_transformA.getBasis() * m_gjkWarmStart.m_separatingAxisInA;
+			btVector3 pWorld = input.m_transformA(min0->localGetSupportVertexNonVirtual((-axis) * input.m_transformA.getBasis()));
+			btVector3 qWorld = input.m_transformB(min1->localGetSupportVertexNonVirtual(axis * input.m_transformB.getBasis()));
+			btScalar separation = axis.dot(pWorld - qWorld);
+			if (separation > btScalar(0.) && separation * separation > input.m_maximumDistanceSquared)
+			{
+				if (m_ownManifold)
+				{
+					resultOut->refreshContactPoints();
+				}
+				return;
+			}
+		}
+		gjkPairDetector.setWarmStart(&m_gjkWarmStart);
+	}
+
 
 
 	
@@ -436,10 +466,10 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 			{
 #ifdef ZERO_MARGIN
 				gjkPairDetector.setIgnoreMargin(true);
-				gjkPairDetector.getClosestPoints(input,*resultOut,dispatchInfo.m_debugDraw);
+				(gjkPairDetector.*m_closestPointsKernel)(input,*resultOut,dispatchInfo.m_debugDraw);
 #else
 				//gjkPairDetector.getClosestPoints(input,*resultOut,dispatchInfo.m_debugDraw);
-				gjkPairDetector.getClosestPoints(input,dummy,dispatchInfo.m_debugDraw);
+				(gjkPairDetector.*m_closestPointsKernel)(input,dummy,dispatchInfo.m_debugDraw);
 #endif //ZERO_MARGIN
 				sepNormalWorldSpace = gjkPairDetector.getCachedSeparatingAxis().normalized();
 				//minDist = -1e30f;//gjkPairDetector.getCachedSeparatingDistance();
@@ -501,9 +531,9 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 				{
 #ifdef ZERO_MARGIN
 					gjkPairDetector.setIgnoreMargin(true);
-					gjkPairDetector.getClosestPoints(input,*resultOut,dispatchInfo.m_debugDraw);
+					(gjkPairDetector.*m_closestPointsKernel)(input,*resultOut,dispatchInfo.m_debugDraw);
 #else
-					gjkPairDetector.getClosestPoints(input,dummy,dispatchInfo.m_debugDraw);
+					(gjkPairDetector.*m_closestPointsKernel)(input,dummy,dispatchInfo.m_debugDraw);
 #endif//ZERO_MARGIN
 					
 					sepNormalWorldSpace = gjkPairDetector.getCachedSeparatingAxis().normalized();
@@ -533,7 +563,9 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 
 	}
 	
-	gjkPairDetector.getClosestPoints(input,*resultOut,dispatchInfo.m_debugDraw);
+	(gjkPairDetector.*m_closestPointsKernel)(input,*resultOut,dispatchInfo.m_debugDraw);
+	//perturbed queries don't update the cache
+	gjkPairDetector.setWarmStart(0);
 
 	//now perform 'm_numPerturbationIterations' collision queries with the perturbated collision objects
 	
@@ -601,7 +633,7 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 			}
 			
 			btPerturbedContactResult perturbedResultOut(resultOut,input.m_transformA,input.m_transformB,unPerturbedTransform,perturbeA,dispatchInfo.m_debugDraw);
-			gjkPairDetector.getClosestPoints(input,perturbedResultOut,dispatchInfo.m_debugDraw);
+			(gjkPairDetector.*m_closestPointsKernel)(input,perturbedResultOut,dispatchInfo.m_debugDraw);
 			}
 			
 		}
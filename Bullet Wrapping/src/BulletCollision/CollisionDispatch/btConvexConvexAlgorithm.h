@@ -37,6 +37,9 @@ class btConvexPenetrationDepthSolver;
 ///The convexConvexAlgorithm collision algorithm implements time of impact, convex closest points and penetration depth calculations between two convex objects.
 ///Multiple contact points are calculated by perturbing the orientation of the smallest object orthogonal to the separating normal.
 ///This idea was described by Gino van den Bergen in this forum topic http://www.bulletphysics.com/Bullet/phpBB3/viewtopic.php?f=4&t=288&p=888#p888
+///The separating axis of the last GJK query is kept per pair. GJK restarts from it, and when the cached axis
+///still separates the objects by more than the contact distance, GJK is skipped. This is disabled in deterministic mode,
+///because the cache is not part of a snapshot of the world.
 class btConvexConvexAlgorithm : public btActivatingCollisionAlgorithm
 {
 #ifdef USE_SEPDISTANCE_UTIL2
@@ -53,13 +56,15 @@ class btConvexConvexAlgorithm : public btActivatingCollisionAlgorithm
 	int m_numPerturbationIterations;
 	int m_minimumPointsPerturbationThreshold;
 
+	///GJK query used for this pair, a kernel specialized for the shape types or getClosestPointsNonVirtual
+	btGjkClosestPointsKernel	m_closestPointsKernel;
 
 	///cache separating vector to speedup collision detection
-	
+	btGjkWarmStart	m_gjkWarmStart;
 
 public:
 
-	btConvexConvexAlgorithm(btPersistentManifold* mf,const btCollisionAlgorithmConstructionInfo& ci,btCollisionObject* body0,btCollisionObject* body1, btSimplexSolverInterface* simplexSolver, btConvexPenetrationDepthSolver* pdSolver, int numPerturbationIterations, int minimumPointsPerturbationThreshold);
+	btConvexConvexAlgorithm(btPersistentManifold* mf,const btCollisionAlgorithmConstructionInfo& ci,btCollisionObject* body0,btCollisionObject* body1, btSimplexSolverInterface* simplexSolver, btConvexPenetrationDepthSolver* pdSolver, int numPerturbationIterations, int minimumPointsPerturbationThreshold,btGjkClosestPointsKernel closestPointsKernel=&btGjkPairDetector::getClosestPointsNonVirtual);
 
 
 	virtual ~btConvexConvexAlgorithm();
@@ -91,6 +96,8 @@ public:
 		btSimplexSolverInterface*			m_simplexSolver;
 		int m_numPerturbationIterations;
 		int m_minimumPointsPerturbationThreshold;
+		///see btGjkPairDetectorKernel.h, the create function has to be registered for shape types that match the kernel
+		btGjkClosestPointsKernel			m_closestPointsKernel;
 
 		CreateFunc(btSimplexSolverInterface*			simplexSolver, btConvexPenetrationDepthSolver* pdSolver);
 		
@@ -99,7 +106,7 @@ public:
 		virtual	btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, btCollisionObject* body0,btCollisionObject* body1)
 		{
 			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btConvexConvexAlgorithm));
-			return new(mem) btConvexConvexAlgorithm(ci.m_manifold,ci,body0,body1,m_simplexSolver,m_pdSolver,m_numPerturbationIterations,m_minimumPointsPerturbationThreshold);
+			return new(mem) btConvexConvexAlgorithm(ci.m_manifold,ci,body0,body1,m_simplexSolver,m_pdSolver,m_numPerturbationIterations,m_minimumPointsPerturbationThreshold,m_closestPointsKernel);
 		}
 	};
 
@@ -63,6 +63,7 @@ public:
 			: m_numPerturbationIterations(1),
 			m_minimumPointsPerturbationThreshold(1)
 		{
+			m_concurrentProcessing = true;
 		}
 		
 		virtual	btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, btCollisionObject* body0,btCollisionObject* body1)
@@ -26,9 +26,11 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btSphereBoxCollisionAlgorithm.h"
 #endif //USE_BUGGY_SPHERE_BOX_ALGORITHM
 #include "BulletCollision/CollisionDispatch/btSphereTriangleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCapsuleTriangleCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h"
 #include "BulletCollision/NarrowPhaseCollision/btMinkowskiPenetrationDepthSolver.h"
 #include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkPairDetectorKernel.h"
 
 
 
@@ -59,6 +61,8 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	//default CreationFunctions, filling the m_doubleDispatch table
 	mem = btAlignedAlloc(sizeof(btConvexConvexAlgorithm::CreateFunc),16);
 	m_convexConvexCreateFunc = new(mem) btConvexConvexAlgorithm::CreateFunc(m_simplexSolver,m_pdSolver);
+	///btMinkowskiPenetrationDepthSolver adds the preferred penetration directions of the shapes to a static array
+	m_convexConvexCreateFunc->m_concurrentProcessing = constructionInfo.m_useEpaPenetrationAlgorithm;
 	mem = btAlignedAlloc(sizeof(btConvexConcaveCollisionAlgorithm::CreateFunc),16);
 	m_convexConcaveCreateFunc = new (mem)btConvexConcaveCollisionAlgorithm::CreateFunc;
 	mem = btAlignedAlloc(sizeof(btConvexConcaveCollisionAlgorithm::CreateFunc),16);
@@ -85,6 +89,12 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	mem = btAlignedAlloc(sizeof(btSphereTriangleCollisionAlgorithm::CreateFunc),16);
 	m_triangleSphereCF = new (mem)btSphereTriangleCollisionAlgorithm::CreateFunc;
 	m_triangleSphereCF->m_swapped = true;
+
+	mem = btAlignedAlloc(sizeof(btCapsuleTriangleCollisionAlgorithm::CreateFunc),16);
+	m_capsuleTriangleCF = new (mem)btCapsuleTriangleCollisionAlgorithm::CreateFunc;
+	mem = btAlignedAlloc(sizeof(btCapsuleTriangleCollisionAlgorithm::CreateFunc),16);
+	m_triangleCapsuleCF = new (mem)btCapsuleTriangleCollisionAlgorithm::CreateFunc;
+	m_triangleCapsuleCF->m_swapped = true;
 	
 	mem = btAlignedAlloc(sizeof(btBoxBoxCollisionAlgorithm::CreateFunc),16);
 	m_boxBoxCF = new(mem)btBoxBoxCollisionAlgorithm::CreateFunc;
@@ -96,6 +106,42 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	m_planeConvexCF = new (mem) btConvexPlaneCollisionAlgorithm::CreateFunc;
 	m_planeConvexCF->m_swapped = true;
 	
+	m_numConvexKernels = 0;
+	if (constructionInfo.m_useConvexKernels)
+	{
+		struct	btConvexKernel
+		{
+			int	m_proxyType0;
+			int	m_proxyType1;
+			btGjkClosestPointsKernel	m_kernel;
+		};
+		///capsule-capsule isn't listed, btConvexConvexAlgorithm handles it without GJK
+		const btConvexKernel kernels[MAX_CONVEX_KERNELS] =
+		{
+			{CAPSULE_SHAPE_PROXYTYPE,BOX_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btCapsuleShapeSupport,btBoxShapeSupport>},
+			{BOX_SHAPE_PROXYTYPE,CAPSULE_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btBoxShapeSupport,btCapsuleShapeSupport>},
+			{CAPSULE_SHAPE_PROXYTYPE,CONVEX_HULL_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btCapsuleShapeSupport,btConvexHullShapeSupport>},
+			{CONVEX_HULL_SHAPE_PROXYTYPE,CAPSULE_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btConvexHullShapeSupport,btCapsuleShapeSupport>},
+			{SPHERE_SHAPE_PROXYTYPE,CONVEX_HULL_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btSphereShapeSupport,btConvexHullShapeSupport>},
+			{CONVEX_HULL_SHAPE_PROXYTYPE,SPHERE_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btConvexHullShapeSupport,btSphereShapeSupport>},
+			{BOX_SHAPE_PROXYTYPE,CONVEX_HULL_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btBoxShapeSupport,btConvexHullShapeSupport>},
+			{CONVEX_HULL_SHAPE_PROXYTYPE,BOX_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btConvexHullShapeSupport,btBoxShapeSupport>},
+			{CYLINDER_SHAPE_PROXYTYPE,BOX_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btCylinderShapeSupport,btBoxShapeSupport>},
+			{BOX_SHAPE_PROXYTYPE,CYLINDER_SHAPE_PROXYTYPE,&btGjkPairDetector::getClosestPointsKernel<btBoxShapeSupport,btCylinderShapeSupport>}
+		};
+		for (int i=0;i<MAX_CONVEX_KERNELS;i++)
+		{
+			mem = btAlignedAlloc(sizeof(btConvexConvexAlgorithm::CreateFunc),16);
+			btConvexConvexAlgorithm::CreateFunc* createFunc = new(mem) btConvexConvexAlgorithm::CreateFunc(m_simplexSolver,m_pdSolver);
+			createFunc->m_closestPointsKernel = kernels[i].m_kernel;
+			createFunc->m_concurrentProcessing = constructionInfo.m_useEpaPenetrationAlgorithm;
+			m_convexKernelCF[i] = createFunc;
+			m_convexKernelProxyType0[i] = kernels[i].m_proxyType0;
+			m_convexKernelProxyType1[i] = kernels[i].m_proxyType1;
+		}
+		m_numConvexKernels = MAX_CONVEX_KERNELS;
+	}
+
 	///calculate maximum element size, big enough to fit any collision algorithm in the memory pool
 	int maxSize = sizeof(btConvexConvexAlgorithm);
 	int maxSize2 = sizeof(btConvexConcaveCollisionAlgorithm);
@@ -125,7 +171,7 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	{
 		m_ownsPersistentManifoldPool = true;
 		void* mem = btAlignedAlloc(sizeof(btPoolAllocator),16);
-		m_persistentManifoldPool = new (mem) btPoolAllocator(sizeof(btPersistentManifold),constructionInfo.m_defaultMaxPersistentManifoldPoolSize);
+		m_persistentManifoldPool = new (mem) btPoolAllocator(sizeof(btPersistentManifold),constructionInfo.m_defaultMaxPersistentManifoldPoolSize,constructionInfo.m_useGrowablePools!=0);
 	}
 	
 	if (constructionInfo.m_collisionAlgorithmPool)
@@ -136,7 +182,7 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	{
 		m_ownsCollisionAlgorithmPool = true;
 		void* mem = btAlignedAlloc(sizeof(btPoolAllocator),16);
-		m_collisionAlgorithmPool = new(mem) btPoolAllocator(collisionAlgorithmMaxElementSize,constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize);
+		m_collisionAlgorithmPool = new(mem) btPoolAllocator(collisionAlgorithmMaxElementSize,constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize,constructionInfo.m_useGrowablePools!=0);
 	}
 
 
@@ -192,6 +238,10 @@ btDefaultCollisionConfiguration::~btDefaultCollisionConfiguration()
 	btAlignedFree( m_sphereTriangleCF);
 	m_triangleSphereCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree( m_triangleSphereCF);
+	m_capsuleTriangleCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree( m_capsuleTriangleCF);
+	m_triangleCapsuleCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree( m_triangleCapsuleCF);
 	m_boxBoxCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree( m_boxBoxCF);
 
@@ -200,6 +250,12 @@ btDefaultCollisionConfiguration::~btDefaultCollisionConfiguration()
 	m_planeConvexCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree( m_planeConvexCF);
 
+	for (int i=0;i<m_numConvexKernels;i++)
+	{
+		m_convexKernelCF[i]->~btCollisionAlgorithmCreateFunc();
+		btAlignedFree( m_convexKernelCF[i]);
+	}
+
 	m_simplexSolver->~btVoronoiSimplexSolver();
 	btAlignedFree(m_simplexSolver);
 
@@ -243,6 +299,16 @@ btCollisionAlgorithmCreateFunc* btDefaultCollisionConfiguration::getCollisionAlg
 		return	m_triangleSphereCF;
 	} 
 
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE ) && (proxyType1==TRIANGLE_SHAPE_PROXYTYPE))
+	{
+		return	m_capsuleTriangleCF;
+	}
+
+	if ((proxyType0 == TRIANGLE_SHAPE_PROXYTYPE  ) && (proxyType1==CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return	m_triangleCapsuleCF;
+	}
+
 	if ((proxyType0 == BOX_SHAPE_PROXYTYPE) && (proxyType1 == BOX_SHAPE_PROXYTYPE))
 	{
 		return m_boxBoxCF;
@@ -259,6 +325,13 @@ btCollisionAlgorithmCreateFunc* btDefaultCollisionConfiguration::getCollisionAlg
 	}
 	
 
+	for (int i=0;i<m_numConvexKernels;i++)
+	{
+		if ((proxyType0 == m_convexKernelProxyType0[i]) && (proxyType1 == m_convexKernelProxyType1[i]))
+		{
+			return m_convexKernelCF[i];
+		}
+	}
 
 	if (btBroadphaseProxy::isConvex(proxyType0) && btBroadphaseProxy::isConvex(proxyType1))
 	{
@@ -295,4 +368,10 @@ void btDefaultCollisionConfiguration::setConvexConvexMultipointIterations(int nu
 	btConvexConvexAlgorithm::CreateFunc* convexConvex = (btConvexConvexAlgorithm::CreateFunc*) m_convexConvexCreateFunc;
 	convexConvex->m_numPerturbationIterations = numPerturbationIterations;
 	convexConvex->m_minimumPointsPerturbationThreshold = minimumPointsPerturbationThreshold;
+	for (int i=0;i<m_numConvexKernels;i++)
+	{
+		btConvexConvexAlgorithm::CreateFunc* convexKernel = (btConvexConvexAlgorithm::CreateFunc*) m_convexKernelCF[i];
+		convexKernel->m_numPerturbationIterations = numPerturbationIterations;
+		convexKernel->m_minimumPointsPerturbationThreshold = minimumPointsPerturbationThreshold;
+	}
 }
@@ -30,6 +30,11 @@ struct	btDefaultCollisionConstructionInfo
 	int					m_customCollisionAlgorithmMaxElementSize;
 	int					m_defaultStackAllocatorSize;
 	int					m_useEpaPenetrationAlgorithm;
+	///the default pools start with the max pool sizes above and grow when they run out, instead of falling back to an allocation per element
+	int					m_useGrowablePools;
+	///capsule, sphere, box, cylinder and convex hull pairs use a GJK kernel specialized for their shape types, see btGjkPairDetectorKernel.h.
+	///The kernels give the same results as the generic convex-convex algorithm.
+	int					m_useConvexKernels;
 
 	btDefaultCollisionConstructionInfo()
 		:m_stackAlloc(0),
@@ -39,7 +44,9 @@ struct	btDefaultCollisionConstructionInfo
 		m_defaultMaxCollisionAlgorithmPoolSize(4096),
 		m_customCollisionAlgorithmMaxElementSize(0),
 		m_defaultStackAllocatorSize(0),
-		m_useEpaPenetrationAlgorithm(true)
+		m_useEpaPenetrationAlgorithm(true),
+		m_useGrowablePools(false),
+		m_useConvexKernels(true)
 	{
 	}
 };
@@ -86,8 +93,17 @@ protected:
 	btCollisionAlgorithmCreateFunc* m_boxBoxCF;
 	btCollisionAlgorithmCreateFunc*	m_sphereTriangleCF;
 	btCollisionAlgorithmCreateFunc*	m_triangleSphereCF;
+	btCollisionAlgorithmCreateFunc*	m_capsuleTriangleCF;
+	btCollisionAlgorithmCreateFunc*	m_triangleCapsuleCF;
 	btCollisionAlgorithmCreateFunc*	m_planeConvexCF;
 	btCollisionAlgorithmCreateFunc*	m_convexPlaneCF;
+
+	//convex-convex CreationFunctions with a GJK kernel for the shape types
+	enum	{ MAX_CONVEX_KERNELS = 10 };
+	btCollisionAlgorithmCreateFunc*	m_convexKernelCF[MAX_CONVEX_KERNELS];
+	int		m_convexKernelProxyType0[MAX_CONVEX_KERNELS];
+	int		m_convexKernelProxyType1[MAX_CONVEX_KERNELS];
+	int		m_numConvexKernels;
 	
 public:
 
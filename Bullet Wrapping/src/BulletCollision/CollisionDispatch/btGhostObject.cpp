@@ -34,25 +34,78 @@ void btGhostObject::addOverlappingObjectInternal(btBroadphaseProxy* otherProxy,b
 {
 	btCollisionObject* otherObject = (btCollisionObject*)otherProxy->m_clientObject;
 	btAssert(otherObject);
-	///if this linearSearch becomes too slow (too many overlapping objects) we should add a more appropriate data structure
-	int index = m_overlappingObjects.findLinearSearch(otherObject);
-	if (index==m_overlappingObjects.size())
-	{
-		//not found
-		m_overlappingObjects.push_back(otherObject);
-	}
+	insertOverlappingObject(otherObject);
 }
 
 void btGhostObject::removeOverlappingObjectInternal(btBroadphaseProxy* otherProxy,btDispatcher* dispatcher,btBroadphaseProxy* thisProxy)
 {
 	btCollisionObject* otherObject = (btCollisionObject*)otherProxy->m_clientObject;
 	btAssert(otherObject);
-	int index = m_overlappingObjects.findLinearSearch(otherObject);
-	if (index<m_overlappingObjects.size())
+	eraseOverlappingObject(otherObject);
+}
+
+bool	btGhostObject::insertOverlappingObject(btCollisionObject* otherObject)
+{
+	btHashPtr key(otherObject);
+	if (m_overlappingIndex.find(key))
+		return false;
+
+	m_overlappingIndex.insert(key,m_overlappingObjects.size());
+	m_overlappingObjects.push_back(otherObject);
+	return true;
+}
+
+bool	btGhostObject::eraseOverlappingObject(btCollisionObject* otherObject)
+{
+	btHashPtr key(otherObject);
+	int* indexPtr = m_overlappingIndex.find(key);
+	if (!indexPtr)
+		return false;
+
+	int index = *indexPtr;
+	btAssert(m_overlappingObjects[index] == otherObject);
+	int lastIndex = m_overlappingObjects.size()-1;
+	if (index != lastIndex)
+	{
+		//move the last object into the freed slot, and update its index
+		btCollisionObject* lastObject = m_overlappingObjects[lastIndex];
+		m_overlappingObjects[index] = lastObject;
+		m_overlappingIndex.insert(btHashPtr(lastObject),index);
+	}
+	m_overlappingObjects.pop_back();
+	m_overlappingIndex.remove(key);
+	return true;
+}
+
+void	btGhostObject::processAllOverlappingObjects(OverlapCallback& callback, short int collisionFilterMask) const
+{
+	int i;
+	for (i=0;i<m_overlappingObjects.size();i++)
+	{
+		btCollisionObject* otherObject = m_overlappingObjects[i];
+		btBroadphaseProxy* otherProxy = otherObject->getBroadphaseHandle();
+		if (otherProxy && !(otherProxy->m_collisionFilterGroup & collisionFilterMask))
+			continue;
+		if (!callback.processOverlap(otherObject))
+			break;
+	}
+}
+
+int		btGhostObject::getOverlappingObjects(btAlignedObjectArray<btCollisionObject*>& objectsOut, short int collisionFilterMask) const
+{
+	int numAppended = 0;
+	objectsOut.reserve(objectsOut.size()+m_overlappingObjects.size());
+	int i;
+	for (i=0;i<m_overlappingObjects.size();i++)
 	{
-		m_overlappingObjects[index] = m_overlappingObjects[m_overlappingObjects.size()-1];
-		m_overlappingObjects.pop_back();
+		btCollisionObject* otherObject = m_overlappingObjects[i];
+		btBroadphaseProxy* otherProxy = otherObject->getBroadphaseHandle();
+		if (otherProxy && !(otherProxy->m_collisionFilterGroup & collisionFilterMask))
+			continue;
+		objectsOut.push_back(otherObject);
+		numAppended++;
 	}
+	return numAppended;
 }
 
 
@@ -74,10 +127,8 @@ void btPairCachingGhostObject::addOverlappingObjectInternal(btBroadphaseProxy* o
 
 	btCollisionObject* otherObject = (btCollisionObject*)otherProxy->m_clientObject;
 	btAssert(otherObject);
-	int index = m_overlappingObjects.findLinearSearch(otherObject);
-	if (index==m_overlappingObjects.size())
+	if (insertOverlappingObject(otherObject))
 	{
-		m_overlappingObjects.push_back(otherObject);
 		m_hashPairCache->addOverlappingPair(actualThisProxy,otherProxy);
 	}
 }
@@ -89,11 +140,8 @@ void btPairCachingGhostObject::removeOverlappingObjectInternal(btBroadphaseProxy
 	btAssert(actualThisProxy);
 
 	btAssert(otherObject);
-	int index = m_overlappingObjects.findLinearSearch(otherObject);
-	if (index<m_overlappingObjects.size())
+	if (eraseOverlappingObject(otherObject))
 	{
-		m_overlappingObjects[index] = m_overlappingObjects[m_overlappingObjects.size()-1];
-		m_overlappingObjects.pop_back();
 		m_hashPairCache->removeOverlappingPair(actualThisProxy,otherProxy,dispatcher);
 	}
 }
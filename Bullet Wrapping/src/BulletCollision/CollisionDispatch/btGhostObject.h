@@ -22,6 +22,7 @@ subject to the following restrictions:
 #include "LinearMath/btAlignedAllocator.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 #include "btCollisionWorld.h"
+#include "LinearMath/btHashMap.h"
 
 class btConvexShape;
 
@@ -31,14 +32,31 @@ class btDispatcher;
 ///By default, this overlap is based on the AABB
 ///This is useful for creating a character controller, collision sensors/triggers, explosions etc.
 ///We plan on adding rayTest and other queries for the btGhostObject
+///The overlapping objects are stored in a dense array, indexed by a hashmap from object to array slot,
+///so adding and removing an overlap is O(1) even for large trigger volumes that overlap thousands of objects.
 ATTRIBUTE_ALIGNED16(class) btGhostObject : public btCollisionObject
 {
 protected:
 
 	btAlignedObjectArray<btCollisionObject*> m_overlappingObjects;
 
+	///maps each overlapping object to its index in m_overlappingObjects
+	btHashMap<btHashPtr,int>	m_overlappingIndex;
+
+	///returns true if otherObject was not yet overlapping
+	bool	insertOverlappingObject(btCollisionObject* otherObject);
+	///returns true if otherObject was overlapping
+	bool	eraseOverlappingObject(btCollisionObject* otherObject);
+
 public:
 
+	///callback for processAllOverlappingObjects, return false to stop the iteration
+	struct	OverlapCallback
+	{
+		virtual ~OverlapCallback() {}
+		virtual bool	processOverlap(btCollisionObject* otherObject) = 0;
+	};
+
 	btGhostObject();
 
 	virtual ~btGhostObject();
@@ -67,6 +85,34 @@ public:
 		return m_overlappingObjects[index];
 	}
 
+	///O(1) overlap query
+	bool	isOverlappingObject(const btCollisionObject* otherObject) const
+	{
+		return m_overlappingIndex.find(btHashPtr(otherObject)) != 0;
+	}
+
+	///calls the callback for each overlapping object that passes the filter mask, stops early when the callback returns false
+	void	processAllOverlappingObjects(OverlapCallback& callback, short int collisionFilterMask = btBroadphaseProxy::AllFilter) const;
+
+	///appends all overlapping objects that pass the filter mask to the array and returns the number of objects appended
+	int		getOverlappingObjects(btAlignedObjectArray<btCollisionObject*>& objectsOut, short int collisionFilterMask = btBroadphaseProxy::AllFilter) const;
+
+	///only report overlaps based on the broadphase AABB test, pairs with this ghost never create narrowphase collision algorithms.
+	///useful for large trigger volumes (zones, water, explosions) that don't need contact points
+	void	setAabbOverlapOnly(bool aabbOnly)
+	{
+		if (aabbOnly)
+			m_collisionFlags |= CF_AABB_OVERLAP_ONLY;
+		else
+			m_collisionFlags &= ~CF_AABB_OVERLAP_ONLY;
+	}
+
+	bool	isAabbOverlapOnly() const
+	{
+		return (m_collisionFlags & CF_AABB_OVERLAP_ONLY) != 0;
+	}
+
+	///the returned array must not be reordered or resized, the overlap index depends on it
 	btAlignedObjectArray<btCollisionObject*>&	getOverlappingPairs()
 	{
 		return m_overlappingObjects;
@@ -53,6 +53,8 @@ btManifoldResult::btManifoldResult(btCollisionObject* body0,btCollisionObject* b
 	m_index0(-1),
 	m_index1(-1)
 #endif //DEBUG_PART_INDEX
+		,m_childKey0(-1),
+		m_childKey1(-1)
 {
 	m_rootTransA = body0->getWorldTransform();
 	m_rootTransB = body1->getWorldTransform();
@@ -52,14 +52,21 @@ protected:
 
 public:
 
+	///child key of body0 and body1 along the compound shapes being processed, -1 outside of a compound.
+	///btCompoundCollisionAlgorithm extends it for each nested level and stores it in btPersistentManifold::m_childIndex0/1.
+	int	m_childKey0;
+	int	m_childKey1;
+
 	btManifoldResult()
-#ifdef DEBUG_PART_INDEX
 		:
+#ifdef DEBUG_PART_INDEX
 	m_partId0(-1),
 	m_partId1(-1),
 	m_index0(-1),
-	m_index1(-1)
+	m_index1(-1),
 #endif //DEBUG_PART_INDEX
+	m_childKey0(-1),
+	m_childKey1(-1)
 	{
 	}
 
@@ -24,9 +24,18 @@ subject to the following restrictions:
 
 //#include <stdio.h>
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btAabbUtil2.h"
 
 btSimulationIslandManager::btSimulationIslandManager():
-m_splitIslands(true)
+m_splitIslands(true),
+m_incrementalIslands(false),
+m_needsRebuild(true),
+m_needsSplit(false),
+m_groupingDirty(true),
+m_splitDelay(8),
+m_stepsSinceSplit(0),
+m_numMergingPairs(0),
+m_numConstraintUnions(0)
 {
 }
 
@@ -41,9 +50,9 @@ void btSimulationIslandManager::initUnionFind(int n)
 }
 		
 
-void btSimulationIslandManager::findUnions(btDispatcher* /* dispatcher */,btCollisionWorld* colWorld)
+void btSimulationIslandManager::findUnions(btDispatcher* dispatcher,btCollisionWorld* colWorld)
 {
-	
+	const bool deterministic = colWorld->getDispatchInfo().m_deterministicOrder;
 	{
 		btOverlappingPairCache* pairCachePtr = colWorld->getPairCache();
 		const int numOverlappingPairs = pairCachePtr->getNumOverlappingPairs();
@@ -57,21 +66,62 @@ void btSimulationIslandManager::findUnions(btDispatcher* /* dispatcher */,btColl
 			btCollisionObject* colObj0 = (btCollisionObject*)collisionPair.m_pProxy0->m_clientObject;
 			btCollisionObject* colObj1 = (btCollisionObject*)collisionPair.m_pProxy1->m_clientObject;
 
+			//a broadphase can keep pairs of enlarged bounds (btDbvtBroadphase) that depend on its history,
+			//deterministic mode only unites pairs whose current bounds overlap
+			if (deterministic && !TestAabbAgainstAabb2(collisionPair.m_pProxy0->m_aabbMin,collisionPair.m_pProxy0->m_aabbMax,
+				collisionPair.m_pProxy1->m_aabbMin,collisionPair.m_pProxy1->m_aabbMax))
+				continue;
+
 			if (((colObj0) && ((colObj0)->mergesSimulationIslands())) &&
 				((colObj1) && ((colObj1)->mergesSimulationIslands())))
 			{
-
-				m_unionFind.unite((colObj0)->getIslandTag(),
-					(colObj1)->getIslandTag());
+				if (deterministic)
+				{
+					m_unionFind.uniteMinRoot((colObj0)->getIslandTag(),
+						(colObj1)->getIslandTag());
+				} else
+				{
+					m_unionFind.unite((colObj0)->getIslandTag(),
+						(colObj1)->getIslandTag());
+				}
 			}
 		}
 		}
 	}
+
+	//contacts are kept up to the contact breaking threshold of the shapes, which can be larger than the bounds margin,
+	//so their objects still need to be solved within one island
+	if (deterministic && dispatcher)
+	{
+		int numManifolds = dispatcher->getNumManifolds();
+		for (int i=0;i<numManifolds;i++)
+		{
+			btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+			btCollisionObject* colObj0 = static_cast<btCollisionObject*>(manifold->getBody0());
+			btCollisionObject* colObj1 = static_cast<btCollisionObject*>(manifold->getBody1());
+			if (manifold->getNumContacts() && colObj0->mergesSimulationIslands() && colObj1->mergesSimulationIslands())
+			{
+				m_unionFind.uniteMinRoot(colObj0->getIslandTag(),colObj1->getIslandTag());
+			}
+		}
+	}
+}
+
+bool	btSimulationIslandManager::isIncremental(const btCollisionWorld* colWorld) const
+{
+	//the persistent union find depends on the order of earlier unions, deterministic mode rebuilds it every step
+	return m_incrementalIslands && !colWorld->getDispatchInfo().m_deterministicOrder;
 }
 
 #ifdef STATIC_SIMULATION_ISLAND_OPTIMIZATION
 void   btSimulationIslandManager::updateActivationState(btCollisionWorld* colWorld,btDispatcher* dispatcher)
 {
+	if (isIncremental(colWorld))
+	{
+		updateActivationStateIncremental(colWorld);
+		return;
+	}
+	m_needsRebuild = true;
 
 	// put the index into m_controllers into m_tag   
 	int index = 0;
@@ -99,6 +149,11 @@ void   btSimulationIslandManager::updateActivationState(btCollisionWorld* colWor
 
 void   btSimulationIslandManager::storeIslandActivationState(btCollisionWorld* colWorld)
 {
+	if (isIncremental(colWorld))
+	{
+		storeIslandActivationStateIncremental(colWorld);
+		return;
+	}
 	// put the islandId ('find' value) into m_tag   
 	{
 		int index = 0;
@@ -126,6 +181,12 @@ void   btSimulationIslandManager::storeIslandActivationState(btCollisionWorld* c
 #else //STATIC_SIMULATION_ISLAND_OPTIMIZATION
 void	btSimulationIslandManager::updateActivationState(btCollisionWorld* colWorld,btDispatcher* dispatcher)
 {
+	if (isIncremental(colWorld))
+	{
+		updateActivationStateIncremental(colWorld);
+		return;
+	}
+	m_needsRebuild = true;
 
 	initUnionFind( int (colWorld->getCollisionObjectArray().size()));
 
@@ -151,6 +212,11 @@ void	btSimulationIslandManager::updateActivationState(btCollisionWorld* colWorld
 
 void	btSimulationIslandManager::storeIslandActivationState(btCollisionWorld* colWorld)
 {
+	if (isIncremental(colWorld))
+	{
+		storeIslandActivationStateIncremental(colWorld);
+		return;
+	}
 	// put the islandId ('find' value) into m_tag	
 	{
 
@@ -188,20 +254,69 @@ inline	int	getIslandId(const btPersistentManifold* lhs)
 
 
 
-/// function object that routes calls to operator<
-class btPersistentManifoldSortPredicate
+inline	int	getManifoldUid(const void* body)
+{
+	const btBroadphaseProxy* proxy = static_cast<const btCollisionObject*>(body)->getBroadphaseHandle();
+	return proxy ? proxy->getUid() : -1;
+}
+
+///orders the manifolds by island, then by the broadphase uids of their objects, their compound child indices and then by their first contact point.
+///Unlike the dispatcher manifold order, this doesn't depend on allocation order or on the history of the pair cache.
+class btPersistentManifoldDeterministicSortPredicate
 {
 	public:
 
-		SIMD_FORCE_INLINE bool operator() ( const btPersistentManifold* lhs, const btPersistentManifold* rhs )
+		bool operator() ( const btPersistentManifold* lhs, const btPersistentManifold* rhs ) const
 		{
-			return getIslandId(lhs) < getIslandId(rhs);
+			int islandL = getIslandId(lhs);
+			int islandR = getIslandId(rhs);
+			if (islandL != islandR)
+				return islandL < islandR;
+			int uidL = getManifoldUid(lhs->getBody0());
+			int uidR = getManifoldUid(rhs->getBody0());
+			if (uidL != uidR)
+				return uidL < uidR;
+			uidL = getManifoldUid(lhs->getBody1());
+			uidR = getManifoldUid(rhs->getBody1());
+			if (uidL != uidR)
+				return uidL < uidR;
+			if (lhs->m_childIndex0 != rhs->m_childIndex0)
+				return lhs->m_childIndex0 < rhs->m_childIndex0;
+			if (lhs->m_childIndex1 != rhs->m_childIndex1)
+				return lhs->m_childIndex1 < rhs->m_childIndex1;
+			if (!lhs->getNumContacts() || !rhs->getNumContacts())
+				return lhs->getNumContacts() < rhs->getNumContacts();
+
+			//several manifolds for one pair of objects (compounds, concave meshes), tell them apart by their first contact
+			const btManifoldPoint& ptL = lhs->getContactPoint(0);
+			const btManifoldPoint& ptR = rhs->getContactPoint(0);
+			if (ptL.m_partId0 != ptR.m_partId0)
+				return ptL.m_partId0 < ptR.m_partId0;
+			if (ptL.m_index0 != ptR.m_index0)
+				return ptL.m_index0 < ptR.m_index0;
+			if (ptL.m_partId1 != ptR.m_partId1)
+				return ptL.m_partId1 < ptR.m_partId1;
+			if (ptL.m_index1 != ptR.m_index1)
+				return ptL.m_index1 < ptR.m_index1;
+			for (int i=0;i<3;i++)
+			{
+				if (ptL.m_localPointA[i] != ptR.m_localPointA[i])
+					return ptL.m_localPointA[i] < ptR.m_localPointA[i];
+				if (ptL.m_localPointB[i] != ptR.m_localPointB[i])
+					return ptL.m_localPointB[i] < ptR.m_localPointB[i];
+			}
+			return false;
 		}
 };
 
 
 void btSimulationIslandManager::buildIslands(btDispatcher* dispatcher,btCollisionWorld* collisionWorld)
 {
+	if (isIncremental(collisionWorld))
+	{
+		buildIslandsIncremental(dispatcher,collisionWorld);
+		return;
+	}
 
 	BT_PROFILE("islandUnionFindAndQuickSort");
 	
@@ -307,6 +422,7 @@ void btSimulationIslandManager::buildIslands(btDispatcher* dispatcher,btCollisio
 	
 	int i;
 	int maxNumManifolds = dispatcher->getNumManifolds();
+	const bool deterministic = collisionWorld->getDispatchInfo().m_deterministicOrder;
 
 //#define SPLIT_ISLANDS 1
 //#ifdef SPLIT_ISLANDS
@@ -318,6 +434,10 @@ void btSimulationIslandManager::buildIslands(btDispatcher* dispatcher,btCollisio
 	for (i=0;i<maxNumManifolds ;i++)
 	{
 		 btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+
+		 //whether an empty manifold still exists depends on when the broadphase removed its pair
+		 if (deterministic && !manifold->getNumContacts())
+			 continue;
 		 
 		 btCollisionObject* colObj0 = static_cast<btCollisionObject*>(manifold->getBody0());
 		 btCollisionObject* colObj1 = static_cast<btCollisionObject*>(manifold->getBody1());
@@ -336,7 +456,7 @@ void btSimulationIslandManager::buildIslands(btDispatcher* dispatcher,btCollisio
 			{
 				colObj0->activate();
 			}
-			if(m_splitIslands)
+			if(m_splitIslands || deterministic)
 			{ 
 				//filtering for response
 				if (dispatcher->needsResponse(colObj0,colObj1))
@@ -348,6 +468,34 @@ void btSimulationIslandManager::buildIslands(btDispatcher* dispatcher,btCollisio
 
 
 
+void	btSimulationIslandManager::sortIslandManifolds(int numElements,bool deterministic)
+{
+	int numManifolds = m_islandmanifold.size();
+	m_islandManifoldKeys.resize(numManifolds);
+	int i;
+	for (i=0;i<numManifolds;i++)
+	{
+		//island ids are union find element indices, or -1 when both objects are static
+		m_islandManifoldKeys[i] = getIslandId(m_islandmanifold[i])+1;
+	}
+	m_manifoldSorter.sort(m_islandmanifold,m_islandManifoldKeys,numElements+1);
+
+	if (deterministic)
+	{
+		int endIndex;
+		for (int startIndex=0;startIndex<numManifolds;startIndex=endIndex)
+		{
+			for (endIndex=startIndex+1;(endIndex<numManifolds) && (m_islandManifoldKeys[endIndex] == m_islandManifoldKeys[startIndex]);endIndex++)
+			{
+			}
+			if (endIndex-startIndex > 1)
+			{
+				m_islandmanifold.quickSortInternal(btPersistentManifoldDeterministicSortPredicate(),startIndex,endIndex-1);
+			}
+		}
+	}
+}
+
 ///@todo: this is random access, it can be walked 'cache friendly'!
 void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,btCollisionWorld* collisionWorld, IslandCallback* callback)
 {
@@ -355,28 +503,41 @@ void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,
 
 	buildIslands(dispatcher,collisionWorld);
 
+	if (isIncremental(collisionWorld) && m_splitIslands)
+	{
+		BT_PROFILE("processIslands");
+		processIslandsIncremental(callback);
+		return;
+	}
+
 	int endIslandIndex=1;
 	int startIslandIndex;
 	int numElem = getUnionFind().getNumElements();
 
 	BT_PROFILE("processIslands");
 
+	const bool deterministic = collisionWorld->getDispatchInfo().m_deterministicOrder;
+
 	if(!m_splitIslands)
 	{
-		btPersistentManifold** manifold = dispatcher->getInternalManifoldPointer();
-		int maxNumManifolds = dispatcher->getNumManifolds();
-		callback->ProcessIsland(&collisionObjects[0],collisionObjects.size(),manifold,maxNumManifolds, -1);
+		if (deterministic)
+		{
+			sortIslandManifolds(numElem,true);
+			callback->ProcessIsland(&collisionObjects[0],collisionObjects.size(),m_islandmanifold.size() ? &m_islandmanifold[0] : 0,m_islandmanifold.size(), -1);
+		} else
+		{
+			btPersistentManifold** manifold = dispatcher->getInternalManifoldPointer();
+			int maxNumManifolds = dispatcher->getNumManifolds();
+			callback->ProcessIsland(&collisionObjects[0],collisionObjects.size(),manifold,maxNumManifolds, -1);
+		}
 	}
 	else
 	{
 		// Sort manifolds, based on islands
-		// Sort the vector using predicate and std::sort
-		//std::sort(islandmanifold.begin(), islandmanifold.end(), btPersistentManifoldSortPredicate);
 
 		int numManifolds = int (m_islandmanifold.size());
 
-		//we should do radix sort, it it much faster (O(n) instead of O (n log2(n))
-		m_islandmanifold.quickSort(btPersistentManifoldSortPredicate());
+		sortIslandManifolds(numElem,deterministic);
 
 		//now process all active islands (sets of manifolds for now)
 
@@ -413,12 +574,12 @@ void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,
 
 			if (startManifoldIndex<numManifolds)
 			{
-				int curIslandId = getIslandId(m_islandmanifold[startManifoldIndex]);
+				int curIslandId = m_islandManifoldKeys[startManifoldIndex]-1;
 				if (curIslandId == islandId)
 				{
 					startManifold = &m_islandmanifold[startManifoldIndex];
 				
-					for (endManifoldIndex = startManifoldIndex+1;(endManifoldIndex<numManifolds) && (islandId == getIslandId(m_islandmanifold[endManifoldIndex]));endManifoldIndex++)
+					for (endManifoldIndex = startManifoldIndex+1;(endManifoldIndex<numManifolds) && (islandId == m_islandManifoldKeys[endManifoldIndex]-1);endManifoldIndex++)
 					{
 
 					}
@@ -444,3 +605,306 @@ void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,
 	} // else if(!splitIslands) 
 
 }
+
+
+
+void	btSimulationIslandManager::updateActivationStateIncremental(btCollisionWorld* colWorld)
+{
+	btCollisionObjectArray& collisionObjects = colWorld->getCollisionObjectArray();
+
+	// union find elements are the non-static objects, in collision object array order.
+	// Any change of that set invalidates the persistent union find.
+	bool fullRebuild = m_needsRebuild;
+	int index = 0;
+	int i;
+	for (i=0;i<collisionObjects.size(); i++)
+	{
+		btCollisionObject*	collisionObject= collisionObjects[i];
+		if (!collisionObject->isStaticOrKinematicObject())
+		{
+			if ((index >= m_slotObjects.size()) || (m_slotObjects[index] != collisionObject))
+				fullRebuild = true;
+			collisionObject->setIslandTag(index++);
+		}
+		collisionObject->setCompanionId(-1);
+		collisionObject->setHitFraction(btScalar(1.));
+	}
+	if (index != m_slotObjects.size())
+		fullRebuild = true;
+
+	// lazy split: disconnected parts stay in one island until the delay expired
+	m_stepsSinceSplit++;
+	if (m_needsSplit && (m_stepsSinceSplit > m_splitDelay))
+		fullRebuild = true;
+
+	if (fullRebuild)
+	{
+		m_slotObjects.resize(index);
+		index = 0;
+		for (i=0;i<collisionObjects.size(); i++)
+		{
+			if (!collisionObjects[i]->isStaticOrKinematicObject())
+				m_slotObjects[index++] = collisionObjects[i];
+		}
+		initUnionFind(index);
+		m_unitedPairs.clear();
+		m_slotRoots.resize(index);
+		for (i=0;i<index;i++)
+		{
+			m_slotRoots[i] = -1;
+		}
+		m_needsRebuild = false;
+		m_needsSplit = false;
+		m_stepsSinceSplit = 0;
+		m_groupingDirty = true;
+	}
+
+	findUnionsIncremental(colWorld,fullRebuild);
+}
+
+void	btSimulationIslandManager::findUnionsIncremental(btCollisionWorld* colWorld,bool fullRebuild)
+{
+	btOverlappingPairCache* pairCachePtr = colWorld->getPairCache();
+	const int numOverlappingPairs = pairCachePtr->getNumOverlappingPairs();
+	int numMergingPairs = 0;
+	int numKnownPairs = 0;
+	if (numOverlappingPairs)
+	{
+		btBroadphasePair* pairPtr = pairCachePtr->getOverlappingPairArrayPtr();
+		for (int i=0;i<numOverlappingPairs;i++)
+		{
+			btBroadphasePair& collisionPair = pairPtr[i];
+			btCollisionObject* colObj0 = (btCollisionObject*)collisionPair.m_pProxy0->m_clientObject;
+			btCollisionObject* colObj1 = (btCollisionObject*)collisionPair.m_pProxy1->m_clientObject;
+
+			if (((colObj0) && ((colObj0)->mergesSimulationIslands())) &&
+				((colObj1) && ((colObj1)->mergesSimulationIslands())))
+			{
+				numMergingPairs++;
+				// removed pairs stay in m_unitedPairs until the next full rebuild, the split is pending until then
+				btIslandPairKey key(collisionPair.m_pProxy0->getUid(),collisionPair.m_pProxy1->getUid());
+				if (!fullRebuild && m_unitedPairs.find(key))
+				{
+					numKnownPairs++;
+					continue;
+				}
+				m_unionFind.unite((colObj0)->getIslandTag(),
+					(colObj1)->getIslandTag());
+				m_unitedPairs.insert(key,0);
+			}
+		}
+	}
+
+	// a pair that was united before is gone, its island might fall apart
+	if (!fullRebuild && (numKnownPairs < m_numMergingPairs))
+		m_needsSplit = true;
+	m_numMergingPairs = numMergingPairs;
+}
+
+void	btSimulationIslandManager::storeIslandActivationStateIncremental(btCollisionWorld* colWorld)
+{
+	btCollisionObjectArray& collisionObjects = colWorld->getCollisionObjectArray();
+	int index = 0;
+	for (int i=0;i<collisionObjects.size();i++)
+	{
+		btCollisionObject* collisionObject= collisionObjects[i];
+		if (!collisionObject->isStaticOrKinematicObject())
+		{
+			int root = m_unionFind.find(index);
+			if (m_slotRoots[index] != root)
+			{
+				m_slotRoots[index] = root;
+				m_groupingDirty = true;
+			}
+			collisionObject->setIslandTag(root);
+			collisionObject->setCompanionId(-1);
+			index++;
+		} else
+		{
+			collisionObject->setIslandTag(-1);
+			collisionObject->setCompanionId(-2);
+		}
+	}
+}
+
+///group the elements by island root with a counting pass, islands are ordered by root and
+///bodies keep their collision object array order. Only needed when some root changed.
+void	btSimulationIslandManager::groupIslands()
+{
+	int numElem = m_slotObjects.size();
+	int i;
+
+	m_islandOfRoot.resize(numElem);
+	for (i=0;i<numElem;i++)
+	{
+		m_islandOfRoot[i] = 0;
+	}
+	for (i=0;i<numElem;i++)
+	{
+		m_islandOfRoot[m_slotRoots[i]]++;
+	}
+
+	m_islandRoots.resize(0);
+	m_islandStarts.resize(0);
+	int offset = 0;
+	for (i=0;i<numElem;i++)
+	{
+		int count = m_islandOfRoot[i];
+		if (count)
+		{
+			m_islandOfRoot[i] = m_islandRoots.size();
+			m_islandRoots.push_back(i);
+			m_islandStarts.push_back(offset);
+			offset += count;
+		} else
+		{
+			m_islandOfRoot[i] = -1;
+		}
+	}
+	m_islandStarts.push_back(offset);
+
+	m_islandBodies.resize(numElem);
+	btAlignedObjectArray<int>& fill = m_manifoldStarts;
+	fill.resize(m_islandRoots.size());
+	for (i=0;i<m_islandRoots.size();i++)
+	{
+		fill[i] = m_islandStarts[i];
+	}
+	for (i=0;i<numElem;i++)
+	{
+		int island = m_islandOfRoot[m_slotRoots[i]];
+		m_islandBodies[fill[island]++] = m_slotObjects[i];
+	}
+
+	m_groupingDirty = false;
+}
+
+void	btSimulationIslandManager::buildIslandsIncremental(btDispatcher* dispatcher,btCollisionWorld* /*collisionWorld*/)
+{
+	BT_PROFILE("islandIncrementalGrouping");
+
+	if (m_groupingDirty)
+		groupIslands();
+
+	int numIslands = m_islandRoots.size();
+	int island;
+
+	//update the sleeping state for bodies, if all are sleeping
+	for (island=0;island<numIslands;island++)
+	{
+		int startIslandIndex = m_islandStarts[island];
+		int endIslandIndex = m_islandStarts[island+1];
+		bool allSleeping = true;
+
+		int idx;
+		for (idx=startIslandIndex;idx<endIslandIndex;idx++)
+		{
+			btCollisionObject* colObj0 = m_islandBodies[idx];
+			if ((colObj0->getActivationState()== ACTIVE_TAG) ||
+				(colObj0->getActivationState()== DISABLE_DEACTIVATION))
+			{
+				allSleeping = false;
+				break;
+			}
+		}
+
+		for (idx=startIslandIndex;idx<endIslandIndex;idx++)
+		{
+			btCollisionObject* colObj0 = m_islandBodies[idx];
+			if (allSleeping)
+			{
+				colObj0->setActivationState( ISLAND_SLEEPING );
+			} else if ( colObj0->getActivationState() == ISLAND_SLEEPING)
+			{
+				colObj0->setActivationState( WANTS_DEACTIVATION);
+				colObj0->setDeactivationTime(0.f);
+			}
+		}
+	}
+
+	//bucket the manifolds by island, counting sort on the island index
+	m_unsortedManifolds.resize(0);
+	m_manifoldStarts.resize(numIslands+1);
+	for (island=0;island<=numIslands;island++)
+	{
+		m_manifoldStarts[island] = 0;
+	}
+
+	int i;
+	int maxNumManifolds = dispatcher->getNumManifolds();
+	for (i=0;i<maxNumManifolds ;i++)
+	{
+		 btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		 
+		 btCollisionObject* colObj0 = static_cast<btCollisionObject*>(manifold->getBody0());
+		 btCollisionObject* colObj1 = static_cast<btCollisionObject*>(manifold->getBody1());
+		
+		 if (((colObj0) && colObj0->getActivationState() != ISLAND_SLEEPING) ||
+			((colObj1) && colObj1->getActivationState() != ISLAND_SLEEPING))
+		{
+			//kinematic objects don't merge islands, but wake up all connected objects
+			if (colObj0->isKinematicObject() && colObj0->getActivationState() != ISLAND_SLEEPING)
+			{
+				colObj1->activate();
+			}
+			if (colObj1->isKinematicObject() && colObj1->getActivationState() != ISLAND_SLEEPING)
+			{
+				colObj0->activate();
+			}
+			if (dispatcher->needsResponse(colObj0,colObj1))
+			{
+				int islandId = getIslandId(manifold);
+				if (islandId >= 0)
+				{
+					m_unsortedManifolds.push_back(manifold);
+					m_manifoldStarts[m_islandOfRoot[islandId]+1]++;
+				}
+			}
+		}
+	}
+
+	for (island=0;island<numIslands;island++)
+	{
+		m_manifoldStarts[island+1] += m_manifoldStarts[island];
+	}
+	m_islandmanifold.resize(m_unsortedManifolds.size());
+	for (i=0;i<m_unsortedManifolds.size();i++)
+	{
+		btPersistentManifold* manifold = m_unsortedManifolds[i];
+		int island = m_islandOfRoot[getIslandId(manifold)];
+		//m_manifoldStarts[island] is used as fill pointer, restored below
+		m_islandmanifold[m_manifoldStarts[island]++] = manifold;
+	}
+	for (island=numIslands;island>0;island--)
+	{
+		m_manifoldStarts[island] = m_manifoldStarts[island-1];
+	}
+	m_manifoldStarts[0] = 0;
+}
+
+void	btSimulationIslandManager::processIslandsIncremental(IslandCallback* callback)
+{
+	int numIslands = m_islandRoots.size();
+	for (int island=0;island<numIslands;island++)
+	{
+		int startIslandIndex = m_islandStarts[island];
+		int numBodies = m_islandStarts[island+1]-startIslandIndex;
+
+		bool islandSleeping = true;
+		for (int idx=startIslandIndex;idx<startIslandIndex+numBodies;idx++)
+		{
+			if (m_islandBodies[idx]->isActive())
+			{
+				islandSleeping = false;
+				break;
+			}
+		}
+		if (islandSleeping)
+			continue;
+
+		int startManifold = m_manifoldStarts[island];
+		int numIslandManifolds = m_manifoldStarts[island+1]-startManifold;
+		callback->ProcessIsland(&m_islandBodies[startIslandIndex],numBodies,
+			numIslandManifolds ? &m_islandmanifold[startManifold] : 0,numIslandManifolds,m_islandRoots[island]);
+	}
+}
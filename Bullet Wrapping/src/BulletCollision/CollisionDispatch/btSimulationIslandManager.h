@@ -19,6 +19,8 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btUnionFind.h"
 #include "btCollisionCreateFunc.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btRadixSort.h"
+#include "LinearMath/btHashMap.h"
 #include "btCollisionObject.h"
 
 class btCollisionObject;
@@ -26,8 +28,45 @@ class btCollisionWorld;
 class btDispatcher;
 class btPersistentManifold;
 
+///key of an overlapping pair in the incremental island union set, both proxy uids in full
+class btIslandPairKey
+{
+	unsigned long long int	m_key;
+public:
+	btIslandPairKey(int uid0,int uid1)
+	{
+		if (uid0 > uid1)
+			btSwap(uid0,uid1);
+		m_key = ((unsigned long long int)(unsigned(uid0))<<32) | (unsigned long long int)(unsigned(uid1));
+	}
+
+	bool equals(const btIslandPairKey& other) const
+	{
+		return m_key == other.m_key;
+	}
+
+	// Thomas Wang's 64 bit integer hash
+	SIMD_FORCE_INLINE	unsigned int getHash()const
+	{
+		unsigned long long int key = m_key;
+		key = (~key) + (key << 21);
+		key = key ^ (key >> 24);
+		key = (key + (key << 3)) + (key << 8);
+		key = key ^ (key >> 14);
+		key = (key + (key << 2)) + (key << 4);
+		key = key ^ (key >> 28);
+		key = key + (key << 31);
+		return (unsigned int)(key ^ (key >> 32));
+	}
+};
+
 
 ///SimulationIslandManager creates and handles simulation islands, using btUnionFind
+///In incremental mode the union find persists across steps: only new overlapping pairs are united,
+///islands are grouped with a linear pass instead of sorting, and splits after pair or constraint
+///removal are deferred (see setSplitDelay) and done by rebuilding from scratch.
+///With btDispatcherInfo::m_deterministicOrder the islands are rebuilt every step and their manifolds are sorted by
+///broadphase uid instead of following the dispatcher manifold order.
 class btSimulationIslandManager
 {
 	btUnionFind m_unionFind;
@@ -36,6 +75,29 @@ class btSimulationIslandManager
 	btAlignedObjectArray<btCollisionObject* >  m_islandBodies;
 	
 	bool m_splitIslands;
+
+	//incremental island state
+	bool m_incrementalIslands;
+	bool m_needsRebuild;
+	bool m_needsSplit;
+	bool m_groupingDirty;
+	int	 m_splitDelay;
+	int	 m_stepsSinceSplit;
+	int	 m_numMergingPairs;
+	int	 m_numConstraintUnions;
+
+	btHashMap<btIslandPairKey,int>				m_unitedPairs;		//merging pairs already united in the persistent union find
+	btAlignedObjectArray<btCollisionObject*>	m_slotObjects;		//non-static objects, indexed by union find element
+	btAlignedObjectArray<int>					m_slotRoots;		//island root of each element at the last store
+	btAlignedObjectArray<int>					m_islandOfRoot;		//island index for root elements, -1 otherwise
+	btAlignedObjectArray<int>					m_islandRoots;
+	btAlignedObjectArray<int>					m_islandStarts;		//numIslands+1 offsets into m_islandBodies
+	btAlignedObjectArray<int>					m_manifoldStarts;	//numIslands+1 offsets into m_islandmanifold
+	btAlignedObjectArray<btPersistentManifold*>	m_unsortedManifolds;
+
+	btAlignedObjectArray<int>					m_islandManifoldKeys;	//island id + 1 of each manifold in m_islandmanifold
+	btRadixSort<btPersistentManifold*>			m_manifoldSorter;
+
 	
 public:
 	btSimulationIslandManager();
@@ -75,6 +137,56 @@ public:
 		m_splitIslands = doSplitIslands;
 	}
 
+	bool getIncrementalIslands() const
+	{
+		return m_incrementalIslands;
+	}
+	void setIncrementalIslands(bool incremental)
+	{
+		m_incrementalIslands = incremental;
+		m_needsRebuild = true;
+		m_islandBodies.resize(0);
+	}
+
+	///number of steps a possible island split (removed pair or constraint) is deferred, islands stay merged meanwhile
+	int getSplitDelay() const
+	{
+		return m_splitDelay;
+	}
+	void setSplitDelay(int steps)
+	{
+		m_splitDelay = steps;
+	}
+
+	///called by the dynamics world with the number of constraints that merged islands this step,
+	///fewer than the previous step means a constraint went to sleep. Removed constraints are
+	///reported through notifyConstraintRemoved, a removal and an addition in one step keep the count.
+	void notifyConstraintUnions(int numUnions)
+	{
+		if (numUnions < m_numConstraintUnions)
+			m_needsSplit = true;
+		m_numConstraintUnions = numUnions;
+	}
+
+	///called by the dynamics world when a constraint that may have merged islands is removed
+	void notifyConstraintRemoved()
+	{
+		m_needsSplit = true;
+	}
+
+private:
+
+	bool	isIncremental(const btCollisionWorld* colWorld) const;
+
+	void	updateActivationStateIncremental(btCollisionWorld* colWorld);
+	void	storeIslandActivationStateIncremental(btCollisionWorld* colWorld);
+	void	findUnionsIncremental(btCollisionWorld* colWorld,bool fullRebuild);
+	void	groupIslands();
+	void	buildIslandsIncremental(btDispatcher* dispatcher,btCollisionWorld* colWorld);
+	///groups m_islandmanifold by island with a stable counting sort, and in deterministic mode sorts each island with the deterministic predicate
+	void	sortIslandManifolds(int numElements,bool deterministic);
+	void	processIslandsIncremental(IslandCallback* callback);
+
 };
 
 #endif //BT_SIMULATION_ISLAND_MANAGER_H
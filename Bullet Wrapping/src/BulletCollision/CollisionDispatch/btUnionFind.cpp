@@ -49,16 +49,6 @@ void	btUnionFind::reset(int N)
 }
 
 
-class btUnionFindElementSortPredicate
-{
-	public:
-
-		bool operator() ( const btElement& lhs, const btElement& rhs )
-		{
-			return lhs.m_id < rhs.m_id;
-		}
-};
-
 ///this is a special operation, destroying the content of btUnionFind.
 ///it sorts the elements, based on island id, in order to make it easy to iterate over islands
 void	btUnionFind::sortIslands()
@@ -66,17 +56,18 @@ void	btUnionFind::sortIslands()
 
 	//first store the original body index, and islandId
 	int numElements = m_elements.size();
+	m_sortKeys.resize(numElements);
 	
 	for (int i=0;i<numElements;i++)
 	{
 		m_elements[i].m_id = find(i);
+		m_sortKeys[i] = m_elements[i].m_id;
 #ifndef STATIC_SIMULATION_ISLAND_OPTIMIZATION
 		m_elements[i].m_sz = i;
 #endif //STATIC_SIMULATION_ISLAND_OPTIMIZATION
 	}
 	
-	 // Sort the vector using predicate and std::sort
-	  //std::sort(m_elements.begin(), m_elements.end(), btUnionFindElementSortPredicate);
-	  m_elements.quickSort(btUnionFindElementSortPredicate());
+	//the island ids are element indices, so a counting sort groups the islands in linear time
+	m_sorter.sort(m_elements,m_sortKeys,numElements);
 
 }
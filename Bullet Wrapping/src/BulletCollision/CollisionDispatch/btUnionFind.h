@@ -17,6 +17,7 @@ subject to the following restrictions:
 #define BT_UNION_FIND_H
 
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btRadixSort.h"
 
 #define USE_PATH_COMPRESSION 1
 
@@ -36,6 +37,8 @@ class btUnionFind
   {
     private:
 		btAlignedObjectArray<btElement>	m_elements;
+		btAlignedObjectArray<int>		m_sortKeys;
+		btRadixSort<btElement>			m_sorter;
 
     public:
 	  
@@ -44,7 +47,8 @@ class btUnionFind
 
 	
 		//this is a special operation, destroying the content of btUnionFind.
-		//it sorts the elements, based on island id, in order to make it easy to iterate over islands
+		//it sorts the elements, based on island id, in order to make it easy to iterate over islands.
+		//The sort is stable, elements of one island keep their order.
 		void	sortIslands();
 
 	  void	reset(int N);
@@ -99,6 +103,18 @@ class btUnionFind
 #endif //USE_PATH_COMPRESSION
 		}
 
+		///links the larger root below the smaller one, so the root of each set is its smallest element,
+		///independent of the order of the unions
+		void uniteMinRoot(int p, int q)
+		{
+			int i = find(p), j = find(q);
+			if (i == j) 
+				return;
+			if (j < i)
+				btSwap(i,j);
+			m_elements[j].m_id = i; m_elements[i].m_sz += m_elements[j].m_sz; 
+		}
+
 		int find(int x)
 		{ 
 			//btAssert(x < m_N);
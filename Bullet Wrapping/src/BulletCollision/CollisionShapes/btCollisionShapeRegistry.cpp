@@ -0,0 +1,617 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btCollisionShapeRegistry.h"
+#include "btBoxShape.h"
+#include "btSphereShape.h"
+#include "btCapsuleShape.h"
+#include "btCylinderShape.h"
+#include "btConeShape.h"
+#include "btConvexHullShape.h"
+#include "btConvexPolyhedron.h"
+#include "btUniformScalingShape.h"
+#include "btCompoundShape.h"
+#include "BulletCollision/BroadphaseCollision/btDbvt.h"
+
+///FNV-1a, see http://www.isthe.com/chongo/tech/comp/fnv/
+static unsigned int	hashBytes(unsigned int hash,const void* data,int numBytes)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (int i=0;i<numBytes;i++)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static unsigned int	hashInt(unsigned int hash,int value)
+{
+	return hashBytes(hash,&value,sizeof(int));
+}
+
+static unsigned int	hashScalar(unsigned int hash,btScalar value)
+{
+	//-0 and 0 compare equal, so they need the same hash
+	value += btScalar(0.);
+	return hashBytes(hash,&value,sizeof(btScalar));
+}
+
+static unsigned int	hashPointer(unsigned int hash,const void* pointer)
+{
+	return hashBytes(hash,&pointer,sizeof(void*));
+}
+
+static unsigned int	hashVector3(unsigned int hash,const btScalar* v)
+{
+	hash = hashScalar(hash,v[0]);
+	hash = hashScalar(hash,v[1]);
+	return hashScalar(hash,v[2]);
+}
+
+///the w component is not used by the shapes, and not always initialized
+static bool	isEqualVector3(const btScalar* a,const btScalar* b)
+{
+	return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+static bool	isEqualTransform(const btTransform& a,const btTransform& b)
+{
+	return isEqualVector3(a.getBasis()[0],b.getBasis()[0]) &&
+		isEqualVector3(a.getBasis()[1],b.getBasis()[1]) &&
+		isEqualVector3(a.getBasis()[2],b.getBasis()[2]) &&
+		isEqualVector3(a.getOrigin(),b.getOrigin());
+}
+
+static bool	isDeduplicatedType(int shapeType)
+{
+	switch (shapeType)
+	{
+	case BOX_SHAPE_PROXYTYPE:
+	case SPHERE_SHAPE_PROXYTYPE:
+	case CAPSULE_SHAPE_PROXYTYPE:
+	case CYLINDER_SHAPE_PROXYTYPE:
+	case CONE_SHAPE_PROXYTYPE:
+	case CONVEX_HULL_SHAPE_PROXYTYPE:
+	case UNIFORM_SCALING_SHAPE_PROXYTYPE:
+	case COMPOUND_SHAPE_PROXYTYPE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static unsigned int	hashCommon(int shapeType,const void* userPointer,btScalar margin,const btVector3& scaling)
+{
+	unsigned int hash = 2166136261u;
+	hash = hashInt(hash,shapeType);
+	hash = hashPointer(hash,userPointer);
+	hash = hashScalar(hash,margin);
+	return hashVector3(hash,scaling);
+}
+
+static unsigned int	hashConvexHullPoints(unsigned int hash,const btScalar* points,int numPoints,int stride,bool polyhedralFeatures)
+{
+	hash = hashInt(hash,polyhedralFeatures ? 1 : 0);
+	hash = hashInt(hash,numPoints);
+	const unsigned char* pointer = (const unsigned char*)points;
+	for (int i=0;i<numPoints;i++)
+	{
+		hash = hashVector3(hash,(const btScalar*)pointer);
+		pointer += stride;
+	}
+	return hash;
+}
+
+static unsigned int	hashShape(const btCollisionShape* shape)
+{
+	int shapeType = shape->getShapeType();
+	unsigned int hash = hashCommon(shapeType,shape->getUserPointer(),shape->getMargin(),shape->getLocalScaling());
+	switch (shapeType)
+	{
+	case BOX_SHAPE_PROXYTYPE:
+		//initializePolyhedralFeatures changes the box collision algorithm, like for the hull
+		hash = hashInt(hash,((const btBoxShape*)shape)->getConvexPolyhedron() != 0 ? 1 : 0);
+		return hashVector3(hash,((const btConvexInternalShape*)shape)->getImplicitShapeDimensions());
+	case SPHERE_SHAPE_PROXYTYPE:
+		//the sphere only sets the x dimension
+		return hashScalar(hash,((const btConvexInternalShape*)shape)->getImplicitShapeDimensions().getX());
+	case CAPSULE_SHAPE_PROXYTYPE:
+		hash = hashInt(hash,((const btCapsuleShape*)shape)->getUpAxis());
+		return hashVector3(hash,((const btConvexInternalShape*)shape)->getImplicitShapeDimensions());
+	case CYLINDER_SHAPE_PROXYTYPE:
+		hash = hashInt(hash,((const btCylinderShape*)shape)->getUpAxis());
+		return hashVector3(hash,((const btConvexInternalShape*)shape)->getImplicitShapeDimensions());
+	case CONE_SHAPE_PROXYTYPE:
+		{
+			const btConeShape* cone = (const btConeShape*)shape;
+			hash = hashInt(hash,cone->getConeUpIndex());
+			hash = hashScalar(hash,cone->getRadius());
+			return hashScalar(hash,cone->getHeight());
+		}
+	case CONVEX_HULL_SHAPE_PROXYTYPE:
+		{
+			const btConvexHullShape* hull = (const btConvexHullShape*)shape;
+			const btScalar* points = hull->getNumPoints() ? (const btScalar*)hull->getUnscaledPoints() : 0;
+			return hashConvexHullPoints(hash,points,hull->getNumPoints(),sizeof(btVector3),hull->getConvexPolyhedron() != 0);
+		}
+	case UNIFORM_SCALING_SHAPE_PROXYTYPE:
+		{
+			const btUniformScalingShape* scalingShape = (const btUniformScalingShape*)shape;
+			hash = hashPointer(hash,scalingShape->getChildShape());
+			return hashScalar(hash,scalingShape->getUniformScalingFactor());
+		}
+	case COMPOUND_SHAPE_PROXYTYPE:
+		{
+			const btCompoundShape* compound = (const btCompoundShape*)shape;
+			hash = hashInt(hash,compound->getNumChildShapes());
+			for (int i=0;i<compound->getNumChildShapes();i++)
+			{
+				const btTransform& childTransform = compound->getChildTransform(i);
+				hash = hashPointer(hash,compound->getChildShape(i));
+				hash = hashVector3(hash,childTransform.getBasis()[0]);
+				hash = hashVector3(hash,childTransform.getBasis()[1]);
+				hash = hashVector3(hash,childTransform.getBasis()[2]);
+				hash = hashVector3(hash,childTransform.getOrigin());
+			}
+			return hash;
+		}
+	default:
+		return hash;
+	}
+}
+
+///shapeA and shapeB have one of the deduplicated types
+static bool	isEqualShape(const btCollisionShape* shapeA,const btCollisionShape* shapeB)
+{
+	int shapeType = shapeA->getShapeType();
+	if (shapeType != shapeB->getShapeType() ||
+		shapeA->getUserPointer() != shapeB->getUserPointer() ||
+		shapeA->getMargin() != shapeB->getMargin() ||
+		!isEqualVector3(shapeA->getLocalScaling(),shapeB->getLocalScaling()))
+	{
+		return false;
+	}
+
+	switch (shapeType)
+	{
+	case BOX_SHAPE_PROXYTYPE:
+		return (((const btBoxShape*)shapeA)->getConvexPolyhedron() != 0) == (((const btBoxShape*)shapeB)->getConvexPolyhedron() != 0) &&
+			isEqualVector3(((const btConvexInternalShape*)shapeA)->getImplicitShapeDimensions(),((const btConvexInternalShape*)shapeB)->getImplicitShapeDimensions());
+	case SPHERE_SHAPE_PROXYTYPE:
+		return ((const btConvexInternalShape*)shapeA)->getImplicitShapeDimensions().getX() == ((const btConvexInternalShape*)shapeB)->getImplicitShapeDimensions().getX();
+	case CAPSULE_SHAPE_PROXYTYPE:
+		return ((const btCapsuleShape*)shapeA)->getUpAxis() == ((const btCapsuleShape*)shapeB)->getUpAxis() &&
+			isEqualVector3(((const btConvexInternalShape*)shapeA)->getImplicitShapeDimensions(),((const btConvexInternalShape*)shapeB)->getImplicitShapeDimensions());
+	case CYLINDER_SHAPE_PROXYTYPE:
+		return ((const btCylinderShape*)shapeA)->getUpAxis() == ((const btCylinderShape*)shapeB)->getUpAxis() &&
+			isEqualVector3(((const btConvexInternalShape*)shapeA)->getImplicitShapeDimensions(),((const btConvexInternalShape*)shapeB)->getImplicitShapeDimensions());
+	case CONE_SHAPE_PROXYTYPE:
+		{
+			const btConeShape* coneA = (const btConeShape*)shapeA;
+			const btConeShape* coneB = (const btConeShape*)shapeB;
+			return coneA->getConeUpIndex() == coneB->getConeUpIndex() && coneA->getRadius() == coneB->getRadius() && coneA->getHeight() == coneB->getHeight();
+		}
+	case CONVEX_HULL_SHAPE_PROXYTYPE:
+		{
+			const btConvexHullShape* hullA = (const btConvexHullShape*)shapeA;
+			const btConvexHullShape* hullB = (const btConvexHullShape*)shapeB;
+			if (hullA->getNumPoints() != hullB->getNumPoints() || (hullA->getConvexPolyhedron() != 0) != (hullB->getConvexPolyhedron() != 0))
+			{
+				return false;
+			}
+			for (int i=0;i<hullA->getNumPoints();i++)
+			{
+				if (!isEqualVector3(hullA->getUnscaledPoints()[i],hullB->getUnscaledPoints()[i]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	case UNIFORM_SCALING_SHAPE_PROXYTYPE:
+		{
+			const btUniformScalingShape* scalingShapeA = (const btUniformScalingShape*)shapeA;
+			const btUniformScalingShape* scalingShapeB = (const btUniformScalingShape*)shapeB;
+			return scalingShapeA->getChildShape() == scalingShapeB->getChildShape() && scalingShapeA->getUniformScalingFactor() == scalingShapeB->getUniformScalingFactor();
+		}
+	case COMPOUND_SHAPE_PROXYTYPE:
+		{
+			const btCompoundShape* compoundA = (const btCompoundShape*)shapeA;
+			const btCompoundShape* compoundB = (const btCompoundShape*)shapeB;
+			if (compoundA->getNumChildShapes() != compoundB->getNumChildShapes())
+			{
+				return false;
+			}
+			for (int i=0;i<compoundA->getNumChildShapes();i++)
+			{
+				if (compoundA->getChildShape(i) != compoundB->getChildShape(i) || !isEqualTransform(compoundA->getChildTransform(i),compoundB->getChildTransform(i)))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	default:
+		return false;
+	}
+}
+
+static int	calculatePolyhedronSize(const btConvexPolyhedron* polyhedron)
+{
+	if (!polyhedron)
+		return 0;
+	int size = sizeof(btConvexPolyhedron) + (polyhedron->m_vertices.size() + polyhedron->m_uniqueEdges.size()) * int(sizeof(btVector3));
+	for (int i=0;i<polyhedron->m_faces.size();i++)
+	{
+		size += sizeof(btFace) + polyhedron->m_faces[i].m_indices.size() * int(sizeof(int));
+	}
+	return size;
+}
+
+int	btCollisionShapeRegistry::calculateShapeSize(const btCollisionShape* shape)
+{
+	switch (shape->getShapeType())
+	{
+	case BOX_SHAPE_PROXYTYPE:
+		return sizeof(btBoxShape) + calculatePolyhedronSize(((const btBoxShape*)shape)->getConvexPolyhedron());
+	case SPHERE_SHAPE_PROXYTYPE:
+		return sizeof(btSphereShape);
+	case CAPSULE_SHAPE_PROXYTYPE:
+		return sizeof(btCapsuleShape);
+	case CYLINDER_SHAPE_PROXYTYPE:
+		return sizeof(btCylinderShape);
+	case CONE_SHAPE_PROXYTYPE:
+		return sizeof(btConeShape);
+	case CONVEX_HULL_SHAPE_PROXYTYPE:
+		{
+			const btConvexHullShape* hull = (const btConvexHullShape*)shape;
+			return sizeof(btConvexHullShape) + hull->getNumPoints() * int(sizeof(btVector3)) + calculatePolyhedronSize(hull->getConvexPolyhedron());
+		}
+	case UNIFORM_SCALING_SHAPE_PROXYTYPE:
+		return sizeof(btUniformScalingShape);
+	case COMPOUND_SHAPE_PROXYTYPE:
+		{
+			const btCompoundShape* compound = (const btCompoundShape*)shape;
+			int numChildren = compound->getNumChildShapes();
+			int size = sizeof(btCompoundShape) + numChildren * int(sizeof(btCompoundShapeChild));
+			if (compound->getDynamicAabbTree() && numChildren)
+			{
+				size += sizeof(btDbvt) + (2*numChildren-1) * int(sizeof(btDbvtNode));
+			}
+			return size;
+		}
+	default:
+		return 0;
+	}
+}
+
+
+btCollisionShapeRegistry::btCollisionShapeRegistry()
+	:m_firstFreeEntry(-1),
+	m_numShapes(0),
+	m_numReferences(0),
+	m_numDeduplicated(0),
+	m_memoryUsed(0),
+	m_memorySaved(0)
+{
+}
+
+btCollisionShapeRegistry::~btCollisionShapeRegistry()
+{
+	///compound and uniform scaling shapes don't delete their children, so the shapes can be deleted in any order
+	for (int i=0;i<m_entries.size();i++)
+	{
+		if (m_entries[i].m_shape)
+		{
+			delete m_entries[i].m_shape;
+		}
+	}
+}
+
+int	btCollisionShapeRegistry::findEntry(const btCollisionShape* shape) const
+{
+	const int* entryIndex = m_entryByShape.find(btHashPtr(shape));
+	return entryIndex ? *entryIndex : -1;
+}
+
+int	btCollisionShapeRegistry::findEqualEntry(const btCollisionShape* shape,unsigned int hash) const
+{
+	const int* firstEntry = m_firstEntryByHash.find(btHashInt(int(hash)));
+	for (int i = firstEntry ? *firstEntry : -1;i>=0;i=m_entries[i].m_next)
+	{
+		if (m_entries[i].m_hash == hash && isEqualShape(m_entries[i].m_shape,shape))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+int	btCollisionShapeRegistry::findConvexHullEntry(const btScalar* points,int numPoints,int stride,btScalar margin,bool polyhedralFeatures,unsigned int hash) const
+{
+	const int* firstEntry = m_firstEntryByHash.find(btHashInt(int(hash)));
+	for (int i = firstEntry ? *firstEntry : -1;i>=0;i=m_entries[i].m_next)
+	{
+		const btCollisionShape* shape = m_entries[i].m_shape;
+		if (m_entries[i].m_hash != hash || shape->getShapeType() != CONVEX_HULL_SHAPE_PROXYTYPE ||
+			shape->getUserPointer() || shape->getMargin() != margin || !isEqualVector3(shape->getLocalScaling(),btVector3(1,1,1)))
+		{
+			continue;
+		}
+		const btConvexHullShape* hull = (const btConvexHullShape*)shape;
+		if (hull->getNumPoints() != numPoints || (hull->getConvexPolyhedron() != 0) != polyhedralFeatures)
+		{
+			continue;
+		}
+		const unsigned char* pointer = (const unsigned char*)points;
+		int j;
+		for (j=0;j<numPoints;j++)
+		{
+			if (!isEqualVector3(hull->getUnscaledPoints()[j],(const btScalar*)pointer))
+				break;
+			pointer += stride;
+		}
+		if (j == numPoints)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+btCollisionShape*	btCollisionShapeRegistry::addEntry(btCollisionShape* shape,unsigned int hash)
+{
+	int entryIndex = m_firstFreeEntry;
+	if (entryIndex >= 0)
+	{
+		m_firstFreeEntry = m_entries[entryIndex].m_next;
+	} else
+	{
+		entryIndex = m_entries.size();
+		m_entries.expand();
+	}
+
+	btShapeEntry& entry = m_entries[entryIndex];
+	entry.m_shape = shape;
+	entry.m_hash = hash;
+	entry.m_refCount = 1;
+	entry.m_sizeInBytes = calculateShapeSize(shape);
+	entry.m_next = -1;
+	if (isDeduplicatedType(shape->getShapeType()))
+	{
+		const int* firstEntry = m_firstEntryByHash.find(btHashInt(int(hash)));
+		entry.m_next = firstEntry ? *firstEntry : -1;
+		m_firstEntryByHash.insert(btHashInt(int(hash)),entryIndex);
+	}
+	m_entryByShape.insert(btHashPtr(shape),entryIndex);
+
+	m_numShapes++;
+	m_numReferences++;
+	m_memoryUsed += entry.m_sizeInBytes;
+	return shape;
+}
+
+btCollisionShape*	btCollisionShapeRegistry::reuseEntry(int entryIndex)
+{
+	btShapeEntry& entry = m_entries[entryIndex];
+	entry.m_refCount++;
+	m_numReferences++;
+	m_numDeduplicated++;
+	m_memorySaved += entry.m_sizeInBytes;
+	return entry.m_shape;
+}
+
+void	btCollisionShapeRegistry::removeEntry(int entryIndex)
+{
+	btShapeEntry& entry = m_entries[entryIndex];
+	btCollisionShape* shape = entry.m_shape;
+
+	if (isDeduplicatedType(shape->getShapeType()))
+	{
+		btHashInt key(int(entry.m_hash));
+		int* firstEntry = m_firstEntryByHash.find(key);
+		btAssert(firstEntry);
+		if (*firstEntry == entryIndex)
+		{
+			if (entry.m_next >= 0)
+			{
+				*firstEntry = entry.m_next;
+			} else
+			{
+				m_firstEntryByHash.remove(key);
+			}
+		} else
+		{
+			int previous = *firstEntry;
+			while (m_entries[previous].m_next != entryIndex)
+			{
+				previous = m_entries[previous].m_next;
+			}
+			m_entries[previous].m_next = entry.m_next;
+		}
+	}
+	m_entryByShape.remove(btHashPtr(shape));
+
+	m_numShapes--;
+	m_memoryUsed -= entry.m_sizeInBytes;
+
+	entry.m_shape = 0;
+	entry.m_next = m_firstFreeEntry;
+	m_firstFreeEntry = entryIndex;
+
+	releaseChildShapes(shape);
+	delete shape;
+}
+
+void	btCollisionShapeRegistry::internChildShapes(btCollisionShape* shape)
+{
+	if (shape->getShapeType() != COMPOUND_SHAPE_PROXYTYPE)
+		return;
+
+	btCompoundShape* compound = (btCompoundShape*)shape;
+	btCompoundShapeChild* children = compound->getChildList();
+	for (int i=0;i<compound->getNumChildShapes();i++)
+	{
+		btCollisionShape* childShape = children[i].m_childShape;
+		if (isRegistered(childShape))
+		{
+			addReference(childShape);
+			continue;
+		}
+		///an equal child has the same aabb, so the child can be replaced without updating the aabb tree of the compound
+		btCollisionShape* internedShape = internShape(childShape);
+		for (int j=i;j<compound->getNumChildShapes();j++)
+		{
+			if (children[j].m_childShape == childShape)
+			{
+				children[j].m_childShape = internedShape;
+			}
+		}
+	}
+}
+
+void	btCollisionShapeRegistry::releaseChildShapes(btCollisionShape* shape)
+{
+	if (shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
+	{
+		btCompoundShape* compound = (btCompoundShape*)shape;
+		for (int i=0;i<compound->getNumChildShapes();i++)
+		{
+			releaseShape(compound->getChildShape(i));
+		}
+	} else if (shape->getShapeType() == UNIFORM_SCALING_SHAPE_PROXYTYPE)
+	{
+		releaseShape(((btUniformScalingShape*)shape)->getChildShape());
+	}
+}
+
+btCollisionShape*	btCollisionShapeRegistry::internShape(btCollisionShape* shape)
+{
+	int entryIndex = findEntry(shape);
+	if (entryIndex >= 0)
+	{
+		addReference(shape);
+		return shape;
+	}
+
+	if (shape->getShapeType() == UNIFORM_SCALING_SHAPE_PROXYTYPE)
+	{
+		btUniformScalingShape* scalingShape = (btUniformScalingShape*)shape;
+		btConvexShape* childShape = scalingShape->getChildShape();
+		if (isRegistered(childShape))
+		{
+			addReference(childShape);
+		} else
+		{
+			btConvexShape* internedShape = (btConvexShape*)internShape(childShape);
+			if (internedShape != childShape)
+			{
+				///the child of a btUniformScalingShape can't be replaced, so the shape is replaced instead
+				btUniformScalingShape* replacement = new btUniformScalingShape(internedShape,scalingShape->getUniformScalingFactor());
+				replacement->setUserPointer(scalingShape->getUserPointer());
+				delete scalingShape;
+				shape = replacement;
+			}
+		}
+	} else
+	{
+		internChildShapes(shape);
+	}
+
+	unsigned int hash = hashShape(shape);
+	if (isDeduplicatedType(shape->getShapeType()))
+	{
+		entryIndex = findEqualEntry(shape,hash);
+		if (entryIndex >= 0)
+		{
+			releaseChildShapes(shape);
+			delete shape;
+			return reuseEntry(entryIndex);
+		}
+	}
+	return addEntry(shape,hash);
+}
+
+btConvexHullShape*	btCollisionShapeRegistry::internConvexHullShape(const btScalar* points,int numPoints,int stride,btScalar margin,bool polyhedralFeatures)
+{
+	unsigned int hash = hashCommon(CONVEX_HULL_SHAPE_PROXYTYPE,0,margin,btVector3(1,1,1));
+	hash = hashConvexHullPoints(hash,points,numPoints,stride,polyhedralFeatures);
+
+	int entryIndex = findConvexHullEntry(points,numPoints,stride,margin,polyhedralFeatures,hash);
+	if (entryIndex >= 0)
+	{
+		return (btConvexHullShape*)reuseEntry(entryIndex);
+	}
+
+	btConvexHullShape* hull = new btConvexHullShape(points,numPoints,stride);
+	hull->setMargin(margin);
+	if (polyhedralFeatures)
+	{
+		hull->initializePolyhedralFeatures();
+	}
+	///the hash changes when the polyhedral features couldn't be initialized
+	addEntry(hull,hashShape(hull));
+	return hull;
+}
+
+btCollisionShape*	btCollisionShapeRegistry::internUniformScaledShape(btConvexShape* shape,btScalar scale)
+{
+	btConvexShape* internedShape = (btConvexShape*)internShape(shape);
+	if (scale == btScalar(1.))
+	{
+		return internedShape;
+	}
+	btCollisionShape* scalingShape = internShape(new btUniformScalingShape(internedShape,scale));
+	///the scaling shape holds its own reference to the interned shape
+	releaseShape(internedShape);
+	return scalingShape;
+}
+
+void	btCollisionShapeRegistry::addReference(btCollisionShape* shape)
+{
+	int entryIndex = findEntry(shape);
+	btAssert(entryIndex >= 0);
+	if (entryIndex >= 0)
+	{
+		m_entries[entryIndex].m_refCount++;
+		m_numReferences++;
+		m_memorySaved += m_entries[entryIndex].m_sizeInBytes;
+	}
+}
+
+bool	btCollisionShapeRegistry::releaseShape(btCollisionShape* shape)
+{
+	int entryIndex = findEntry(shape);
+	if (entryIndex < 0)
+	{
+		return false;
+	}
+	m_numReferences--;
+	if (--m_entries[entryIndex].m_refCount)
+	{
+		m_memorySaved -= m_entries[entryIndex].m_sizeInBytes;
+	} else
+	{
+		removeEntry(entryIndex);
+	}
+	return true;
+}
+
+int	btCollisionShapeRegistry::getReferenceCount(const btCollisionShape* shape) const
+{
+	int entryIndex = findEntry(shape);
+	return entryIndex >= 0 ? m_entries[entryIndex].m_refCount : 0;
+}
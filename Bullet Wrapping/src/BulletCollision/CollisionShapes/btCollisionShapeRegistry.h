@@ -0,0 +1,133 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_COLLISION_SHAPE_REGISTRY_H
+#define BT_COLLISION_SHAPE_REGISTRY_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btHashMap.h"
+#include "btCollisionMargin.h"
+
+class btCollisionShape;
+class btConvexShape;
+class btConvexHullShape;
+
+///btCollisionShapeRegistry interns collision shapes: equal shapes are replaced by a single reference counted instance.
+///Two shapes are equal when they have the same type, geometry, margin, local scaling and user pointer.
+///Boxes, spheres, capsules, cylinders, cones, convex hulls, uniform scaling shapes and compounds are deduplicated,
+///other shapes, such as triangle meshes, are only reference counted.
+///Interned shapes are shared, so they must not be modified afterwards. The registry is not thread safe.
+class	btCollisionShapeRegistry
+{
+protected:
+
+	struct	btShapeEntry
+	{
+		btCollisionShape*	m_shape;
+		unsigned int		m_hash;
+		int					m_refCount;
+		///next entry with the same hash, or the next free entry
+		int					m_next;
+		int					m_sizeInBytes;
+	};
+
+	btAlignedObjectArray<btShapeEntry>	m_entries;
+	int		m_firstFreeEntry;
+	btHashMap<btHashInt,int>	m_firstEntryByHash;
+	btHashMap<btHashPtr,int>	m_entryByShape;
+
+	int		m_numShapes;
+	int		m_numReferences;
+	int		m_numDeduplicated;
+	int		m_memoryUsed;
+	int		m_memorySaved;
+
+	int		findEntry(const btCollisionShape* shape) const;
+	int		findEqualEntry(const btCollisionShape* shape,unsigned int hash) const;
+	int		findConvexHullEntry(const btScalar* points,int numPoints,int stride,btScalar margin,bool polyhedralFeatures,unsigned int hash) const;
+	btCollisionShape*	addEntry(btCollisionShape* shape,unsigned int hash);
+	///adds a reference to the shape of the entry, in place of an equal shape
+	btCollisionShape*	reuseEntry(int entryIndex);
+	void	removeEntry(int entryIndex);
+	void	internChildShapes(btCollisionShape* shape);
+	void	releaseChildShapes(btCollisionShape* shape);
+
+public:
+
+	btCollisionShapeRegistry();
+
+	///deletes all shapes that are still registered
+	virtual ~btCollisionShapeRegistry();
+
+	///takes ownership of shape, and returns the registered shape that is equal to it, with one reference for the caller.
+	///When an equal shape was registered before, shape is deleted. The child shapes of compound and uniform scaling shapes are interned as well,
+	///the compound or uniform scaling shape holds a reference to each of its children. Interning a registered shape adds a reference to it.
+	btCollisionShape*	internShape(btCollisionShape* shape);
+
+	///returns a convex hull of the points, with one reference for the caller. The hull, and its polyhedral features when requested,
+	///are only built when there is no equal hull yet. The points are 3 consecutive btScalar, stride bytes apart, like in the btConvexHullShape constructor.
+	btConvexHullShape*	internConvexHullShape(const btScalar* points,int numPoints,int stride = sizeof(btVector3),btScalar margin = CONVEX_DISTANCE_MARGIN,bool polyhedralFeatures = false);
+
+	///takes ownership of shape like internShape, and returns a btUniformScalingShape around it, so differently scaled instances share one shape.
+	///Returns the interned shape itself when scale is 1.
+	btCollisionShape*	internUniformScaledShape(btConvexShape* shape,btScalar scale);
+
+	void	addReference(btCollisionShape* shape);
+
+	///removes a reference, and deletes the shape when it was the last one. Returns false when the shape is not registered.
+	bool	releaseShape(btCollisionShape* shape);
+
+	bool	isRegistered(const btCollisionShape* shape) const
+	{
+		return findEntry(shape) >= 0;
+	}
+
+	int		getReferenceCount(const btCollisionShape* shape) const;
+
+	///number of distinct registered shapes
+	int		getNumShapes() const
+	{
+		return m_numShapes;
+	}
+
+	int		getNumReferences() const
+	{
+		return m_numReferences;
+	}
+
+	///number of shapes that were replaced by an equal registered shape, or not built at all by internConvexHullShape
+	int		getNumDeduplicated() const
+	{
+		return m_numDeduplicated;
+	}
+
+	///estimated bytes held by the registered shapes of the deduplicated types, including hull points and polyhedral features
+	int		getMemoryUsed() const
+	{
+		return m_memoryUsed;
+	}
+
+	///estimated bytes saved by sharing, counting each reference beyond the first as a shape of its own
+	int		getMemorySaved() const
+	{
+		return m_memorySaved;
+	}
+
+	///estimated bytes used by a shape of one of the deduplicated types, not counting its child shapes. Returns 0 for other shapes.
+	static int	calculateShapeSize(const btCollisionShape* shape);
+};
+
+#endif //BT_COLLISION_SHAPE_REGISTRY_H
@@ -20,6 +20,7 @@ subject to the following restrictions:
 #include "btCapsuleShape.h"
 #include "btConvexHullShape.h"
 #include "btConvexPointCloudShape.h"
+#include "btConvexShapeSupport.h"
 
 ///not supported on IBM SDK, until we fix the alignment of btVector3
 #if defined (__CELLOS_LV2__) && defined (__SPU__)
@@ -63,11 +64,10 @@ void btConvexShape::project(const btTransform& trans, const btVector3& dir, floa
 
 static btVector3 convexHullSupport (const btVector3& localDirOrg, const btVector3* points, int numPoints, const btVector3& localScaling)
 {	
+#if defined (__CELLOS_LV2__) && defined (__SPU__)
 
 	btVector3 vec = localDirOrg * localScaling;
 
-#if defined (__CELLOS_LV2__) && defined (__SPU__)
-
 	btVector3 localDir = vec;
 
 	vec_float4 v_distMax = {-FLT_MAX,0,0,0};
@@ -108,23 +108,7 @@ static btVector3 convexHullSupport (const btVector3& localDirOrg, const btVector
 	const btVector3& supVec= points[ptIndex] * localScaling;
 	return supVec;
 #else
-
-	btScalar newDot,maxDot = btScalar(-BT_LARGE_FLOAT);
-	int ptIndex = -1;
-
-	for (int i=0;i<numPoints;i++)
-	{
-
-		newDot = vec.dot(points[i]);
-		if (newDot > maxDot)
-		{
-			maxDot = newDot;
-			ptIndex = i;
-		}
-	}
-	btAssert(ptIndex >= 0);
-	btVector3 supVec = points[ptIndex] * localScaling;
-	return supVec;
+	return btConvexPointsSupport(localDirOrg, points, numPoints, localScaling);
 #endif //__SPU__
 }
 
@@ -134,16 +118,11 @@ btVector3 btConvexShape::localGetSupportVertexWithoutMarginNonVirtual (const btV
 	{
     case SPHERE_SHAPE_PROXYTYPE:
 	{
-		return btVector3(0,0,0);
+		return btSphereShapeSupport::supportWithoutMargin(this,localDir);
     }
 	case BOX_SHAPE_PROXYTYPE:
 	{
-		btBoxShape* convexShape = (btBoxShape*)this;
-		const btVector3& halfExtents = convexShape->getImplicitShapeDimensions();
-
-		return btVector3(btFsels(localDir.x(), halfExtents.x(), -halfExtents.x()),
-			btFsels(localDir.y(), halfExtents.y(), -halfExtents.y()),
-			btFsels(localDir.z(), halfExtents.z(), -halfExtents.z()));
+		return btBoxShapeSupport::supportWithoutMargin(this,localDir);
 	}
 	case TRIANGLE_SHAPE_PROXYTYPE:
 	{
@@ -156,118 +135,11 @@ btVector3 btConvexShape::localGetSupportVertexWithoutMarginNonVirtual (const btV
 	}
 	case CYLINDER_SHAPE_PROXYTYPE:
 	{
-		btCylinderShape* cylShape = (btCylinderShape*)this;
-		//mapping of halfextents/dimension onto radius/height depends on how cylinder local orientation is (upAxis)
-
-		btVector3 halfExtents = cylShape->getImplicitShapeDimensions();
-		btVector3 v(localDir.getX(),localDir.getY(),localDir.getZ());
-		int cylinderUpAxis = cylShape->getUpAxis();
-		int XX(1),YY(0),ZZ(2);
-
-		switch (cylinderUpAxis)
-		{
-		case 0:
-		{
-			XX = 1;
-			YY = 0;
-			ZZ = 2;
-		}
-		break;
-		case 1:
-		{
-			XX = 0;
-			YY = 1;
-			ZZ = 2;	
-		}
-		break;
-		case 2:
-		{
-			XX = 0;
-			YY = 2;
-			ZZ = 1;
-			
-		}
-		break;
-		default:
-			btAssert(0);
-		break;
-		};
-
-		btScalar radius = halfExtents[XX];
-		btScalar halfHeight = halfExtents[cylinderUpAxis];
-
-		btVector3 tmp;
-		btScalar d ;
-
-		btScalar s = btSqrt(v[XX] * v[XX] + v[ZZ] * v[ZZ]);
-		if (s != btScalar(0.0))
-		{
-			d = radius / s;  
-			tmp[XX] = v[XX] * d;
-			tmp[YY] = v[YY] < 0.0 ? -halfHeight : halfHeight;
-			tmp[ZZ] = v[ZZ] * d;
-			return btVector3(tmp.getX(),tmp.getY(),tmp.getZ());
-		} else {
-			tmp[XX] = radius;
-			tmp[YY] = v[YY] < 0.0 ? -halfHeight : halfHeight;
-			tmp[ZZ] = btScalar(0.0);
-			return btVector3(tmp.getX(),tmp.getY(),tmp.getZ());
-		}
+		return btCylinderShapeSupport::supportWithoutMargin(this,localDir);
 	}
 	case CAPSULE_SHAPE_PROXYTYPE:
 	{
-		btVector3 vec0(localDir.getX(),localDir.getY(),localDir.getZ());
-
-		btCapsuleShape* capsuleShape = (btCapsuleShape*)this;
-		btScalar halfHeight = capsuleShape->getHalfHeight();
-		int capsuleUpAxis = capsuleShape->getUpAxis();
-
-		btScalar radius = capsuleShape->getRadius();
-		btVector3 supVec(0,0,0);
-
-		btScalar maxDot(btScalar(-BT_LARGE_FLOAT));
-
-		btVector3 vec = vec0;
-		btScalar lenSqr = vec.length2();
-		if (lenSqr < btScalar(0.0001))
-		{
-			vec.setValue(1,0,0);
-		} else
-		{
-			btScalar rlen = btScalar(1.) / btSqrt(lenSqr );
-			vec *= rlen;
-		}
-		btVector3 vtx;
-		btScalar newDot;
-		{
-			btVector3 pos(0,0,0);
-			pos[capsuleUpAxis] = halfHeight;
-
-			//vtx = pos +vec*(radius);
-			vtx = pos +vec*capsuleShape->getLocalScalingNV()*(radius) - vec * capsuleShape->getMarginNV();
-			newDot = vec.dot(vtx);
-			
-
-			if (newDot > maxDot)
-			{
-				maxDot = newDot;
-				supVec = vtx;
-			}
-		}
-		{
-			btVector3 pos(0,0,0);
-			pos[capsuleUpAxis] = -halfHeight;
-
-			//vtx = pos +vec*(radius);
-			vtx = pos +vec*capsuleShape->getLocalScalingNV()*(radius) - vec * capsuleShape->getMarginNV();
-			newDot = vec.dot(vtx);
-			if (newDot > maxDot)
-			{
-				maxDot = newDot;
-				supVec = vtx;
-			}
-		}
-		return btVector3(supVec.getX(),supVec.getY(),supVec.getZ());	
+		return btCapsuleShapeSupport::supportWithoutMargin(this,localDir);
 	}
 	case CONVEX_POINT_CLOUD_SHAPE_PROXYTYPE:
 	{
@@ -0,0 +1,217 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_CONVEX_SHAPE_SUPPORT_H
+#define BT_CONVEX_SHAPE_SUPPORT_H
+
+#include "btConvexShape.h"
+#include "btBoxShape.h"
+#include "btCylinderShape.h"
+#include "btCapsuleShape.h"
+#include "btConvexHullShape.h"
+
+///The support policies compute the supporting vertex without margin of one shape type, in local space.
+///btConvexShape::localGetSupportVertexWithoutMarginNonVirtual switches on the shape type and uses them,
+///a GJK kernel that knows the shape types at compile time calls them directly, see btGjkPairDetector::getClosestPointsKernel.
+///Both give bit identical results.
+
+///any convex shape, using the switch on the shape type
+struct btConvexShapeSupport
+{
+	static SIMD_FORCE_INLINE btVector3	supportWithoutMargin(const btConvexShape* shape,const btVector3& localDir)
+	{
+		return shape->localGetSupportVertexWithoutMarginNonVirtual(localDir);
+	}
+};
+
+struct btSphereShapeSupport
+{
+	static SIMD_FORCE_INLINE btVector3	supportWithoutMargin(const btConvexShape* shape,const btVector3& localDir)
+	{
+		(void)shape;
+		(void)localDir;
+		return btVector3(0,0,0);
+	}
+};
+
+struct btBoxShapeSupport
+{
+	static SIMD_FORCE_INLINE btVector3	supportWithoutMargin(const btConvexShape* shape,const btVector3& localDir)
+	{
+		const btBoxShape* convexShape = static_cast<const btBoxShape*>(shape);
+		const btVector3& halfExtents = convexShape->getImplicitShapeDimensions();
+
+		return btVector3(btFsels(localDir.x(), halfExtents.x(), -halfExtents.x()),
+			btFsels(localDir.y(), halfExtents.y(), -halfExtents.y()),
+			btFsels(localDir.z(), halfExtents.z(), -halfExtents.z()));
+	}
+};
+
+struct btCylinderShapeSupport
+{
+	static SIMD_FORCE_INLINE btVector3	supportWithoutMargin(const btConvexShape* shape,const btVector3& localDir)
+	{
+		const btCylinderShape* cylShape = static_cast<const btCylinderShape*>(shape);
+		//mapping of halfextents/dimension onto radius/height depends on how cylinder local orientation is (upAxis)
+
+		btVector3 halfExtents = cylShape->getImplicitShapeDimensions();
+		btVector3 v(localDir.getX(),localDir.getY(),localDir.getZ());
+		int cylinderUpAxis = cylShape->getUpAxis();
+		int XX(1),YY(0),ZZ(2);
+
+		switch (cylinderUpAxis)
+		{
+		case 0:
+		{
+			XX = 1;
+			YY = 0;
+			ZZ = 2;
+		}
+		break;
+		case 1:
+		{
+			XX = 0;
+			YY = 1;
+			ZZ = 2;
+		}
+		break;
+		case 2:
+		{
+			XX = 0;
+			YY = 2;
+			ZZ = 1;
+
+		}
+		break;
+		default:
+			btAssert(0);
+		break;
+		};
+
+		btScalar radius = halfExtents[XX];
+		btScalar halfHeight = halfExtents[cylinderUpAxis];
+
+		btVector3 tmp;
+		btScalar d ;
+
+		btScalar s = btSqrt(v[XX] * v[XX] + v[ZZ] * v[ZZ]);
+		if (s != btScalar(0.0))
+		{
+			d = radius / s;
+			tmp[XX] = v[XX] * d;
+			tmp[YY] = v[YY] < 0.0 ? -halfHeight : halfHeight;
+			tmp[ZZ] = v[ZZ] * d;
+			return btVector3(tmp.getX(),tmp.getY(),tmp.getZ());
+		} else {
+			tmp[XX] = radius;
+			tmp[YY] = v[YY] < 0.0 ? -halfHeight : halfHeight;
+			tmp[ZZ] = btScalar(0.0);
+			return btVector3(tmp.getX(),tmp.getY(),tmp.getZ());
+		}
+	}
+};
+
+struct btCapsuleShapeSupport
+{
+	static SIMD_FORCE_INLINE btVector3	supportWithoutMargin(const btConvexShape* shape,const btVector3& localDir)
+	{
+		btVector3 vec0(localDir.getX(),localDir.getY(),localDir.getZ());
+
+		const btCapsuleShape* capsuleShape = static_cast<const btCapsuleShape*>(shape);
+		btScalar halfHeight = capsuleShape->getHalfHeight();
+		int capsuleUpAxis = capsuleShape->getUpAxis();
+
+		btScalar radius = capsuleShape->getRadius();
+		btVector3 supVec(0,0,0);
+
+		btScalar maxDot(btScalar(-BT_LARGE_FLOAT));
+
+		btVector3 vec = vec0;
+		btScalar lenSqr = vec.length2();
+		if (lenSqr < btScalar(0.0001))
+		{
+			vec.setValue(1,0,0);
+		} else
+		{
+			btScalar rlen = btScalar(1.) / btSqrt(lenSqr );
+			vec *= rlen;
+		}
+		btVector3 vtx;
+		btScalar newDot;
+		{
+			btVector3 pos(0,0,0);
+			pos[capsuleUpAxis] = halfHeight;
+
+			//vtx = pos +vec*(radius);
+			vtx = pos +vec*capsuleShape->getLocalScalingNV()*(radius) - vec * capsuleShape->getMarginNV();
+			newDot = vec.dot(vtx);
+
+
+			if (newDot > maxDot)
+			{
+				maxDot = newDot;
+				supVec = vtx;
+			}
+		}
+		{
+			btVector3 pos(0,0,0);
+			pos[capsuleUpAxis] = -halfHeight;
+
+			//vtx = pos +vec*(radius);
+			vtx = pos +vec*capsuleShape->getLocalScalingNV()*(radius) - vec * capsuleShape->getMarginNV();
+			newDot = vec.dot(vtx);
+			if (newDot > maxDot)
+			{
+				maxDot = newDot;
+				supVec = vtx;
+			}
+		}
+		return btVector3(supVec.getX(),supVec.getY(),supVec.getZ());
+	}
+};
+
+///supporting vertex of a point cloud, shared by btConvexHullShape and btConvexPointCloudShape
+SIMD_FORCE_INLINE btVector3	btConvexPointsSupport(const btVector3& localDirOrg, const btVector3* points, int numPoints, const btVector3& localScaling)
+{
+	btVector3 vec = localDirOrg * localScaling;
+
+	btScalar newDot,maxDot = btScalar(-BT_LARGE_FLOAT);
+	int ptIndex = -1;
+
+	for (int i=0;i<numPoints;i++)
+	{
+
+		newDot = vec.dot(points[i]);
+		if (newDot > maxDot)
+		{
+			maxDot = newDot;
+			ptIndex = i;
+		}
+	}
+	btAssert(ptIndex >= 0);
+	btVector3 supVec = points[ptIndex] * localScaling;
+	return supVec;
+}
+
+struct btConvexHullShapeSupport
+{
+	static SIMD_FORCE_INLINE btVector3	supportWithoutMargin(const btConvexShape* shape,const btVector3& localDir)
+	{
+		const btConvexHullShape* convexHullShape = static_cast<const btConvexHullShape*>(shape);
+		return btConvexPointsSupport(localDir,convexHullShape->getUnscaledPoints(),convexHullShape->getNumPoints(),convexHullShape->getLocalScalingNV());
+	}
+};
+
+#endif //BT_CONVEX_SHAPE_SUPPORT_H
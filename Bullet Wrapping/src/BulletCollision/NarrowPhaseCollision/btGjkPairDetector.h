@@ -26,6 +26,25 @@ class btConvexShape;
 #include "btSimplexSolverInterface.h"
 class btConvexPenetrationDepthSolver;
 
+///btGjkWarmStart keeps the separating axis of a previous GJK query between two objects, in the local space of object A,
+///so the next query can start from it. Restarting from the old simplex as well doesn't pay off: against large shapes,
+///such as a ground hull, the old support points span a large simplex and the closest point on it loses precision.
+struct btGjkWarmStart
+{
+	btVector3	m_separatingAxisInA;
+	bool		m_valid;
+
+	btGjkWarmStart()
+		:m_valid(false)
+	{
+	}
+
+	void	reset()
+	{
+		m_valid = false;
+	}
+};
+
 /// btGjkPairDetector uses GJK to implement the btDiscreteCollisionDetectorInterface
 class btGjkPairDetector : public btDiscreteCollisionDetectorInterface
 {
@@ -43,6 +62,7 @@ class btGjkPairDetector : public btDiscreteCollisionDetectorInterface
 
 	bool		m_ignoreMargin;
 	btScalar	m_cachedSeparatingDistance;
+	btGjkWarmStart*	m_warmStart;
 	
 
 public:
@@ -61,6 +81,10 @@ public:
 	virtual void	getClosestPoints(const ClosestPointInput& input,Result& output,class btIDebugDraw* debugDraw,bool swapResults=false);
 
 	void	getClosestPointsNonVirtual(const ClosestPointInput& input,Result& output,class btIDebugDraw* debugDraw);
+
+	///the same query, with the support functions of both shapes known at compile time. It is defined in btGjkPairDetectorKernel.h
+	template <typename SUPPORT_A,typename SUPPORT_B>
+	void	getClosestPointsKernel(const ClosestPointInput& input,Result& output,class btIDebugDraw* debugDraw);
 	
 
 	void setMinkowskiA(btConvexShape* minkA)
@@ -77,6 +101,12 @@ public:
 		m_cachedSeparatingAxis = seperatingAxis;
 	}
 
+	///the query starts from the separating axis in warmStart, and stores its own result there. Pass 0 to start from scratch.
+	void	setWarmStart(btGjkWarmStart* warmStart)
+	{
+		m_warmStart = warmStart;
+	}
+
 	const btVector3& getCachedSeparatingAxis() const
 	{
 		return m_cachedSeparatingAxis;
@@ -100,4 +130,7 @@ public:
 
 };
 
+///getClosestPointsNonVirtual or an instance of getClosestPointsKernel
+typedef void (btGjkPairDetector::*btGjkClosestPointsKernel)(const btDiscreteCollisionDetectorInterface::ClosestPointInput& input,btDiscreteCollisionDetectorInterface::Result& output,class btIDebugDraw* debugDraw);
+
 #endif //BT_GJK_PAIR_DETECTOR_H
@@ -43,16 +43,16 @@ class btManifoldPoint
 	{
 		public:
 			btManifoldPoint()
-				:m_userPersistentData(0),
+				:m_lifeTime(0),
+				m_userPersistentData(0),
 				m_appliedImpulse(0.f),
-				m_lateralFrictionInitialized(false),
 				m_appliedImpulseLateral1(0.f),
 				m_appliedImpulseLateral2(0.f),
 				m_contactMotion1(0.f),
 				m_contactMotion2(0.f),
 				m_contactCFM1(0.f),
 				m_contactCFM2(0.f),
-				m_lifeTime(0)
+				m_lateralFrictionInitialized(false)
 			{
 			}
 
@@ -63,25 +63,28 @@ class btManifoldPoint
 					m_localPointB( pointB ), 
 					m_normalWorldOnB( normal ), 
 					m_distance1( distance ),
+					m_lifeTime(0),
 					m_combinedFriction(btScalar(0.)),
 					m_combinedRestitution(btScalar(0.)),
 					m_userPersistentData(0),
 					m_appliedImpulse(0.f),
-					m_lateralFrictionInitialized(false),
 					m_appliedImpulseLateral1(0.f),
 					m_appliedImpulseLateral2(0.f),
 					m_contactMotion1(0.f),
 					m_contactMotion2(0.f),
 					m_contactCFM1(0.f),
 					m_contactCFM2(0.f),
-					m_lifeTime(0)
+					m_lateralFrictionInitialized(false)
 			{
+#ifdef PFX_USE_FREE_VECTORMATH
 				mConstraintRow[0].m_accumImpulse = 0.f;
 				mConstraintRow[1].m_accumImpulse = 0.f;
 				mConstraintRow[2].m_accumImpulse = 0.f;
+#endif //PFX_USE_FREE_VECTORMATH
 			}
 
-			
+			///the fields used by the narrowphase and refreshContactPoints come first, the fields only used by the constraint solver last,
+			///so refreshing a point touches two cache lines instead of the whole point
 
 			btVector3 m_localPointA;			
 			btVector3 m_localPointB;			
@@ -91,6 +94,7 @@ class btManifoldPoint
 			btVector3 m_normalWorldOnB;
 		
 			btScalar	m_distance1;
+			int			m_lifeTime;//lifetime of the contactpoint in frames
 			btScalar	m_combinedFriction;
 			btScalar	m_combinedRestitution;
 
@@ -101,24 +105,23 @@ class btManifoldPoint
          int      m_index1;
 				
 			mutable void*	m_userPersistentData;
-			btScalar		m_appliedImpulse;
 
-			bool			m_lateralFrictionInitialized;
+			btScalar		m_appliedImpulse;
 			btScalar		m_appliedImpulseLateral1;
 			btScalar		m_appliedImpulseLateral2;
 			btScalar		m_contactMotion1;
 			btScalar		m_contactMotion2;
 			btScalar		m_contactCFM1;
 			btScalar		m_contactCFM2;
-
-			int				m_lifeTime;//lifetime of the contactpoint in frames
+			bool			m_lateralFrictionInitialized;
 			
 			btVector3		m_lateralFrictionDir1;
 			btVector3		m_lateralFrictionDir2;
 
-
-
+#ifdef PFX_USE_FREE_VECTORMATH
+			///only used by the Physics Effects solver, the other solvers keep the warm starting impulses in m_appliedImpulse
 			btConstraintRow mConstraintRow[3];
+#endif //PFX_USE_FREE_VECTORMATH
 
 
 			btScalar getDistance() const
@@ -29,7 +29,9 @@ btPersistentManifold::btPersistentManifold()
 m_body0(0),
 m_body1(0),
 m_cachedPoints (0),
-m_index1a(0)
+m_index1a(0),
+m_childIndex0(-1),
+m_childIndex1(-1)
 {
 }
 
@@ -211,7 +213,10 @@ void btPersistentManifold::refreshContactPoints(const btTransform& trA,const btT
 		trB.getOrigin().getY(),
 		trB.getOrigin().getZ());
 #endif //DEBUG_PERSISTENCY
-	/// first refresh worldspace positions and distance
+	/// refresh worldspace positions and distance, then validate the point in the same pass.
+	/// removeContactPoint moves the last point into slot i, which was already refreshed because the loop runs backwards
+	btScalar distance2d;
+	btVector3 projectedDifference,projectedPoint;
 	for (i=getNumContacts()-1;i>=0;i--)
 	{
 		btManifoldPoint &manifoldPoint = m_pointCache[i];
@@ -219,15 +224,7 @@ void btPersistentManifold::refreshContactPoints(const btTransform& trA,const btT
 		manifoldPoint.m_positionWorldOnB = trB( manifoldPoint.m_localPointB );
 		manifoldPoint.m_distance1 = (manifoldPoint.m_positionWorldOnA -  manifoldPoint.m_positionWorldOnB).dot(manifoldPoint.m_normalWorldOnB);
 		manifoldPoint.m_lifeTime++;
-	}
 
-	/// then 
-	btScalar distance2d;
-	btVector3 projectedDifference,projectedPoint;
-	for (i=getNumContacts()-1;i>=0;i--)
-	{
-		
-		btManifoldPoint &manifoldPoint = m_pointCache[i];
 		//contact becomes invalid when signed distance exceeds margin (projected on contactnormal direction)
 		if (!validContactDistance(manifoldPoint))
 		{
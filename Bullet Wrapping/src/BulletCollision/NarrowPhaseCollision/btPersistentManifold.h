@@ -53,8 +53,7 @@ enum btContactManifoldTypes
 ATTRIBUTE_ALIGNED128( class) btPersistentManifold : public btTypedObject
 //ATTRIBUTE_ALIGNED16( class) btPersistentManifold : public btTypedObject
 {
-
-	btManifoldPoint m_pointCache[MANIFOLD_CACHE_SIZE];
+	///the bodies, point count and thresholds come before the points, so they share the first cache line of the manifold
 
 	/// this two body pointers can point to the physics rigidbody class.
 	/// void* will allow any rigidbody class
@@ -66,6 +65,8 @@ ATTRIBUTE_ALIGNED128( class) btPersistentManifold : public btTypedObject
 	btScalar	m_contactBreakingThreshold;
 	btScalar	m_contactProcessingThreshold;
 
+	btManifoldPoint m_pointCache[MANIFOLD_CACHE_SIZE];
+
 	
 	/// sort cached points so most isolated points come first
 	int	sortCachedPoints(const btManifoldPoint& pt);
@@ -81,13 +82,21 @@ public:
 
 	int m_index1a;
 
+	///compound child shape index of body0 and body1 this manifold belongs to, or -1. Set by btCompoundCollisionAlgorithm,
+	///for nested compounds it is a key of the child indices along the path (see btManifoldResult::m_childKey0).
+	///It tells apart the manifolds of one pair of objects, see btDiscreteDynamicsWorld::restoreSnapshot.
+	int	m_childIndex0;
+	int	m_childIndex1;
+
 	btPersistentManifold();
 
 	btPersistentManifold(void* body0,void* body1,int , btScalar contactBreakingThreshold,btScalar contactProcessingThreshold)
 		: btTypedObject(BT_PERSISTENT_MANIFOLD_TYPE),
 	m_body0(body0),m_body1(body1),m_cachedPoints(0),
 		m_contactBreakingThreshold(contactBreakingThreshold),
-		m_contactProcessingThreshold(contactProcessingThreshold)
+		m_contactProcessingThreshold(contactProcessingThreshold),
+		m_childIndex0(-1),
+		m_childIndex1(-1)
 	{
 	}
 
@@ -146,9 +155,11 @@ public:
 			m_pointCache[index] = m_pointCache[lastUsedIndex]; 
 			//get rid of duplicated userPersistentData pointer
 			m_pointCache[lastUsedIndex].m_userPersistentData = 0;
+#ifdef PFX_USE_FREE_VECTORMATH
 			m_pointCache[lastUsedIndex].mConstraintRow[0].m_accumImpulse = 0.f;
 			m_pointCache[lastUsedIndex].mConstraintRow[1].m_accumImpulse = 0.f;
 			m_pointCache[lastUsedIndex].mConstraintRow[2].m_accumImpulse = 0.f;
+#endif //PFX_USE_FREE_VECTORMATH
 
 			m_pointCache[lastUsedIndex].m_appliedImpulse = 0.f;
 			m_pointCache[lastUsedIndex].m_lateralFrictionInitialized = false;
@@ -167,9 +178,15 @@ public:
 #define MAINTAIN_PERSISTENCY 1
 #ifdef MAINTAIN_PERSISTENCY
 		int	lifeTime = m_pointCache[insertIndex].getLifeTime();
+#ifdef PFX_USE_FREE_VECTORMATH
 		btScalar	appliedImpulse = m_pointCache[insertIndex].mConstraintRow[0].m_accumImpulse;
 		btScalar	appliedLateralImpulse1 = m_pointCache[insertIndex].mConstraintRow[1].m_accumImpulse;
 		btScalar	appliedLateralImpulse2 = m_pointCache[insertIndex].mConstraintRow[2].m_accumImpulse;
+#else
+		btScalar	appliedImpulse = m_pointCache[insertIndex].m_appliedImpulse;
+		btScalar	appliedLateralImpulse1 = m_pointCache[insertIndex].m_appliedImpulseLateral1;
+		btScalar	appliedLateralImpulse2 = m_pointCache[insertIndex].m_appliedImpulseLateral2;
+#endif //PFX_USE_FREE_VECTORMATH
 //		bool isLateralFrictionInitialized = m_pointCache[insertIndex].m_lateralFrictionInitialized;
 		
 		
@@ -184,9 +201,11 @@ public:
 		m_pointCache[insertIndex].m_appliedImpulseLateral1 = appliedLateralImpulse1;
 		m_pointCache[insertIndex].m_appliedImpulseLateral2 = appliedLateralImpulse2;
 		
+#ifdef PFX_USE_FREE_VECTORMATH
 		m_pointCache[insertIndex].mConstraintRow[0].m_accumImpulse =  appliedImpulse;
 		m_pointCache[insertIndex].mConstraintRow[1].m_accumImpulse = appliedLateralImpulse1;
 		m_pointCache[insertIndex].mConstraintRow[2].m_accumImpulse = appliedLateralImpulse2;
+#endif //PFX_USE_FREE_VECTORMATH
 
 
 		m_pointCache[insertIndex].m_lifeTime = lifeTime;
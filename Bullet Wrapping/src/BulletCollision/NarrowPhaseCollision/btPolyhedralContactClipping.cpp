@@ -21,6 +21,7 @@ subject to the following restrictions:
 
 #include "btPolyhedralContactClipping.h"
 #include "BulletCollision/CollisionShapes/btConvexPolyhedron.h"
+#include "LinearMath/btThreads.h"
 
 #include <float.h> //for FLT_MAX
 
@@ -166,7 +167,7 @@ void InverseTransformPoint3x3(btVector3& out, const btVector3& in, const btTrans
 
 bool btPolyhedralContactClipping::findSeparatingAxis(	const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA,const btTransform& transB, btVector3& sep)
 {
-	gActualSATPairTests++;
+	btAtomicAdd(gActualSATPairTests,1);
 
 //#ifdef TEST_INTERNAL_OBJECTS
 	const btVector3 c0 = transA * hullA.m_localCenter;
@@ -188,10 +189,10 @@ bool btPolyhedralContactClipping::findSeparatingAxis(	const btConvexPolyhedron&
 
 		curPlaneTests++;
 #ifdef TEST_INTERNAL_OBJECTS
-		gExpectedNbTests++;
+		btAtomicAdd(gExpectedNbTests,1);
 		if(gUseInternalObject && !TestInternalObjects(transA,transB, DeltaC2, faceANormalWS, hullA, hullB, dmin))
 			continue;
-		gActualNbTests++;
+		btAtomicAdd(gActualNbTests,1);
 #endif
 
 		btScalar d;
@@ -216,10 +217,10 @@ bool btPolyhedralContactClipping::findSeparatingAxis(	const btConvexPolyhedron&
 
 		curPlaneTests++;
 #ifdef TEST_INTERNAL_OBJECTS
-		gExpectedNbTests++;
+		btAtomicAdd(gExpectedNbTests,1);
 		if(gUseInternalObject && !TestInternalObjects(transA,transB,DeltaC2, WorldNormal, hullA, hullB, dmin))
 			continue;
-		gActualNbTests++;
+		btAtomicAdd(gActualNbTests,1);
 #endif
 
 		btScalar d;
@@ -256,10 +257,10 @@ bool btPolyhedralContactClipping::findSeparatingAxis(	const btConvexPolyhedron&
 
 
 #ifdef TEST_INTERNAL_OBJECTS
-				gExpectedNbTests++;
+				btAtomicAdd(gExpectedNbTests,1);
 				if(gUseInternalObject && !TestInternalObjects(transA,transB,DeltaC2, Cross, hullA, hullB, dmin))
 					continue;
-				gActualNbTests++;
+				btAtomicAdd(gActualNbTests,1);
 #endif
 
 				btScalar dist;
@@ -0,0 +1,612 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btBlockPivotingConstraintSolver.h"
+#include "btContactSolverInfo.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btMinMax.h"
+#include "LinearMath/btQuickprof.h"
+#include "LinearMath/btThreads.h"
+
+int	gNumDirectSolverIslands = 0;
+int	gNumIterativeSolverIslands = 0;
+int	gNumDirectSolverFallbacks = 0;
+
+///amount of block pivoting steps that may fail to reduce the number of infeasible rows, before switching to single pivots
+#define BT_PIVOTING_MAX_BACKUPS 3
+
+btBlockPivotingConstraintSolver::btBlockPivotingConstraintSolver()
+:m_maxDirectRows(32),
+m_maxPivotingIterations(100),
+m_numFrictionPasses(4),
+m_regularization(btScalar(1e-4))
+{
+}
+
+btBlockPivotingConstraintSolver::~btBlockPivotingConstraintSolver()
+{
+}
+
+int	btBlockPivotingConstraintSolver::getDynamicBodyIndex(btRigidBody* body,btCollisionObject** bodies,int numBodies) const
+{
+	int index = body->getCompanionId();
+	if (index>=0 && index<numBodies && bodies[index]==body && body->getInvMass()!=btScalar(0.))
+		return index;
+	return -1;
+}
+
+void	btBlockPivotingConstraintSolver::buildRowGroups(btCollisionObject** bodies,int numBodies,btTypedConstraint** constraints,int numConstraints)
+{
+	int i;
+	for (i=0;i<numBodies;i++)
+		bodies[i]->setCompanionId(i);
+
+	m_bodyUnionFind.reset(numBodies);
+
+	btConstraintArray* pools[3] = {&m_tmpSolverNonContactConstraintPool,&m_tmpSolverContactConstraintPool,&m_tmpSolverContactFrictionConstraintPool};
+	int type;
+	for (type=0;type<3;type++)
+	{
+		btConstraintArray& pool = *pools[type];
+		for (i=0;i<pool.size();i++)
+		{
+			int a = getDynamicBodyIndex(pool[i].m_solverBodyA,bodies,numBodies);
+			int b = getDynamicBodyIndex(pool[i].m_solverBodyB,bodies,numBodies);
+			if (a>=0 && b>=0)
+				m_bodyUnionFind.unite(a,b);
+		}
+	}
+
+	///enabled constraints without rows are solved using solveConstraintObsolete, their bodies are connected as well
+	for (i=0;i<numConstraints;i++)
+	{
+		if (constraints[i]->isEnabled() && !m_tmpConstraintSizesPool[i].m_numConstraintRows)
+		{
+			int a = getDynamicBodyIndex(&constraints[i]->getRigidBodyA(),bodies,numBodies);
+			int b = getDynamicBodyIndex(&constraints[i]->getRigidBodyB(),bodies,numBodies);
+			if (a>=0 && b>=0)
+				m_bodyUnionFind.unite(a,b);
+		}
+	}
+
+	///group numBodies collects the rows without dynamic bodies
+	m_groupRowOffsets.resize(numBodies+2);
+	m_groupIterative.resize(numBodies+1);
+	for (i=0;i<numBodies+2;i++)
+		m_groupRowOffsets[i] = 0;
+	for (i=0;i<numBodies+1;i++)
+		m_groupIterative[i] = 0;
+	m_groupIterative[numBodies] = 1;
+
+	for (i=0;i<numConstraints;i++)
+	{
+		if (constraints[i]->isEnabled() && !m_tmpConstraintSizesPool[i].m_numConstraintRows)
+		{
+			int a = getDynamicBodyIndex(&constraints[i]->getRigidBodyA(),bodies,numBodies);
+			if (a<0)
+				a = getDynamicBodyIndex(&constraints[i]->getRigidBodyB(),bodies,numBodies);
+			if (a>=0)
+				m_groupIterative[m_bodyUnionFind.find(a)] = 1;
+		}
+	}
+
+	//counting sort of the rows on group
+	int numRows = 0;
+	for (type=0;type<3;type++)
+	{
+		btConstraintArray& pool = *pools[type];
+		for (i=0;i<pool.size();i++)
+		{
+			int a = getDynamicBodyIndex(pool[i].m_solverBodyA,bodies,numBodies);
+			if (a<0)
+				a = getDynamicBodyIndex(pool[i].m_solverBodyB,bodies,numBodies);
+			int group = a>=0 ? m_bodyUnionFind.find(a) : numBodies;
+			m_groupRowOffsets[group+1]++;
+			numRows++;
+		}
+	}
+	for (i=0;i<numBodies+1;i++)
+		m_groupRowOffsets[i+1] += m_groupRowOffsets[i];
+
+	m_groupRows.resize(numRows);
+	for (type=0;type<3;type++)
+	{
+		btConstraintArray& pool = *pools[type];
+		for (i=0;i<pool.size();i++)
+		{
+			int a = getDynamicBodyIndex(pool[i].m_solverBodyA,bodies,numBodies);
+			if (a<0)
+				a = getDynamicBodyIndex(pool[i].m_solverBodyB,bodies,numBodies);
+			int group = a>=0 ? m_bodyUnionFind.find(a) : numBodies;
+			btDirectRow& row = m_groupRows[m_groupRowOffsets[group]++];
+			row.m_constraint = &pool[i];
+			row.m_type = type;
+			row.m_poolIndex = i;
+		}
+	}
+	//the offsets moved to the end of each group, shift them back
+	for (i=numBodies+1;i>0;i--)
+		m_groupRowOffsets[i] = m_groupRowOffsets[i-1];
+	m_groupRowOffsets[0] = 0;
+
+	m_contactLocalIndex.resize(m_tmpSolverContactConstraintPool.size());
+}
+
+bool	btBlockPivotingConstraintSolver::solveDenseSystem(int n)
+{
+	//Gaussian elimination with partial pivoting, the solution replaces m_subB
+	btScalar* a = &m_subA[0];
+	btScalar* b = &m_subB[0];
+	int i,j,k;
+
+	btScalar maxDiag = btScalar(0.);
+	for (i=0;i<n;i++)
+		maxDiag = btMax(maxDiag,btFabs(a[i*n+i]));
+	const btScalar tiny = maxDiag*SIMD_EPSILON;
+
+	for (k=0;k<n;k++)
+	{
+		int pivot = k;
+		btScalar largest = btFabs(a[k*n+k]);
+		for (i=k+1;i<n;i++)
+		{
+			if (btFabs(a[i*n+k])>largest)
+			{
+				largest = btFabs(a[i*n+k]);
+				pivot = i;
+			}
+		}
+		if (!(largest>tiny))
+			return false;
+
+		if (pivot!=k)
+		{
+			for (j=k;j<n;j++)
+				btSwap(a[k*n+j],a[pivot*n+j]);
+			btSwap(b[k],b[pivot]);
+		}
+
+		btScalar invPivot = btScalar(1.)/a[k*n+k];
+		for (i=k+1;i<n;i++)
+		{
+			btScalar factor = a[i*n+k]*invPivot;
+			if (factor!=btScalar(0.))
+			{
+				for (j=k+1;j<n;j++)
+					a[i*n+j] -= factor*a[k*n+j];
+				b[i] -= factor*b[k];
+			}
+		}
+	}
+
+	for (k=n-1;k>=0;k--)
+	{
+		btScalar sum = b[k];
+		for (j=k+1;j<n;j++)
+			sum -= a[k*n+j]*b[j];
+		b[k] = sum/a[k*n+k];
+	}
+	return true;
+}
+
+///Block principal pivoting for the boxed LCP A x = b + w, lo <= x <= hi, see Judice and Pires.
+///A free row has w = 0, a row at its lower bound needs w >= 0 and a row at its upper bound needs w <= 0.
+///All infeasible rows switch state at once, and when that stops reducing the number of infeasible rows, only the last one switches.
+bool	btBlockPivotingConstraintSolver::solveBoxedLCP(int n,bool initStates)
+{
+	int i,j;
+	btScalar* A = &m_A[0];
+	btScalar* b = &m_b[0];
+	btScalar* x = &m_x[0];
+
+	m_state.resize(n);
+	m_infeasible.resize(n);
+	for (i=0;i<n;i++)
+	{
+		if (m_lo[i]>=m_hi[i])
+		{
+			m_state[i] = BT_PIVOT_FIXED;
+			continue;
+		}
+		if (initStates || m_state[i]==BT_PIVOT_FIXED)
+		{
+			if (x[i]<=m_lo[i])
+				m_state[i] = BT_PIVOT_LOWER;
+			else if (x[i]>=m_hi[i])
+				m_state[i] = BT_PIVOT_UPPER;
+			else
+				m_state[i] = BT_PIVOT_FREE;
+		}
+	}
+
+	btScalar maxB = btScalar(0.);
+	for (i=0;i<n;i++)
+		maxB = btMax(maxB,btFabs(b[i]));
+	const btScalar tolW = maxB*btScalar(1e-5)+SIMD_EPSILON;
+
+	int bestNumInfeasible = n+1;
+	int numBackups = BT_PIVOTING_MAX_BACKUPS;
+
+	for (int iteration=0;iteration<m_maxPivotingIterations;iteration++)
+	{
+		m_freeIndices.resize(0);
+		for (i=0;i<n;i++)
+		{
+			switch (m_state[i])
+			{
+			case BT_PIVOT_FREE:
+				m_freeIndices.push_back(i);
+				break;
+			case BT_PIVOT_UPPER:
+				x[i] = m_hi[i];
+				break;
+			default:
+				x[i] = m_lo[i];
+			}
+		}
+
+		int numFree = m_freeIndices.size();
+		if (numFree)
+		{
+			m_subA.resize(numFree*numFree);
+			m_subB.resize(numFree);
+			for (int r=0;r<numFree;r++)
+			{
+				const int row = m_freeIndices[r];
+				btScalar rhs = b[row];
+				for (j=0;j<n;j++)
+				{
+					if (m_state[j]!=BT_PIVOT_FREE)
+						rhs -= A[row*n+j]*x[j];
+				}
+				m_subB[r] = rhs;
+				for (int c=0;c<numFree;c++)
+					m_subA[r*numFree+c] = A[row*n+m_freeIndices[c]];
+			}
+			if (!solveDenseSystem(numFree))
+				return false;
+			for (int r=0;r<numFree;r++)
+				x[m_freeIndices[r]] = m_subB[r];
+		}
+
+		btScalar maxX = btScalar(0.);
+		for (i=0;i<n;i++)
+			maxX = btMax(maxX,btFabs(x[i]));
+		const btScalar tolX = maxX*btScalar(1e-5)+SIMD_EPSILON;
+
+		int numInfeasible = 0;
+		int lastInfeasible = -1;
+		for (i=0;i<n;i++)
+		{
+			bool infeasible = false;
+			switch (m_state[i])
+			{
+			case BT_PIVOT_FREE:
+				infeasible = (x[i]<m_lo[i]-tolX) || (x[i]>m_hi[i]+tolX);
+				break;
+			case BT_PIVOT_LOWER:
+			case BT_PIVOT_UPPER:
+				{
+					btScalar w = -b[i];
+					for (j=0;j<n;j++)
+						w += A[i*n+j]*x[j];
+					infeasible = (m_state[i]==BT_PIVOT_LOWER) ? (w<-tolW) : (w>tolW);
+				}
+				break;
+			default:
+				break;
+			}
+			m_infeasible[i] = infeasible;
+			if (infeasible)
+			{
+				numInfeasible++;
+				lastInfeasible = i;
+			}
+		}
+
+		if (!numInfeasible)
+		{
+			for (i=0;i<n;i++)
+				btSetMax(x[i],m_lo[i]);
+			for (i=0;i<n;i++)
+				btSetMin(x[i],m_hi[i]);
+			return true;
+		}
+
+		bool switchAll = true;
+		if (numInfeasible<bestNumInfeasible)
+		{
+			bestNumInfeasible = numInfeasible;
+			numBackups = BT_PIVOTING_MAX_BACKUPS;
+		} else if (numBackups>0)
+		{
+			numBackups--;
+		} else
+		{
+			switchAll = false;
+		}
+
+		for (i=0;i<n;i++)
+		{
+			if (!m_infeasible[i] || (!switchAll && i!=lastInfeasible))
+				continue;
+			if (m_state[i]==BT_PIVOT_FREE)
+				m_state[i] = (x[i]<m_lo[i]) ? BT_PIVOT_LOWER : BT_PIVOT_UPPER;
+			else
+				m_state[i] = BT_PIVOT_FREE;
+		}
+	}
+	return false;
+}
+
+bool	btBlockPivotingConstraintSolver::solveDirectGroup(const btDirectRow* rows,int n)
+{
+	BT_PROFILE("solveDirectGroup");
+	int i,j;
+
+	m_A.resize(n*n);
+	m_b.resize(n);
+	m_x.resize(n);
+	m_lo.resize(n);
+	m_hi.resize(n);
+	m_rowEffects.resize(n*4);
+
+	for (i=0;i<n;i++)
+	{
+		const btSolverConstraint& c = *rows[i].m_constraint;
+		if (rows[i].m_type==BT_DIRECT_CONTACT_ROW)
+			m_contactLocalIndex[rows[i].m_poolIndex] = i;
+
+		///velocity change of both bodies for a unit impulse, the same as the iterative solver applies
+		btRigidBody* bodyA = c.m_solverBodyA;
+		btRigidBody* bodyB = c.m_solverBodyB;
+		btVector3* effects = &m_rowEffects[i*4];
+		if (bodyA->getInvMass()!=btScalar(0.))
+		{
+			effects[0] = c.m_contactNormal*bodyA->internalGetInvMass();
+			effects[1] = c.m_angularComponentA*bodyA->getAngularFactor();
+		} else
+		{
+			effects[0].setZero();
+			effects[1].setZero();
+		}
+		if (bodyB->getInvMass()!=btScalar(0.))
+		{
+			effects[2] = -c.m_contactNormal*bodyB->internalGetInvMass();
+			effects[3] = c.m_angularComponentB*bodyB->getAngularFactor();
+		} else
+		{
+			effects[2].setZero();
+			effects[3].setZero();
+		}
+	}
+
+	///the fixed point of the iterative solver is J M^-1 J^T x + cfm/jacDiagABInv x = rhs/jacDiagABInv
+	for (i=0;i<n;i++)
+	{
+		const btSolverConstraint& ci = *rows[i].m_constraint;
+		for (j=0;j<n;j++)
+		{
+			const btSolverConstraint& cj = *rows[j].m_constraint;
+			const btVector3* effects = &m_rowEffects[j*4];
+			btScalar a = btScalar(0.);
+			if (ci.m_solverBodyA==cj.m_solverBodyA)
+				a += ci.m_contactNormal.dot(effects[0])+ci.m_relpos1CrossNormal.dot(effects[1]);
+			if (ci.m_solverBodyA==cj.m_solverBodyB)
+				a += ci.m_contactNormal.dot(effects[2])+ci.m_relpos1CrossNormal.dot(effects[3]);
+			if (ci.m_solverBodyB==cj.m_solverBodyA)
+				a += -ci.m_contactNormal.dot(effects[0])+ci.m_relpos2CrossNormal.dot(effects[1]);
+			if (ci.m_solverBodyB==cj.m_solverBodyB)
+				a += -ci.m_contactNormal.dot(effects[2])+ci.m_relpos2CrossNormal.dot(effects[3]);
+			m_A[i*n+j] = a;
+		}
+
+		btScalar jacDiagABInv = ci.m_jacDiagABInv;
+		if (!(jacDiagABInv>btScalar(0.)) || !(jacDiagABInv<SIMD_INFINITY))
+			return false;
+		m_A[i*n+i] += m_A[i*n+i]*m_regularization + ci.m_cfm/jacDiagABInv;
+		m_b[i] = ci.m_rhs/jacDiagABInv;
+		m_x[i] = btScalar(ci.m_appliedImpulse);
+		m_lo[i] = ci.m_lowerLimit;
+		m_hi[i] = ci.m_upperLimit;
+	}
+
+	bool initStates = true;
+	for (int pass=0;;pass++)
+	{
+		bool hasFriction = false;
+		btScalar maxBoundChange = btScalar(0.);
+		btScalar maxBound = btScalar(0.);
+		for (i=0;i<n;i++)
+		{
+			if (rows[i].m_type!=BT_DIRECT_FRICTION_ROW)
+				continue;
+			hasFriction = true;
+			const btSolverConstraint& c = *rows[i].m_constraint;
+			btScalar normalImpulse = m_x[m_contactLocalIndex[c.m_frictionIndex]];
+			btScalar bound = c.m_friction*btMax(normalImpulse,btScalar(0.));
+			maxBoundChange = btMax(maxBoundChange,btFabs(bound-m_hi[i]));
+			maxBound = btMax(maxBound,bound);
+			m_lo[i] = -bound;
+			m_hi[i] = bound;
+		}
+
+		if (pass>0)
+		{
+			if (!hasFriction || maxBoundChange<=maxBound*btScalar(1e-3)+SIMD_EPSILON)
+				break;
+			if (pass>=m_numFrictionPasses)
+			{
+				for (i=0;i<n;i++)
+				{
+					btSetMax(m_x[i],m_lo[i]);
+					btSetMin(m_x[i],m_hi[i]);
+				}
+				break;
+			}
+		}
+
+		if (!solveBoxedLCP(n,initStates))
+			return false;
+		initStates = false;
+	}
+
+	for (i=0;i<n;i++)
+	{
+		btSolverConstraint& c = *rows[i].m_constraint;
+		btScalar deltaImpulse = m_x[i]-btScalar(c.m_appliedImpulse);
+		c.m_appliedImpulse = m_x[i];
+		c.m_solverBodyA->internalApplyImpulse(c.m_contactNormal*c.m_solverBodyA->internalGetInvMass(),c.m_angularComponentA,deltaImpulse);
+		c.m_solverBodyB->internalApplyImpulse(-c.m_contactNormal*c.m_solverBodyB->internalGetInvMass(),c.m_angularComponentB,deltaImpulse);
+	}
+	return true;
+}
+
+void	btBlockPivotingConstraintSolver::solveIterativeRows(int iteration,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal)
+{
+	int j;
+	const int numContactRows = m_iterativeContactRows.size();
+	const int numFrictionRows = m_iterativeFrictionRows.size();
+
+	if ((infoGlobal.m_solverMode & SOLVER_RANDMIZE_ORDER) && (iteration & 7) == 0)
+	{
+		for (j=0;j<numContactRows;j++)
+			m_iterativeContactRows.swap(j,btRandInt2(j+1));
+		for (j=0;j<numFrictionRows;j++)
+			m_iterativeFrictionRows.swap(j,btRandInt2(j+1));
+	}
+
+	const bool useSimd = (infoGlobal.m_solverMode & SOLVER_SIMD)!=0;
+
+	for (j=0;j<m_iterativeNonContactRows.size();j++)
+	{
+		btSolverConstraint& c = m_tmpSolverNonContactConstraintPool[m_iterativeNonContactRows[j]];
+		if (useSimd)
+			resolveSingleConstraintRowGenericSIMD(*c.m_solverBodyA,*c.m_solverBodyB,c);
+		else
+			resolveSingleConstraintRowGeneric(*c.m_solverBodyA,*c.m_solverBodyB,c);
+	}
+
+	for (j=0;j<numConstraints;j++)
+	{
+		constraints[j]->solveConstraintObsolete(constraints[j]->getRigidBodyA(),constraints[j]->getRigidBodyB(),infoGlobal.m_timeStep);
+	}
+
+	for (j=0;j<numContactRows;j++)
+	{
+		const btSolverConstraint& c = m_tmpSolverContactConstraintPool[m_iterativeContactRows[j]];
+		if (useSimd)
+			resolveSingleConstraintRowLowerLimitSIMD(*c.m_solverBodyA,*c.m_solverBodyB,c);
+		else
+			resolveSingleConstraintRowLowerLimit(*c.m_solverBodyA,*c.m_solverBodyB,c);
+	}
+
+	for (j=0;j<numFrictionRows;j++)
+	{
+		btSolverConstraint& c = m_tmpSolverContactFrictionConstraintPool[m_iterativeFrictionRows[j]];
+		btScalar totalImpulse = m_tmpSolverContactConstraintPool[c.m_frictionIndex].m_appliedImpulse;
+		if (totalImpulse>btScalar(0))
+		{
+			c.m_lowerLimit = -(c.m_friction*totalImpulse);
+			c.m_upperLimit = c.m_friction*totalImpulse;
+			if (useSimd)
+				resolveSingleConstraintRowGenericSIMD(*c.m_solverBodyA,*c.m_solverBodyB,c);
+			else
+				resolveSingleConstraintRowGeneric(*c.m_solverBodyA,*c.m_solverBodyB,c);
+		}
+	}
+}
+
+btScalar btBlockPivotingConstraintSolver::solveGroupCacheFriendlyIterations(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc)
+{
+	const int numRows = m_tmpSolverNonContactConstraintPool.size()+m_tmpSolverContactConstraintPool.size()+m_tmpSolverContactFrictionConstraintPool.size();
+	if (!m_maxDirectRows || !numRows)
+	{
+		return btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyIterations(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+	}
+
+	BT_PROFILE("solveGroupCacheFriendlyIterations");
+
+	solveGroupCacheFriendlySplitImpulseIterations(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+
+	buildRowGroups(bodies,numBodies,constraints,numConstraints);
+
+	m_iterativeNonContactRows.resize(0);
+	m_iterativeContactRows.resize(0);
+	m_iterativeFrictionRows.resize(0);
+
+	int numDirectGroups = 0;
+	bool needIterations = false;
+	int i,group;
+	for (group=0;group<=numBodies;group++)
+	{
+		const int firstRow = m_groupRowOffsets[group];
+		const int numGroupRows = m_groupRowOffsets[group+1]-firstRow;
+		if (!numGroupRows)
+		{
+			if (m_groupIterative[group] && group<numBodies)
+				needIterations = true;
+			continue;
+		}
+
+		const btDirectRow* rows = &m_groupRows[firstRow];
+		if (!m_groupIterative[group] && numGroupRows<=m_maxDirectRows)
+		{
+			if (solveDirectGroup(rows,numGroupRows))
+			{
+				btAtomicAdd(gNumDirectSolverIslands,1);
+				numDirectGroups++;
+				continue;
+			}
+			btAtomicAdd(gNumDirectSolverFallbacks,1);
+		}
+
+		if (group<numBodies)
+			btAtomicAdd(gNumIterativeSolverIslands,1);
+		needIterations = true;
+		for (i=0;i<numGroupRows;i++)
+		{
+			switch (rows[i].m_type)
+			{
+			case BT_DIRECT_NON_CONTACT_ROW:
+				m_iterativeNonContactRows.push_back(rows[i].m_poolIndex);
+				break;
+			case BT_DIRECT_CONTACT_ROW:
+				m_iterativeContactRows.push_back(rows[i].m_poolIndex);
+				break;
+			default:
+				m_iterativeFrictionRows.push_back(rows[i].m_poolIndex);
+			}
+		}
+	}
+
+	for (i=0;i<numBodies;i++)
+		bodies[i]->setCompanionId(-1);
+
+	if (needIterations)
+	{
+		int iteration;
+		if (!numDirectGroups)
+		{
+			for (iteration=0;iteration<infoGlobal.m_numIterations;iteration++)
+				solveSingleIteration(iteration,bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+		} else
+		{
+			for (iteration=0;iteration<infoGlobal.m_numIterations;iteration++)
+				solveIterativeRows(iteration,constraints,numConstraints,infoGlobal);
+		}
+	}
+	return 0.f;
+}
@@ -0,0 +1,150 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_BLOCK_PIVOTING_CONSTRAINT_SOLVER_H
+#define BT_BLOCK_PIVOTING_CONSTRAINT_SOLVER_H
+
+#include "btSequentialImpulseConstraintSolver.h"
+#include "BulletCollision/CollisionDispatch/btUnionFind.h"
+
+///number of connected row groups solved directly, iteratively, and direct solves that failed and were solved iteratively instead
+extern int gNumDirectSolverIslands;
+extern int gNumIterativeSolverIslands;
+extern int gNumDirectSolverFallbacks;
+
+///The btBlockPivotingConstraintSolver solves small groups of constraint rows directly, and the other rows with the projected Gauss Seidel
+///iterations of the btSequentialImpulseConstraintSolver.
+///The rows passed to solveGroup are split into groups of rows that are connected through dynamic bodies, so batched islands are handled
+///separately. A group with at most getMaxDirectRows() rows, such as a door on a hinge or a short chain, is solved as a dense boxed LCP using
+///block principal pivoting, so it doesn't need btContactSolverInfo::m_numIterations to converge. The friction bounds are updated from the
+///normal impulses between pivoting solves.
+///The split impulse (positional) correction is always iterative.
+class btBlockPivotingConstraintSolver : public btSequentialImpulseConstraintSolver
+{
+protected:
+
+	enum	btDirectRowType
+	{
+		BT_DIRECT_NON_CONTACT_ROW = 0,
+		BT_DIRECT_CONTACT_ROW,
+		BT_DIRECT_FRICTION_ROW
+	};
+
+	struct	btDirectRow
+	{
+		btSolverConstraint*	m_constraint;
+		int					m_type;
+		int					m_poolIndex;
+	};
+
+	enum	btPivotingState
+	{
+		BT_PIVOT_FREE = 0,
+		BT_PIVOT_LOWER,
+		BT_PIVOT_UPPER,
+		BT_PIVOT_FIXED
+	};
+
+	int		m_maxDirectRows;
+	int		m_maxPivotingIterations;
+	int		m_numFrictionPasses;
+	btScalar	m_regularization;
+
+	btUnionFind							m_bodyUnionFind;
+	btAlignedObjectArray<int>			m_groupRowOffsets;
+	btAlignedObjectArray<int>			m_groupIterative;
+	btAlignedObjectArray<btDirectRow>	m_groupRows;
+	btAlignedObjectArray<int>			m_contactLocalIndex;
+	btAlignedObjectArray<btVector3>		m_rowEffects;
+
+	btAlignedObjectArray<int>	m_iterativeNonContactRows;
+	btAlignedObjectArray<int>	m_iterativeContactRows;
+	btAlignedObjectArray<int>	m_iterativeFrictionRows;
+
+	///dense boxed LCP A x = b + w, stored row major
+	btAlignedObjectArray<btScalar>	m_A;
+	btAlignedObjectArray<btScalar>	m_b;
+	btAlignedObjectArray<btScalar>	m_x;
+	btAlignedObjectArray<btScalar>	m_lo;
+	btAlignedObjectArray<btScalar>	m_hi;
+	btAlignedObjectArray<int>		m_state;
+	btAlignedObjectArray<int>		m_freeIndices;
+	btAlignedObjectArray<int>		m_infeasible;
+	btAlignedObjectArray<btScalar>	m_subA;
+	btAlignedObjectArray<btScalar>	m_subB;
+
+	int		getDynamicBodyIndex(btRigidBody* body,btCollisionObject** bodies,int numBodies) const;
+
+	///sorts the rows into groups of rows that are connected through dynamic bodies
+	void	buildRowGroups(btCollisionObject** bodies,int numBodies,btTypedConstraint** constraints,int numConstraints);
+
+	bool	solveDirectGroup(const btDirectRow* rows,int numRows);
+
+	bool	solveBoxedLCP(int n,bool initStates);
+
+	bool	solveDenseSystem(int n);
+
+	void	solveIterativeRows(int iteration,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal);
+
+	virtual btScalar solveGroupCacheFriendlyIterations(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc);
+
+public:
+
+	btBlockPivotingConstraintSolver();
+
+	virtual ~btBlockPivotingConstraintSolver();
+
+	///groups with more rows use the iterative solver, 0 disables the direct solver
+	void	setMaxDirectRows(int maxDirectRows)
+	{
+		m_maxDirectRows = maxDirectRows;
+	}
+	int		getMaxDirectRows() const
+	{
+		return m_maxDirectRows;
+	}
+
+	///when the pivoting doesn't terminate within this amount of pivoting steps, the group falls back to the iterative solver
+	void	setMaxPivotingIterations(int maxIterations)
+	{
+		m_maxPivotingIterations = maxIterations;
+	}
+	int		getMaxPivotingIterations() const
+	{
+		return m_maxPivotingIterations;
+	}
+
+	///the friction bounds depend on the normal impulses, they are updated at most this amount of times
+	void	setNumFrictionPasses(int numPasses)
+	{
+		m_numFrictionPasses = numPasses;
+	}
+	int		getNumFrictionPasses() const
+	{
+		return m_numFrictionPasses;
+	}
+
+	///relative diagonal regularization, keeps redundant rows (for example 4 coplanar contacts) solvable
+	void	setRegularization(btScalar regularization)
+	{
+		m_regularization = regularization;
+	}
+	btScalar	getRegularization() const
+	{
+		return m_regularization;
+	}
+};
+
+#endif //BT_BLOCK_PIVOTING_CONSTRAINT_SOLVER_H
@@ -969,6 +969,7 @@ void btConeTwistConstraint::adjustSwingAxisToUseEllipseNormal(btVector3& vSwingA
 
 void btConeTwistConstraint::setMotorTarget(const btQuaternion &q)
 {
+	setRowCacheDirty();
 	btTransform trACur = m_rbA.getCenterOfMassTransform();
 	btTransform trBCur = m_rbB.getCenterOfMassTransform();
 	btTransform trABCur = trBCur.inverse() * trACur;
@@ -983,6 +984,7 @@ void btConeTwistConstraint::setMotorTarget(const btQuaternion &q)
 
 void btConeTwistConstraint::setMotorTargetInConstraintSpace(const btQuaternion &q)
 {
+	setRowCacheDirty();
 	m_qTarget = q;
 
 	// clamp motor target to within limits
@@ -1035,6 +1037,7 @@ void btConeTwistConstraint::setMotorTargetInConstraintSpace(const btQuaternion &
 ///If no axis is provided, it uses the default axis for this constraint.
 void btConeTwistConstraint::setParam(int num, btScalar value, int axis)
 {
+	setRowCacheDirty();
 	switch(num)
 	{
 		case BT_CONSTRAINT_ERP :
@@ -1116,6 +1119,7 @@ btScalar btConeTwistConstraint::getParam(int num, int axis) const
 
 void btConeTwistConstraint::setFrames(const btTransform & frameA, const btTransform & frameB)
 {
+	setRowCacheDirty();
 	m_rbAFrame = frameA;
 	m_rbBFrame = frameB;
 	buildJacobian();
@@ -157,6 +157,7 @@ public:
 	void	setAngularOnly(bool angularOnly)
 	{
 		m_angularOnly = angularOnly;
+		setRowCacheDirty();
 	}
 
 	void	setLimit(int limitIndex,btScalar limitValue)
@@ -182,6 +183,7 @@ public:
 			{
 			}
 		};
+		setRowCacheDirty();
 	}
 
 	// setLimit(), a few notes:
@@ -204,6 +206,7 @@ public:
 		m_limitSoftness =  _softness;
 		m_biasFactor = _biasFactor;
 		m_relaxationFactor = _relaxationFactor;
+		setRowCacheDirty();
 	}
 
 	const btTransform& getAFrame() { return m_rbAFrame; };	
@@ -245,14 +248,14 @@ public:
 	}
 	bool isPastSwingLimit() { return m_solveSwingLimit; }
 
-	void setDamping(btScalar damping) { m_damping = damping; }
+	void setDamping(btScalar damping) { m_damping = damping; setRowCacheDirty(); }
 
-	void enableMotor(bool b) { m_bMotorEnabled = b; }
-	void setMaxMotorImpulse(btScalar maxMotorImpulse) { m_maxMotorImpulse = maxMotorImpulse; m_bNormalizedMotorStrength = false; }
-	void setMaxMotorImpulseNormalized(btScalar maxMotorImpulse) { m_maxMotorImpulse = maxMotorImpulse; m_bNormalizedMotorStrength = true; }
+	void enableMotor(bool b) { m_bMotorEnabled = b; setRowCacheDirty(); }
+	void setMaxMotorImpulse(btScalar maxMotorImpulse) { m_maxMotorImpulse = maxMotorImpulse; m_bNormalizedMotorStrength = false; setRowCacheDirty(); }
+	void setMaxMotorImpulseNormalized(btScalar maxMotorImpulse) { m_maxMotorImpulse = maxMotorImpulse; m_bNormalizedMotorStrength = true; setRowCacheDirty(); }
 
 	btScalar getFixThresh() { return m_fixThresh; }
-	void setFixThresh(btScalar fixThresh) { m_fixThresh = fixThresh; }
+	void setFixThresh(btScalar fixThresh) { m_fixThresh = fixThresh; setRowCacheDirty(); }
 
 	// setMotorTarget:
 	// q: the desired rotation of bodyA wrt bodyB.
@@ -27,7 +27,9 @@ enum	btSolverMode
 	SOLVER_DISABLE_VELOCITY_DEPENDENT_FRICTION_DIRECTION = 64,
 	SOLVER_CACHE_FRIENDLY = 128,
 	SOLVER_SIMD = 256,	//enabled for Windows, the solver innerloop is branchless SIMD, 40% faster than FPU/scalar version
-	SOLVER_CUDA = 512	//will be open sourced during Game Developers Conference 2009. Much faster.
+	SOLVER_CUDA = 512,	//will be open sourced during Game Developers Conference 2009. Much faster.
+	SOLVER_CACHE_CONSTRAINT_ROWS = 1024,	//reuse the rows of a btTypedConstraint while its bodies didn't move more than m_rowCacheLinearThreshold/m_rowCacheAngularThreshold
+	SOLVER_DETERMINISTIC = 2048	//restart the random order for each solved group and ignore SOLVER_CACHE_CONSTRAINT_ROWS, so the result only depends on the group itself
 };
 
 struct btContactSolverInfoData
@@ -53,6 +55,9 @@ struct btContactSolverInfoData
 	int			m_solverMode;
 	int	m_restingContactRestitutionThreshold;
 	int			m_minimumSolverBatchSize;
+	btScalar	m_rowCacheLinearThreshold;//see SOLVER_CACHE_CONSTRAINT_ROWS
+	btScalar	m_rowCacheAngularThreshold;
+	int			m_constraintSetupGrainSize;//amount of constraints per btParallelFor task in the constraint row setup
 
 
 };
@@ -81,6 +86,9 @@ struct btContactSolverInfo : public btContactSolverInfoData
 		m_solverMode = SOLVER_USE_WARMSTARTING | SOLVER_SIMD;// | SOLVER_RANDMIZE_ORDER;
 		m_restingContactRestitutionThreshold = 2;//resting contact lifetime threshold to disable restitution
 		m_minimumSolverBatchSize = 128; //try to combine islands until the amount of constraints reaches this limit
+		m_rowCacheLinearThreshold = btScalar(1e-4);
+		m_rowCacheAngularThreshold = btScalar(1e-4);
+		m_constraintSetupGrainSize = 64;
 	}
 };
 
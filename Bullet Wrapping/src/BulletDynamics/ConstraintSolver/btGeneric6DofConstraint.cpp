@@ -715,6 +715,7 @@ void	btGeneric6DofConstraint::updateRHS(btScalar	timeStep)
 
 void btGeneric6DofConstraint::setFrames(const btTransform& frameA, const btTransform& frameB)
 {
+	setRowCacheDirty();
 	m_frameInA = frameA;
 	m_frameInB = frameB;
 	buildJacobian();
@@ -898,6 +899,7 @@ int btGeneric6DofConstraint::get_limit_motor_info2(
                 // deal with bounce
                 if (limot->m_bounce > 0)
                 {
+                    m_rowsVelocityDependent = true;
                     // calculate joint velocity
                     btScalar vel;
                     if (rotational)
@@ -951,6 +953,7 @@ int btGeneric6DofConstraint::get_limit_motor_info2(
 	///If no axis is provided, it uses the default axis for this constraint.
 void btGeneric6DofConstraint::setParam(int num, btScalar value, int axis)
 {
+	setRowCacheDirty();
 	if((axis >= 0) && (axis < 3))
 	{
 		switch(num)
@@ -1052,6 +1055,7 @@ btScalar btGeneric6DofConstraint::getParam(int num, int axis) const
 
 void btGeneric6DofConstraint::setAxis(const btVector3& axis1,const btVector3& axis2)
 {
+	setRowCacheDirty();
 	btVector3 zAxis = axis1.normalized();
 	btVector3 yAxis = axis2.normalized();
 	btVector3 xAxis = yAxis.cross(zAxis); // we want right coordinate system
@@ -445,6 +445,7 @@ public:
     void	setLinearLowerLimit(const btVector3& linearLower)
     {
     	m_linearLimits.m_lowerLimit = linearLower;
+		setRowCacheDirty();
     }
 
 	void	getLinearLowerLimit(btVector3& linearLower)
@@ -455,6 +456,7 @@ public:
 	void	setLinearUpperLimit(const btVector3& linearUpper)
 	{
 		m_linearLimits.m_upperLimit = linearUpper;
+		setRowCacheDirty();
 	}
 
 	void	getLinearUpperLimit(btVector3& linearUpper)
@@ -466,6 +468,7 @@ public:
     {
 		for(int i = 0; i < 3; i++) 
 			m_angularLimits[i].m_loLimit = btNormalizeAngle(angularLower[i]);
+		setRowCacheDirty();
     }
 
 	void	getAngularLowerLimit(btVector3& angularLower)
@@ -478,6 +481,7 @@ public:
     {
 		for(int i = 0; i < 3; i++)
 			m_angularLimits[i].m_hiLimit = btNormalizeAngle(angularUpper[i]);
+		setRowCacheDirty();
     }
 
 	void	getAngularUpperLimit(btVector3& angularUpper)
@@ -513,6 +517,7 @@ public:
     		m_angularLimits[axis-3].m_loLimit = lo;
     		m_angularLimits[axis-3].m_hiLimit = hi;
     	}
+		setRowCacheDirty();
     }
 
 	//! Test limit
@@ -540,7 +545,7 @@ public:
 
 	// access for UseFrameOffset
 	bool getUseFrameOffset() { return m_useOffsetForConstraintFrame; }
-	void setUseFrameOffset(bool frameOffsetOnOff) { m_useOffsetForConstraintFrame = frameOffsetOnOff; }
+	void setUseFrameOffset(bool frameOffsetOnOff) { m_useOffsetForConstraintFrame = frameOffsetOnOff; setRowCacheDirty(); }
 
 	///override the default global value of a parameter (such as ERP or CFM), optionally provide the axis (0..5). 
 	///If no axis is provided, it uses the default axis for this constraint.
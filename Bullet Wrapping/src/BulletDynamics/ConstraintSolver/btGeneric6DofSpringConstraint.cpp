@@ -35,6 +35,7 @@ btGeneric6DofSpringConstraint::btGeneric6DofSpringConstraint(btRigidBody& rbA, b
 
 void btGeneric6DofSpringConstraint::enableSpring(int index, bool onOff)
 {
+	setRowCacheDirty();
 	btAssert((index >= 0) && (index < 6));
 	m_springEnabled[index] = onOff;
 	if(index < 3)
@@ -51,6 +52,7 @@ void btGeneric6DofSpringConstraint::enableSpring(int index, bool onOff)
 
 void btGeneric6DofSpringConstraint::setStiffness(int index, btScalar stiffness)
 {
+	setRowCacheDirty();
 	btAssert((index >= 0) && (index < 6));
 	m_springStiffness[index] = stiffness;
 }
@@ -58,6 +60,7 @@ void btGeneric6DofSpringConstraint::setStiffness(int index, btScalar stiffness)
 
 void btGeneric6DofSpringConstraint::setDamping(int index, btScalar damping)
 {
+	setRowCacheDirty();
 	btAssert((index >= 0) && (index < 6));
 	m_springDamping[index] = damping;
 }
@@ -65,6 +68,7 @@ void btGeneric6DofSpringConstraint::setDamping(int index, btScalar damping)
 
 void btGeneric6DofSpringConstraint::setEquilibriumPoint()
 {
+	setRowCacheDirty();
 	calculateTransforms();
 	int i;
 
@@ -82,6 +86,7 @@ void btGeneric6DofSpringConstraint::setEquilibriumPoint()
 
 void btGeneric6DofSpringConstraint::setEquilibriumPoint(int index)
 {
+	setRowCacheDirty();
 	btAssert((index >= 0) && (index < 6));
 	calculateTransforms();
 	if(index < 3)
@@ -96,6 +101,7 @@ void btGeneric6DofSpringConstraint::setEquilibriumPoint(int index)
 
 void btGeneric6DofSpringConstraint::setEquilibriumPoint(int index, btScalar val)
 {
+	setRowCacheDirty();
 	btAssert((index >= 0) && (index < 6));
 	m_equilibriumPoint[index] = val;
 }
@@ -151,6 +157,7 @@ void btGeneric6DofSpringConstraint::getInfo2(btConstraintInfo2* info)
 
 void btGeneric6DofSpringConstraint::setAxis(const btVector3& axis1,const btVector3& axis2)
 {
+	setRowCacheDirty();
 	btVector3 zAxis = axis1.normalized();
 	btVector3 yAxis = axis2.normalized();
 	btVector3 xAxis = yAxis.cross(zAxis); // we want right coordinate system
@@ -545,6 +545,7 @@ void btHingeConstraint::getInfo2Internal(btConstraintInfo2* info, const btTransf
 #endif
 			if(bounce > btScalar(0.0))
 			{
+				m_rowsVelocityDependent = true;
 				btScalar vel = angVelA.dot(ax1);
 				vel -= angVelB.dot(ax1);
 				// only apply bounce if the velocity is incoming, and if the
@@ -584,6 +585,7 @@ void btHingeConstraint::getInfo2Internal(btConstraintInfo2* info, const btTransf
 
 void btHingeConstraint::setFrames(const btTransform & frameA, const btTransform & frameB)
 {
+	setRowCacheDirty();
 	m_rbAFrame = frameA;
 	m_rbBFrame = frameB;
 	buildJacobian();
@@ -649,6 +651,7 @@ static btVector3 vHinge(0, 0, btScalar(1));
 
 void btHingeConstraint::setMotorTarget(const btQuaternion& qAinB, btScalar dt)
 {
+	setRowCacheDirty();
 	// convert target from body to constraint space
 	btQuaternion qConstraint = m_rbBFrame.getRotation().inverse() * qAinB * m_rbAFrame.getRotation();
 	qConstraint.normalize();
@@ -674,6 +677,7 @@ void btHingeConstraint::setMotorTarget(const btQuaternion& qAinB, btScalar dt)
 
 void btHingeConstraint::setMotorTarget(btScalar targetAngle, btScalar dt)
 {
+	setRowCacheDirty();
 #ifdef	_BT_USE_CENTER_LIMIT_
 	m_limit.fit(targetAngle);
 #else
@@ -932,6 +936,7 @@ void btHingeConstraint::getInfo2InternalUsingFrameOffset(btConstraintInfo2* info
 #endif
 			if(bounce > btScalar(0.0))
 			{
+				m_rowsVelocityDependent = true;
 				btScalar vel = angVelA.dot(ax1);
 				vel -= angVelB.dot(ax1);
 				// only apply bounce if the velocity is incoming, and if the
@@ -973,6 +978,7 @@ void btHingeConstraint::getInfo2InternalUsingFrameOffset(btConstraintInfo2* info
 ///If no axis is provided, it uses the default axis for this constraint.
 void btHingeConstraint::setParam(int num, btScalar value, int axis)
 {
+	setRowCacheDirty();
 	if((axis == -1) || (axis == 5))
 	{
 		switch(num)
@@ -159,6 +159,7 @@ public:
 	void	setAngularOnly(bool angularOnly)
 	{
 		m_angularOnly = angularOnly;
+		setRowCacheDirty();
 	}
 
 	void	enableAngularMotor(bool enableMotor,btScalar targetVelocity,btScalar maxMotorImpulse)
@@ -166,13 +167,14 @@ public:
 		m_enableAngularMotor  = enableMotor;
 		m_motorTargetVelocity = targetVelocity;
 		m_maxMotorImpulse = maxMotorImpulse;
+		setRowCacheDirty();
 	}
 
 	// extra motor API, including ability to set a target rotation (as opposed to angular velocity)
 	// note: setMotorTarget sets angular velocity under the hood, so you must call it every tick to
 	//       maintain a given angular target.
-	void enableMotor(bool enableMotor) 	{ m_enableAngularMotor = enableMotor; }
-	void setMaxMotorImpulse(btScalar maxMotorImpulse) { m_maxMotorImpulse = maxMotorImpulse; }
+	void enableMotor(bool enableMotor) 	{ m_enableAngularMotor = enableMotor; setRowCacheDirty(); }
+	void setMaxMotorImpulse(btScalar maxMotorImpulse) { m_maxMotorImpulse = maxMotorImpulse; setRowCacheDirty(); }
 	void setMotorTarget(const btQuaternion& qAinB, btScalar dt); // qAinB is rotation of body A wrt body B.
 	void setMotorTarget(btScalar targetAngle, btScalar dt);
 
@@ -188,10 +190,12 @@ public:
 		m_biasFactor = _biasFactor;
 		m_relaxationFactor = _relaxationFactor;
 #endif
+		setRowCacheDirty();
 	}
 
 	void	setAxis(btVector3& axisInA)
 	{
+		setRowCacheDirty();
 		btVector3 rbAxisA1, rbAxisA2;
 		btPlaneSpace1(axisInA, rbAxisA1, rbAxisA2);
 		btVector3 pivotInA = m_rbAFrame.getOrigin();
@@ -283,7 +287,7 @@ public:
 	}
 	// access for UseFrameOffset
 	bool getUseFrameOffset() { return m_useOffsetForConstraintFrame; }
-	void setUseFrameOffset(bool frameOffsetOnOff) { m_useOffsetForConstraintFrame = frameOffsetOnOff; }
+	void setUseFrameOffset(bool frameOffsetOnOff) { m_useOffsetForConstraintFrame = frameOffsetOnOff; setRowCacheDirty(); }
 
 
 	///override the default global value of a parameter (such as ERP or CFM), optionally provide the axis (0..5). 
@@ -175,6 +175,7 @@ void	btPoint2PointConstraint::updateRHS(btScalar	timeStep)
 ///If no axis is provided, it uses the default axis for this constraint.
 void btPoint2PointConstraint::setParam(int num, btScalar value, int axis)
 {
+	setRowCacheDirty();
 	if(axis != -1)
 	{
 		btAssertConstrParams(0);
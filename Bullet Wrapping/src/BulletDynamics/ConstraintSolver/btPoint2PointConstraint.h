@@ -92,11 +92,13 @@ public:
 	void	setPivotA(const btVector3& pivotA)
 	{
 		m_pivotInA = pivotA;
+		setRowCacheDirty();
 	}
 
 	void	setPivotB(const btVector3& pivotB)
 	{
 		m_pivotInB = pivotB;
+		setRowCacheDirty();
 	}
 
 	const btVector3& getPivotInA() const
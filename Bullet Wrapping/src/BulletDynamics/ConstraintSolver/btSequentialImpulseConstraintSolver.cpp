@@ -32,6 +32,7 @@ subject to the following restrictions:
 #include "btSolverBody.h"
 #include "btSolverConstraint.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btThreads.h"
 #include <string.h> //for memset
 
 int		gNumSplitImpulseRecoveries = 0;
@@ -39,11 +40,12 @@ int		gNumSplitImpulseRecoveries = 0;
 btSequentialImpulseConstraintSolver::btSequentialImpulseConstraintSolver()
 :m_btSeed2(0)
 {
-
+	m_fixedBody = new btRigidBody(0,0,0);
 }
 
 btSequentialImpulseConstraintSolver::~btSequentialImpulseConstraintSolver()
 {
+	delete m_fixedBody;
 }
 
 #ifdef USE_SIMD
@@ -181,7 +183,7 @@ void	btSequentialImpulseConstraintSolver::resolveSplitPenetrationImpulseCacheFri
 {
 		if (c.m_rhsPenetration)
         {
-			gNumSplitImpulseRecoveries++;
+			btAtomicAdd(gNumSplitImpulseRecoveries,1);
 			btScalar deltaImpulse = c.m_rhsPenetration-btScalar(c.m_appliedPushImpulse)*c.m_cfm;
 			const btScalar deltaVel1Dotn	=	c.m_contactNormal.dot(body1.internalGetPushVelocity()) 	+ c.m_relpos1CrossNormal.dot(body1.internalGetTurnVelocity());
 			const btScalar deltaVel2Dotn	=	-c.m_contactNormal.dot(body2.internalGetPushVelocity()) + c.m_relpos2CrossNormal.dot(body2.internalGetTurnVelocity());
@@ -209,7 +211,7 @@ void	btSequentialImpulseConstraintSolver::resolveSplitPenetrationImpulseCacheFri
 	if (!c.m_rhsPenetration)
 		return;
 
-	gNumSplitImpulseRecoveries++;
+	btAtomicAdd(gNumSplitImpulseRecoveries,1);
 
 	__m128 cpAppliedImp = _mm_set1_ps(c.m_appliedPushImpulse);
 	__m128	lowerLimit1 = _mm_set1_ps(c.m_lowerLimit);
@@ -741,12 +743,214 @@ void	btSequentialImpulseConstraintSolver::convertContact(btPersistentManifold* m
 }
 
 
+///constraints to the world share btTypedConstraint::getFixedBody, their rows use the fixed body of the solver instead
+static SIMD_FORCE_INLINE btRigidBody*	btGetConstraintSolverBody(btRigidBody& body,btRigidBody* fixedBody)
+{
+	return (&body == &btTypedConstraint::getFixedBody()) ? fixedBody : &body;
+}
+
+///fills in the rows of one btTypedConstraint, it only writes to its own rows and the constraint, so constraints can be converted concurrently.
+///solverBodyA and solverBodyB are its bodies as returned by btGetConstraintSolverBody.
+static void	btConvertJoint(btSolverConstraint* currentConstraintRow,btTypedConstraint* constraint,btRigidBody* solverBodyA,btRigidBody* solverBodyB,const btTypedConstraint::btConstraintInfo1& info1,bool rowsCached,bool useRowCache,const btContactSolverInfo& infoGlobal)
+{
+	btRigidBody& rbA = constraint->getRigidBodyA();
+	btRigidBody& rbB = constraint->getRigidBodyB();
+
+	int j;
+	for ( j=0;j<info1.m_numConstraintRows;j++)
+	{
+		memset(&currentConstraintRow[j],0,sizeof(btSolverConstraint));
+		currentConstraintRow[j].m_lowerLimit = -SIMD_INFINITY;
+		currentConstraintRow[j].m_upperLimit = SIMD_INFINITY;
+		currentConstraintRow[j].m_appliedImpulse = 0.f;
+		currentConstraintRow[j].m_appliedPushImpulse = 0.f;
+		currentConstraintRow[j].m_solverBodyA = solverBodyA;
+		currentConstraintRow[j].m_solverBodyB = solverBodyB;
+	}
+
+	btTypedConstraint::btConstraintInfo2 info2;
+	info2.fps = 1.f/infoGlobal.m_timeStep;
+	info2.erp = infoGlobal.m_erp;
+	info2.m_J1linearAxis = currentConstraintRow->m_contactNormal;
+	info2.m_J1angularAxis = currentConstraintRow->m_relpos1CrossNormal;
+	info2.m_J2linearAxis = 0;
+	info2.m_J2angularAxis = currentConstraintRow->m_relpos2CrossNormal;
+	info2.rowskip = sizeof(btSolverConstraint)/sizeof(btScalar);//check this
+	///the size of btSolverConstraint needs be a multiple of btScalar
+	btAssert(info2.rowskip*sizeof(btScalar)== sizeof(btSolverConstraint));
+	info2.m_constraintError = &currentConstraintRow->m_rhs;
+	currentConstraintRow->m_cfm = infoGlobal.m_globalCfm;
+	info2.m_damping = infoGlobal.m_damping;
+	info2.cfm = &currentConstraintRow->m_cfm;
+	info2.m_lowerLimit = &currentConstraintRow->m_lowerLimit;
+	info2.m_upperLimit = &currentConstraintRow->m_upperLimit;
+	info2.m_numIterations = infoGlobal.m_numIterations;
+	if (rowsCached)
+	{
+		constraint->internalGetCachedInfo2(&info2);
+	} else if (useRowCache)
+	{
+		constraint->internalGetInfo2AndCacheRows(info1,&info2,infoGlobal);
+	} else
+	{
+		constraint->getInfo2(&info2);
+	}
+
+	if (currentConstraintRow->m_upperLimit>constraint->getBreakingImpulseThreshold())
+	{
+		currentConstraintRow->m_upperLimit = constraint->getBreakingImpulseThreshold();
+	}
+
+	if (currentConstraintRow->m_lowerLimit<-constraint->getBreakingImpulseThreshold())
+	{
+		currentConstraintRow->m_lowerLimit = -constraint->getBreakingImpulseThreshold();
+	}
+
+
+
+	///finalize the constraint setup
+	for ( j=0;j<info1.m_numConstraintRows;j++)
+	{
+		btSolverConstraint& solverConstraint = currentConstraintRow[j];
+		solverConstraint.m_originalContactPoint = constraint;
+
+		{
+			const btVector3& ftorqueAxis1 = solverConstraint.m_relpos1CrossNormal;
+			solverConstraint.m_angularComponentA = constraint->getRigidBodyA().getInvInertiaTensorWorld()*ftorqueAxis1*constraint->getRigidBodyA().getAngularFactor();
+		}
+		{
+			const btVector3& ftorqueAxis2 = solverConstraint.m_relpos2CrossNormal;
+			solverConstraint.m_angularComponentB = constraint->getRigidBodyB().getInvInertiaTensorWorld()*ftorqueAxis2*constraint->getRigidBodyB().getAngularFactor();
+		}
+
+		{
+			btVector3 iMJlA = solverConstraint.m_contactNormal*rbA.getInvMass();
+			btVector3 iMJaA = rbA.getInvInertiaTensorWorld()*solverConstraint.m_relpos1CrossNormal;
+			btVector3 iMJlB = solverConstraint.m_contactNormal*rbB.getInvMass();//sign of normal?
+			btVector3 iMJaB = rbB.getInvInertiaTensorWorld()*solverConstraint.m_relpos2CrossNormal;
+
+			btScalar sum = iMJlA.dot(solverConstraint.m_contactNormal);
+			sum += iMJaA.dot(solverConstraint.m_relpos1CrossNormal);
+			sum += iMJlB.dot(solverConstraint.m_contactNormal);
+			sum += iMJaB.dot(solverConstraint.m_relpos2CrossNormal);
+
+			solverConstraint.m_jacDiagABInv = btScalar(1.)/sum;
+		}
+
+
+		///fix rhs
+		///todo: add force/torque accelerators
+		{
+			btScalar rel_vel;
+			btScalar vel1Dotn = solverConstraint.m_contactNormal.dot(rbA.getLinearVelocity()) + solverConstraint.m_relpos1CrossNormal.dot(rbA.getAngularVelocity());
+			btScalar vel2Dotn = -solverConstraint.m_contactNormal.dot(rbB.getLinearVelocity()) + solverConstraint.m_relpos2CrossNormal.dot(rbB.getAngularVelocity());
+
+			rel_vel = vel1Dotn+vel2Dotn;
+
+			btScalar restitution = 0.f;
+			btScalar positionalError = solverConstraint.m_rhs;//already filled in by getConstraintInfo2
+			btScalar	velocityError = restitution - rel_vel * info2.m_damping;
+			btScalar	penetrationImpulse = positionalError*solverConstraint.m_jacDiagABInv;
+			btScalar	velocityImpulse = velocityError *solverConstraint.m_jacDiagABInv;
+			solverConstraint.m_rhs = penetrationImpulse+velocityImpulse;
+			solverConstraint.m_appliedImpulse = 0.f;
+
+		}
+	}
+}
+
+///calculates the amount of rows of a range of constraints, using the row cache when possible
+struct	btConstraintInfo1Loop : public btIParallelForBody
+{
+	btTypedConstraint**	m_constraints;
+	btTypedConstraint::btConstraintInfo1*	m_info1;
+	int*	m_rowsCached;
+	bool	m_useRowCache;
+	const btContactSolverInfo&	m_infoGlobal;
+
+	btConstraintInfo1Loop(btTypedConstraint** constraints,btTypedConstraint::btConstraintInfo1* info1,int* rowsCached,bool useRowCache,const btContactSolverInfo& infoGlobal)
+		:m_constraints(constraints),
+		m_info1(info1),
+		m_rowsCached(rowsCached),
+		m_useRowCache(useRowCache),
+		m_infoGlobal(infoGlobal)
+	{
+	}
+
+	virtual void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			btTypedConstraint::btConstraintInfo1& info1 = m_info1[i];
+			m_rowsCached[i] = 0;
+			if (m_constraints[i]->isEnabled())
+			{
+				if (m_useRowCache && m_constraints[i]->internalGetCachedInfo1(&info1,m_infoGlobal))
+				{
+					m_rowsCached[i] = 1;
+				} else
+				{
+					m_constraints[i]->getInfo1(&info1);
+				}
+			} else
+			{
+				info1.m_numConstraintRows = 0;
+				info1.nub = 0;
+			}
+		}
+	}
+};
+
+///converts a range of constraints into their rows in the non-contact constraint pool
+struct	btConvertJointsLoop : public btIParallelForBody
+{
+	btTypedConstraint**	m_constraints;
+	const btTypedConstraint::btConstraintInfo1*	m_info1;
+	const int*	m_rowOffsets;
+	const int*	m_rowsCached;
+	btSolverConstraint*	m_rows;
+	btRigidBody*	m_fixedBody;
+	bool	m_useRowCache;
+	const btContactSolverInfo&	m_infoGlobal;
+
+	btConvertJointsLoop(btTypedConstraint** constraints,const btTypedConstraint::btConstraintInfo1* info1,const int* rowOffsets,const int* rowsCached,
+		btSolverConstraint* rows,btRigidBody* fixedBody,bool useRowCache,const btContactSolverInfo& infoGlobal)
+		:m_constraints(constraints),
+		m_info1(info1),
+		m_rowOffsets(rowOffsets),
+		m_rowsCached(rowsCached),
+		m_rows(rows),
+		m_fixedBody(fixedBody),
+		m_useRowCache(useRowCache),
+		m_infoGlobal(infoGlobal)
+	{
+	}
+
+	virtual void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			if (m_info1[i].m_numConstraintRows)
+			{
+				btTypedConstraint* constraint = m_constraints[i];
+				btConvertJoint(&m_rows[m_rowOffsets[i]],constraint,btGetConstraintSolverBody(constraint->getRigidBodyA(),m_fixedBody),
+					btGetConstraintSolverBody(constraint->getRigidBodyB(),m_fixedBody),m_info1[i],m_rowsCached[i]!=0,m_useRowCache,m_infoGlobal);
+			}
+		}
+	}
+};
+
+
 btScalar btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc)
 {
 	BT_PROFILE("solveGroupCacheFriendlySetup");
 	(void)stackAlloc;
 	(void)debugDrawer;
 
+	if (infoGlobal.m_solverMode & SOLVER_DETERMINISTIC)
+	{
+		m_btSeed2 = 0;
+	}
 
 	if (!(numConstraints + numManifolds))
 	{
@@ -801,143 +1005,41 @@ btScalar btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(btCol
 			int i;
 			
 			m_tmpConstraintSizesPool.resize(numConstraints);
+			m_tmpConstraintRowOffsetPool.resize(numConstraints);
+			m_tmpConstraintRowsCachedPool.resize(numConstraints);
+
+			//cached rows depend on the steps in which they were refreshed, which a restored snapshot doesn't reproduce
+			bool useRowCache = (infoGlobal.m_solverMode & (SOLVER_CACHE_CONSTRAINT_ROWS|SOLVER_DETERMINISTIC)) == SOLVER_CACHE_CONSTRAINT_ROWS;
+			int grainSize = btMax(infoGlobal.m_constraintSetupGrainSize,1);
+
 			//calculate the total number of contraint rows
+			if (numConstraints)
+			{
+				btConstraintInfo1Loop info1Loop(constraints,&m_tmpConstraintSizesPool[0],&m_tmpConstraintRowsCachedPool[0],useRowCache,infoGlobal);
+				btParallelFor(0,numConstraints,grainSize,info1Loop);
+			}
 			for (i=0;i<numConstraints;i++)
 			{
-				btTypedConstraint::btConstraintInfo1& info1 = m_tmpConstraintSizesPool[i];
-				if (constraints[i]->isEnabled())
-				{
-					constraints[i]->getInfo1(&info1);
-				} else
+				m_tmpConstraintRowOffsetPool[i] = totalNumRows;
+				if (m_tmpConstraintSizesPool[i].m_numConstraintRows)
 				{
-					info1.m_numConstraintRows = 0;
-					info1.nub = 0;
+					btRigidBody* rbA = btGetConstraintSolverBody(constraints[i]->getRigidBodyA(),m_fixedBody);
+					btRigidBody* rbB = btGetConstraintSolverBody(constraints[i]->getRigidBodyB(),m_fixedBody);
+					rbA->internalGetDeltaLinearVelocity().setValue(0.f,0.f,0.f);
+					rbA->internalGetDeltaAngularVelocity().setValue(0.f,0.f,0.f);
+					rbB->internalGetDeltaLinearVelocity().setValue(0.f,0.f,0.f);
+					rbB->internalGetDeltaAngularVelocity().setValue(0.f,0.f,0.f);
 				}
-				totalNumRows += info1.m_numConstraintRows;
+				totalNumRows += m_tmpConstraintSizesPool[i].m_numConstraintRows;
 			}
 			m_tmpSolverNonContactConstraintPool.resize(totalNumRows);
 
-			
-			///setup the btSolverConstraints
-			int currentRow = 0;
-
-			for (i=0;i<numConstraints;i++)
+			///setup the btSolverConstraints, each constraint fills in its own range of rows
+			if (totalNumRows)
 			{
-				const btTypedConstraint::btConstraintInfo1& info1 = m_tmpConstraintSizesPool[i];
-				
-				if (info1.m_numConstraintRows)
-				{
-					btAssert(currentRow<totalNumRows);
-
-					btSolverConstraint* currentConstraintRow = &m_tmpSolverNonContactConstraintPool[currentRow];
-					btTypedConstraint* constraint = constraints[i];
-
-
-					btRigidBody& rbA = constraint->getRigidBodyA();
-					btRigidBody& rbB = constraint->getRigidBodyB();
-
-					
-					int j;
-					for ( j=0;j<info1.m_numConstraintRows;j++)
-					{
-						memset(&currentConstraintRow[j],0,sizeof(btSolverConstraint));
-						currentConstraintRow[j].m_lowerLimit = -SIMD_INFINITY;
-						currentConstraintRow[j].m_upperLimit = SIMD_INFINITY;
-						currentConstraintRow[j].m_appliedImpulse = 0.f;
-						currentConstraintRow[j].m_appliedPushImpulse = 0.f;
-						currentConstraintRow[j].m_solverBodyA = &rbA;
-						currentConstraintRow[j].m_solverBodyB = &rbB;
-					}
-
-					rbA.internalGetDeltaLinearVelocity().setValue(0.f,0.f,0.f);
-					rbA.internalGetDeltaAngularVelocity().setValue(0.f,0.f,0.f);
-					rbB.internalGetDeltaLinearVelocity().setValue(0.f,0.f,0.f);
-					rbB.internalGetDeltaAngularVelocity().setValue(0.f,0.f,0.f);
-
-
-
-					btTypedConstraint::btConstraintInfo2 info2;
-					info2.fps = 1.f/infoGlobal.m_timeStep;
-					info2.erp = infoGlobal.m_erp;
-					info2.m_J1linearAxis = currentConstraintRow->m_contactNormal;
-					info2.m_J1angularAxis = currentConstraintRow->m_relpos1CrossNormal;
-					info2.m_J2linearAxis = 0;
-					info2.m_J2angularAxis = currentConstraintRow->m_relpos2CrossNormal;
-					info2.rowskip = sizeof(btSolverConstraint)/sizeof(btScalar);//check this
-					///the size of btSolverConstraint needs be a multiple of btScalar
-					btAssert(info2.rowskip*sizeof(btScalar)== sizeof(btSolverConstraint));
-					info2.m_constraintError = &currentConstraintRow->m_rhs;
-					currentConstraintRow->m_cfm = infoGlobal.m_globalCfm;
-					info2.m_damping = infoGlobal.m_damping;
-					info2.cfm = &currentConstraintRow->m_cfm;
-					info2.m_lowerLimit = &currentConstraintRow->m_lowerLimit;
-					info2.m_upperLimit = &currentConstraintRow->m_upperLimit;
-					info2.m_numIterations = infoGlobal.m_numIterations;
-					constraints[i]->getInfo2(&info2);
-
-					if (currentConstraintRow->m_upperLimit>constraints[i]->getBreakingImpulseThreshold())
-					{
-						currentConstraintRow->m_upperLimit = constraints[i]->getBreakingImpulseThreshold();
-					}
-
-					if (currentConstraintRow->m_lowerLimit<-constraints[i]->getBreakingImpulseThreshold())
-					{
-						currentConstraintRow->m_lowerLimit = -constraints[i]->getBreakingImpulseThreshold();
-					}
-
-
-
-					///finalize the constraint setup
-					for ( j=0;j<info1.m_numConstraintRows;j++)
-					{
-						btSolverConstraint& solverConstraint = currentConstraintRow[j];
-						solverConstraint.m_originalContactPoint = constraint;
-
-						{
-							const btVector3& ftorqueAxis1 = solverConstraint.m_relpos1CrossNormal;
-							solverConstraint.m_angularComponentA = constraint->getRigidBodyA().getInvInertiaTensorWorld()*ftorqueAxis1*constraint->getRigidBodyA().getAngularFactor();
-						}
-						{
-							const btVector3& ftorqueAxis2 = solverConstraint.m_relpos2CrossNormal;
-							solverConstraint.m_angularComponentB = constraint->getRigidBodyB().getInvInertiaTensorWorld()*ftorqueAxis2*constraint->getRigidBodyB().getAngularFactor();
-						}
-
-						{
-							btVector3 iMJlA = solverConstraint.m_contactNormal*rbA.getInvMass();
-							btVector3 iMJaA = rbA.getInvInertiaTensorWorld()*solverConstraint.m_relpos1CrossNormal;
-							btVector3 iMJlB = solverConstraint.m_contactNormal*rbB.getInvMass();//sign of normal?
-							btVector3 iMJaB = rbB.getInvInertiaTensorWorld()*solverConstraint.m_relpos2CrossNormal;
-
-							btScalar sum = iMJlA.dot(solverConstraint.m_contactNormal);
-							sum += iMJaA.dot(solverConstraint.m_relpos1CrossNormal);
-							sum += iMJlB.dot(solverConstraint.m_contactNormal);
-							sum += iMJaB.dot(solverConstraint.m_relpos2CrossNormal);
-
-							solverConstraint.m_jacDiagABInv = btScalar(1.)/sum;
-						}
-
-
-						///fix rhs
-						///todo: add force/torque accelerators
-						{
-							btScalar rel_vel;
-							btScalar vel1Dotn = solverConstraint.m_contactNormal.dot(rbA.getLinearVelocity()) + solverConstraint.m_relpos1CrossNormal.dot(rbA.getAngularVelocity());
-							btScalar vel2Dotn = -solverConstraint.m_contactNormal.dot(rbB.getLinearVelocity()) + solverConstraint.m_relpos2CrossNormal.dot(rbB.getAngularVelocity());
-
-							rel_vel = vel1Dotn+vel2Dotn;
-
-							btScalar restitution = 0.f;
-							btScalar positionalError = solverConstraint.m_rhs;//already filled in by getConstraintInfo2
-							btScalar	velocityError = restitution - rel_vel * info2.m_damping;
-							btScalar	penetrationImpulse = positionalError*solverConstraint.m_jacDiagABInv;
-							btScalar	velocityImpulse = velocityError *solverConstraint.m_jacDiagABInv;
-							solverConstraint.m_rhs = penetrationImpulse+velocityImpulse;
-							solverConstraint.m_appliedImpulse = 0.f;
-
-						}
-					}
-				}
-				currentRow+=m_tmpConstraintSizesPool[i].m_numConstraintRows;
+				btConvertJointsLoop convertLoop(constraints,&m_tmpConstraintSizesPool[0],&m_tmpConstraintRowOffsetPool[0],&m_tmpConstraintRowsCachedPool[0],
+					&m_tmpSolverNonContactConstraintPool[0],m_fixedBody,useRowCache,infoGlobal);
+				btParallelFor(0,numConstraints,grainSize,convertLoop);
 			}
 		}
 
@@ -1230,10 +1332,4 @@ void	btSequentialImpulseConstraintSolver::reset()
 	m_btSeed2 = 0;
 }
 
-btRigidBody& btSequentialImpulseConstraintSolver::getFixedBody()
-{
-	static btRigidBody s_fixed(0, 0,0);
-	s_fixed.setMassProps(btScalar(0.),btVector3(btScalar(0.),btScalar(0.),btScalar(0.)));
-	return s_fixed;
-}
 
@@ -562,6 +562,7 @@ void btSliderConstraint::getInfo2NonVirtual(btConstraintInfo2* info, const btTra
 			btScalar bounce = btFabs(btScalar(1.0) - getDampingLimLin());
 			if(bounce > btScalar(0.0))
 			{
+				m_rowsVelocityDependent = true;
 				btScalar vel = linVelA.dot(ax1);
 				vel -= linVelB.dot(ax1);
 				vel *= signFact;
@@ -665,6 +666,7 @@ void btSliderConstraint::getInfo2NonVirtual(btConstraintInfo2* info, const btTra
 			btScalar bounce = btFabs(btScalar(1.0) - getDampingLimAng());
 			if(bounce > btScalar(0.0))
 			{
+				m_rowsVelocityDependent = true;
 				btScalar vel = m_rbA.getAngularVelocity().dot(ax1);
 				vel -= m_rbB.getAngularVelocity().dot(ax1);
 				// only apply bounce if the velocity is incoming, and if the
@@ -702,6 +704,7 @@ void btSliderConstraint::getInfo2NonVirtual(btConstraintInfo2* info, const btTra
 ///If no axis is provided, it uses the default axis for this constraint.
 void btSliderConstraint::setParam(int num, btScalar value, int axis)
 {
+	setRowCacheDirty();
 	switch(num)
 	{
 	case BT_CONSTRAINT_STOP_ERP :
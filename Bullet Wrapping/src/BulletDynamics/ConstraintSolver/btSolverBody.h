@@ -23,7 +23,7 @@ class	btRigidBody;
 #include "LinearMath/btAlignedAllocator.h"
 #include "LinearMath/btTransformUtil.h"
 
-///Until we get other contributions, only use SIMD on Windows, when using Visual Studio 2008 or later, and not double precision
+///The SSE solver rows are used with the SSE backend of LinearMath: Visual Studio 2008 or later, or GCC and Clang building for SSE 4.1, and not double precision
 #ifdef BT_USE_SSE
 #define USE_SIMD 1
 #endif //
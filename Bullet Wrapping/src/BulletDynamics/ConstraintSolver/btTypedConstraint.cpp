@@ -15,6 +15,7 @@ subject to the following restrictions:
 
 
 #include "btTypedConstraint.h"
+#include "btContactSolverInfo.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "LinearMath/btSerializer.h"
 
@@ -25,13 +26,15 @@ btTypedConstraint::btTypedConstraint(btTypedConstraintType type, btRigidBody& rb
 :btTypedObject(type),
 m_userConstraintType(-1),
 m_userConstraintId(-1),
+m_breakingImpulseThreshold(SIMD_INFINITY),
+m_isEnabled(true),
 m_needsFeedback(false),
 m_rbA(rbA),
 m_rbB(getFixedBody()),
 m_appliedImpulse(btScalar(0.)),
 m_dbgDrawSize(DEFAULT_DEBUGDRAW_SIZE),
-m_breakingImpulseThreshold(SIMD_INFINITY),
-m_isEnabled(true)
+m_rowCacheDirty(true),
+m_rowsVelocityDependent(false)
 {
 }
 
@@ -40,13 +43,15 @@ btTypedConstraint::btTypedConstraint(btTypedConstraintType type, btRigidBody& rb
 :btTypedObject(type),
 m_userConstraintType(-1),
 m_userConstraintId(-1),
+m_breakingImpulseThreshold(SIMD_INFINITY),
+m_isEnabled(true),
 m_needsFeedback(false),
 m_rbA(rbA),
 m_rbB(rbB),
 m_appliedImpulse(btScalar(0.)),
 m_dbgDrawSize(DEFAULT_DEBUGDRAW_SIZE),
-m_breakingImpulseThreshold(SIMD_INFINITY),
-m_isEnabled(true)
+m_rowCacheDirty(true),
+m_rowsVelocityDependent(false)
 {
 }
 
@@ -137,10 +142,99 @@ const char*	btTypedConstraint::serialize(void* dataBuffer, btSerializer* seriali
 	return "btTypedConstraintData";
 }
 
+static bool	btRowCacheTransformEqual(const btTransform& a,const btTransform& b,btScalar linearThreshold,btScalar angularThreshold)
+{
+	if ((a.getOrigin()-b.getOrigin()).length2() > linearThreshold*linearThreshold)
+		return false;
+	///for small rotations the rows of the basis move by about the rotation angle
+	btScalar angularThreshold2 = angularThreshold*angularThreshold;
+	for (int i=0;i<3;i++)
+	{
+		if ((a.getBasis()[i]-b.getBasis()[i]).length2() > angularThreshold2)
+			return false;
+	}
+	return true;
+}
+
+bool	btTypedConstraint::internalGetCachedInfo1(btConstraintInfo1* info1, const btContactSolverInfo& infoGlobal) const
+{
+	if (m_rowCacheDirty)
+		return false;
+	if (m_cachedTimeStep != infoGlobal.m_timeStep || m_cachedErp != infoGlobal.m_erp || m_cachedGlobalCfm != infoGlobal.m_globalCfm ||
+		m_cachedGlobalDamping != infoGlobal.m_damping || m_cachedNumIterations != infoGlobal.m_numIterations)
+		return false;
+	if (m_cachedInvMassA != m_rbA.getInvMass() || m_cachedInvMassB != m_rbB.getInvMass())
+		return false;
+	if (!btRowCacheTransformEqual(m_rbA.getCenterOfMassTransform(),m_cachedTransformA,infoGlobal.m_rowCacheLinearThreshold,infoGlobal.m_rowCacheAngularThreshold))
+		return false;
+	if (!btRowCacheTransformEqual(m_rbB.getCenterOfMassTransform(),m_cachedTransformB,infoGlobal.m_rowCacheLinearThreshold,infoGlobal.m_rowCacheAngularThreshold))
+		return false;
+	info1->m_numConstraintRows = m_cachedRows.size();
+	info1->nub = m_cachedNub;
+	return true;
+}
+
+void	btTypedConstraint::internalGetCachedInfo2(btConstraintInfo2* info2) const
+{
+	for (int i=0;i<m_cachedRows.size();i++)
+	{
+		const btCachedConstraintRow& row = m_cachedRows[i];
+		int s = i*info2->rowskip;
+		for (int k=0;k<3;k++)
+		{
+			info2->m_J1linearAxis[s+k] = row.m_J1linearAxis[k];
+			info2->m_J1angularAxis[s+k] = row.m_J1angularAxis[k];
+			info2->m_J2angularAxis[s+k] = row.m_J2angularAxis[k];
+		}
+		info2->m_constraintError[s] = row.m_constraintError;
+		info2->cfm[s] = row.m_cfm;
+		info2->m_lowerLimit[s] = row.m_lowerLimit;
+		info2->m_upperLimit[s] = row.m_upperLimit;
+	}
+	info2->m_damping = m_cachedDamping;
+}
+
+void	btTypedConstraint::internalGetInfo2AndCacheRows(const btConstraintInfo1& info1, btConstraintInfo2* info2, const btContactSolverInfo& infoGlobal)
+{
+	m_rowsVelocityDependent = false;
+	getInfo2(info2);
+	if (m_rowsVelocityDependent)
+	{
+		m_rowCacheDirty = true;
+		return;
+	}
+
+	m_cachedRows.resize(info1.m_numConstraintRows);
+	for (int i=0;i<info1.m_numConstraintRows;i++)
+	{
+		btCachedConstraintRow& row = m_cachedRows[i];
+		int s = i*info2->rowskip;
+		row.m_J1linearAxis.setValue(info2->m_J1linearAxis[s],info2->m_J1linearAxis[s+1],info2->m_J1linearAxis[s+2]);
+		row.m_J1angularAxis.setValue(info2->m_J1angularAxis[s],info2->m_J1angularAxis[s+1],info2->m_J1angularAxis[s+2]);
+		row.m_J2angularAxis.setValue(info2->m_J2angularAxis[s],info2->m_J2angularAxis[s+1],info2->m_J2angularAxis[s+2]);
+		row.m_constraintError = info2->m_constraintError[s];
+		row.m_cfm = info2->cfm[s];
+		row.m_lowerLimit = info2->m_lowerLimit[s];
+		row.m_upperLimit = info2->m_upperLimit[s];
+	}
+	m_cachedNub = info1.nub;
+	m_cachedTransformA = m_rbA.getCenterOfMassTransform();
+	m_cachedTransformB = m_rbB.getCenterOfMassTransform();
+	m_cachedInvMassA = m_rbA.getInvMass();
+	m_cachedInvMassB = m_rbB.getInvMass();
+	m_cachedTimeStep = infoGlobal.m_timeStep;
+	m_cachedErp = infoGlobal.m_erp;
+	m_cachedGlobalCfm = infoGlobal.m_globalCfm;
+	m_cachedGlobalDamping = infoGlobal.m_damping;
+	m_cachedDamping = info2->m_damping;
+	m_cachedNumIterations = infoGlobal.m_numIterations;
+	m_rowCacheDirty = false;
+}
+
+///the body is shared by all worlds and only set up once, the solvers don't write to it (see btSequentialImpulseConstraintSolver::m_fixedBody)
 btRigidBody& btTypedConstraint::getFixedBody()
 {
 	static btRigidBody s_fixed(0, 0,0);
-	s_fixed.setMassProps(btScalar(0.),btVector3(btScalar(0.),btScalar(0.),btScalar(0.)));
 	return s_fixed;
 }
 
@@ -18,9 +18,11 @@ subject to the following restrictions:
 
 class btRigidBody;
 #include "LinearMath/btScalar.h"
+#include "LinearMath/btTransform.h"
 #include "btSolverConstraint.h"
 
 class btSerializer;
+struct btContactSolverInfo;
 
 //Don't change any of the existing enum values, so add enum types at the end for serialization compatibility
 enum btTypedConstraintType
@@ -52,8 +54,27 @@ enum btConstraintParams
 
 
 ///TypedConstraint is the baseclass for Bullet constraints and vehicles
+///With SOLVER_CACHE_CONSTRAINT_ROWS the solver reuses the rows from getInfo2 while both bodies stay within the
+///btContactSolverInfo row cache thresholds of the transforms the rows were computed for, and their inverse masses
+///are unchanged (btSliderConstraint and btGeneric6DofConstraint weight their rows by them). The setters of the Bullet constraints
+///call setRowCacheDirty, call it yourself after changing constraint parameters directly, for example through
+///btGeneric6DofConstraint::getRotationalLimitMotor or btPoint2PointConstraint::m_setting.
 class btTypedConstraint : public btTypedObject
 {
+public:
+	///a row as filled in by getInfo2, see SOLVER_CACHE_CONSTRAINT_ROWS
+	struct	btCachedConstraintRow
+	{
+		btVector3	m_J1linearAxis;
+		btVector3	m_J1angularAxis;
+		btVector3	m_J2angularAxis;
+		btScalar	m_constraintError;
+		btScalar	m_cfm;
+		btScalar	m_lowerLimit;
+		btScalar	m_upperLimit;
+	};
+
+private:
 	int	m_userConstraintType;
 
 	union
@@ -81,13 +102,32 @@ protected:
 	btScalar	m_appliedImpulse;
 	btScalar	m_dbgDrawSize;
 
+	///row cache, the transforms and solver parameters the cached rows were computed for
+	btAlignedObjectArray<btCachedConstraintRow>	m_cachedRows;
+	btTransform	m_cachedTransformA;
+	btTransform	m_cachedTransformB;
+	btScalar	m_cachedInvMassA;
+	btScalar	m_cachedInvMassB;
+	btScalar	m_cachedTimeStep;
+	btScalar	m_cachedErp;
+	btScalar	m_cachedGlobalCfm;
+	btScalar	m_cachedGlobalDamping;
+	btScalar	m_cachedDamping;
+	int			m_cachedNumIterations;
+	int			m_cachedNub;
+	bool		m_rowCacheDirty;
+
+	///getInfo2 sets this when the rows it filled in depend on the body velocities, such as limit bounce, those rows are not cached
+	bool		m_rowsVelocityDependent;
+
 	///internal method used by the constraint solver, don't use them directly
 	btScalar getMotorFactor(btScalar pos, btScalar lowLim, btScalar uppLim, btScalar vel, btScalar timeFact);
-	
-	static btRigidBody& getFixedBody();
 
 public:
 
+	///the body of constraints attached to the world, shared by all worlds. The solvers replace it by their own fixed body.
+	static btRigidBody& getFixedBody();
+
 	virtual ~btTypedConstraint() {};
 	btTypedConstraint(btTypedConstraintType type, btRigidBody& rbA);
 	btTypedConstraint(btTypedConstraintType type, btRigidBody& rbA,btRigidBody& rbB);
@@ -178,8 +218,24 @@ public:
 	void	setEnabled(bool enabled)
 	{
 		m_isEnabled=enabled;
+		m_rowCacheDirty = true;
+	}
+
+	///the next solver setup calls getInfo1/getInfo2 instead of reusing the cached rows
+	void	setRowCacheDirty()
+	{
+		m_rowCacheDirty = true;
 	}
 
+	///internal method used by the constraint solver, returns true and fills in info1 when the cached rows can be used
+	bool	internalGetCachedInfo1(btConstraintInfo1* info1, const btContactSolverInfo& infoGlobal) const;
+
+	///internal method used by the constraint solver, replaces getInfo2 when internalGetCachedInfo1 succeeded
+	void	internalGetCachedInfo2(btConstraintInfo2* info2) const;
+
+	///internal method used by the constraint solver, calls getInfo2 and caches the rows unless they depend on the body velocities
+	void	internalGetInfo2AndCacheRows(const btConstraintInfo1& info1, btConstraintInfo2* info2, const btContactSolverInfo& infoGlobal);
+
 
 	///internal method used by the constraint solver, don't use them directly
 	virtual	void	solveConstraintObsolete(btRigidBody& /*bodyA*/,btRigidBody& /*bodyB*/,btScalar	/*timeStep*/) {};
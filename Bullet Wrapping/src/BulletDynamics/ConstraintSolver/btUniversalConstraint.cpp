@@ -63,6 +63,7 @@ btUniversalConstraint::btUniversalConstraint(btRigidBody& rbA, btRigidBody& rbB,
 
 void btUniversalConstraint::setAxis(const btVector3& axis1,const btVector3& axis2)
 {
+	setRowCacheDirty();
   m_axis1 = axis1;
   m_axis2 = axis2;
 
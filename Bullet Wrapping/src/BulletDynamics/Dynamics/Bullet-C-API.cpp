@@ -23,6 +23,7 @@ subject to the following restrictions:
 #include "Bullet-C-Api.h"
 #include "btBulletDynamicsCommon.h"
 #include "LinearMath/btAlignedAllocator.h"
+#include "LinearMath/btHashMap.h"
 
 
 
@@ -71,6 +72,206 @@ struct	btPhysicsSdk
 	
 };
 
+///the key of a touching pair, ordered by address so a manifold that is recreated with the bodies swapped stays the same pair
+struct	btCApiContactPair
+{
+	const btCollisionObject*	m_body0;
+	const btCollisionObject*	m_body1;
+
+	btCApiContactPair(const btCollisionObject* body0,const btCollisionObject* body1)
+		:m_body0(body0 < body1 ? body0 : body1),
+		m_body1(body0 < body1 ? body1 : body0)
+	{
+	}
+
+	unsigned int getHash() const
+	{
+		btHashPtr hash0(m_body0);
+		btHashPtr hash1(m_body1);
+		return hash0.getHash() ^ (hash1.getHash()*0x9E3779B1u);
+	}
+
+	bool equals(const btCApiContactPair& other) const
+	{
+		return m_body0 == other.m_body0 && m_body1 == other.m_body1;
+	}
+};
+
+struct	btCApiTouchingPair
+{
+	btCApiContactPair	m_pair;
+	int		m_stamp;
+	///index of the begin event created by the current plGetContactEvents, or -1
+	int		m_beginEvent;
+	///the begin event had the bodies in the other order than m_pair, the end event uses the same order
+	bool	m_swapped;
+
+	btCApiTouchingPair(const btCApiContactPair& pair,int stamp,int beginEvent,bool swapped)
+		:m_pair(pair),
+		m_stamp(stamp),
+		m_beginEvent(beginEvent),
+		m_swapped(swapped)
+	{
+	}
+};
+
+///the world created by plCreateDynamicsWorld, with the stepping parameters and contact events of the C-API
+class	btCApiDynamicsWorld : public btDiscreteDynamicsWorld
+{
+public:
+
+	int			m_maxSubSteps;
+	btScalar	m_fixedTimeStep;
+	int			m_numSubSteps;
+
+	btHashMap<btCApiContactPair,btCApiTouchingPair>	m_touchingPairs;
+	int			m_touchingStamp;
+	btAlignedObjectArray<plContactEvent>	m_events;
+	int			m_numEventsRead;
+
+	btCApiDynamicsWorld(btDispatcher* dispatcher,btBroadphaseInterface* pairCache,btConstraintSolver* constraintSolver,btCollisionConfiguration* collisionConfiguration)
+		:btDiscreteDynamicsWorld(dispatcher,pairCache,constraintSolver,collisionConfiguration),
+		m_maxSubSteps(1),
+		m_fixedTimeStep(btScalar(1.)/btScalar(60.)),
+		m_numSubSteps(0),
+		m_touchingStamp(0),
+		m_numEventsRead(0)
+	{
+	}
+
+	///compares the touching pairs of rigid bodies with the pairs at the previous call, and queues begin and end events
+	void	queueContactEvents();
+
+	///forgets the contact state of a body that is removed from the world
+	void	removeContactEvents(const btCollisionObject* body)
+	{
+		removeContactEvents(&body,1);
+	}
+
+	///forgets the contact state of several bodies in one pass over the touching pairs and events
+	void	removeContactEvents(const btCollisionObject* const* bodies,int numBodies);
+};
+
+void	btCApiDynamicsWorld::queueContactEvents()
+{
+	m_events.resize(0);
+	m_numEventsRead = 0;
+	m_touchingStamp++;
+
+	int numManifolds = getDispatcher()->getNumManifolds();
+	for (int i=0;i<numManifolds;i++)
+	{
+		btPersistentManifold* manifold = getDispatcher()->getManifoldByIndexInternal(i);
+		int numContacts = manifold->getNumContacts();
+		const btCollisionObject* body0 = static_cast<const btCollisionObject*>(manifold->getBody0());
+		const btCollisionObject* body1 = static_cast<const btCollisionObject*>(manifold->getBody1());
+		if (!numContacts || !btRigidBody::upcast(body0) || !btRigidBody::upcast(body1))
+			continue;
+
+		btCApiContactPair pair(body0,body1);
+		btCApiTouchingPair* touching = m_touchingPairs.find(pair);
+		if (!touching)
+		{
+			m_touchingPairs.insert(pair,btCApiTouchingPair(pair,m_touchingStamp,m_events.size(),pair.m_body0 != body0));
+			plContactEvent& event = m_events.expand();
+			event.m_body0 = (plRigidBodyHandle) body0;
+			event.m_body1 = (plRigidBodyHandle) body1;
+			event.m_type = PL_CONTACT_BEGIN;
+			event.m_numContacts = 0;
+			event.m_distance = BT_LARGE_FLOAT;
+			touching = m_touchingPairs.find(pair);
+		} else if (touching->m_stamp != m_touchingStamp)
+		{
+			touching->m_stamp = m_touchingStamp;
+			touching->m_beginEvent = -1;
+		}
+
+		//a compound shape can have several manifolds for the same pair of bodies
+		if (touching->m_beginEvent >= 0)
+		{
+			plContactEvent& event = m_events[touching->m_beginEvent];
+			event.m_numContacts += numContacts;
+			//the event takes the body order of its first manifold, the points of a manifold with the bodies swapped are flipped
+			bool swapped = event.m_body0 != (plRigidBodyHandle) body0;
+			for (int j=0;j<numContacts;j++)
+			{
+				const btManifoldPoint& pt = manifold->getContactPoint(j);
+				if (pt.getDistance() < event.m_distance)
+				{
+					event.m_distance = pt.getDistance();
+					for (int k=0;k<3;k++)
+					{
+						event.m_positionWorld[k] = swapped ? pt.m_positionWorldOnA[k] : pt.m_positionWorldOnB[k];
+						event.m_normalWorld[k] = swapped ? -pt.m_normalWorldOnB[k] : pt.m_normalWorldOnB[k];
+					}
+				}
+			}
+		}
+	}
+
+	int i=0;
+	while (i<m_touchingPairs.size())
+	{
+		const btCApiTouchingPair* touching = m_touchingPairs.getAtIndex(i);
+		if (touching->m_stamp == m_touchingStamp)
+		{
+			i++;
+			continue;
+		}
+		plContactEvent& event = m_events.expand();
+		event.m_body0 = (plRigidBodyHandle) (touching->m_swapped ? touching->m_pair.m_body1 : touching->m_pair.m_body0);
+		event.m_body1 = (plRigidBodyHandle) (touching->m_swapped ? touching->m_pair.m_body0 : touching->m_pair.m_body1);
+		event.m_type = PL_CONTACT_END;
+		event.m_numContacts = 0;
+		event.m_distance = 0;
+		for (int k=0;k<3;k++)
+		{
+			event.m_positionWorld[k] = 0;
+			event.m_normalWorld[k] = 0;
+		}
+		//remove moves the last pair into index i
+		btCApiContactPair pair = touching->m_pair;
+		m_touchingPairs.remove(pair);
+	}
+}
+
+void	btCApiDynamicsWorld::removeContactEvents(const btCollisionObject* const* bodies,int numBodies)
+{
+	btAlignedObjectArray<const btCollisionObject*> removedBodies;
+	removedBodies.resize(numBodies);
+	int i;
+	for (i=0;i<numBodies;i++)
+	{
+		removedBodies[i] = bodies[i];
+	}
+	removedBodies.quickSort(btAlignedObjectArray<const btCollisionObject*>::less());
+
+	i=0;
+	while (i<m_touchingPairs.size())
+	{
+		btCApiContactPair pair = m_touchingPairs.getAtIndex(i)->m_pair;
+		if (removedBodies.findBinarySearch(pair.m_body0) < numBodies || removedBodies.findBinarySearch(pair.m_body1) < numBodies)
+		{
+			m_touchingPairs.remove(pair);
+		} else
+		{
+			i++;
+		}
+	}
+
+	int numEvents = m_numEventsRead;
+	for (i=m_numEventsRead;i<m_events.size();i++)
+	{
+		if (removedBodies.findBinarySearch((const btCollisionObject*)m_events[i].m_body0) == numBodies &&
+			removedBodies.findBinarySearch((const btCollisionObject*)m_events[i].m_body1) == numBodies)
+		{
+			m_events[numEvents++] = m_events[i];
+		}
+	}
+	m_events.resize(numEvents);
+}
+
+
 plPhysicsSdkHandle	plNewBulletSdk()
 {
 	void* mem = btAlignedAlloc(sizeof(btPhysicsSdk),16);
@@ -97,21 +298,22 @@ plDynamicsWorldHandle plCreateDynamicsWorld(plPhysicsSdkHandle physicsSdkHandle)
 	mem = btAlignedAlloc(sizeof(btSequentialImpulseConstraintSolver),16);
 	btConstraintSolver*			constraintSolver = new(mem) btSequentialImpulseConstraintSolver();
 
-	mem = btAlignedAlloc(sizeof(btDiscreteDynamicsWorld),16);
-	return (plDynamicsWorldHandle) new (mem)btDiscreteDynamicsWorld(dispatcher,pairCache,constraintSolver,collisionConfiguration);
+	mem = btAlignedAlloc(sizeof(btCApiDynamicsWorld),16);
+	return (plDynamicsWorldHandle) new (mem)btCApiDynamicsWorld(dispatcher,pairCache,constraintSolver,collisionConfiguration);
 }
 void           plDeleteDynamicsWorld(plDynamicsWorldHandle world)
 {
 	//todo: also clean up the other allocations, axisSweep, pairCache,dispatcher,constraintSolver,collisionConfiguration
-	btDynamicsWorld* dynamicsWorld = reinterpret_cast< btDynamicsWorld* >(world);
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
+	dynamicsWorld->~btCApiDynamicsWorld();
 	btAlignedFree(dynamicsWorld);
 }
 
 void	plStepSimulation(plDynamicsWorldHandle world,	plReal	timeStep)
 {
-	btDynamicsWorld* dynamicsWorld = reinterpret_cast< btDynamicsWorld* >(world);
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
 	btAssert(dynamicsWorld);
-	dynamicsWorld->stepSimulation(timeStep);
+	dynamicsWorld->m_numSubSteps = dynamicsWorld->stepSimulation(timeStep,dynamicsWorld->m_maxSubSteps,dynamicsWorld->m_fixedTimeStep);
 }
 
 void plAddRigidBody(plDynamicsWorldHandle world, plRigidBodyHandle object)
@@ -126,12 +328,13 @@ void plAddRigidBody(plDynamicsWorldHandle world, plRigidBodyHandle object)
 
 void plRemoveRigidBody(plDynamicsWorldHandle world, plRigidBodyHandle object)
 {
-	btDynamicsWorld* dynamicsWorld = reinterpret_cast< btDynamicsWorld* >(world);
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
 	btAssert(dynamicsWorld);
 	btRigidBody* body = reinterpret_cast< btRigidBody* >(object);
 	btAssert(body);
 
 	dynamicsWorld->removeRigidBody(body);
+	dynamicsWorld->removeContactEvents(body);
 }
 
 /* Rigid Body  */
@@ -334,6 +537,231 @@ void plGetOrientation(plRigidBodyHandle object,plQuaternion orientation)
 
 
 
+/* Bulk operations */
+
+void	plSetStepParameters(plDynamicsWorldHandle world, int maxSubSteps, plReal fixedTimeStep, int numSolverIterations)
+{
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
+	btAssert(dynamicsWorld);
+	dynamicsWorld->m_maxSubSteps = maxSubSteps;
+	dynamicsWorld->m_fixedTimeStep = fixedTimeStep;
+	dynamicsWorld->getSolverInfo().m_numIterations = numSolverIterations;
+}
+
+void	plSetGravity(plDynamicsWorldHandle world, const plVector3 gravity)
+{
+	btDynamicsWorld* dynamicsWorld = reinterpret_cast< btDynamicsWorld* >(world);
+	btAssert(dynamicsWorld);
+	dynamicsWorld->setGravity(btVector3(gravity[0],gravity[1],gravity[2]));
+}
+
+void	plGetStepCounters(plDynamicsWorldHandle world, plStepCounters* counters)
+{
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
+	btAssert(dynamicsWorld);
+	counters->m_numSubSteps = dynamicsWorld->m_numSubSteps;
+	counters->m_numRigidBodies = 0;
+	counters->m_numActiveRigidBodies = 0;
+	const btCollisionObjectArray& objects = dynamicsWorld->getCollisionObjectArray();
+	int i;
+	for (i=0;i<objects.size();i++)
+	{
+		if (btRigidBody::upcast(objects[i]))
+		{
+			counters->m_numRigidBodies++;
+			if (objects[i]->isActive() && !objects[i]->isStaticOrKinematicObject())
+			{
+				counters->m_numActiveRigidBodies++;
+			}
+		}
+	}
+	counters->m_numOverlappingPairs = dynamicsWorld->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+	btDispatcher* dispatcher = dynamicsWorld->getDispatcher();
+	counters->m_numManifolds = dispatcher->getNumManifolds();
+	counters->m_numContacts = 0;
+	for (i=0;i<counters->m_numManifolds;i++)
+	{
+		counters->m_numContacts += dispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+	}
+}
+
+static btTransform	plPoseToTransform(const plReal* pose)
+{
+	return btTransform(btQuaternion(pose[3],pose[4],pose[5],pose[6]),btVector3(pose[0],pose[1],pose[2]));
+}
+
+void	plCreateRigidBodies(plDynamicsWorldHandle world, int count, const plCollisionShapeHandle* shapes, const plReal* masses, const plReal* poses, void** userData, plRigidBodyHandle* bodies)
+{
+	btDiscreteDynamicsWorld* dynamicsWorld = reinterpret_cast< btDiscreteDynamicsWorld* >(world);
+	btAlignedObjectArray<btRigidBody*> rigidBodies;
+	rigidBodies.resize(count);
+	for (int i=0;i<count;i++)
+	{
+		btRigidBody* body = reinterpret_cast< btRigidBody* >(plCreateRigidBody(userData ? userData[i] : 0,float(masses[i]),shapes[i]));
+		body->setCenterOfMassTransform(plPoseToTransform(&poses[7*i]));
+		rigidBodies[i] = body;
+		bodies[i] = (plRigidBodyHandle) body;
+	}
+	if (dynamicsWorld && count)
+	{
+		dynamicsWorld->addRigidBodies(&rigidBodies[0],count);
+	}
+}
+
+void	plDeleteRigidBodies(plDynamicsWorldHandle world, int count, const plRigidBodyHandle* bodies)
+{
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
+	int i;
+	if (dynamicsWorld && count)
+	{
+		btAlignedObjectArray<btRigidBody*> rigidBodies;
+		btAlignedObjectArray<const btCollisionObject*> collisionObjects;
+		rigidBodies.resize(count);
+		collisionObjects.resize(count);
+		for (i=0;i<count;i++)
+		{
+			rigidBodies[i] = reinterpret_cast< btRigidBody* >(bodies[i]);
+			btAssert(rigidBodies[i]);
+			collisionObjects[i] = rigidBodies[i];
+		}
+		dynamicsWorld->removeContactEvents(&collisionObjects[0],count);
+		dynamicsWorld->removeRigidBodies(&rigidBodies[0],count);
+	}
+	for (i=0;i<count;i++)
+	{
+		plDeleteRigidBody(bodies[i]);
+	}
+}
+
+void	plGetPoses(int count, const plRigidBodyHandle* bodies, plReal* poses)
+{
+	for (int i=0;i<count;i++)
+	{
+		const btRigidBody* body = reinterpret_cast< const btRigidBody* >(bodies[i]);
+		const btTransform& worldTrans = body->getWorldTransform();
+		btQuaternion orn = worldTrans.getRotation();
+		plReal* pose = &poses[7*i];
+		pose[0] = worldTrans.getOrigin().getX();
+		pose[1] = worldTrans.getOrigin().getY();
+		pose[2] = worldTrans.getOrigin().getZ();
+		pose[3] = orn.getX();
+		pose[4] = orn.getY();
+		pose[5] = orn.getZ();
+		pose[6] = orn.getW();
+	}
+}
+
+void	plSetPoses(int count, const plRigidBodyHandle* bodies, const plReal* poses)
+{
+	for (int i=0;i<count;i++)
+	{
+		btRigidBody* body = reinterpret_cast< btRigidBody* >(bodies[i]);
+		body->setCenterOfMassTransform(plPoseToTransform(&poses[7*i]));
+	}
+}
+
+void	plGetOpenGLMatrices(int count, const plRigidBodyHandle* bodies, plReal* matrices)
+{
+	for (int i=0;i<count;i++)
+	{
+		const btRigidBody* body = reinterpret_cast< const btRigidBody* >(bodies[i]);
+		body->getWorldTransform().getOpenGLMatrix(&matrices[16*i]);
+	}
+}
+
+void	plGetVelocities(int count, const plRigidBodyHandle* bodies, plReal* velocities)
+{
+	for (int i=0;i<count;i++)
+	{
+		const btRigidBody* body = reinterpret_cast< const btRigidBody* >(bodies[i]);
+		const btVector3& linVel = body->getLinearVelocity();
+		const btVector3& angVel = body->getAngularVelocity();
+		plReal* velocity = &velocities[6*i];
+		velocity[0] = linVel.getX();
+		velocity[1] = linVel.getY();
+		velocity[2] = linVel.getZ();
+		velocity[3] = angVel.getX();
+		velocity[4] = angVel.getY();
+		velocity[5] = angVel.getZ();
+	}
+}
+
+void	plSetVelocities(int count, const plRigidBodyHandle* bodies, const plReal* velocities)
+{
+	for (int i=0;i<count;i++)
+	{
+		btRigidBody* body = reinterpret_cast< btRigidBody* >(bodies[i]);
+		const plReal* velocity = &velocities[6*i];
+		body->setLinearVelocity(btVector3(velocity[0],velocity[1],velocity[2]));
+		body->setAngularVelocity(btVector3(velocity[3],velocity[4],velocity[5]));
+	}
+}
+
+void	plApplyImpulses(int count, const plRigidBodyHandle* bodies, const plReal* impulses, const plReal* relativePositions)
+{
+	for (int i=0;i<count;i++)
+	{
+		btRigidBody* body = reinterpret_cast< btRigidBody* >(bodies[i]);
+		btVector3 impulse(impulses[3*i],impulses[3*i+1],impulses[3*i+2]);
+		if (relativePositions)
+		{
+			body->applyImpulse(impulse,btVector3(relativePositions[3*i],relativePositions[3*i+1],relativePositions[3*i+2]));
+		} else
+		{
+			body->applyCentralImpulse(impulse);
+		}
+		body->activate();
+	}
+}
+
+int		plRayCasts(plDynamicsWorldHandle world, int count, const plReal* rayStarts, const plReal* rayEnds, plRayCastResult* results)
+{
+	btDynamicsWorld* dynamicsWorld = reinterpret_cast< btDynamicsWorld* >(world);
+	btAssert(dynamicsWorld);
+	int numHits = 0;
+	for (int i=0;i<count;i++)
+	{
+		btVector3 rayFrom(rayStarts[3*i],rayStarts[3*i+1],rayStarts[3*i+2]);
+		btVector3 rayTo(rayEnds[3*i],rayEnds[3*i+1],rayEnds[3*i+2]);
+		btCollisionWorld::ClosestRayResultCallback rayCallback(rayFrom,rayTo);
+		dynamicsWorld->rayTest(rayFrom,rayTo,rayCallback);
+
+		plRayCastResult& result = results[i];
+		const btRigidBody* body = rayCallback.hasHit() ? btRigidBody::upcast(rayCallback.m_collisionObject) : 0;
+		result.m_body = (plRigidBodyHandle) body;
+		result.m_shape = body ? (plCollisionShapeHandle) body->getCollisionShape() : 0;
+		for (int k=0;k<3;k++)
+		{
+			result.m_positionWorld[k] = body ? rayCallback.m_hitPointWorld[k] : plReal(0.);
+			result.m_normalWorld[k] = body ? rayCallback.m_hitNormalWorld[k] : plReal(0.);
+		}
+		if (body)
+		{
+			numHits++;
+		}
+	}
+	return numHits;
+}
+
+int		plGetContactEvents(plDynamicsWorldHandle world, plContactEvent* events, int maxEvents)
+{
+	btCApiDynamicsWorld* dynamicsWorld = reinterpret_cast< btCApiDynamicsWorld* >(world);
+	btAssert(dynamicsWorld);
+	if (dynamicsWorld->m_numEventsRead == dynamicsWorld->m_events.size())
+	{
+		dynamicsWorld->queueContactEvents();
+	}
+	int numEvents = btMin(maxEvents,dynamicsWorld->m_events.size()-dynamicsWorld->m_numEventsRead);
+	for (int i=0;i<numEvents;i++)
+	{
+		events[i] = dynamicsWorld->m_events[dynamicsWorld->m_numEventsRead+i];
+	}
+	dynamicsWorld->m_numEventsRead += numEvents;
+	return numEvents;
+}
+
+
+
 //plRigidBodyHandle plRayCast(plDynamicsWorldHandle world, const plVector3 rayStart, const plVector3 rayEnd, plVector3 hitpoint, plVector3 normal);
 
 //	extern  plRigidBodyHandle plObjectCast(plDynamicsWorldHandle world, const plVector3 rayStart, const plVector3 rayEnd, plVector3 hitpoint, plVector3 normal);
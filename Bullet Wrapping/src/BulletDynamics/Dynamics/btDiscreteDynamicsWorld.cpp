@@ -24,6 +24,7 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
 #include "LinearMath/btTransformUtil.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btThreads.h"
 
 //rigidbody & constraints
 #include "BulletDynamics/Dynamics/btRigidBody.h"
@@ -47,6 +48,11 @@ subject to the following restrictions:
 #include "LinearMath/btMotionState.h"
 
 #include "LinearMath/btSerializer.h"
+#include "LinearMath/btHashMap.h"
+#include "btDynamicsWorldSnapshot.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+#include <string.h> //for memcpy
 
 #if 0
 btAlignedObjectArray<btVector3> debugContacts;
@@ -62,8 +68,14 @@ btDiscreteDynamicsWorld::btDiscreteDynamicsWorld(btDispatcher* dispatcher,btBroa
 m_constraintSolver(constraintSolver),
 m_gravity(0,-10,0),
 m_localTime(0),
+m_fixedTimeStep(0),
+m_timeDebt(0),
+m_droppedTime(0),
+m_averageSubStepTime(0),
+m_lastNumSubSteps(0),
 m_synchronizeAllMotionStates(false),
-m_profileTimings(0)
+m_profileTimings(0),
+m_lodStepCount(0)
 {
 	if (!m_constraintSolver)
 	{
@@ -201,7 +213,7 @@ void	btDiscreteDynamicsWorld::synchronizeSingleMotionState(btRigidBody* body)
 		{
 			btTransform interpolatedTransform;
 			btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(),
-				body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),m_localTime*body->getHitFraction(),interpolatedTransform);
+				body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),(m_localTime+body->getLodElapsedTime())*body->getHitFraction(),interpolatedTransform);
 			body->getMotionState()->setWorldTransform(interpolatedTransform);
 		}
 	}
@@ -245,6 +257,7 @@ int	btDiscreteDynamicsWorld::stepSimulation( btScalar timeStep,int maxSubSteps,
 	if (maxSubSteps)
 	{
 		//fixed timestep with interpolation
+		m_fixedTimeStep = fixedTimeStep;
 		m_localTime += timeStep;
 		if (m_localTime >= fixedTimeStep)
 		{
@@ -255,6 +268,7 @@ int	btDiscreteDynamicsWorld::stepSimulation( btScalar timeStep,int maxSubSteps,
 	{
 		//variable timestep
 		fixedTimeStep = timeStep;
+		m_fixedTimeStep = timeStep;
 		m_localTime = timeStep;
 		if (btFuzzyZero(timeStep))
 		{
@@ -305,6 +319,113 @@ int	btDiscreteDynamicsWorld::stepSimulation( btScalar timeStep,int maxSubSteps,
 	return numSimulationSubSteps;
 }
 
+///weight of the last substep in the average substep time
+#define BT_SUBSTEP_TIME_AVERAGE_WEIGHT btScalar(0.2)
+
+int	btDiscreteDynamicsWorld::stepSimulationWithBudget(btScalar timeStep,btScalar timeBudget,btScalar fixedTimeStep,btScalar maxTimeDebt)
+{
+	startProfiling(timeStep);
+
+	BT_PROFILE("stepSimulationWithBudget");
+
+	btAssert(fixedTimeStep > btScalar(0.));
+	m_fixedTimeStep = fixedTimeStep;
+
+	///the debt is a whole number of substeps, the fraction of a substep stays in m_localTime for the interpolation
+	m_localTime += timeStep;
+	int numDueSubSteps = int(m_timeDebt / fixedTimeStep + btScalar(0.5));
+	if (m_localTime >= fixedTimeStep)
+	{
+		int numNewSubSteps = int(m_localTime / fixedTimeStep);
+		m_localTime -= numNewSubSteps * fixedTimeStep;
+		numDueSubSteps += numNewSubSteps;
+	}
+
+	///after a long frame, like the first one after loading a scene, only the substeps that the debt can hold are kept
+	int maxDueSubSteps = int(maxTimeDebt / fixedTimeStep) + 1;
+	if (numDueSubSteps > maxDueSubSteps)
+	{
+		m_droppedTime += (numDueSubSteps - maxDueSubSteps) * fixedTimeStep;
+		numDueSubSteps = maxDueSubSteps;
+	}
+
+	if (getDebugDrawer())
+	{
+		btIDebugDraw* debugDrawer = getDebugDrawer ();
+		gDisableDeactivation = (debugDrawer->getDebugMode() & btIDebugDraw::DBG_NoDeactivation) != 0;
+	}
+
+	///the number of substeps is decided before stepping, from the average substep time, so the kinematic bodies
+	///move with the velocity that covers the simulated time. One substep always runs when one is due, and until
+	///the cost of a substep has been measured only one runs.
+	int numPlannedSubSteps = numDueSubSteps;
+#ifdef USE_BT_CLOCK
+	if (numPlannedSubSteps > 1)
+	{
+		if (m_averageSubStepTime > btScalar(0.))
+		{
+			btScalar fittingSubSteps = timeBudget / m_averageSubStepTime;
+			if (fittingSubSteps < btScalar(numPlannedSubSteps))
+			{
+				numPlannedSubSteps = btMax(int(fittingSubSteps),1);
+			}
+		} else
+		{
+			numPlannedSubSteps = 1;
+		}
+	}
+#else
+	(void)timeBudget;
+#endif //USE_BT_CLOCK
+
+	int numSubSteps = 0;
+	if (numPlannedSubSteps)
+	{
+		saveKinematicState(fixedTimeStep*numPlannedSubSteps);
+
+		applyGravity();
+
+#ifdef USE_BT_CLOCK
+		btClock clock;
+		btScalar elapsed = btScalar(0.);
+#endif //USE_BT_CLOCK
+		while (numSubSteps < numPlannedSubSteps)
+		{
+			internalSingleStepSimulation(fixedTimeStep);
+			synchronizeMotionStates();
+			numSubSteps++;
+
+#ifdef USE_BT_CLOCK
+			btScalar now = btScalar(clock.getTimeMicroseconds()) * btScalar(1e-6);
+			btScalar subStepTime = now - elapsed;
+			elapsed = now;
+			if (m_averageSubStepTime > btScalar(0.))
+			{
+				m_averageSubStepTime += (subStepTime - m_averageSubStepTime) * BT_SUBSTEP_TIME_AVERAGE_WEIGHT;
+			} else
+			{
+				m_averageSubStepTime = subStepTime;
+			}
+#endif //USE_BT_CLOCK
+		}
+	} else
+	{
+		synchronizeMotionStates();
+	}
+
+	///at least one substep ran, so the remaining debt is within maxTimeDebt
+	m_timeDebt = (numDueSubSteps - numSubSteps) * fixedTimeStep;
+	m_lastNumSubSteps = numSubSteps;
+
+	clearForces();
+
+#ifndef BT_NO_PROFILE
+	CProfileManager::Increment_Frame_Counter();
+#endif //BT_NO_PROFILE
+
+	return numSubSteps;
+}
+
 void	btDiscreteDynamicsWorld::internalSingleStepSimulation(btScalar timeStep)
 {
 	
@@ -314,6 +435,9 @@ void	btDiscreteDynamicsWorld::internalSingleStepSimulation(btScalar timeStep)
 		(*m_internalPreTickCallback)(this, timeStep);
 	}	
 
+	if (m_lodLevels.size())
+		updateLodSteps(timeStep);
+
 	///apply gravity, predict motion
 	predictUnconstraintMotion(timeStep);
 
@@ -391,6 +515,8 @@ void	btDiscreteDynamicsWorld::removeCollisionObject(btCollisionObject* collision
 void	btDiscreteDynamicsWorld::removeRigidBody(btRigidBody* body)
 {
 	m_nonStaticRigidBodies.remove(body);
+	body->setCollisionFlags(body->getCollisionFlags() & ~btCollisionObject::CF_LOD_SKIPPED);
+	body->updateLodTime(btScalar(0.),true);
 	btCollisionWorld::removeCollisionObject(body);
 }
 
@@ -442,6 +568,127 @@ void	btDiscreteDynamicsWorld::addRigidBody(btRigidBody* body, short group, short
 }
 
 
+void	btDiscreteDynamicsWorld::addRigidBodies(btRigidBody* const* bodies,int numBodies)
+{
+	btAlignedObjectArray<btCollisionObject*>	collisionObjects;
+	btAlignedObjectArray<short int>	groups;
+	btAlignedObjectArray<short int>	masks;
+	collisionObjects.reserve(numBodies);
+	groups.reserve(numBodies);
+	masks.reserve(numBodies);
+	for (int i=0;i<numBodies;i++)
+	{
+		btRigidBody* body = bodies[i];
+		if (!body->isStaticOrKinematicObject() && !(body->getFlags() &BT_DISABLE_WORLD_GRAVITY))
+		{
+			body->setGravity(m_gravity);
+		}
+
+		if (body->getCollisionShape())
+		{
+			if (!body->isStaticObject())
+			{
+				m_nonStaticRigidBodies.push_back(body);
+			} else
+			{
+				body->setActivationState(ISLAND_SLEEPING);
+			}
+
+			bool isDynamic = !(body->isStaticObject() || body->isKinematicObject());
+			collisionObjects.push_back(body);
+			groups.push_back(isDynamic? short(btBroadphaseProxy::DefaultFilter) : short(btBroadphaseProxy::StaticFilter));
+			masks.push_back(isDynamic? short(btBroadphaseProxy::AllFilter) : short(btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter));
+		}
+	}
+	if (collisionObjects.size())
+	{
+		addCollisionObjects(&collisionObjects[0],collisionObjects.size(),&groups[0],&masks[0]);
+	}
+}
+
+void	btDiscreteDynamicsWorld::addRigidBodies(btRigidBody* const* bodies,int numBodies,short group,short mask)
+{
+	btAlignedObjectArray<btCollisionObject*>	collisionObjects;
+	collisionObjects.reserve(numBodies);
+	for (int i=0;i<numBodies;i++)
+	{
+		btRigidBody* body = bodies[i];
+		if (!body->isStaticOrKinematicObject() && !(body->getFlags() &BT_DISABLE_WORLD_GRAVITY))
+		{
+			body->setGravity(m_gravity);
+		}
+
+		if (body->getCollisionShape())
+		{
+			if (!body->isStaticObject())
+			{
+				m_nonStaticRigidBodies.push_back(body);
+			}
+			 else
+			{
+				body->setActivationState(ISLAND_SLEEPING);
+			}
+			collisionObjects.push_back(body);
+		}
+	}
+	if (collisionObjects.size())
+	{
+		btAlignedObjectArray<short int>	groups;
+		btAlignedObjectArray<short int>	masks;
+		groups.resize(collisionObjects.size(),group);
+		masks.resize(collisionObjects.size(),mask);
+		addCollisionObjects(&collisionObjects[0],collisionObjects.size(),&groups[0],&masks[0]);
+	}
+}
+
+void	btDiscreteDynamicsWorld::removeRigidBodies(btRigidBody* const* bodies,int numBodies)
+{
+	btAlignedObjectArray<btCollisionObject*>	collisionObjects;
+	collisionObjects.resize(numBodies);
+	for (int i=0;i<numBodies;i++)
+	{
+		collisionObjects[i] = bodies[i];
+	}
+	if (numBodies)
+	{
+		removeCollisionObjects(&collisionObjects[0],numBodies);
+	}
+}
+
+void	btDiscreteDynamicsWorld::removeCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects)
+{
+	btAlignedObjectArray<btRigidBody*>	removedBodies;
+	int i;
+	for (i=0;i<numObjects;i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(collisionObjects[i]);
+		if (body)
+		{
+			body->setCollisionFlags(body->getCollisionFlags() & ~btCollisionObject::CF_LOD_SKIPPED);
+			body->updateLodTime(btScalar(0.),true);
+			removedBodies.push_back(body);
+		}
+	}
+
+	///one pass over the non static bodies, which keep their order
+	if (removedBodies.size())
+	{
+		removedBodies.quickSort(btAlignedObjectArray<btRigidBody*>::less());
+		int numRemaining = 0;
+		for (i=0;i<m_nonStaticRigidBodies.size();i++)
+		{
+			btRigidBody* body = m_nonStaticRigidBodies[i];
+			if (removedBodies.findBinarySearch(body) == removedBodies.size())
+			{
+				m_nonStaticRigidBodies[numRemaining++] = body;
+			}
+		}
+		m_nonStaticRigidBodies.resize(numRemaining);
+	}
+
+	btCollisionWorld::removeCollisionObjects(collisionObjects,numObjects);
+}
+
 void	btDiscreteDynamicsWorld::updateActions(btScalar timeStep)
 {
 	BT_PROFILE("updateActions");
@@ -462,7 +709,10 @@ void	btDiscreteDynamicsWorld::updateActivationState(btScalar timeStep)
 		btRigidBody* body = m_nonStaticRigidBodies[i];
 		if (body)
 		{
-			body->updateDeactivation(timeStep);
+			if (body->getCollisionFlags() & btCollisionObject::CF_LOD_SKIPPED)
+				continue;
+
+			body->updateDeactivation(m_lodLevels.size() ? body->getLodTimeStep() : timeStep);
 
 			if (body->wantsSleeping())
 			{
@@ -504,6 +754,7 @@ void	btDiscreteDynamicsWorld::removeConstraint(btTypedConstraint* constraint)
 	m_constraints.remove(constraint);
 	constraint->getRigidBodyA().removeConstraintRef(constraint);
 	constraint->getRigidBodyB().removeConstraintRef(constraint);
+	m_islandManager->notifyConstraintRemoved();
 }
 
 void	btDiscreteDynamicsWorld::addAction(btActionInterface* action)
@@ -579,6 +830,9 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 		btIDebugDraw*			m_debugDrawer;
 		btStackAlloc*			m_stackAlloc;
 		btDispatcher*			m_dispatcher;
+		const btAlignedObjectArray<btRigidBodyLodLevel>*	m_lodLevels;
+		///solver info of the islands in m_bodies, with the time step and iterations of their level of detail
+		btContactSolverInfo		m_lodSolverInfo;
 		
 		btAlignedObjectArray<btCollisionObject*> m_bodies;
 		btAlignedObjectArray<btPersistentManifold*> m_manifolds;
@@ -599,11 +853,58 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 			m_numConstraints(numConstraints),
 			m_debugDrawer(debugDrawer),
 			m_stackAlloc(stackAlloc),
-			m_dispatcher(dispatcher)
+			m_dispatcher(dispatcher),
+			m_lodLevels(0),
+			m_lodSolverInfo(solverInfo)
 		{
 
 		}
 
+		const btContactSolverInfo&	getIslandSolverInfo() const
+		{
+			return m_lodLevels ? m_lodSolverInfo : m_solverInfo;
+		}
+
+		///finds the time step and iterations of an island, from its bodies that are stepped. Returns false when all its bodies skip this substep.
+		bool	getIslandLod(btCollisionObject** bodies,int numBodies,btScalar& timeStep,int& numIterations) const
+		{
+			int numLevels = m_lodLevels->size();
+			int islandLevel = numLevels;
+			timeStep = btScalar(0.);
+			for (int i=0;i<numBodies;i++)
+			{
+				btRigidBody* body = btRigidBody::upcast(bodies[i]);
+				if (!body)
+				{
+					timeStep = btMax(timeStep,m_solverInfo.m_timeStep);
+					islandLevel = 0;
+				} else if (body->getLodTimeStep() > btScalar(0.))
+				{
+					timeStep = btMax(timeStep,body->getLodTimeStep());
+					islandLevel = btMin(islandLevel,btMax(body->getLodLevel(),0));
+				}
+			}
+			if (timeStep == btScalar(0.))
+				return false;
+			numIterations = (*m_lodLevels)[btMin(islandLevel,numLevels-1)].m_numIterations;
+			if (!numIterations)
+				numIterations = m_solverInfo.m_numIterations;
+			return true;
+		}
+
+		///bodies that started touching in this substep can come from islands with other time steps, they are integrated with the time step they are solved with
+		void	setIslandLodTimeStep(btCollisionObject** bodies,int numBodies,btScalar timeStep)
+		{
+			for (int i=0;i<numBodies;i++)
+			{
+				btRigidBody* body = btRigidBody::upcast(bodies[i]);
+				if (body && body->getLodTimeStep() > btScalar(0.) && body->getLodTimeStep() != timeStep)
+				{
+					body->setLodTimeStep(timeStep);
+				}
+			}
+		}
+
 
 		InplaceSolverIslandCallback& operator=(InplaceSolverIslandCallback& other)
 		{
@@ -615,13 +916,40 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 		{
 			if (islandId<0)
 			{
+				if (m_lodLevels)
+				{
+					///all bodies are solved as one island
+					btScalar islandTimeStep;
+					int numIterations;
+					if (!getIslandLod(bodies,numBodies,islandTimeStep,numIterations))
+						return;
+					setIslandLodTimeStep(bodies,numBodies,islandTimeStep);
+					m_lodSolverInfo.m_timeStep = islandTimeStep;
+					m_lodSolverInfo.m_numIterations = numIterations;
+				}
 				if (numManifolds + m_numConstraints)
 				{
 					///we don't split islands, so all constraints/contact manifolds/bodies are passed into the solver regardless the island id
-					m_solver->solveGroup( bodies,numBodies,manifolds, numManifolds,&m_sortedConstraints[0],m_numConstraints,m_solverInfo,m_debugDrawer,m_stackAlloc,m_dispatcher);
+					m_solver->solveGroup( bodies,numBodies,manifolds, numManifolds,&m_sortedConstraints[0],m_numConstraints,getIslandSolverInfo(),m_debugDrawer,m_stackAlloc,m_dispatcher);
 				}
 			} else
 			{
+				if (m_lodLevels)
+				{
+					btScalar islandTimeStep;
+					int numIterations;
+					if (!getIslandLod(bodies,numBodies,islandTimeStep,numIterations))
+						return;
+					setIslandLodTimeStep(bodies,numBodies,islandTimeStep);
+					if (islandTimeStep != m_lodSolverInfo.m_timeStep || numIterations != m_lodSolverInfo.m_numIterations)
+					{
+						///islands are only batched with islands of the same time step and iterations
+						processConstraints();
+						m_lodSolverInfo.m_timeStep = islandTimeStep;
+						m_lodSolverInfo.m_numIterations = numIterations;
+					}
+				}
+
 					//also add all non-contact constraints/joints for this island
 				btTypedConstraint** startConstraint = 0;
 				int numCurConstraints = 0;
@@ -650,7 +978,7 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 					///only call solveGroup if there is some work: avoid virtual function call, its overhead can be excessive
 					if (numManifolds + numCurConstraints)
 					{
-						m_solver->solveGroup( bodies,numBodies,manifolds, numManifolds,startConstraint,numCurConstraints,m_solverInfo,m_debugDrawer,m_stackAlloc,m_dispatcher);
+						m_solver->solveGroup( bodies,numBodies,manifolds, numManifolds,startConstraint,numCurConstraints,getIslandSolverInfo(),m_debugDrawer,m_stackAlloc,m_dispatcher);
 					}
 				} else
 				{
@@ -680,7 +1008,7 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 				btPersistentManifold** manifold = m_manifolds.size()?&m_manifolds[0]:0;
 				btTypedConstraint** constraints = m_constraints.size()?&m_constraints[0]:0;
 				
-				m_solver->solveGroup( bodies,m_bodies.size(),manifold, m_manifolds.size(),constraints, m_constraints.size() ,m_solverInfo,m_debugDrawer,m_stackAlloc,m_dispatcher);
+				m_solver->solveGroup( bodies,m_bodies.size(),manifold, m_manifolds.size(),constraints, m_constraints.size() ,getIslandSolverInfo(),m_debugDrawer,m_stackAlloc,m_dispatcher);
 			}
 			m_bodies.resize(0);
 			m_manifolds.resize(0);
@@ -710,6 +1038,8 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 	btTypedConstraint** constraintsPtr = getNumConstraints() ? &sortedConstraints[0] : 0;
 	
 	InplaceSolverIslandCallback	solverCallback(	solverInfo,	m_constraintSolver, constraintsPtr,sortedConstraints.size(),	m_debugDrawer,m_stackAlloc,m_dispatcher1);
+	if (m_lodLevels.size())
+		solverCallback.m_lodLevels = &m_lodLevels;
 	
 	m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(), getCollisionWorld()->getDispatcher()->getNumManifolds());
 	
@@ -733,6 +1063,7 @@ void	btDiscreteDynamicsWorld::calculateSimulationIslands()
 	{
 		int i;
 		int numConstraints = int(m_constraints.size());
+		int numConstraintUnions = 0;
 		for (i=0;i< numConstraints ; i++ )
 		{
 			btTypedConstraint* constraint = m_constraints[i];
@@ -748,9 +1079,11 @@ void	btDiscreteDynamicsWorld::calculateSimulationIslands()
 
 					getSimulationIslandManager()->getUnionFind().unite((colObj0)->getIslandTag(),
 						(colObj1)->getIslandTag());
+					numConstraintUnions++;
 				}
 			}
 		}
+		getSimulationIslandManager()->notifyConstraintUnions(numConstraintUnions);
 	}
 
 	//Store the island id in each body
@@ -855,12 +1188,15 @@ void	btDiscreteDynamicsWorld::integrateTransforms(btScalar timeStep)
 	for ( int i=0;i<m_nonStaticRigidBodies.size();i++)
 	{
 		btRigidBody* body = m_nonStaticRigidBodies[i];
+		if (body->getCollisionFlags() & btCollisionObject::CF_LOD_SKIPPED)
+			continue;
+		btScalar bodyTimeStep = m_lodLevels.size() ? body->getLodTimeStep() : timeStep;
 		body->setHitFraction(1.f);
 
 		if (body->isActive() && (!body->isStaticOrKinematicObject()))
 		{
 
-			body->predictIntegratedTransform(timeStep, predictedTrans);
+			body->predictIntegratedTransform(bodyTimeStep, predictedTrans);
 			
 			btScalar squareMotion = (predictedTrans.getOrigin()-body->getWorldTransform().getOrigin()).length2();
 
@@ -871,7 +1207,7 @@ void	btDiscreteDynamicsWorld::integrateTransforms(btScalar timeStep)
 				BT_PROFILE("CCD motion clamping");
 				if (body->getCollisionShape()->isConvex())
 				{
-					gNumClampedCcdMotions++;
+					btAtomicAdd(gNumClampedCcdMotions,1);
 #ifdef USE_STATIC_ONLY
 					class StaticOnlyCallback : public btClosestNotMeConvexResultCallback
 					{
@@ -910,7 +1246,7 @@ void	btDiscreteDynamicsWorld::integrateTransforms(btScalar timeStep)
 						
 						//printf("clamped integration to hit fraction = %f\n",fraction);
 						body->setHitFraction(sweepResults.m_closestHitFraction);
-						body->predictIntegratedTransform(timeStep*body->getHitFraction(), predictedTrans);
+						body->predictIntegratedTransform(bodyTimeStep*body->getHitFraction(), predictedTrans);
 						body->setHitFraction(0.f);
 						body->proceedToTransform( predictedTrans);
 
@@ -925,7 +1261,7 @@ void	btDiscreteDynamicsWorld::integrateTransforms(btScalar timeStep)
 							linVel*= maxSpeed;
 							body->setLinearVelocity(linVel);
 							btScalar ms2 = body->getLinearVelocity().length2();
-							body->predictIntegratedTransform(timeStep, predictedTrans);
+							body->predictIntegratedTransform(bodyTimeStep, predictedTrans);
 
 							btScalar sm2 = (predictedTrans.getOrigin()-body->getWorldTransform().getOrigin()).length2();
 							btScalar smt = body->getCcdSquareMotionThreshold();
@@ -958,11 +1294,14 @@ void	btDiscreteDynamicsWorld::addSpeculativeContacts(btScalar timeStep)
 	for ( int i=0;i<m_nonStaticRigidBodies.size();i++)
 	{
 		btRigidBody* body = m_nonStaticRigidBodies[i];
+		if (body->getCollisionFlags() & btCollisionObject::CF_LOD_SKIPPED)
+			continue;
+		btScalar bodyTimeStep = m_lodLevels.size() ? body->getLodTimeStep() : timeStep;
 		body->setHitFraction(1.f);
 
 		if (body->isActive() && (!body->isStaticOrKinematicObject()))
 		{
-			body->predictIntegratedTransform(timeStep, predictedTrans);
+			body->predictIntegratedTransform(bodyTimeStep, predictedTrans);
 			btScalar squareMotion = (predictedTrans.getOrigin()-body->getWorldTransform().getOrigin()).length2();
 
 			if (body->getCcdSquareMotionThreshold() && body->getCcdSquareMotionThreshold() < squareMotion)
@@ -970,7 +1309,7 @@ void	btDiscreteDynamicsWorld::addSpeculativeContacts(btScalar timeStep)
 				BT_PROFILE("search speculative contacts");
 				if (body->getCollisionShape()->isConvex())
 				{
-					gNumClampedCcdMotions++;
+					btAtomicAdd(gNumClampedCcdMotions,1);
 					
 					btClosestNotMeConvexResultCallback sweepResults(body,body->getWorldTransform().getOrigin(),predictedTrans.getOrigin(),getBroadphase()->getOverlappingPairCache(),getDispatcher());
 					//btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
@@ -1070,13 +1409,15 @@ void	btDiscreteDynamicsWorld::predictUnconstraintMotion(btScalar timeStep)
 	for ( int i=0;i<m_nonStaticRigidBodies.size();i++)
 	{
 		btRigidBody* body = m_nonStaticRigidBodies[i];
-		if (!body->isStaticOrKinematicObject())
+		if (!body->isStaticOrKinematicObject() && !(body->getCollisionFlags() & btCollisionObject::CF_LOD_SKIPPED))
 		{
-			body->integrateVelocities( timeStep);
+			btScalar bodyTimeStep = m_lodLevels.size() ? body->getLodTimeStep() : timeStep;
+
+			body->integrateVelocities( bodyTimeStep);
 			//damping
-			body->applyDamping(timeStep);
+			body->applyDamping(bodyTimeStep);
 
-			body->predictIntegratedTransform(timeStep,body->getInterpolationWorldTransform());
+			body->predictIntegratedTransform(bodyTimeStep,body->getInterpolationWorldTransform());
 		}
 	}
 }
@@ -1351,3 +1692,666 @@ void	btDiscreteDynamicsWorld::serialize(btSerializer* serializer)
 	serializer->finishSerialization();
 }
 
+
+
+static void	btFillObjectRecord(btDynamicsWorldSnapshot::btObjectRecord& record,const btCollisionObject* colObj,int index)
+{
+	///clear the padding, delta snapshots compare records with memcmp
+	memset(&record,0,sizeof(record));
+	colObj->getWorldTransform().serialize(record.m_worldTransform);
+	colObj->getInterpolationWorldTransform().serialize(record.m_interpolationWorldTransform);
+	colObj->getInterpolationLinearVelocity().serialize(record.m_interpolationLinearVelocity);
+	colObj->getInterpolationAngularVelocity().serialize(record.m_interpolationAngularVelocity);
+	const btRigidBody* body = btRigidBody::upcast(colObj);
+	if (body)
+	{
+		body->getLinearVelocity().serialize(record.m_linearVelocity);
+		body->getAngularVelocity().serialize(record.m_angularVelocity);
+	}
+	record.m_deactivationTime = colObj->getDeactivationTime();
+	record.m_hitFraction = colObj->getHitFraction();
+	record.m_activationState = colObj->getActivationState();
+	record.m_index = index;
+}
+
+static void	btFillConstraintRecord(btDynamicsWorldSnapshot::btConstraintRecord& record,btTypedConstraint* constraint,int index)
+{
+	memset(&record,0,sizeof(record));
+	record.m_appliedImpulse = constraint->internalGetAppliedImpulse();
+	record.m_isEnabled = constraint->isEnabled();
+	record.m_index = index;
+}
+
+///a delta base has to be a full snapshot of the current format, taken from a world with the same objects and constraints
+static bool	btIsSnapshotBaseValid(const btDynamicsWorldSnapshot& base,int numObjects,int numConstraints)
+{
+	if (!base.hasValidHeader() || base.isDelta())
+		return false;
+	const btDynamicsWorldSnapshot::btHeader& header = base.getHeader();
+	if (header.m_numCollisionObjects != numObjects || header.m_numConstraints != numConstraints)
+		return false;
+	return base.getSize() >= int(sizeof(btDynamicsWorldSnapshot::btHeader) + numObjects*sizeof(btDynamicsWorldSnapshot::btObjectRecord) +
+		numConstraints*sizeof(btDynamicsWorldSnapshot::btConstraintRecord));
+}
+
+bool	btDiscreteDynamicsWorld::writeSnapshot(const btDynamicsWorldSnapshot* base,btDynamicsWorldSnapshot& snapshot)
+{
+	BT_PROFILE("saveSnapshot");
+	btAssert(base != &snapshot);
+
+	typedef btDynamicsWorldSnapshot::btHeader btHeader;
+	typedef btDynamicsWorldSnapshot::btObjectRecord btObjectRecord;
+	typedef btDynamicsWorldSnapshot::btConstraintRecord btConstraintRecord;
+	typedef btDynamicsWorldSnapshot::btManifoldRecord btManifoldRecord;
+
+	int numObjects = m_collisionObjects.size();
+	int numConstraints = m_constraints.size();
+	int numManifolds = m_dispatcher1->getNumManifolds();
+
+	bool validBase = true;
+	if (base && !btIsSnapshotBaseValid(*base,numObjects,numConstraints))
+	{
+		///the base doesn't belong to the current world, store everything
+		base = 0;
+		validBase = false;
+	}
+
+	int i;
+	int maxSize = sizeof(btHeader) + numObjects*sizeof(btObjectRecord) + numConstraints*sizeof(btConstraintRecord);
+	for (i=0;i<numManifolds;i++)
+	{
+		maxSize += sizeof(btManifoldRecord) + m_dispatcher1->getManifoldByIndexInternal(i)->getNumContacts()*sizeof(btManifoldPoint);
+	}
+
+	unsigned char* buffer = snapshot.internalAllocate(maxSize);
+	unsigned char* cursor = buffer + sizeof(btHeader);
+
+	btHeader header;
+	memset(&header,0,sizeof(header));
+	header.m_version = BT_DYNAMICS_WORLD_SNAPSHOT_VERSION;
+	header.m_sizeofManifoldPoint = int(sizeof(btManifoldPoint));
+	header.m_numCollisionObjects = numObjects;
+	header.m_numConstraints = numConstraints;
+	header.m_numManifolds = numManifolds;
+	header.m_isDelta = base ? 1 : 0;
+	header.m_localTime = m_localTime;
+	header.m_timeDebt = m_timeDebt;
+	m_worldOrigin.serialize(header.m_worldOrigin);
+
+	const unsigned char* baseObjects = base ? base->getBuffer() + sizeof(btHeader) : 0;
+	btObjectRecord objectRecord;
+	for (i=0;i<numObjects;i++)
+	{
+		btFillObjectRecord(objectRecord,m_collisionObjects[i],i);
+		if (baseObjects && !memcmp(&objectRecord,baseObjects + i*sizeof(btObjectRecord),sizeof(btObjectRecord)))
+			continue;
+		memcpy(cursor,&objectRecord,sizeof(btObjectRecord));
+		cursor += sizeof(btObjectRecord);
+		header.m_numObjectRecords++;
+	}
+
+	const unsigned char* baseConstraints = base ? baseObjects + numObjects*sizeof(btObjectRecord) : 0;
+	btConstraintRecord constraintRecord;
+	for (i=0;i<numConstraints;i++)
+	{
+		btFillConstraintRecord(constraintRecord,m_constraints[i],i);
+		if (baseConstraints && !memcmp(&constraintRecord,baseConstraints + i*sizeof(btConstraintRecord),sizeof(btConstraintRecord)))
+			continue;
+		memcpy(cursor,&constraintRecord,sizeof(btConstraintRecord));
+		cursor += sizeof(btConstraintRecord);
+		header.m_numConstraintRecords++;
+	}
+
+	for (i=0;i<numManifolds;i++)
+	{
+		const btPersistentManifold* manifold = m_dispatcher1->getManifoldByIndexInternal(i);
+		btManifoldRecord manifoldRecord;
+		memset(&manifoldRecord,0,sizeof(manifoldRecord));
+		manifoldRecord.m_body0 = manifold->getBody0();
+		manifoldRecord.m_body1 = manifold->getBody1();
+		manifoldRecord.m_childIndex0 = manifold->m_childIndex0;
+		manifoldRecord.m_childIndex1 = manifold->m_childIndex1;
+		manifoldRecord.m_numContacts = manifold->getNumContacts();
+		memcpy(cursor,&manifoldRecord,sizeof(btManifoldRecord));
+		cursor += sizeof(btManifoldRecord);
+		if (manifoldRecord.m_numContacts)
+		{
+			memcpy(cursor,&manifold->getContactPoint(0),manifoldRecord.m_numContacts*sizeof(btManifoldPoint));
+			cursor += manifoldRecord.m_numContacts*sizeof(btManifoldPoint);
+		}
+	}
+
+	memcpy(buffer,&header,sizeof(btHeader));
+	snapshot.internalSetSize(int(cursor-buffer));
+	return validBase;
+}
+
+
+///checks that the records and manifolds announced by the header fit in the buffer and that delta records are sorted by index,
+///so a truncated or corrupt buffer is rejected before the world is changed
+///the manifold records refer to the objects by pointer, they have to be objects of the world
+static bool	btIsSnapshotBufferValid(const btDynamicsWorldSnapshot& snapshot,const btHashMap<btHashPtr,int>& worldObjects)
+{
+	typedef btDynamicsWorldSnapshot::btHeader btHeader;
+	typedef btDynamicsWorldSnapshot::btObjectRecord btObjectRecord;
+	typedef btDynamicsWorldSnapshot::btConstraintRecord btConstraintRecord;
+	typedef btDynamicsWorldSnapshot::btManifoldRecord btManifoldRecord;
+
+	const btHeader& header = snapshot.getHeader();
+	const unsigned char* buffer = snapshot.getBuffer();
+	int size = snapshot.getSize();
+	if (header.m_numObjectRecords < 0 || header.m_numObjectRecords > header.m_numCollisionObjects ||
+		header.m_numConstraintRecords < 0 || header.m_numConstraintRecords > header.m_numConstraints || header.m_numManifolds < 0)
+		return false;
+	if (!header.m_isDelta && (header.m_numObjectRecords != header.m_numCollisionObjects || header.m_numConstraintRecords != header.m_numConstraints))
+		return false;
+
+	int offset = sizeof(btHeader);
+	if (size - offset < header.m_numObjectRecords*int(sizeof(btObjectRecord)) + header.m_numConstraintRecords*int(sizeof(btConstraintRecord)))
+		return false;
+	int i;
+	if (header.m_isDelta)
+	{
+		int prevIndex = -1;
+		for (i=0;i<header.m_numObjectRecords;i++)
+		{
+			btObjectRecord objectRecord;
+			memcpy(&objectRecord,buffer + offset + i*sizeof(btObjectRecord),sizeof(btObjectRecord));
+			if (objectRecord.m_index <= prevIndex || objectRecord.m_index >= header.m_numCollisionObjects)
+				return false;
+			prevIndex = objectRecord.m_index;
+		}
+		offset += header.m_numObjectRecords*sizeof(btObjectRecord);
+		prevIndex = -1;
+		for (i=0;i<header.m_numConstraintRecords;i++)
+		{
+			btConstraintRecord constraintRecord;
+			memcpy(&constraintRecord,buffer + offset + i*sizeof(btConstraintRecord),sizeof(btConstraintRecord));
+			if (constraintRecord.m_index <= prevIndex || constraintRecord.m_index >= header.m_numConstraints)
+				return false;
+			prevIndex = constraintRecord.m_index;
+		}
+		offset += header.m_numConstraintRecords*sizeof(btConstraintRecord);
+	} else
+	{
+		offset += header.m_numObjectRecords*sizeof(btObjectRecord) + header.m_numConstraintRecords*sizeof(btConstraintRecord);
+	}
+
+	for (i=0;i<header.m_numManifolds;i++)
+	{
+		if (size - offset < int(sizeof(btManifoldRecord)))
+			return false;
+		btManifoldRecord manifoldRecord;
+		memcpy(&manifoldRecord,buffer + offset,sizeof(btManifoldRecord));
+		offset += sizeof(btManifoldRecord);
+		if (!worldObjects.find(manifoldRecord.m_body0) || !worldObjects.find(manifoldRecord.m_body1))
+			return false;
+		if (manifoldRecord.m_numContacts < 0 || manifoldRecord.m_numContacts > MANIFOLD_CACHE_SIZE ||
+			size - offset < manifoldRecord.m_numContacts*int(sizeof(btManifoldPoint)))
+			return false;
+		offset += manifoldRecord.m_numContacts*sizeof(btManifoldPoint);
+	}
+	return true;
+}
+
+///the key of a contact manifold in a snapshot: its objects and the compound child indices, see btPersistentManifold::m_childIndex0
+static bool	btSnapshotManifoldKeyLess(const btPersistentManifold& manifold,const btDynamicsWorldSnapshot::btManifoldRecord& record)
+{
+	if (manifold.getBody0() != record.m_body0)
+		return (size_t)manifold.getBody0() < (size_t)record.m_body0;
+	if (manifold.getBody1() != record.m_body1)
+		return (size_t)manifold.getBody1() < (size_t)record.m_body1;
+	if (manifold.m_childIndex0 != record.m_childIndex0)
+		return manifold.m_childIndex0 < record.m_childIndex0;
+	return manifold.m_childIndex1 < record.m_childIndex1;
+}
+
+static bool	btSnapshotManifoldKeyEqual(const btPersistentManifold& manifold,const btDynamicsWorldSnapshot::btManifoldRecord& record)
+{
+	return manifold.getBody0() == record.m_body0 && manifold.getBody1() == record.m_body1 &&
+		manifold.m_childIndex0 == record.m_childIndex0 && manifold.m_childIndex1 == record.m_childIndex1;
+}
+
+struct btSnapshotManifoldSortPredicate
+{
+	template <class T>
+	bool operator() ( const T& a, const T& b ) const
+	{
+		if (a.m_manifold->getBody0() != b.m_manifold->getBody0())
+			return (size_t)a.m_manifold->getBody0() < (size_t)b.m_manifold->getBody0();
+		if (a.m_manifold->getBody1() != b.m_manifold->getBody1())
+			return (size_t)a.m_manifold->getBody1() < (size_t)b.m_manifold->getBody1();
+		if (a.m_manifold->m_childIndex0 != b.m_manifold->m_childIndex0)
+			return a.m_manifold->m_childIndex0 < b.m_manifold->m_childIndex0;
+		if (a.m_manifold->m_childIndex1 != b.m_manifold->m_childIndex1)
+			return a.m_manifold->m_childIndex1 < b.m_manifold->m_childIndex1;
+		return a.m_order < b.m_order;
+	}
+};
+
+///returns the first unmatched entry with the key of the record, or -1
+template <class T>
+static int	btFindSnapshotManifold(const btAlignedObjectArray<T>& entries,const btDynamicsWorldSnapshot::btManifoldRecord& record)
+{
+	//lower bound of the key
+	int lo = 0;
+	int hi = entries.size();
+	while (lo < hi)
+	{
+		int mid = (lo+hi)/2;
+		if (btSnapshotManifoldKeyLess(*entries[mid].m_manifold,record))
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	for (int i=lo;i<entries.size();i++)
+	{
+		if (!btSnapshotManifoldKeyEqual(*entries[i].m_manifold,record))
+			break;
+		if (!entries[i].m_matched)
+			return i;
+	}
+	return -1;
+}
+
+void	btDiscreteDynamicsWorld::collectSnapshotManifolds()
+{
+	int numManifolds = m_dispatcher1->getNumManifolds();
+	m_snapshotManifolds.resize(numManifolds);
+	for (int i=0;i<numManifolds;i++)
+	{
+		m_snapshotManifolds[i].m_manifold = m_dispatcher1->getManifoldByIndexInternal(i);
+		m_snapshotManifolds[i].m_order = i;
+		m_snapshotManifolds[i].m_matched = 0;
+	}
+	m_snapshotManifolds.quickSort(btSnapshotManifoldSortPredicate());
+}
+
+bool	btDiscreteDynamicsWorld::readSnapshot(const btDynamicsWorldSnapshot* base,const btDynamicsWorldSnapshot& snapshot)
+{
+	BT_PROFILE("restoreSnapshot");
+
+	typedef btDynamicsWorldSnapshot::btHeader btHeader;
+	typedef btDynamicsWorldSnapshot::btObjectRecord btObjectRecord;
+	typedef btDynamicsWorldSnapshot::btConstraintRecord btConstraintRecord;
+	typedef btDynamicsWorldSnapshot::btManifoldRecord btManifoldRecord;
+
+	int numObjects = m_collisionObjects.size();
+	int numConstraints = m_constraints.size();
+
+	if (!snapshot.hasValidHeader())
+		return false;
+	btHeader header;
+	memcpy(&header,snapshot.getBuffer(),sizeof(btHeader));
+	if (header.m_numCollisionObjects != numObjects || header.m_numConstraints != numConstraints)
+		return false;
+	if ((header.m_isDelta != 0) != (base != 0))
+		return false;
+	if (base && !btIsSnapshotBaseValid(*base,numObjects,numConstraints))
+		return false;
+	btHashMap<btHashPtr,int> worldObjects;
+	for (int j=0;j<numObjects;j++)
+	{
+		worldObjects.insert(m_collisionObjects[j],j);
+	}
+	if (!btIsSnapshotBufferValid(snapshot,worldObjects))
+		return false;
+
+	///the records are relative to the world origin at the time of the snapshot
+	btVector3 worldOrigin;
+	worldOrigin.deSerialize(header.m_worldOrigin);
+	if (worldOrigin != m_worldOrigin)
+	{
+		shiftOrigin(worldOrigin - m_worldOrigin);
+	}
+
+	m_localTime = header.m_localTime;
+	m_timeDebt = header.m_timeDebt;
+
+	int i;
+	const unsigned char* cursor = snapshot.getBuffer() + sizeof(btHeader);
+	const unsigned char* baseObjects = base ? base->getBuffer() + sizeof(btHeader) : 0;
+
+	///a full snapshot stores all records in order, a delta only the changed ones, sorted by index
+	btObjectRecord objectRecord;
+	btObjectRecord deltaObjectRecord;
+	int numDeltaObjects = base ? header.m_numObjectRecords : 0;
+	int deltaObject = 0;
+	if (numDeltaObjects)
+	{
+		memcpy(&deltaObjectRecord,cursor,sizeof(btObjectRecord));
+	}
+	for (i=0;i<numObjects;i++)
+	{
+		if (!base)
+		{
+			memcpy(&objectRecord,cursor,sizeof(btObjectRecord));
+			cursor += sizeof(btObjectRecord);
+		} else if (deltaObject < numDeltaObjects && deltaObjectRecord.m_index == i)
+		{
+			objectRecord = deltaObjectRecord;
+			cursor += sizeof(btObjectRecord);
+			deltaObject++;
+			if (deltaObject < numDeltaObjects)
+			{
+				memcpy(&deltaObjectRecord,cursor,sizeof(btObjectRecord));
+			}
+		} else
+		{
+			memcpy(&objectRecord,baseObjects + i*sizeof(btObjectRecord),sizeof(btObjectRecord));
+		}
+
+		btCollisionObject* colObj = m_collisionObjects[i];
+		btTransform transform;
+		btVector3 velocity;
+		transform.deSerialize(objectRecord.m_worldTransform);
+		colObj->setWorldTransform(transform);
+		transform.deSerialize(objectRecord.m_interpolationWorldTransform);
+		colObj->setInterpolationWorldTransform(transform);
+		velocity.deSerialize(objectRecord.m_interpolationLinearVelocity);
+		colObj->setInterpolationLinearVelocity(velocity);
+		velocity.deSerialize(objectRecord.m_interpolationAngularVelocity);
+		colObj->setInterpolationAngularVelocity(velocity);
+		colObj->forceActivationState(objectRecord.m_activationState);
+		colObj->setDeactivationTime(objectRecord.m_deactivationTime);
+		colObj->setHitFraction(objectRecord.m_hitFraction);
+		btRigidBody* body = btRigidBody::upcast(colObj);
+		if (body)
+		{
+			velocity.deSerialize(objectRecord.m_linearVelocity);
+			body->setLinearVelocity(velocity);
+			velocity.deSerialize(objectRecord.m_angularVelocity);
+			body->setAngularVelocity(velocity);
+			body->updateInertiaTensor();
+			synchronizeSingleMotionState(body);
+		}
+		if (!colObj->isStaticObject())
+		{
+			updateSingleAabb(colObj);
+		}
+	}
+
+	const unsigned char* baseConstraints = base ? baseObjects + numObjects*sizeof(btObjectRecord) : 0;
+	btConstraintRecord constraintRecord;
+	btConstraintRecord deltaConstraintRecord;
+	int numDeltaConstraints = base ? header.m_numConstraintRecords : 0;
+	int deltaConstraint = 0;
+	if (numDeltaConstraints)
+	{
+		memcpy(&deltaConstraintRecord,cursor,sizeof(btConstraintRecord));
+	}
+	for (i=0;i<numConstraints;i++)
+	{
+		if (!base)
+		{
+			memcpy(&constraintRecord,cursor,sizeof(btConstraintRecord));
+			cursor += sizeof(btConstraintRecord);
+		} else if (deltaConstraint < numDeltaConstraints && deltaConstraintRecord.m_index == i)
+		{
+			constraintRecord = deltaConstraintRecord;
+			cursor += sizeof(btConstraintRecord);
+			deltaConstraint++;
+			if (deltaConstraint < numDeltaConstraints)
+			{
+				memcpy(&deltaConstraintRecord,cursor,sizeof(btConstraintRecord));
+			}
+		} else
+		{
+			memcpy(&constraintRecord,baseConstraints + i*sizeof(btConstraintRecord),sizeof(btConstraintRecord));
+		}
+
+		btTypedConstraint* constraint = m_constraints[i];
+		constraint->internalSetAppliedImpulse(constraintRecord.m_appliedImpulse);
+		constraint->setEnabled(constraintRecord.m_isEnabled != 0);
+	}
+
+	///the current contacts are replaced, gContactDestroyedCallback releases their user data
+	int numCurrentManifolds = m_dispatcher1->getNumManifolds();
+	for (i=0;i<numCurrentManifolds;i++)
+	{
+		m_dispatcher1->getManifoldByIndexInternal(i)->clearManifold();
+	}
+
+	///deterministic mode recreates the pairs and manifolds that were removed since the snapshot, before the contacts are restored.
+	///This isn't a simulation step, the contact callbacks are suspended meanwhile and the points it finds are replaced below.
+	const unsigned char* manifoldRecords = cursor;
+	btManifoldRecord manifoldRecord;
+	if (isDeterministic())
+	{
+		ContactAddedCallback contactAdded = gContactAddedCallback;
+		ContactProcessedCallback contactProcessed = gContactProcessedCallback;
+		ContactDestroyedCallback contactDestroyed = gContactDestroyedCallback;
+		gContactAddedCallback = 0;
+		gContactProcessedCallback = 0;
+		gContactDestroyedCallback = 0;
+		getDispatchInfo().m_processAllCompoundChildren = true;
+		performDiscreteCollisionDetection();
+
+		///the pass above uses the restored bounds, while the next step also sweeps them over the predicted motion, so a pair
+		///that had contacts can still be skipped here. Those pairs are added and processed directly, to get their manifolds back.
+		collectSnapshotManifolds();
+		btOverlappingPairCache* pairCache = m_broadphasePairCache->getOverlappingPairCache();
+		for (i=0;i<header.m_numManifolds;i++)
+		{
+			memcpy(&manifoldRecord,cursor,sizeof(btManifoldRecord));
+			cursor += sizeof(btManifoldRecord) + manifoldRecord.m_numContacts*sizeof(btManifoldPoint);
+			if (!manifoldRecord.m_numContacts || btFindSnapshotManifold(m_snapshotManifolds,manifoldRecord) >= 0)
+				continue;
+			btBroadphaseProxy* proxy0 = ((btCollisionObject*)manifoldRecord.m_body0)->getBroadphaseHandle();
+			btBroadphaseProxy* proxy1 = ((btCollisionObject*)manifoldRecord.m_body1)->getBroadphaseHandle();
+			if (!proxy0 || !proxy1)
+				continue;
+			btBroadphasePair* pair = pairCache->findPair(proxy0,proxy1);
+			if (!pair)
+				pair = pairCache->addOverlappingPair(proxy0,proxy1);
+			if (!pair)
+				continue;
+			btCollisionObject* colObj0 = (btCollisionObject*)pair->m_pProxy0->m_clientObject;
+			btCollisionObject* colObj1 = (btCollisionObject*)pair->m_pProxy1->m_clientObject;
+			if (!pair->m_algorithm)
+				pair->m_algorithm = m_dispatcher1->findAlgorithm(colObj0,colObj1);
+			if (pair->m_algorithm)
+			{
+				btManifoldResult contactPointResult(colObj0,colObj1);
+				pair->m_algorithm->processCollision(colObj0,colObj1,getDispatchInfo(),&contactPointResult);
+			}
+		}
+		cursor = manifoldRecords;
+		getDispatchInfo().m_processAllCompoundChildren = false;
+
+		gContactAddedCallback = contactAdded;
+		gContactProcessedCallback = contactProcessed;
+		gContactDestroyedCallback = contactDestroyed;
+	}
+
+	///match the stored manifolds with the current ones by object pair and compound child indices. Manifolds with the same key
+	///(only possible for algorithms that keep several manifolds per child pair) are matched in dispatcher order.
+	collectSnapshotManifolds();
+	btManifoldPoint point;
+	for (i=0;i<header.m_numManifolds;i++)
+	{
+		memcpy(&manifoldRecord,cursor,sizeof(btManifoldRecord));
+		cursor += sizeof(btManifoldRecord);
+		const unsigned char* points = cursor;
+		cursor += manifoldRecord.m_numContacts*sizeof(btManifoldPoint);
+
+		int match = btFindSnapshotManifold(m_snapshotManifolds,manifoldRecord);
+		if (match < 0)
+			continue;
+
+		m_snapshotManifolds[match].m_matched = 1;
+		btPersistentManifold* manifold = m_snapshotManifolds[match].m_manifold;
+		manifold->clearManifold();
+		for (int j=0;j<manifoldRecord.m_numContacts;j++)
+		{
+			memcpy(&point,points + j*sizeof(btManifoldPoint),sizeof(btManifoldPoint));
+			point.m_userPersistentData = 0;
+			manifold->addManifoldPoint(point);
+		}
+	}
+	for (i=0;i<m_snapshotManifolds.size();i++)
+	{
+		if (!m_snapshotManifolds[i].m_matched)
+		{
+			m_snapshotManifolds[i].m_manifold->clearManifold();
+		}
+	}
+
+	///incremental islands keep their unions across steps, rebuild them for the restored state
+	if (m_islandManager->getIncrementalIslands())
+	{
+		m_islandManager->setIncrementalIslands(true);
+	}
+	return true;
+}
+
+void	btDiscreteDynamicsWorld::shiftOrigin(const btVector3& shift)
+{
+	btCollisionWorld::shiftOrigin(shift);
+
+	for (int i=0;i<m_collisionObjects.size();i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(m_collisionObjects[i]);
+		if (!body || !body->getMotionState())
+			continue;
+		if (body->isKinematicObject())
+		{
+			//saveKinematicState reads the next transform from the motion state
+			btTransform worldTrans;
+			body->getMotionState()->getWorldTransform(worldTrans);
+			worldTrans.getOrigin() -= shift;
+			body->getMotionState()->setWorldTransform(worldTrans);
+		} else
+		{
+			synchronizeSingleMotionState(body);
+		}
+	}
+}
+
+void	btDiscreteDynamicsWorld::updateLodSteps(btScalar timeStep)
+{
+	BT_PROFILE("updateLodSteps");
+
+	///the bodies of an island are stepped together, with the finest level among them and the longest time step among them. The islands of the
+	///previous substep are used, bodies that start touching in this substep are solved with the island that is stepped, and stepped together from the next substep on
+	int numLevels = m_lodLevels.size();
+	m_lodIslandLevels.resize(0);
+	m_lodIslandLevels.resize(m_collisionObjects.size(),numLevels-1);
+	m_lodIslandTimeSteps.resize(0);
+	m_lodIslandTimeSteps.resize(m_collisionObjects.size(),btScalar(0.));
+	int i;
+	for (i=0;i<m_nonStaticRigidBodies.size();i++)
+	{
+		btRigidBody* body = m_nonStaticRigidBodies[i];
+		int islandTag = body->getIslandTag();
+		if (islandTag >= 0 && islandTag < m_lodIslandLevels.size())
+		{
+			m_lodIslandLevels[islandTag] = btMin(m_lodIslandLevels[islandTag],btMax(body->getLodLevel(),0));
+		}
+	}
+
+	for (i=0;i<m_nonStaticRigidBodies.size();i++)
+	{
+		btRigidBody* body = m_nonStaticRigidBodies[i];
+		bool stepped = true;
+		if (body->isActive() && !body->isStaticOrKinematicObject())
+		{
+			int islandTag = body->getIslandTag();
+			int level = (islandTag >= 0 && islandTag < m_lodIslandLevels.size()) ? m_lodIslandLevels[islandTag] : btMin(btMax(body->getLodLevel(),0),numLevels-1);
+			int updateInterval = m_lodLevels[level].m_updateInterval;
+			stepped = (m_lodStepCount & (updateInterval-1)) == (updateInterval>>1);
+			///a body that its island stepped ahead of the world waits until the world catches up
+			if (body->getLodElapsedTime() + timeStep <= btScalar(0.))
+				stepped = false;
+		}
+		body->updateLodTime(timeStep,stepped);
+		if (stepped)
+		{
+			body->setCollisionFlags(body->getCollisionFlags() & ~btCollisionObject::CF_LOD_SKIPPED);
+			int islandTag = body->getIslandTag();
+			if (islandTag >= 0 && islandTag < m_lodIslandTimeSteps.size())
+			{
+				m_lodIslandTimeSteps[islandTag] = btMax(m_lodIslandTimeSteps[islandTag],body->getLodTimeStep());
+			}
+		} else
+		{
+			body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_LOD_SKIPPED);
+		}
+	}
+
+	///the stepped bodies of an island are integrated with the time step the island is solved with
+	for (i=0;i<m_nonStaticRigidBodies.size();i++)
+	{
+		btRigidBody* body = m_nonStaticRigidBodies[i];
+		int islandTag = body->getIslandTag();
+		if (body->getLodTimeStep() > btScalar(0.) && islandTag >= 0 && islandTag < m_lodIslandTimeSteps.size())
+		{
+			body->setLodTimeStep(m_lodIslandTimeSteps[islandTag]);
+		}
+	}
+	m_lodStepCount++;
+}
+
+void	btDiscreteDynamicsWorld::setLodLevel(int level,int updateInterval,int numIterations)
+{
+	btAssert(level >= 0 && updateInterval >= 1);
+	int interval = 1;
+	while (interval < updateInterval)
+	{
+		interval <<= 1;
+	}
+	while (m_lodLevels.size() <= level)
+	{
+		btRigidBodyLodLevel lodLevel;
+		lodLevel.m_updateInterval = 1;
+		lodLevel.m_numIterations = 0;
+		m_lodLevels.push_back(lodLevel);
+	}
+	m_lodLevels[level].m_updateInterval = interval;
+	m_lodLevels[level].m_numIterations = numIterations;
+}
+
+void	btDiscreteDynamicsWorld::clearLodLevels()
+{
+	m_lodLevels.clear();
+	m_lodIslandLevels.clear();
+	m_lodIslandTimeSteps.clear();
+	for (int i=0;i<m_nonStaticRigidBodies.size();i++)
+	{
+		btRigidBody* body = m_nonStaticRigidBodies[i];
+		body->setCollisionFlags(body->getCollisionFlags() & ~btCollisionObject::CF_LOD_SKIPPED);
+		body->updateLodTime(btScalar(0.),true);
+	}
+}
+
+void	btDiscreteDynamicsWorld::setDeterministic(bool deterministic)
+{
+	getDispatchInfo().m_deterministicOrder = deterministic;
+	if (deterministic)
+	{
+		getSolverInfo().m_solverMode |= SOLVER_DETERMINISTIC;
+	} else
+	{
+		getSolverInfo().m_solverMode &= ~SOLVER_DETERMINISTIC;
+	}
+}
+
+void	btDiscreteDynamicsWorld::saveSnapshot(btDynamicsWorldSnapshot& snapshot)
+{
+	writeSnapshot(0,snapshot);
+}
+
+bool	btDiscreteDynamicsWorld::saveDeltaSnapshot(const btDynamicsWorldSnapshot& base,btDynamicsWorldSnapshot& delta)
+{
+	return writeSnapshot(&base,delta);
+}
+
+bool	btDiscreteDynamicsWorld::restoreSnapshot(const btDynamicsWorldSnapshot& snapshot)
+{
+	return readSnapshot(0,snapshot);
+}
+
+bool	btDiscreteDynamicsWorld::restoreDeltaSnapshot(const btDynamicsWorldSnapshot& base,const btDynamicsWorldSnapshot& delta)
+{
+	return readSnapshot(&base,delta);
+}
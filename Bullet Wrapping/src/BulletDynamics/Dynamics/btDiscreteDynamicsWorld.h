@@ -27,8 +27,19 @@ class btTypedConstraint;
 class btActionInterface;
 
 class btIDebugDraw;
+class btPersistentManifold;
+class btDynamicsWorldSnapshot;
 #include "LinearMath/btAlignedObjectArray.h"
 
+///update rate and solver iterations of the rigid bodies at a level of detail, see btDiscreteDynamicsWorld::setLodLevel
+struct	btRigidBodyLodLevel
+{
+	///the bodies are stepped once every m_updateInterval substeps, a power of two
+	int		m_updateInterval;
+	///solver iterations of the islands at this level, 0 uses btContactSolverInfo::m_numIterations
+	int		m_numIterations;
+};
+
 
 ///btDiscreteDynamicsWorld provides discrete rigid body simulation
 ///those classes replace the obsolete CcdPhysicsEnvironment/CcdPhysicsController
@@ -50,6 +61,14 @@ protected:
 	btScalar	m_localTime;
 	//for variable timesteps
 
+	btScalar	m_fixedTimeStep;
+
+	///state of stepSimulationWithBudget
+	btScalar	m_timeDebt;
+	btScalar	m_droppedTime;
+	btScalar	m_averageSubStepTime;
+	int			m_lastNumSubSteps;
+
 	bool	m_ownsIslandManager;
 	bool	m_ownsConstraintSolver;
 	bool	m_synchronizeAllMotionStates;
@@ -58,6 +77,30 @@ protected:
 	
 	int	m_profileTimings;
 
+	///levels of detail, empty when all bodies are stepped every substep
+	btAlignedObjectArray<btRigidBodyLodLevel>	m_lodLevels;
+	int		m_lodStepCount;
+	btAlignedObjectArray<int>	m_lodIslandLevels;
+	btAlignedObjectArray<btScalar>	m_lodIslandTimeSteps;
+
+	///decides which bodies are stepped in this substep, from their level of detail
+	void	updateLodSteps(btScalar timeStep);
+
+	struct	btSnapshotManifoldEntry
+	{
+		btPersistentManifold*	m_manifold;
+		int		m_order;
+		int		m_matched;
+	};
+	btAlignedObjectArray<btSnapshotManifoldEntry>	m_snapshotManifolds;
+
+	///fills m_snapshotManifolds with the current manifolds, sorted by their snapshot key
+	void	collectSnapshotManifolds();
+
+	bool	writeSnapshot(const btDynamicsWorldSnapshot* base,btDynamicsWorldSnapshot& snapshot);
+
+	bool	readSnapshot(const btDynamicsWorldSnapshot* base,const btDynamicsWorldSnapshot& snapshot);
+
 	virtual void	predictUnconstraintMotion(btScalar timeStep);
 	
 	virtual void	integrateTransforms(btScalar timeStep);
@@ -68,7 +111,7 @@ protected:
 
 	virtual void	solveConstraints(btContactSolverInfo& solverInfo);
 	
-	void	updateActivationState(btScalar timeStep);
+	virtual void	updateActivationState(btScalar timeStep);
 
 	void	updateActions(btScalar timeStep);
 
@@ -92,6 +135,46 @@ public:
 	///if maxSubSteps > 0, it will interpolate motion between fixedTimeStep's
 	virtual int	stepSimulation( btScalar timeStep,int maxSubSteps=1, btScalar fixedTimeStep=btScalar(1.)/btScalar(60.));
 
+	///steps like stepSimulation, but instead of a fixed maxSubSteps it runs as many substeps as fit in timeBudget seconds of wall clock time,
+	///estimated from the measured average cost of the previous substeps before stepping. One substep always runs when one is due.
+	///Substeps that don't fit are not dropped: they are kept as time debt, and caught up by later calls that have budget left.
+	///The debt is limited to maxTimeDebt seconds: at most maxTimeDebt/fixedTimeStep+1 substeps are due in a call, due time beyond it
+	///is dropped and added to getDroppedTime. Until a substep has been timed, one substep runs per call.
+	///Returns the number of substeps that ran. When the library is built with BT_NO_PROFILE there is no clock, and all due substeps
+	///within that limit run.
+	int		stepSimulationWithBudget(btScalar timeStep,btScalar timeBudget,btScalar fixedTimeStep=btScalar(1.)/btScalar(60.),btScalar maxTimeDebt=btScalar(0.25));
+
+	///simulation time that was due but not simulated yet by stepSimulationWithBudget, a multiple of the fixed time step.
+	///A growing debt means the simulation can't keep up with real time, and load should be shed.
+	btScalar	getTimeDebt() const
+	{
+		return m_timeDebt;
+	}
+
+	///total simulation time that stepSimulationWithBudget dropped, because the time debt exceeded maxTimeDebt
+	btScalar	getDroppedTime() const
+	{
+		return m_droppedTime;
+	}
+
+	///average wall clock time of a substep in seconds, measured by stepSimulationWithBudget
+	btScalar	getAverageSubStepTime() const
+	{
+		return m_averageSubStepTime;
+	}
+
+	int		getLastNumSubSteps() const
+	{
+		return m_lastNumSubSteps;
+	}
+
+	///fraction of a fixed time step that the motion states are interpolated beyond the last substep, in [0,1).
+	///Renderers that interpolate transforms themselves can blend the previous and the current transforms with it.
+	btScalar	getInterpolationAlpha() const
+	{
+		return m_fixedTimeStep > btScalar(0.) ? btMin(m_localTime / m_fixedTimeStep,btScalar(1.)) : btScalar(0.);
+	}
+
 
 	virtual void	synchronizeMotionStates();
 
@@ -136,6 +219,17 @@ public:
 	///removeCollisionObject will first check if it is a rigid body, if so call removeRigidBody otherwise call btCollisionWorld::removeCollisionObject
 	virtual void	removeCollisionObject(btCollisionObject* collisionObject);
 
+	///adds numBodies rigid bodies at once, with the same filters as addRigidBody. The broadphase builds its structures for the whole set in one pass.
+	void	addRigidBodies(btRigidBody* const* bodies,int numBodies);
+
+	void	addRigidBodies(btRigidBody* const* bodies,int numBodies,short group,short mask);
+
+	///removes numBodies rigid bodies at once, see btCollisionWorld::removeCollisionObjects
+	void	removeRigidBodies(btRigidBody* const* bodies,int numBodies);
+
+	///removes the rigid bodies among the objects like removeRigidBody, and the other objects like btCollisionWorld::removeCollisionObject, all in one batch
+	virtual void	removeCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects);
+
 
 	void	debugDrawConstraint(btTypedConstraint* constraint);
 
@@ -192,6 +286,73 @@ public:
 		return m_synchronizeAllMotionStates;
 	}
 
+	///sets the update interval and solver iterations of a level of detail, see btRigidBody::setLodLevel. Levels that are not set step every substep
+	///with the default iterations, bodies with a level beyond the last one use the last one. A body that skips substeps is stepped with the time
+	///it skipped in its next step, and its motion state is extrapolated in the meantime. The bodies of a simulation island are stepped together,
+	///with the finest level among them and the longest time step among them, so they are solved and integrated with the same time step and
+	///don't push into each other. The intervals are powers of two and the levels step in different substeps,
+	///level n every 2^n substeps that are 2^(n-1) modulo 2^n, to spread the load. Pairs of bodies that don't move in a substep skip the narrowphase.
+	///The solver only skips islands when islands are split (btSimulationIslandManager::setSplitIslands), derived worlds with their own solver
+	///callback solve all islands. The time a body skipped is not stored in snapshots.
+	void	setLodLevel(int level,int updateInterval,int numIterations = 0);
+
+	const btRigidBodyLodLevel&	getLodLevel(int level) const
+	{
+		return m_lodLevels[level];
+	}
+
+	int		getNumLodLevels() const
+	{
+		return m_lodLevels.size();
+	}
+
+	///removes the levels of detail, all bodies step every substep again
+	void	clearLodLevels();
+
+	///In deterministic mode a step only depends on the state of the world and the order in which objects and constraints were added,
+	///not on pointer values, allocation order or how the broadphase and manifold pools got to their current state. Two runs of the same
+	///binary that add the same objects and step with the same time steps produce bit identical results, also after restoreSnapshot.
+	///It sets btDispatcherInfo::m_deterministicOrder and SOLVER_DETERMINISTIC: the overlapping pairs and the contact manifolds are sorted
+	///by broadphase uid, islands are rebuilt every step instead of incrementally, the solver restarts its random order for each group
+	///and constraint rows are not cached. The parallel parts of the step (btParallelFor) write disjoint data, so they keep the result
+	///independent of the task scheduler.
+	void	setDeterministic(bool deterministic);
+
+	bool	isDeterministic() const
+	{
+		return getDispatchInfo().m_deterministicOrder;
+	}
+
+	///also moves the motion states of kinematic bodies, through btMotionState::setWorldTransform, and synchronizes the other motion states.
+	///Snapshots store the world origin, restoring a snapshot taken before a shift moves the world back to that origin.
+	virtual void	shiftOrigin(const btVector3& shift);
+
+	///saveSnapshot stores the mutable simulation state: the transforms, velocities and activation of the collision objects, the contact points
+	///including their warm starting impulses and the applied impulse and enabled state of the constraints, see btDynamicsWorldSnapshot.
+	///Take snapshots between steps, the forces are cleared by stepSimulation and are not stored. Actions (vehicles, characters) and soft body
+	///nodes are not stored, and with SOLVER_RANDMIZE_ORDER the btSequentialImpulseConstraintSolver seed has to be saved separately, unless the world is deterministic.
+	void	saveSnapshot(btDynamicsWorldSnapshot& snapshot);
+
+	///stores only the collision objects and constraints whose state differs from base, which has to be a full snapshot of this world.
+	///The contact points are always stored completely. Returns false when base isn't a full snapshot of this world, delta is a full snapshot then.
+	bool	saveDeltaSnapshot(const btDynamicsWorldSnapshot& base,btDynamicsWorldSnapshot& delta);
+
+	///returns false, without changing the world, when the snapshot doesn't match the amount of collision objects and constraints,
+	///was written by another format version (BT_DYNAMICS_WORLD_SNAPSHOT_VERSION), is truncated or has contacts of objects that aren't in the world,
+	///like objects that were removed since the snapshot was taken.
+	///The contacts present before the restore are released through gContactDestroyedCallback, the restored contacts carry no user data.
+	///The collision detection pass of deterministic mode doesn't call gContactAddedCallback, gContactProcessedCallback or gContactDestroyedCallback:
+	///it suspends these globals, so don't restore a snapshot while other worlds step on other threads (see btDynamicsWorldHost).
+	///Contact manifolds that were destroyed since the snapshot was taken are not recreated, the narrowphase adds their points again.
+	///The broadphase pairs are not stored either, when overlaps began or ended since the snapshot the contacts can be solved in a
+	///different order, so a re-simulated pile of objects can differ slightly from the first run. In deterministic mode (see setDeterministic)
+	///the restore runs the collision detection once to recreate the pairs and manifolds first, and a re-simulation reproduces the first run.
+	///Manifolds are matched by their objects and compound child indices, so this also holds for compound shapes.
+	bool	restoreSnapshot(const btDynamicsWorldSnapshot& snapshot);
+
+	///restores the state of base, updated with the delta created by saveDeltaSnapshot
+	bool	restoreDeltaSnapshot(const btDynamicsWorldSnapshot& base,const btDynamicsWorldSnapshot& delta);
+
 	///Preliminary serialization test for Bullet 2.76. Loading those files requires a separate parser (see Bullet/Demos/SerializeDemo)
 	virtual	void	serialize(btSerializer* serializer);
 
@@ -0,0 +1,239 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btDynamicsWorldHost.h"
+#include "btDiscreteDynamicsWorld.h"
+#include "BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
+#include "BulletCollision/CollisionShapes/btCollisionShape.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "LinearMath/btPoolAllocator.h"
+#include "LinearMath/btThreads.h"
+#include "LinearMath/btMinMax.h"
+
+#include <string.h>
+#include <new>
+
+///weight of the last step in the average step times
+#define BT_HOSTED_WORLD_AVERAGE_WEIGHT btScalar(0.1)
+
+
+btDynamicsWorldHost::btDynamicsWorldHost(int poolSize)
+	:m_poolSize(btMax(poolSize,1))
+{
+}
+
+btDynamicsWorldHost::~btDynamicsWorldHost()
+{
+	while (m_worlds.size())
+	{
+		destroyWorld(m_worlds.size()-1);
+	}
+	for (int i=0;i<m_sharedShapes.size();i++)
+	{
+		btAlignedFree(m_sharedShapes[i].m_name);
+		delete m_sharedShapes[i].m_shape;
+	}
+}
+
+void	btDynamicsWorldHost::addSharedShape(const char* name,btCollisionShape* shape)
+{
+	btAssert(shape && shape->getShapeType() != GIMPACT_SHAPE_PROXYTYPE);
+	btAssert(!findSharedShape(name));
+	int length = int(strlen(name));
+	btSharedShape sharedShape;
+	sharedShape.m_name = (char*)btAlignedAlloc(length+1,16);
+	memcpy(sharedShape.m_name,name,length+1);
+	sharedShape.m_shape = shape;
+	m_sharedShapes.push_back(sharedShape);
+}
+
+btCollisionShape*	btDynamicsWorldHost::findSharedShape(const char* name) const
+{
+	for (int i=0;i<m_sharedShapes.size();i++)
+	{
+		if (!strcmp(m_sharedShapes[i].m_name,name))
+		{
+			return m_sharedShapes[i].m_shape;
+		}
+	}
+	return 0;
+}
+
+int		btDynamicsWorldHost::createWorld()
+{
+	void* mem = btAlignedAlloc(sizeof(btHostedWorld),16);
+	btHostedWorld* world = new (mem) btHostedWorld();
+
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_defaultMaxPersistentManifoldPoolSize = m_poolSize;
+	constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = m_poolSize;
+	constructionInfo.m_useGrowablePools = true;
+
+	///each world needs its own collision configuration, the collision algorithms share its simplex and penetration depth solvers
+	world->m_collisionConfiguration = new btDefaultCollisionConfiguration(constructionInfo);
+	world->m_dispatcher = new btCollisionDispatcher(world->m_collisionConfiguration);
+	world->m_broadphase = new btDbvtBroadphase();
+	world->m_solver = new btSequentialImpulseConstraintSolver();
+	world->m_dynamicsWorld = new btDiscreteDynamicsWorld(world->m_dispatcher,world->m_broadphase,world->m_solver,world->m_collisionConfiguration);
+	world->m_timeBudget = btScalar(0.);
+	memset(&world->m_stats,0,sizeof(btHostedWorldStats));
+
+	m_worlds.push_back(world);
+	return m_worlds.size()-1;
+}
+
+void	btDynamicsWorldHost::destroyWorld(int index)
+{
+	btHostedWorld* world = m_worlds[index];
+	delete world->m_dynamicsWorld;
+	delete world->m_solver;
+	delete world->m_broadphase;
+	delete world->m_dispatcher;
+	delete world->m_collisionConfiguration;
+	world->~btHostedWorld();
+	btAlignedFree(world);
+
+	m_worlds[index] = m_worlds[m_worlds.size()-1];
+	m_worlds.pop_back();
+}
+
+void	btDynamicsWorldHost::stepWorld(int index,btScalar timeStep,int maxSubSteps,btScalar fixedTimeStep)
+{
+	btHostedWorld& world = *m_worlds[index];
+	btHostedWorldStats& stats = world.m_stats;
+
+	int numSubSteps = maxSubSteps;
+	if (maxSubSteps && world.m_timeBudget > btScalar(0.) && stats.m_averageSubStepTime > btScalar(0.))
+	{
+		numSubSteps = btMin(btMax(int(world.m_timeBudget / stats.m_averageSubStepTime),1),maxSubSteps);
+	}
+
+#ifdef USE_BT_CLOCK
+	world.m_clock.reset();
+#endif //USE_BT_CLOCK
+
+	///stepSimulation returns the number of substeps that were due, before clamping them to numSubSteps
+	int numSimulationSubSteps = world.m_dynamicsWorld->stepSimulation(timeStep,numSubSteps,fixedTimeStep);
+	if (numSubSteps)
+	{
+		if (numSubSteps < btMin(numSimulationSubSteps,maxSubSteps))
+		{
+			stats.m_numBudgetLimitedSteps++;
+		}
+		numSimulationSubSteps = btMin(numSimulationSubSteps,numSubSteps);
+	}
+
+	stats.m_lastNumSubSteps = numSimulationSubSteps;
+#ifdef USE_BT_CLOCK
+	stats.m_lastStepTime = btScalar(world.m_clock.getTimeMicroseconds()) * btScalar(1e-6);
+#else
+	stats.m_lastStepTime = btScalar(0.);
+#endif //USE_BT_CLOCK
+	stats.m_averageStepTime += (stats.m_lastStepTime - stats.m_averageStepTime) * BT_HOSTED_WORLD_AVERAGE_WEIGHT;
+	if (numSimulationSubSteps)
+	{
+		btScalar subStepTime = stats.m_lastStepTime / btScalar(numSimulationSubSteps);
+		if (stats.m_averageSubStepTime > btScalar(0.))
+		{
+			stats.m_averageSubStepTime += (subStepTime - stats.m_averageSubStepTime) * BT_HOSTED_WORLD_AVERAGE_WEIGHT;
+		} else
+		{
+			stats.m_averageSubStepTime = subStepTime;
+		}
+	}
+	stats.m_poolBytes = world.m_collisionConfiguration->getPersistentManifoldPool()->getCapacityInBytes() +
+		world.m_collisionConfiguration->getCollisionAlgorithmPool()->getCapacityInBytes();
+}
+
+
+struct	btStepWorldsLoop : public btIParallelForBody
+{
+	btDynamicsWorldHost*	m_host;
+	const int*				m_order;
+	btScalar				m_timeStep;
+	int						m_maxSubSteps;
+	btScalar				m_fixedTimeStep;
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			m_host->stepWorld(m_order[i],m_timeStep,m_maxSubSteps,m_fixedTimeStep);
+		}
+	}
+};
+
+struct	btHostedWorldCostSortPredicate
+{
+	const btHostedWorldStats* const*	m_stats;
+
+	bool	operator() (int lhs,int rhs) const
+	{
+		btScalar lhsCost = m_stats[lhs]->m_averageStepTime;
+		btScalar rhsCost = m_stats[rhs]->m_averageStepTime;
+		return lhsCost > rhsCost || (lhsCost == rhsCost && lhs < rhs);
+	}
+};
+
+void	btDynamicsWorldHost::stepWorlds(btScalar timeStep,int maxSubSteps,btScalar fixedTimeStep)
+{
+	int numWorlds = m_worlds.size();
+	if (!numWorlds)
+		return;
+
+	///the most expensive worlds start first, so the cheap ones fill up the threads at the end
+	btAlignedObjectArray<const btHostedWorldStats*> stats;
+	stats.resize(numWorlds);
+	m_stepOrder.resize(numWorlds);
+	for (int i=0;i<numWorlds;i++)
+	{
+		stats[i] = &m_worlds[i]->m_stats;
+		m_stepOrder[i] = i;
+	}
+	btHostedWorldCostSortPredicate predicate;
+	predicate.m_stats = &stats[0];
+	m_stepOrder.quickSort(predicate);
+
+	btStepWorldsLoop loop;
+	loop.m_host = this;
+	loop.m_order = &m_stepOrder[0];
+	loop.m_timeStep = timeStep;
+	loop.m_maxSubSteps = maxSubSteps;
+	loop.m_fixedTimeStep = fixedTimeStep;
+
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	if (numWorlds == 1 || scheduler == btGetSequentialTaskScheduler())
+	{
+		///the worlds can use the task scheduler themselves
+		loop.forLoop(0,numWorlds);
+		return;
+	}
+
+	///the task scheduler can't be called recursively, so the worlds run their btParallelFor loops on their own thread
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+#ifndef BT_NO_PROFILE
+	bool profile = CProfileManager::Is_Enabled();
+	CProfileManager::Set_Enabled(false);
+#endif //BT_NO_PROFILE
+
+	scheduler->parallelFor(0,numWorlds,1,loop);
+
+#ifndef BT_NO_PROFILE
+	CProfileManager::Set_Enabled(profile);
+#endif //BT_NO_PROFILE
+	btSetTaskScheduler(scheduler);
+}
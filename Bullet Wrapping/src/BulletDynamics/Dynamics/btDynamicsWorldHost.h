@@ -0,0 +1,152 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_DYNAMICS_WORLD_HOST_H
+#define BT_DYNAMICS_WORLD_HOST_H
+
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btQuickprof.h"
+
+class btCollisionShape;
+class btDefaultCollisionConfiguration;
+class btCollisionDispatcher;
+class btBroadphaseInterface;
+class btConstraintSolver;
+class btDiscreteDynamicsWorld;
+
+///step cost of a hosted world, in seconds. The times are 0 when the library is built with BT_NO_PROFILE.
+struct	btHostedWorldStats
+{
+	btScalar	m_lastStepTime;
+	btScalar	m_averageStepTime;
+	btScalar	m_averageSubStepTime;
+	int			m_lastNumSubSteps;
+	///number of stepWorlds calls that ran fewer substeps than requested, to stay within the time budget
+	int			m_numBudgetLimitedSteps;
+	///bytes held by the manifold and algorithm pools of the world
+	int			m_poolBytes;
+};
+
+///btDynamicsWorldHost runs many small independent btDiscreteDynamicsWorld in one process, for example one per match on a game server.
+///Each world gets its own collision configuration, with small pools that grow on demand, instead of the 4096 element default pools.
+///Collision shapes are not modified by the simulation, so a shape can be used by bodies in several worlds, also while the worlds are stepped
+///on different threads. The host keeps a registry of such shared shapes, for example a btBvhTriangleMeshShape of a level or a btConvexHullShape.
+///GIMPACT shapes lock their mesh during collision detection and can't be shared.
+///stepWorlds steps all worlds with btParallelFor, one world per task. Each world can have a time budget, that limits its number of substeps.
+///When the worlds are stepped in parallel:
+///- each world has its own dispatcher, pools, broadphase and solver, and the solver has its own fixed body for the rows against static objects
+///  and btTypedConstraint::getFixedBody. The shared fixed bodies of btTypedConstraint and btActionInterface are only read.
+///- the global statistics counters (gNumManifold, gOverlappingPairs, gAddedPairs, gRemovePairs, gFindPairs, gNumGjkChecks,
+///  gNumDeepPenetrationChecks, gNumSplitImpulseRecoveries and the others) are updated with btAtomicAdd, read them between stepWorlds calls.
+///- gContactAddedCallback, gContactProcessedCallback, gContactDestroyedCallback and the near callbacks of the dispatchers are called
+///  on the stepping threads, concurrently for different worlds, so they have to be thread safe. Don't change these globals while stepping.
+///- don't add or remove objects or constraints, restore snapshots (restoreSnapshot suspends the contact callbacks) or set a debug drawer
+///  (it writes gDisableDeactivation) while stepWorlds runs. gContactBreakingThreshold and gDeactivationTime are only read.
+class	btDynamicsWorldHost
+{
+protected:
+
+	struct	btSharedShape
+	{
+		char*				m_name;
+		btCollisionShape*	m_shape;
+	};
+
+	struct	btHostedWorld
+	{
+		btDefaultCollisionConfiguration*	m_collisionConfiguration;
+		btCollisionDispatcher*				m_dispatcher;
+		btBroadphaseInterface*				m_broadphase;
+		btConstraintSolver*					m_solver;
+		btDiscreteDynamicsWorld*			m_dynamicsWorld;
+		btScalar							m_timeBudget;
+		btHostedWorldStats					m_stats;
+#ifdef USE_BT_CLOCK
+		btClock								m_clock;
+#endif //USE_BT_CLOCK
+	};
+
+	btAlignedObjectArray<btSharedShape>		m_sharedShapes;
+	btAlignedObjectArray<btHostedWorld*>	m_worlds;
+	btAlignedObjectArray<int>				m_stepOrder;
+	int										m_poolSize;
+
+public:
+
+	///poolSize is the initial number of elements of the manifold and algorithm pools of each world
+	btDynamicsWorldHost(int poolSize = 64);
+
+	///deletes all worlds and shared shapes. The rigid bodies and constraints that were added to the worlds are not deleted.
+	virtual ~btDynamicsWorldHost();
+
+	///the host takes ownership of the shape, it is deleted with the host. The name is copied, and has to be unique.
+	void	addSharedShape(const char* name,btCollisionShape* shape);
+
+	///returns 0 when there is no shared shape with that name
+	btCollisionShape*	findSharedShape(const char* name) const;
+
+	int		getNumSharedShapes() const
+	{
+		return m_sharedShapes.size();
+	}
+
+	btCollisionShape*	getSharedShape(int index) const
+	{
+		return m_sharedShapes[index].m_shape;
+	}
+
+	///creates a world with its own dispatcher, broadphase and solver, and returns its index
+	int		createWorld();
+
+	///destroys the world at index, and moves the last world to index. Remove and delete its bodies first.
+	void	destroyWorld(int index);
+
+	int		getNumWorlds() const
+	{
+		return m_worlds.size();
+	}
+
+	btDiscreteDynamicsWorld*	getWorld(int index)
+	{
+		return m_worlds[index]->m_dynamicsWorld;
+	}
+
+	///limits the time spent in stepWorlds on this world, in seconds. When the average substep time times the substeps exceeds the budget,
+	///fewer substeps are run and the world falls behind real time, like stepSimulation does when maxSubSteps is exceeded. 0 means no limit.
+	void	setWorldTimeBudget(int index,btScalar budget)
+	{
+		m_worlds[index]->m_timeBudget = budget;
+	}
+
+	btScalar	getWorldTimeBudget(int index) const
+	{
+		return m_worlds[index]->m_timeBudget;
+	}
+
+	const btHostedWorldStats&	getWorldStats(int index) const
+	{
+		return m_worlds[index]->m_stats;
+	}
+
+	///calls stepSimulation on one world and updates its stats
+	void	stepWorld(int index,btScalar timeStep,int maxSubSteps = 1,btScalar fixedTimeStep = btScalar(1.)/btScalar(60.));
+
+	///steps all worlds, the most expensive ones first. When there is more than one world and a parallel task scheduler is set,
+	///the worlds are stepped in parallel and each world runs its own btParallelFor loops sequentially, with the profiler disabled.
+	void	stepWorlds(btScalar timeStep,int maxSubSteps = 1,btScalar fixedTimeStep = btScalar(1.)/btScalar(60.));
+};
+
+#endif //BT_DYNAMICS_WORLD_HOST_H
@@ -0,0 +1,150 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_DYNAMICS_WORLD_SNAPSHOT_H
+#define BT_DYNAMICS_WORLD_SNAPSHOT_H
+
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "BulletCollision/NarrowPhaseCollision/btManifoldPoint.h"
+
+///bumped whenever the layout of the snapshot records or of btManifoldPoint changes, older snapshots are rejected by restoreSnapshot
+#define BT_DYNAMICS_WORLD_SNAPSHOT_VERSION 2
+
+///btDynamicsWorldSnapshot holds the mutable simulation state of a btDiscreteDynamicsWorld in a flat buffer,
+///see btDiscreteDynamicsWorld::saveSnapshot. The buffer keeps its capacity, so saving into the same snapshot again doesn't allocate.
+///Collision objects and constraints are identified by their index in the world and contact manifolds by the pointers to their objects,
+///so a snapshot can only be restored into the world it was taken from, holding the same collision objects and constraints.
+///The records are plain data, the contact points are stored as btManifoldPoint, so the header keeps the format version and sizeof(btManifoldPoint).
+class btDynamicsWorldSnapshot
+{
+public:
+
+	struct	btHeader
+	{
+		int			m_version;
+		int			m_sizeofManifoldPoint;
+		int			m_numCollisionObjects;
+		int			m_numConstraints;
+		int			m_numObjectRecords;
+		int			m_numConstraintRecords;
+		int			m_numManifolds;
+		int			m_isDelta;
+		btVector3Data	m_worldOrigin;
+		btScalar	m_localTime;
+		btScalar	m_timeDebt;
+	};
+
+	///the state of a collision object, the velocities are only used for rigid bodies
+	struct	btObjectRecord
+	{
+		btTransformData	m_worldTransform;
+		btTransformData	m_interpolationWorldTransform;
+		btVector3Data	m_interpolationLinearVelocity;
+		btVector3Data	m_interpolationAngularVelocity;
+		btVector3Data	m_linearVelocity;
+		btVector3Data	m_angularVelocity;
+		btScalar	m_deactivationTime;
+		btScalar	m_hitFraction;
+		int			m_activationState;
+		int			m_index;
+	};
+
+	struct	btConstraintRecord
+	{
+		btScalar	m_appliedImpulse;
+		int			m_isEnabled;
+		int			m_index;
+	};
+
+	///followed by m_numContacts btManifoldPoint
+	///the objects and the compound child indices (btPersistentManifold::m_childIndex0/1) identify the manifold
+	struct	btManifoldRecord
+	{
+		const void*	m_body0;
+		const void*	m_body1;
+		int			m_childIndex0;
+		int			m_childIndex1;
+		int			m_numContacts;
+	};
+
+	///returns true when the buffer holds a snapshot header of the current format
+	bool	hasValidHeader() const
+	{
+		if (m_size < int(sizeof(btHeader)))
+			return false;
+		const btHeader& header = getHeader();
+		return header.m_version == BT_DYNAMICS_WORLD_SNAPSHOT_VERSION && header.m_sizeofManifoldPoint == int(sizeof(btManifoldPoint));
+	}
+
+private:
+
+	btAlignedObjectArray<unsigned char>	m_buffer;
+	int		m_size;
+
+public:
+
+	btDynamicsWorldSnapshot()
+		:m_size(0)
+	{
+	}
+
+	void	clear()
+	{
+		m_size = 0;
+	}
+
+	///size in bytes of the snapshot data
+	int		getSize() const
+	{
+		return m_size;
+	}
+
+	const unsigned char*	getBuffer() const
+	{
+		return m_size ? &m_buffer[0] : 0;
+	}
+
+	bool	isDelta() const
+	{
+		return m_size >= int(sizeof(btHeader)) && getHeader().m_isDelta != 0;
+	}
+
+	const btHeader&	getHeader() const
+	{
+		btAssert(m_size >= int(sizeof(btHeader)));
+		return *(const btHeader*)&m_buffer[0];
+	}
+
+	///internal method used by btDiscreteDynamicsWorld, makes room for size bytes and returns the start of the buffer
+	unsigned char*	internalAllocate(int size)
+	{
+		if (m_buffer.size() < size)
+		{
+			m_buffer.resize(size);
+		}
+		m_size = size;
+		return &m_buffer[0];
+	}
+
+	///internal method used by btDiscreteDynamicsWorld, shrinks the used size after a delta snapshot was written
+	void	internalSetSize(int size)
+	{
+		btAssert(size <= m_buffer.size());
+		m_size = size;
+	}
+};
+
+#endif //BT_DYNAMICS_WORLD_SNAPSHOT_H
@@ -88,6 +88,10 @@ void	btRigidBody::setupRigidBody(const btRigidBody::btRigidBodyConstructionInfo&
 
 	m_rigidbodyFlags = 0;
 
+	m_lodLevel = 0;
+	m_lodElapsedTime = btScalar(0.);
+	m_lodTimeStep = btScalar(0.);
+
 
 	m_deltaLinearVelocity.setZero();
 	m_deltaAngularVelocity.setZero();
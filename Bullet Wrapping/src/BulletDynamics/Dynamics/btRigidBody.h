@@ -89,6 +89,13 @@ class btRigidBody  : public btCollisionObject
 	int				m_rigidbodyFlags;
 	
 	int				m_debugBodyId;
+
+	///level of detail, see btDiscreteDynamicsWorld::setLodLevel
+	int				m_lodLevel;
+	///simulation time since the body was last stepped, when its level of detail skips substeps
+	btScalar		m_lodElapsedTime;
+	///time step of the body in the current substep, 0 when the body is skipped
+	btScalar		m_lodTimeStep;
 	
 
 protected:
@@ -519,6 +526,50 @@ public:
 		return m_rigidbodyFlags;
 	}
 
+	///the body is stepped with the update interval and solver iterations of this level of the btDiscreteDynamicsWorld, see btDiscreteDynamicsWorld::setLodLevel.
+	///Levels can change at any time, the body keeps the time it skipped and catches it up in its next step.
+	void	setLodLevel(int level)
+	{
+		m_lodLevel = level;
+	}
+
+	int		getLodLevel() const
+	{
+		return m_lodLevel;
+	}
+
+	btScalar	getLodElapsedTime() const
+	{
+		return m_lodElapsedTime;
+	}
+
+	btScalar	getLodTimeStep() const
+	{
+		return m_lodTimeStep;
+	}
+
+	///called by btDiscreteDynamicsWorld at the start of each substep. A stepped body integrates the time it skipped along with this substep.
+	void	updateLodTime(btScalar timeStep,bool stepped)
+	{
+		if (stepped)
+		{
+			m_lodTimeStep = m_lodElapsedTime + timeStep;
+			m_lodElapsedTime = btScalar(0.);
+		} else
+		{
+			m_lodTimeStep = btScalar(0.);
+			m_lodElapsedTime += timeStep;
+		}
+	}
+
+	///called by btDiscreteDynamicsWorld to step the body with the time step of its island. The difference is kept in the elapsed time,
+	///a body stepped ahead of the world has a negative elapsed time and skips substeps until the world catches up.
+	void	setLodTimeStep(btScalar timeStep)
+	{
+		m_lodElapsedTime += m_lodTimeStep - timeStep;
+		m_lodTimeStep = timeStep;
+	}
+
 	const btVector3& getDeltaLinearVelocity() const
 	{
 		return m_deltaLinearVelocity;
@@ -0,0 +1,318 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btSimulationLodManager.h"
+#include "btDiscreteDynamicsWorld.h"
+#include "btRigidBody.h"
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "LinearMath/btQuickprof.h"
+
+
+btSimulationLodManager::btSimulationLodManager(btDiscreteDynamicsWorld* world)
+	:m_world(world),
+	m_updateBudget(btScalar(0.)),
+	m_hysteresis(btScalar(0.1)),
+	m_updateCost(btScalar(0.))
+{
+}
+
+btSimulationLodManager::~btSimulationLodManager()
+{
+	btCollisionObjectArray& objects = m_world->getCollisionObjectArray();
+	for (int i=0;i<objects.size();i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(objects[i]);
+		if (body && m_bodyIndices.find(body))
+		{
+			removeBody(body);
+		}
+	}
+	for (int i=0;i<m_ownedProxyShapes.size();i++)
+	{
+		delete m_ownedProxyShapes[i];
+	}
+	m_world->clearLodLevels();
+}
+
+int		btSimulationLodManager::addLevel(const btSimulationLodLevelInfo& info)
+{
+	btAssert(!m_levels.size() || info.m_distance >= m_levels[m_levels.size()-1].m_distance);
+	m_levels.push_back(info);
+	int level = m_levels.size()-1;
+	m_world->setLodLevel(level,info.m_updateInterval,info.m_numIterations);
+	///the world rounds the interval up to a power of two
+	m_levels[level].m_updateInterval = m_world->getLodLevel(level).m_updateInterval;
+	return level;
+}
+
+int		btSimulationLodManager::findOrAddBody(btRigidBody* body)
+{
+	const int* indexPtr = m_bodyIndices.find(body);
+	if (indexPtr)
+	{
+		btLodBody& lodBody = m_bodies[*indexPtr];
+		if (lodBody.m_proxyShape != body->getCollisionShape())
+		{
+			///the shape was set by the user, or the body was deleted and a new one was created at its address
+			lodBody.m_fullShape = body->getCollisionShape();
+			lodBody.m_proxyShape = 0;
+			lodBody.m_proxyShapeType = BT_LOD_PROXY_NONE;
+		}
+		return *indexPtr;
+	}
+
+	btLodBody lodBody;
+	lodBody.m_body = body;
+	lodBody.m_fullShape = body->getCollisionShape();
+	lodBody.m_proxyShape = 0;
+	lodBody.m_proxyShapeType = BT_LOD_PROXY_NONE;
+	lodBody.m_seen = 0;
+	m_bodies.push_back(lodBody);
+	m_bodyIndices.insert(body,m_bodies.size()-1);
+	return m_bodies.size()-1;
+}
+
+void	btSimulationLodManager::removeBodyAt(int index)
+{
+	m_bodyIndices.remove(m_bodies[index].m_body);
+	int lastIndex = m_bodies.size()-1;
+	if (index != lastIndex)
+	{
+		m_bodies[index] = m_bodies[lastIndex];
+		m_bodyIndices.insert(m_bodies[index].m_body,index);
+	}
+	m_bodies.pop_back();
+}
+
+int		btSimulationLodManager::calculateLevel(btScalar distance2,int currentLevel) const
+{
+	btScalar coarser = (btScalar(1.) + m_hysteresis) * (btScalar(1.) + m_hysteresis);
+	int level = 0;
+	for (int i=1;i<m_levels.size();i++)
+	{
+		btScalar levelDistance2 = m_levels[i].m_distance * m_levels[i].m_distance;
+		if (i > currentLevel)
+		{
+			levelDistance2 *= coarser;
+		}
+		if (distance2 >= levelDistance2)
+		{
+			level = i;
+		}
+	}
+	return level;
+}
+
+btCollisionShape*	btSimulationLodManager::getProxyShape(btCollisionShape* fullShape,int proxyShapeType)
+{
+	if (proxyShapeType == BT_LOD_PROXY_NONE || !fullShape || fullShape->isConcave())
+		return 0;
+	int shapeType = fullShape->getShapeType();
+	if (shapeType == SPHERE_SHAPE_PROXYTYPE || (shapeType == BOX_SHAPE_PROXYTYPE && proxyShapeType == BT_LOD_PROXY_BOX))
+		return 0;
+
+	btHashMap<btHashPtr,btCollisionShape*>& proxyShapes = proxyShapeType == BT_LOD_PROXY_BOX ? m_boxProxyShapes : m_sphereProxyShapes;
+	btCollisionShape** proxyShapePtr = proxyShapes.find(fullShape);
+	if (proxyShapePtr)
+		return *proxyShapePtr;
+
+	btCollisionShape* proxyShape;
+	if (proxyShapeType == BT_LOD_PROXY_BOX)
+	{
+		///the box is centered at the center of mass, so it covers an off-center bounding box
+		btTransform identity;
+		identity.setIdentity();
+		btVector3 aabbMin,aabbMax;
+		fullShape->getAabb(identity,aabbMin,aabbMax);
+		btVector3 halfExtents = aabbMax;
+		halfExtents.setMax(-aabbMin);
+		proxyShape = new btBoxShape(halfExtents);
+	} else
+	{
+		btVector3 center;
+		btScalar radius;
+		fullShape->getBoundingSphere(center,radius);
+		proxyShape = new btSphereShape(radius + center.length());
+	}
+	proxyShape->setUserPointer(fullShape->getUserPointer());
+	m_ownedProxyShapes.push_back(proxyShape);
+	proxyShapes.insert(fullShape,proxyShape);
+	return proxyShape;
+}
+
+void	btSimulationLodManager::setProxyShapeType(btLodBody& lodBody,int proxyShapeType)
+{
+	btCollisionShape* proxyShape = getProxyShape(lodBody.m_fullShape,proxyShapeType);
+	lodBody.m_proxyShapeType = proxyShapeType;
+	if (proxyShape == lodBody.m_proxyShape)
+		return;
+
+	btRigidBody* body = lodBody.m_body;
+	body->setCollisionShape(proxyShape ? proxyShape : lodBody.m_fullShape);
+	lodBody.m_proxyShape = proxyShape;
+
+	///the collision algorithms of the pairs depend on the shape types, the mass and inertia of the body are kept
+	if (body->getBroadphaseHandle())
+	{
+		m_world->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(body->getBroadphaseHandle(),m_world->getDispatcher());
+		m_world->updateSingleAabb(body);
+	}
+}
+
+struct	btLodCandidateSortPredicate
+{
+	template <class T>
+	bool	operator() (const T& lhs,const T& rhs) const
+	{
+		return lhs.m_distance2 < rhs.m_distance2 || (lhs.m_distance2 == rhs.m_distance2 && lhs.m_bodyIndex < rhs.m_bodyIndex);
+	}
+};
+
+void	btSimulationLodManager::updateLevels()
+{
+	BT_PROFILE("updateLodLevels");
+
+	int numLevels = m_levels.size();
+	if (!numLevels)
+		return;
+
+	int i;
+	for (i=0;i<m_bodies.size();i++)
+	{
+		m_bodies[i].m_seen = 0;
+	}
+
+	///find the level of each body by its distance, sleeping bodies don't count for the budget
+	m_numBodiesAtLevel.resize(0);
+	m_numBodiesAtLevel.resize(numLevels,0);
+	m_candidates.resize(0);
+	m_updateCost = btScalar(0.);
+	btCollisionObjectArray& objects = m_world->getCollisionObjectArray();
+	for (i=0;i<objects.size();i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(objects[i]);
+		if (!body || body->isStaticOrKinematicObject())
+			continue;
+
+		int bodyIndex = findOrAddBody(body);
+		m_bodies[bodyIndex].m_seen = 1;
+
+		btScalar distance2 = btScalar(0.);
+		const btVector3& position = body->getWorldTransform().getOrigin();
+		for (int j=0;j<m_observers.size();j++)
+		{
+			btScalar observerDistance2 = (position - m_observers[j]).length2();
+			if (!j || observerDistance2 < distance2)
+			{
+				distance2 = observerDistance2;
+			}
+		}
+
+		int currentLevel = btMin(btMax(body->getLodLevel(),0),numLevels-1);
+		int level = calculateLevel(distance2,currentLevel);
+		if (body->isActive())
+		{
+			btLodCandidate candidate;
+			candidate.m_distance2 = distance2;
+			candidate.m_bodyIndex = bodyIndex;
+			candidate.m_level = level;
+			m_candidates.push_back(candidate);
+		} else
+		{
+			body->setLodLevel(level);
+			setProxyShapeType(m_bodies[bodyIndex],m_levels[level].m_proxyShapeType);
+			m_numBodiesAtLevel[level]++;
+		}
+	}
+
+	if (m_updateBudget > btScalar(0.))
+	{
+		///the nearest bodies get their level first, every other body is left at least the cheapest level
+		m_candidates.quickSort(btLodCandidateSortPredicate());
+		btScalar minCost = getLevelCost(0);
+		int cheapestLevel = 0;
+		for (i=1;i<numLevels;i++)
+		{
+			if (getLevelCost(i) < minCost)
+			{
+				minCost = getLevelCost(i);
+				cheapestLevel = i;
+			}
+		}
+		btScalar remainingBudget = m_updateBudget;
+		int numCandidates = m_candidates.size();
+		for (i=0;i<numCandidates;i++)
+		{
+			btLodCandidate& candidate = m_candidates[i];
+			btScalar allowedCost = remainingBudget - btScalar(numCandidates-i-1) * minCost;
+			int level = cheapestLevel;
+			for (int j=candidate.m_level;j<numLevels;j++)
+			{
+				if (getLevelCost(j) <= allowedCost)
+				{
+					level = j;
+					break;
+				}
+			}
+			candidate.m_level = level;
+			remainingBudget -= getLevelCost(level);
+		}
+	}
+
+	for (i=0;i<m_candidates.size();i++)
+	{
+		const btLodCandidate& candidate = m_candidates[i];
+		btLodBody& lodBody = m_bodies[candidate.m_bodyIndex];
+		lodBody.m_body->setLodLevel(candidate.m_level);
+		setProxyShapeType(lodBody,m_levels[candidate.m_level].m_proxyShapeType);
+		m_numBodiesAtLevel[candidate.m_level]++;
+		m_updateCost += getLevelCost(candidate.m_level);
+	}
+
+	///forget the bodies that are no longer in the world, without touching them
+	for (i=m_bodies.size()-1;i>=0;i--)
+	{
+		if (!m_bodies[i].m_seen)
+		{
+			removeBodyAt(i);
+		}
+	}
+}
+
+btCollisionShape*	btSimulationLodManager::getFullShape(btRigidBody* body) const
+{
+	const int* indexPtr = m_bodyIndices.find(body);
+	if (indexPtr && m_bodies[*indexPtr].m_proxyShape == body->getCollisionShape())
+	{
+		return m_bodies[*indexPtr].m_fullShape;
+	}
+	return body->getCollisionShape();
+}
+
+void	btSimulationLodManager::removeBody(btRigidBody* body)
+{
+	const int* indexPtr = m_bodyIndices.find(body);
+	if (!indexPtr)
+		return;
+	int index = *indexPtr;
+	btLodBody& lodBody = m_bodies[index];
+	if (lodBody.m_proxyShape && lodBody.m_proxyShape == body->getCollisionShape())
+	{
+		setProxyShapeType(lodBody,BT_LOD_PROXY_NONE);
+	}
+	removeBodyAt(index);
+}
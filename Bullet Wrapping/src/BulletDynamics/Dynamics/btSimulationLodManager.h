@@ -0,0 +1,196 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_SIMULATION_LOD_MANAGER_H
+#define BT_SIMULATION_LOD_MANAGER_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btHashMap.h"
+
+class btDiscreteDynamicsWorld;
+class btRigidBody;
+class btCollisionShape;
+
+enum btLodProxyShapeType
+{
+	BT_LOD_PROXY_NONE,
+	///a box around the local bounding box of the shape
+	BT_LOD_PROXY_BOX,
+	///a sphere around the shape, centered at the center of mass
+	BT_LOD_PROXY_SPHERE
+};
+
+///a level of detail of btSimulationLodManager
+struct	btSimulationLodLevelInfo
+{
+	///bodies at least this far from the nearest observer use this level, unless a later level applies
+	btScalar	m_distance;
+	///see btDiscreteDynamicsWorld::setLodLevel
+	int			m_updateInterval;
+	int			m_numIterations;
+	///btLodProxyShapeType that replaces the collision shape of the bodies at this level
+	int			m_proxyShapeType;
+
+	btSimulationLodLevelInfo()
+		:m_distance(btScalar(0.)),
+		m_updateInterval(1),
+		m_numIterations(0),
+		m_proxyShapeType(BT_LOD_PROXY_NONE)
+	{
+	}
+};
+
+///btSimulationLodManager assigns levels of detail to the dynamic rigid bodies of a btDiscreteDynamicsWorld, by their distance to the nearest observer,
+///for example the camera and the players. The levels set the update interval and solver iterations of the bodies, see btDiscreteDynamicsWorld::setLodLevel,
+///and can replace their collision shape by a cheaper proxy shape. Call updateLevels once per frame, before stepSimulation.
+///A level only becomes coarser when the body is a hysteresis fraction beyond the level distance, so bodies near a distance don't switch back and forth.
+///With an update budget, the nearest bodies get the levels for their distance, and farther bodies get coarser levels until the budget is met.
+///Proxy shapes keep the mass and inertia of the body and are shared by bodies with the same full shape, so full shapes have to outlive the manager.
+class	btSimulationLodManager
+{
+protected:
+
+	struct	btLodBody
+	{
+		btRigidBody*		m_body;
+		btCollisionShape*	m_fullShape;
+		///the proxy shape that replaced the full shape, or 0
+		btCollisionShape*	m_proxyShape;
+		int					m_proxyShapeType;
+		int					m_seen;
+	};
+
+	struct	btLodCandidate
+	{
+		btScalar	m_distance2;
+		int			m_bodyIndex;
+		int			m_level;
+	};
+
+	btDiscreteDynamicsWorld*	m_world;
+	btAlignedObjectArray<btSimulationLodLevelInfo>	m_levels;
+	btAlignedObjectArray<btVector3>	m_observers;
+	btScalar	m_updateBudget;
+	btScalar	m_hysteresis;
+
+	btAlignedObjectArray<btLodBody>	m_bodies;
+	btHashMap<btHashPtr,int>		m_bodyIndices;
+	btHashMap<btHashPtr,btCollisionShape*>	m_boxProxyShapes;
+	btHashMap<btHashPtr,btCollisionShape*>	m_sphereProxyShapes;
+	btAlignedObjectArray<btCollisionShape*>	m_ownedProxyShapes;
+
+	btAlignedObjectArray<btLodCandidate>	m_candidates;
+	btAlignedObjectArray<int>	m_numBodiesAtLevel;
+	btScalar	m_updateCost;
+
+	int		findOrAddBody(btRigidBody* body);
+	void	removeBodyAt(int index);
+	int		calculateLevel(btScalar distance2,int currentLevel) const;
+	///returns 0 when the proxy wouldn't be cheaper than the full shape
+	btCollisionShape*	getProxyShape(btCollisionShape* fullShape,int proxyShapeType);
+	void	setProxyShapeType(btLodBody& lodBody,int proxyShapeType);
+
+	btScalar	getLevelCost(int level) const
+	{
+		return btScalar(1.) / btScalar(m_levels[level].m_updateInterval);
+	}
+
+public:
+
+	btSimulationLodManager(btDiscreteDynamicsWorld* world);
+
+	///restores the full shapes of the bodies in the world, deletes the proxy shapes and removes the levels of detail from the world
+	virtual ~btSimulationLodManager();
+
+	///adds the next level, levels are added by increasing distance. The first level applies to the bodies near the observers.
+	int		addLevel(const btSimulationLodLevelInfo& info);
+
+	int		getNumLevels() const
+	{
+		return m_levels.size();
+	}
+
+	const btSimulationLodLevelInfo&	getLevel(int level) const
+	{
+		return m_levels[level];
+	}
+
+	///without observers all bodies use the first level
+	int		addObserver(const btVector3& position)
+	{
+		m_observers.push_back(position);
+		return m_observers.size()-1;
+	}
+
+	void	setObserverPosition(int index,const btVector3& position)
+	{
+		m_observers[index] = position;
+	}
+
+	void	clearObservers()
+	{
+		m_observers.resize(0);
+	}
+
+	int		getNumObservers() const
+	{
+		return m_observers.size();
+	}
+
+	///limits the body updates per substep, where a body costs one over its update interval. Sleeping bodies cost nothing. 0 means no limit.
+	void	setUpdateBudget(btScalar budget)
+	{
+		m_updateBudget = budget;
+	}
+
+	btScalar	getUpdateBudget() const
+	{
+		return m_updateBudget;
+	}
+
+	///fraction of the level distance a body has to be beyond it to move to a coarser level, 0.1 by default
+	void	setHysteresis(btScalar hysteresis)
+	{
+		m_hysteresis = hysteresis;
+	}
+
+	btScalar	getHysteresis() const
+	{
+		return m_hysteresis;
+	}
+
+	///assigns the levels of all dynamic rigid bodies in the world and swaps their proxy shapes
+	void	updateLevels();
+
+	int		getNumBodiesAtLevel(int level) const
+	{
+		return level < m_numBodiesAtLevel.size() ? m_numBodiesAtLevel[level] : 0;
+	}
+
+	///body updates per substep of the active bodies, after the last updateLevels
+	btScalar	getUpdateCost() const
+	{
+		return m_updateCost;
+	}
+
+	///returns the shape that a proxy shape replaced, or the shape of the body when it has no proxy shape
+	btCollisionShape*	getFullShape(btRigidBody* body) const;
+
+	///restores the full shape of the body and forgets it. Call this before removing a body with a proxy shape from the world.
+	void	removeBody(btRigidBody* body);
+};
+
+#endif //BT_SIMULATION_LOD_MANAGER_H
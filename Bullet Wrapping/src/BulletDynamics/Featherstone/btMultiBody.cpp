@@ -0,0 +1,547 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btMultiBody.h"
+#include "btMultiBodyLinkCollider.h"
+#include "LinearMath/btTransformUtil.h"
+#include "LinearMath/btMinMax.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+
+///sum of the squared generalized velocities below which the multibody is considered at rest
+#define BT_MULTIBODY_SLEEP_EPSILON btScalar(0.05)
+
+btMultiBody::btMultiBody(int numLinks,btScalar baseMass,const btVector3& baseInertia,bool fixedBase)
+:m_baseMass(baseMass),
+m_baseInertia(baseInertia),
+m_basePos(btScalar(0.),btScalar(0.),btScalar(0.)),
+m_baseQuat(btScalar(0.),btScalar(0.),btScalar(0.),btScalar(1.)),
+m_baseForce(btScalar(0.),btScalar(0.),btScalar(0.)),
+m_baseTorque(btScalar(0.),btScalar(0.),btScalar(0.)),
+m_fixedBase(fixedBase),
+m_baseCollider(0),
+m_numDofs(0),
+m_linearDamping(btScalar(0.04)),
+m_angularDamping(btScalar(0.04)),
+m_maxCoordinateVelocity(btScalar(100.)),
+m_awake(true),
+m_canSleep(true),
+m_sleepTimer(btScalar(0.)),
+m_companionId(-1),
+m_articulatedCacheValid(false)
+{
+	m_cachedBaseRotationMatrix.setIdentity();
+	m_links.resize(numLinks);
+	m_spatialVel.resize(numLinks+1);
+	m_spatialAcc.resize(numLinks+1);
+	m_coriolis.resize(numLinks+1);
+	m_biasForce.resize(numLinks+1);
+	m_articulatedInertia.resize(numLinks+1);
+	m_dofForce.resize(numLinks*BT_MULTIBODY_MAX_DOFS_PER_LINK);
+	m_dofInvMass.resize(numLinks);
+	m_dofScratch.resize(numLinks*BT_MULTIBODY_MAX_DOFS_PER_LINK);
+	updateDofOffsets();
+}
+
+btMultiBody::~btMultiBody()
+{
+}
+
+void	btMultiBody::setupLink(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+							   const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset,int jointType,const btVector3& jointAxis)
+{
+	///links are processed in index order, so the parent needs to come first
+	btAssert(parent < i);
+	btAssert(mass > btScalar(0.));
+
+	btMultibodyLink& link = m_links[i];
+	link.m_mass = mass;
+	link.m_inertiaLocal = inertia;
+	link.m_parent = parent;
+	link.m_zeroRotParentToThis = rotParentToThis;
+	link.m_eVector = parentComToPivotOffset;
+	link.m_dVector = pivotToThisComOffset;
+	link.m_axis = jointAxis;
+	link.m_jointType = jointType;
+	link.m_jointPos[0] = link.m_jointPos[1] = link.m_jointPos[2] = btScalar(0.);
+	link.m_jointPos[3] = btScalar(1.);
+	link.updateAxes();
+
+	updateDofOffsets();
+	m_articulatedCacheValid = false;
+}
+
+void	btMultiBody::setupRevolute(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+								   const btVector3& jointAxis,const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset)
+{
+	setupLink(i,mass,inertia,parent,rotParentToThis,parentComToPivotOffset,pivotToThisComOffset,BT_MULTIBODY_REVOLUTE,jointAxis.normalized());
+}
+
+void	btMultiBody::setupPrismatic(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+									const btVector3& jointAxis,const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset)
+{
+	setupLink(i,mass,inertia,parent,rotParentToThis,parentComToPivotOffset,pivotToThisComOffset,BT_MULTIBODY_PRISMATIC,jointAxis.normalized());
+}
+
+void	btMultiBody::setupSpherical(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+									const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset)
+{
+	setupLink(i,mass,inertia,parent,rotParentToThis,parentComToPivotOffset,pivotToThisComOffset,BT_MULTIBODY_SPHERICAL,btVector3(btScalar(1.),btScalar(0.),btScalar(0.)));
+}
+
+void	btMultiBody::updateDofOffsets()
+{
+	m_numDofs = 0;
+	for (int i=0;i<m_links.size();i++)
+	{
+		m_links[i].m_dofOffset = m_numDofs;
+		m_numDofs += m_links[i].m_dofCount;
+	}
+	m_velocities.resize(6+m_numDofs,btScalar(0.));
+}
+
+void	btMultiBody::setBaseCollider(btMultiBodyLinkCollider* collider)
+{
+	m_baseCollider = collider;
+	if (collider && m_fixedBase)
+		collider->setCollisionFlags(collider->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT);
+}
+
+void	btMultiBody::clearForcesAndTorques()
+{
+	m_baseForce.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+	m_baseTorque.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+	for (int i=0;i<m_links.size();i++)
+	{
+		btMultibodyLink& link = m_links[i];
+		link.m_appliedForce.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+		link.m_appliedTorque.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+		link.m_jointTorque[0] = link.m_jointTorque[1] = link.m_jointTorque[2] = btScalar(0.);
+	}
+}
+
+void	btMultiBody::clearVelocities()
+{
+	for (int i=0;i<m_velocities.size();i++)
+		m_velocities[i] = btScalar(0.);
+}
+
+btScalar	btMultiBody::getKineticEnergy() const
+{
+	btAlignedObjectArray<btSpatialVector> vel;
+	vel.resize(m_links.size()+1);
+	const btMatrix3x3& baseRot = m_cachedBaseRotationMatrix;
+	vel[0] = btSpatialVector(getBaseOmega()*baseRot,getBaseVel()*baseRot);
+	btScalar energy = vel[0].m_top.dot(m_baseInertia*vel[0].m_top) + m_baseMass*vel[0].m_bottom.length2();
+	for (int i=0;i<m_links.size();i++)
+	{
+		const btMultibodyLink& link = m_links[i];
+		btSpatialVector v = btSpatialTransformMotion(link.m_cachedRotParentToThisMatrix,link.m_cachedRVector,vel[link.m_parent+1]);
+		for (int k=0;k<link.m_dofCount;k++)
+			v += link.m_axes[k]*m_velocities[6+link.m_dofOffset+k];
+		vel[i+1] = v;
+		energy += v.m_top.dot(link.m_inertiaLocal*v.m_top) + link.m_mass*v.m_bottom.length2();
+	}
+	return btScalar(0.5)*energy;
+}
+
+void	btMultiBody::updateLinkTransforms()
+{
+	m_cachedBaseRotationMatrix.setRotation(m_baseQuat);
+
+	for (int i=0;i<m_links.size();i++)
+	{
+		btMultibodyLink& link = m_links[i];
+		link.m_cachedRotParentToThis = link.getJointRotation()*link.m_zeroRotParentToThis;
+		link.m_cachedRotParentToThisMatrix.setRotation(link.m_cachedRotParentToThis);
+		link.m_cachedRVector = quatRotate(link.m_cachedRotParentToThis,link.m_eVector) + link.m_dVector;
+		if (link.m_jointType == BT_MULTIBODY_PRISMATIC)
+			link.m_cachedRVector += link.m_axis*link.m_jointPos[0];
+
+		const btQuaternion& parentRotation = link.m_parent<0 ? m_baseQuat : m_links[link.m_parent].m_cachedWorldRotation;
+		const btVector3& parentPosition = link.m_parent<0 ? m_basePos : m_links[link.m_parent].m_cachedWorldPosition;
+		link.m_cachedWorldRotation = parentRotation*link.m_cachedRotParentToThis.inverse();
+		link.m_cachedWorldRotationMatrix.setRotation(link.m_cachedWorldRotation);
+		link.m_cachedWorldPosition = parentPosition + link.m_cachedWorldRotationMatrix*link.m_cachedRVector;
+	}
+}
+
+void	btMultiBody::updateCollisionObjectWorldTransforms()
+{
+	if (m_baseCollider)
+	{
+		btTransform tr = getBaseWorldTransform();
+		m_baseCollider->setWorldTransform(tr);
+		m_baseCollider->setInterpolationWorldTransform(tr);
+	}
+	for (int i=0;i<m_links.size();i++)
+	{
+		btMultiBodyLinkCollider* collider = m_links[i].m_collider;
+		if (collider)
+		{
+			btTransform tr = getLinkWorldTransform(i);
+			collider->setWorldTransform(tr);
+			collider->setInterpolationWorldTransform(tr);
+		}
+	}
+}
+
+void	btMultiBody::solveBaseInertia(const btSpatialVector& rhs,btSpatialVector& result) const
+{
+	btVector3 top = m_baseSchurInverse*(rhs.m_top - m_baseTopRight*(m_baseLinearInverse*rhs.m_bottom));
+	result.m_top = top;
+	result.m_bottom = m_baseLinearInverse*(rhs.m_bottom - m_baseBottomLeft*top);
+}
+
+btSpatialVector	btMultiBody::calcDampingForce(btScalar mass,const btVector3& inertia,const btSpatialVector& v) const
+{
+	//linear plus quadratic damping, the quadratic term keeps fast whipping chains from gaining energy
+	const btVector3& omega = v.m_top;
+	const btVector3& vel = v.m_bottom;
+	return btSpatialVector(inertia*omega*(m_angularDamping*(btScalar(1.)+omega.length())),
+						   vel*(mass*m_linearDamping*(btScalar(1.)+vel.length())));
+}
+
+void	btMultiBody::stepVelocities(btScalar timeStep,const btVector3& gravity)
+{
+	updateLinkTransforms();
+
+	int numLinks = m_links.size();
+	const btMatrix3x3& baseRot = m_cachedBaseRotationMatrix;
+
+	//outward pass: spatial velocities, velocity product accelerations and bias forces in the local frames
+	{
+		btSpatialVector& v = m_spatialVel[0];
+		v = btSpatialVector(getBaseOmega()*baseRot,getBaseVel()*baseRot);
+		btSpatialInertia& inertia = m_articulatedInertia[0];
+		inertia.setRigidBody(m_baseMass,m_baseInertia);
+		btSpatialVector externalForce(m_baseTorque*baseRot,(m_baseForce+gravity*m_baseMass)*baseRot);
+		m_biasForce[0] = v.crossForce(inertia*v) - externalForce + calcDampingForce(m_baseMass,m_baseInertia,v);
+		m_coriolis[0].setZero();
+	}
+
+	int i,k,l;
+	for (i=0;i<numLinks;i++)
+	{
+		const btMultibodyLink& link = m_links[i];
+		int parentIndex = link.m_parent+1;
+		btSpatialVector v = btSpatialTransformMotion(link.m_cachedRotParentToThisMatrix,link.m_cachedRVector,m_spatialVel[parentIndex]);
+		btSpatialVector jointVel;
+		jointVel.setZero();
+		for (k=0;k<link.m_dofCount;k++)
+			jointVel += link.m_axes[k]*m_velocities[6+link.m_dofOffset+k];
+		v += jointVel;
+		m_spatialVel[i+1] = v;
+		m_coriolis[i+1] = v.crossMotion(jointVel);
+
+		btSpatialInertia& inertia = m_articulatedInertia[i+1];
+		inertia.setRigidBody(link.m_mass,link.m_inertiaLocal);
+		const btMatrix3x3& worldRot = link.m_cachedWorldRotationMatrix;
+		btSpatialVector externalForce(link.m_appliedTorque*worldRot,(link.m_appliedForce+gravity*link.m_mass)*worldRot);
+		m_biasForce[i+1] = v.crossForce(inertia*v) - externalForce + calcDampingForce(link.m_mass,link.m_inertiaLocal,v);
+	}
+
+	//inward pass: articulated inertias and bias forces
+	for (i=numLinks-1;i>=0;i--)
+	{
+		const btMultibodyLink& link = m_links[i];
+		int index = i+1;
+		int parentIndex = link.m_parent+1;
+		const btSpatialInertia& inertia = m_articulatedInertia[index];
+		btSpatialVector* U = &m_dofForce[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		btScalar* u = &m_dofScratch[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		int numDofs = link.m_dofCount;
+
+		btMatrix3x3 jointInertia;
+		jointInertia.setIdentity();
+		for (k=0;k<numDofs;k++)
+			U[k] = inertia*link.m_axes[k];
+		for (k=0;k<numDofs;k++)
+			for (l=0;l<numDofs;l++)
+				jointInertia[k][l] = link.m_axes[k].dot(U[l]);
+		btMatrix3x3& invJointInertia = m_dofInvMass[i];
+		invJointInertia = jointInertia.inverse();
+
+		for (k=0;k<numDofs;k++)
+		{
+			btScalar qdot = m_velocities[6+link.m_dofOffset+k];
+			u[k] = link.m_jointTorque[k] - link.m_jointDamping*qdot - link.m_axes[k].dot(m_biasForce[index]);
+		}
+
+		if ((link.m_parent<0) && m_fixedBase)
+			continue;
+
+		btSpatialInertia articulated = inertia;
+		btSpatialVector bias = m_biasForce[index];
+		for (k=0;k<numDofs;k++)
+		{
+			btSpatialVector W;
+			W.setZero();
+			btScalar Dinvu = btScalar(0.);
+			for (l=0;l<numDofs;l++)
+			{
+				W += U[l]*invJointInertia[k][l];
+				Dinvu += invJointInertia[k][l]*u[l];
+			}
+			articulated.subtractOuterProduct(U[k],W);
+			bias += U[k]*Dinvu;
+		}
+		bias += articulated*m_coriolis[index];
+
+		m_articulatedInertia[parentIndex].addTransformedToParent(articulated,link.m_cachedRotParentToThisMatrix,link.m_cachedRVector);
+		m_biasForce[parentIndex] += btSpatialTransformForceToParent(link.m_cachedRotParentToThisMatrix,link.m_cachedRVector,bias);
+	}
+
+	//base acceleration
+	if (m_fixedBase)
+	{
+		m_spatialAcc[0].setZero();
+	} else
+	{
+		const btSpatialInertia& baseInertia = m_articulatedInertia[0];
+		m_baseLinearInverse = baseInertia.m_bottomRight.inverse();
+		m_baseTopRight = baseInertia.m_topRight;
+		m_baseBottomLeft = baseInertia.m_bottomLeft;
+		m_baseSchurInverse = (baseInertia.m_topLeft - m_baseTopRight*m_baseLinearInverse*m_baseBottomLeft).inverse();
+		solveBaseInertia(-m_biasForce[0],m_spatialAcc[0]);
+	}
+
+	//outward pass: joint accelerations
+	for (i=0;i<numLinks;i++)
+	{
+		const btMultibodyLink& link = m_links[i];
+		const btSpatialVector* U = &m_dofForce[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		const btScalar* u = &m_dofScratch[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		const btMatrix3x3& invJointInertia = m_dofInvMass[i];
+		int numDofs = link.m_dofCount;
+
+		btSpatialVector a = btSpatialTransformMotion(link.m_cachedRotParentToThisMatrix,link.m_cachedRVector,m_spatialAcc[link.m_parent+1]) + m_coriolis[i+1];
+		btScalar rhs[BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		for (k=0;k<numDofs;k++)
+			rhs[k] = u[k] - U[k].dot(a);
+		for (k=0;k<numDofs;k++)
+		{
+			btScalar qdd = btScalar(0.);
+			for (l=0;l<numDofs;l++)
+				qdd += invJointInertia[k][l]*rhs[l];
+			a += link.m_axes[k]*qdd;
+			btScalar& qdot = m_velocities[6+link.m_dofOffset+k];
+			qdot = btClamped(qdot+qdd*timeStep,-m_maxCoordinateVelocity,m_maxCoordinateVelocity);
+		}
+		m_spatialAcc[i+1] = a;
+	}
+
+	if (!m_fixedBase)
+	{
+		//convert the spatial acceleration of the base into the classical acceleration of its center of mass
+		const btSpatialVector& a = m_spatialAcc[0];
+		const btSpatialVector& v = m_spatialVel[0];
+		btVector3 omega = getBaseOmega() + baseRot*a.m_top*timeStep;
+		btVector3 vel = getBaseVel() + baseRot*(a.m_bottom + v.m_top.cross(v.m_bottom))*timeStep;
+		setBaseOmega(omega);
+		setBaseVel(vel);
+	}
+
+	m_articulatedCacheValid = true;
+}
+
+void	btMultiBody::updateArticulatedInertias()
+{
+	if (!m_articulatedCacheValid)
+		stepVelocities(btScalar(0.),btVector3(btScalar(0.),btScalar(0.),btScalar(0.)));
+}
+
+void	btMultiBody::stepPositions(btScalar timeStep)
+{
+	if (!m_fixedBase)
+	{
+		btTransform predicted;
+		btTransformUtil::integrateTransform(getBaseWorldTransform(),getBaseVel(),getBaseOmega(),timeStep,predicted);
+		m_basePos = predicted.getOrigin();
+		m_baseQuat = predicted.getRotation();
+	}
+
+	for (int i=0;i<m_links.size();i++)
+	{
+		btMultibodyLink& link = m_links[i];
+		const btScalar* qdot = &m_velocities[6+link.m_dofOffset];
+		switch (link.m_jointType)
+		{
+		case BT_MULTIBODY_REVOLUTE:
+		case BT_MULTIBODY_PRISMATIC:
+			{
+				link.m_jointPos[0] += qdot[0]*timeStep;
+				break;
+			}
+		case BT_MULTIBODY_SPHERICAL:
+			{
+				//the stored rotation maps the zero pose into the link frame, it rotates with minus the relative angular velocity
+				btTransform jointRot(link.getJointRotation());
+				btTransform predicted;
+				btVector3 omega(qdot[0],qdot[1],qdot[2]);
+				btTransformUtil::integrateTransform(jointRot,btVector3(btScalar(0.),btScalar(0.),btScalar(0.)),-omega,timeStep,predicted);
+				btQuaternion q = predicted.getRotation();
+				q.normalize();
+				link.m_jointPos[0] = q.x();
+				link.m_jointPos[1] = q.y();
+				link.m_jointPos[2] = q.z();
+				link.m_jointPos[3] = q.w();
+				break;
+			}
+		default:
+			{
+				btAssert(0);
+			}
+		}
+	}
+
+	updateLinkTransforms();
+	updateCollisionObjectWorldTransforms();
+	m_articulatedCacheValid = false;
+}
+
+void	btMultiBody::fillContactJacobian(int link,const btVector3& contactPoint,const btVector3& normal,btScalar* jac) const
+{
+	int i;
+	for (i=0;i<6+m_numDofs;i++)
+		jac[i] = btScalar(0.);
+
+	if (!m_fixedBase)
+	{
+		btVector3 angular = (contactPoint - m_basePos).cross(normal);
+		jac[0] = angular.x();
+		jac[1] = angular.y();
+		jac[2] = angular.z();
+		jac[3] = normal.x();
+		jac[4] = normal.y();
+		jac[5] = normal.z();
+	}
+
+	for (i=link;i>=0;i=m_links[i].m_parent)
+	{
+		const btMultibodyLink& l = m_links[i];
+		const btMatrix3x3& worldRot = l.m_cachedWorldRotationMatrix;
+		btVector3 localNormal = normal*worldRot;
+		btVector3 localPoint = (contactPoint - l.m_cachedWorldPosition)*worldRot;
+		btVector3 localTorque = localPoint.cross(localNormal);
+		for (int k=0;k<l.m_dofCount;k++)
+			jac[6+l.m_dofOffset+k] = localNormal.dot(l.m_axes[k].m_bottom) + localTorque.dot(l.m_axes[k].m_top);
+	}
+}
+
+void	btMultiBody::calcAccelerationDeltas(const btScalar* force,btScalar* output)
+{
+	updateArticulatedInertias();
+
+	int numLinks = m_links.size();
+	const btMatrix3x3& baseRot = m_cachedBaseRotationMatrix;
+	int i,k,l;
+
+	//without velocities there are no bias forces, only the applied impulse
+	m_biasForce[0] = btSpatialVector(-(btVector3(force[0],force[1],force[2])*baseRot),-(btVector3(force[3],force[4],force[5])*baseRot));
+	for (i=0;i<numLinks;i++)
+		m_biasForce[i+1].setZero();
+
+	for (i=numLinks-1;i>=0;i--)
+	{
+		const btMultibodyLink& link = m_links[i];
+		int index = i+1;
+		const btSpatialVector* U = &m_dofForce[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		btScalar* u = &m_dofScratch[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		const btMatrix3x3& invJointInertia = m_dofInvMass[i];
+		int numDofs = link.m_dofCount;
+
+		for (k=0;k<numDofs;k++)
+			u[k] = force[6+link.m_dofOffset+k] - link.m_axes[k].dot(m_biasForce[index]);
+
+		if ((link.m_parent<0) && m_fixedBase)
+			continue;
+
+		btSpatialVector bias = m_biasForce[index];
+		for (k=0;k<numDofs;k++)
+		{
+			btScalar Dinvu = btScalar(0.);
+			for (l=0;l<numDofs;l++)
+				Dinvu += invJointInertia[k][l]*u[l];
+			bias += U[k]*Dinvu;
+		}
+		m_biasForce[link.m_parent+1] += btSpatialTransformForceToParent(link.m_cachedRotParentToThisMatrix,link.m_cachedRVector,bias);
+	}
+
+	if (m_fixedBase)
+	{
+		m_spatialAcc[0].setZero();
+		for (i=0;i<6;i++)
+			output[i] = btScalar(0.);
+	} else
+	{
+		solveBaseInertia(-m_biasForce[0],m_spatialAcc[0]);
+		btVector3 angular = baseRot*m_spatialAcc[0].m_top;
+		btVector3 linear = baseRot*m_spatialAcc[0].m_bottom;
+		output[0] = angular.x();
+		output[1] = angular.y();
+		output[2] = angular.z();
+		output[3] = linear.x();
+		output[4] = linear.y();
+		output[5] = linear.z();
+	}
+
+	for (i=0;i<numLinks;i++)
+	{
+		const btMultibodyLink& link = m_links[i];
+		const btSpatialVector* U = &m_dofForce[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		const btScalar* u = &m_dofScratch[i*BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		const btMatrix3x3& invJointInertia = m_dofInvMass[i];
+		int numDofs = link.m_dofCount;
+
+		btSpatialVector a = btSpatialTransformMotion(link.m_cachedRotParentToThisMatrix,link.m_cachedRVector,m_spatialAcc[link.m_parent+1]);
+		btScalar rhs[BT_MULTIBODY_MAX_DOFS_PER_LINK];
+		for (k=0;k<numDofs;k++)
+			rhs[k] = u[k] - U[k].dot(a);
+		for (k=0;k<numDofs;k++)
+		{
+			btScalar qdd = btScalar(0.);
+			for (l=0;l<numDofs;l++)
+				qdd += invJointInertia[k][l]*rhs[l];
+			a += link.m_axes[k]*qdd;
+			output[6+link.m_dofOffset+k] = qdd;
+		}
+		m_spatialAcc[i+1] = a;
+	}
+}
+
+void	btMultiBody::updateSleepTimer(btScalar timeStep)
+{
+	if (!m_canSleep)
+	{
+		m_sleepTimer = btScalar(0.);
+		return;
+	}
+
+	btScalar motion = btScalar(0.);
+	for (int i=0;i<6+m_numDofs;i++)
+		motion += m_velocities[i]*m_velocities[i];
+
+	if (motion < BT_MULTIBODY_SLEEP_EPSILON)
+		m_sleepTimer += timeStep;
+	else
+		m_sleepTimer = btScalar(0.);
+}
+
+bool	btMultiBody::wantsSleeping() const
+{
+	if (!m_canSleep || gDisableDeactivation || (gDeactivationTime == btScalar(0.)))
+		return false;
+	return m_sleepTimer > gDeactivationTime;
+}
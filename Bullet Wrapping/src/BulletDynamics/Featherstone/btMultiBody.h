@@ -0,0 +1,439 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_H
+#define BT_MULTIBODY_H
+
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btMatrix3x3.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "btMultiBodyLink.h"
+
+class btMultiBodyLinkCollider;
+
+///btMultiBody is an articulated body in reduced (joint) coordinates: a floating or fixed base with a tree of links
+///connected by revolute, prismatic or spherical joints.
+///Forward dynamics uses Featherstone's articulated body algorithm, which is O(n) in the number of links, and the joint
+///constraints are exact by construction, so chains don't stretch regardless of the solver iteration count.
+///Contacts and joint limits are handled by the btMultiBodyConstraintSolver, together with regular rigid bodies.
+///The generalized velocity vector holds the base angular and linear velocity (world space), followed by the joint velocities.
+///For spherical joints the 3 joint velocities are the angular velocity of the link relative to its parent, in the link frame.
+ATTRIBUTE_ALIGNED16(class) btMultiBody
+{
+	btAlignedObjectArray<btMultibodyLink>	m_links;
+
+	btScalar		m_baseMass;
+	btVector3		m_baseInertia;			//diagonal inertia tensor in the base frame
+	btVector3		m_basePos;				//center of mass, world space
+	btQuaternion	m_baseQuat;				//rotates base frame vectors into world space
+	btMatrix3x3		m_cachedBaseRotationMatrix;
+	btVector3		m_baseForce;
+	btVector3		m_baseTorque;
+	bool			m_fixedBase;
+
+	btMultiBodyLinkCollider*	m_baseCollider;
+
+	int				m_numDofs;
+	btAlignedObjectArray<btScalar>	m_velocities;
+
+	btScalar		m_linearDamping;
+	btScalar		m_angularDamping;
+	btScalar		m_maxCoordinateVelocity;
+
+	bool			m_awake;
+	bool			m_canSleep;
+	btScalar		m_sleepTimer;
+
+	int				m_companionId;
+
+	//articulated body algorithm state, index 0 is the base and index i+1 is link i
+	bool			m_articulatedCacheValid;
+	btAlignedObjectArray<btSpatialVector>	m_spatialVel;
+	btAlignedObjectArray<btSpatialVector>	m_spatialAcc;
+	btAlignedObjectArray<btSpatialVector>	m_coriolis;
+	btAlignedObjectArray<btSpatialVector>	m_biasForce;
+	btAlignedObjectArray<btSpatialInertia>	m_articulatedInertia;
+	btAlignedObjectArray<btSpatialVector>	m_dofForce;		//U = articulated inertia * joint axis, 3 entries per link
+	btAlignedObjectArray<btMatrix3x3>		m_dofInvMass;	//inverse of the joint space inertia, per link
+	btAlignedObjectArray<btScalar>			m_dofScratch;	//3 entries per link
+
+	//base articulated inertia inverse, using the Schur complement of the linear block
+	btMatrix3x3		m_baseSchurInverse;
+	btMatrix3x3		m_baseLinearInverse;
+	btMatrix3x3		m_baseTopRight;
+	btMatrix3x3		m_baseBottomLeft;
+
+	void	setupLink(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+					  const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset,int jointType,const btVector3& jointAxis);
+
+	void	updateDofOffsets();
+
+	void	solveBaseInertia(const btSpatialVector& rhs,btSpatialVector& result) const;
+
+	btSpatialVector	calcDampingForce(btScalar mass,const btVector3& inertia,const btSpatialVector& v) const;
+
+	///runs the inward pass with the given bias forces and generalized forces, and the outward pass to compute accelerations.
+	///the coriolis terms are only used when useCoriolis is true
+	void	computeAccelerations(const btScalar* jointForces,bool useCoriolis,btScalar* jointAccelerationsOut);
+
+public:
+
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btMultiBody(int numLinks,btScalar baseMass,const btVector3& baseInertia,bool fixedBase);
+
+	~btMultiBody();
+
+	///revolute joint about jointAxis, given in this link frame
+	void	setupRevolute(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+						  const btVector3& jointAxis,const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset);
+
+	///prismatic joint along jointAxis, given in this link frame
+	void	setupPrismatic(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+						   const btVector3& jointAxis,const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset);
+
+	///3 degree of freedom ball joint
+	void	setupSpherical(int i,btScalar mass,const btVector3& inertia,int parent,const btQuaternion& rotParentToThis,
+						   const btVector3& parentComToPivotOffset,const btVector3& pivotToThisComOffset);
+
+	int	getNumLinks() const
+	{
+		return m_links.size();
+	}
+
+	///number of joint degrees of freedom, excluding the 6 base degrees of freedom
+	int	getNumDofs() const
+	{
+		return m_numDofs;
+	}
+
+	btMultibodyLink&	getLink(int i)
+	{
+		return m_links[i];
+	}
+
+	const btMultibodyLink&	getLink(int i) const
+	{
+		return m_links[i];
+	}
+
+	int	getParent(int i) const
+	{
+		return m_links[i].m_parent;
+	}
+
+	bool	hasFixedBase() const
+	{
+		return m_fixedBase;
+	}
+
+	btScalar	getBaseMass() const
+	{
+		return m_baseMass;
+	}
+
+	const btVector3&	getBaseInertia() const
+	{
+		return m_baseInertia;
+	}
+
+	const btVector3&	getBasePos() const
+	{
+		return m_basePos;
+	}
+
+	void	setBasePos(const btVector3& pos)
+	{
+		m_basePos = pos;
+		m_articulatedCacheValid = false;
+	}
+
+	///rotation of the base frame into world space
+	const btQuaternion&	getBaseWorldRotation() const
+	{
+		return m_baseQuat;
+	}
+
+	void	setBaseWorldRotation(const btQuaternion& rot)
+	{
+		m_baseQuat = rot;
+		m_articulatedCacheValid = false;
+	}
+
+	btTransform	getBaseWorldTransform() const
+	{
+		return btTransform(m_baseQuat,m_basePos);
+	}
+
+	btVector3	getBaseOmega() const
+	{
+		return btVector3(m_velocities[0],m_velocities[1],m_velocities[2]);
+	}
+
+	void	setBaseOmega(const btVector3& omega)
+	{
+		m_velocities[0] = omega.x();
+		m_velocities[1] = omega.y();
+		m_velocities[2] = omega.z();
+	}
+
+	btVector3	getBaseVel() const
+	{
+		return btVector3(m_velocities[3],m_velocities[4],m_velocities[5]);
+	}
+
+	void	setBaseVel(const btVector3& vel)
+	{
+		m_velocities[3] = vel.x();
+		m_velocities[4] = vel.y();
+		m_velocities[5] = vel.z();
+	}
+
+	///joint angle or displacement of a revolute or prismatic joint
+	btScalar	getJointPos(int i) const
+	{
+		return m_links[i].m_jointPos[0];
+	}
+
+	void	setJointPos(int i,btScalar q)
+	{
+		btAssert(m_links[i].m_jointType != BT_MULTIBODY_SPHERICAL);
+		m_links[i].m_jointPos[0] = q;
+		m_articulatedCacheValid = false;
+	}
+
+	///rotation of a spherical joint, rotating link frame vectors into the zero pose
+	btQuaternion	getJointRotation(int i) const
+	{
+		return m_links[i].getJointRotation().inverse();
+	}
+
+	void	setJointRotation(int i,const btQuaternion& rot)
+	{
+		btAssert(m_links[i].m_jointType == BT_MULTIBODY_SPHERICAL);
+		btQuaternion q = rot.inverse();
+		m_links[i].m_jointPos[0] = q.x();
+		m_links[i].m_jointPos[1] = q.y();
+		m_links[i].m_jointPos[2] = q.z();
+		m_links[i].m_jointPos[3] = q.w();
+		m_articulatedCacheValid = false;
+	}
+
+	btScalar	getJointVel(int i) const
+	{
+		return m_velocities[6+m_links[i].m_dofOffset];
+	}
+
+	void	setJointVel(int i,btScalar qdot)
+	{
+		m_velocities[6+m_links[i].m_dofOffset] = qdot;
+	}
+
+	btScalar	getJointVelMultiDof(int i,int dof) const
+	{
+		return m_velocities[6+m_links[i].m_dofOffset+dof];
+	}
+
+	void	setJointVelMultiDof(int i,int dof,btScalar qdot)
+	{
+		m_velocities[6+m_links[i].m_dofOffset+dof] = qdot;
+	}
+
+	///generalized velocities, 6 base entries followed by getNumDofs() joint velocities
+	const btScalar*	getVelocityVector() const
+	{
+		return &m_velocities[0];
+	}
+
+	void	setJointDamping(int i,btScalar damping)
+	{
+		m_links[i].m_jointDamping = damping;
+	}
+
+	///limits for revolute and prismatic joints, enforced by the btMultiBodyConstraintSolver
+	void	setJointLimits(int i,btScalar lower,btScalar upper)
+	{
+		btAssert(m_links[i].m_jointType != BT_MULTIBODY_SPHERICAL);
+		m_links[i].m_jointLimitEnabled = true;
+		m_links[i].m_jointLowerLimit = lower;
+		m_links[i].m_jointUpperLimit = upper;
+	}
+
+	void	disableJointLimits(int i)
+	{
+		m_links[i].m_jointLimitEnabled = false;
+	}
+
+	///damping of the base and every link, the damping force is -mass*damping*(1+|v|)*v
+	void	setLinearDamping(btScalar damping)
+	{
+		m_linearDamping = damping;
+	}
+
+	///damping torque of the base and every link, -inertia*damping*(1+|omega|)*omega
+	void	setAngularDamping(btScalar damping)
+	{
+		m_angularDamping = damping;
+	}
+
+	///joint velocities are clamped to this value after each velocity step, it keeps fast whipping chains from blowing up
+	void	setMaxCoordinateVelocity(btScalar maxVelocity)
+	{
+		m_maxCoordinateVelocity = maxVelocity;
+	}
+
+	btScalar	getMaxCoordinateVelocity() const
+	{
+		return m_maxCoordinateVelocity;
+	}
+
+	///for a fixed base, the base collider gets the CF_STATIC_OBJECT flag
+	void	setBaseCollider(btMultiBodyLinkCollider* collider);
+
+	btMultiBodyLinkCollider*	getBaseCollider() const
+	{
+		return m_baseCollider;
+	}
+
+	void	setLinkCollider(int i,btMultiBodyLinkCollider* collider)
+	{
+		m_links[i].m_collider = collider;
+	}
+
+	btMultiBodyLinkCollider*	getLinkCollider(int i) const
+	{
+		return m_links[i].m_collider;
+	}
+
+	///world space transform of the center of mass frame of a link, -1 for the base
+	btTransform	getLinkWorldTransform(int i) const
+	{
+		if (i<0)
+			return getBaseWorldTransform();
+		return btTransform(m_links[i].m_cachedWorldRotation,m_links[i].m_cachedWorldPosition);
+	}
+
+	//forces and torques are world space, applied at the center of mass and cleared by clearForcesAndTorques
+	void	addBaseForce(const btVector3& force)
+	{
+		m_baseForce += force;
+	}
+
+	void	addBaseTorque(const btVector3& torque)
+	{
+		m_baseTorque += torque;
+	}
+
+	void	addLinkForce(int i,const btVector3& force)
+	{
+		m_links[i].m_appliedForce += force;
+	}
+
+	void	addLinkTorque(int i,const btVector3& torque)
+	{
+		m_links[i].m_appliedTorque += torque;
+	}
+
+	void	addJointTorque(int i,btScalar torque)
+	{
+		m_links[i].m_jointTorque[0] += torque;
+	}
+
+	void	addJointTorqueMultiDof(int i,int dof,btScalar torque)
+	{
+		m_links[i].m_jointTorque[dof] += torque;
+	}
+
+	void	clearForcesAndTorques();
+
+	void	clearVelocities();
+
+	btScalar	getKineticEnergy() const;
+
+	///recompute the cached link rotations and positions from the base pose and joint positions
+	void	updateLinkTransforms();
+
+	///copy the link transforms into the base and link colliders
+	void	updateCollisionObjectWorldTransforms();
+
+	///integrate the joint space equations of motion over the time step, including gravity and applied forces
+	void	stepVelocities(btScalar timeStep,const btVector3& gravity);
+
+	///integrate the base pose and joint positions using the current velocities
+	void	stepPositions(btScalar timeStep);
+
+	///make sure the articulated inertias used by calcAccelerationDeltas match the current configuration
+	void	updateArticulatedInertias();
+
+	///jacobian of the velocity of a world space point on link (-1 for the base) along normal, with 6+getNumDofs() entries
+	void	fillContactJacobian(int link,const btVector3& contactPoint,const btVector3& normal,btScalar* jac) const;
+
+	///change of the generalized velocities caused by a generalized impulse, both with 6+getNumDofs() entries. O(n) using the cached articulated inertias
+	void	calcAccelerationDeltas(const btScalar* force,btScalar* output);
+
+	void	applyDeltaVee(const btScalar* deltaVee,btScalar multiplier)
+	{
+		for (int i=0;i<6+m_numDofs;i++)
+			m_velocities[i] += deltaVee[i]*multiplier;
+	}
+
+	bool	isAwake() const
+	{
+		return m_awake;
+	}
+
+	void	wakeUp()
+	{
+		m_awake = true;
+		m_sleepTimer = btScalar(0.);
+	}
+
+	void	goToSleep()
+	{
+		m_awake = false;
+		clearVelocities();
+	}
+
+	void	setCanSleep(bool canSleep)
+	{
+		m_canSleep = canSleep;
+	}
+
+	bool	getCanSleep() const
+	{
+		return m_canSleep;
+	}
+
+	///accumulates the time the multibody has been (almost) at rest
+	void	updateSleepTimer(btScalar timeStep);
+
+	bool	wantsSleeping() const;
+
+	///internal use by the btMultiBodyConstraintSolver
+	int	getCompanionId() const
+	{
+		return m_companionId;
+	}
+
+	void	setCompanionId(int id)
+	{
+		m_companionId = id;
+	}
+};
+
+#endif //BT_MULTIBODY_H
@@ -0,0 +1,527 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btMultiBodyConstraintSolver.h"
+#include "btMultiBody.h"
+#include "btMultiBodyLinkCollider.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "BulletDynamics/ConstraintSolver/btContactSolverInfo.h"
+#include "LinearMath/btQuickprof.h"
+
+void	applyAnisotropicFriction(btCollisionObject* colObj,btVector3& frictionDirection);
+
+btMultiBodyConstraintSolver::btMultiBodyConstraintSolver()
+:m_groupMultiBodies(0),
+m_numGroupMultiBodies(0)
+{
+}
+
+btMultiBodyConstraintSolver::~btMultiBodyConstraintSolver()
+{
+}
+
+///the companion id of a multibody is the offset of its delta velocities during one solve
+int	btMultiBodyConstraintSolver::getOrInitMultiBody(btMultiBody* multiBody)
+{
+	if (multiBody->getCompanionId() >= 0)
+		return multiBody->getCompanionId();
+
+	int offset = m_deltaVelocities.size();
+	m_deltaVelocities.resize(offset+6+multiBody->getNumDofs(),btScalar(0.));
+	multiBody->setCompanionId(offset);
+	multiBody->updateArticulatedInertias();
+	m_tmpMultiBodies.push_back(multiBody);
+	return offset;
+}
+
+btScalar	btMultiBodyConstraintSolver::setupMultiBodyRow(btMultiBodySolverConstraint& solverConstraint,const btVector3& normal,
+														   const btVector3& posA,const btVector3& posB,btCollisionObject* colObjA,btCollisionObject* colObjB)
+{
+	btMultiBodyLinkCollider* fcA = btMultiBodyLinkCollider::upcast(colObjA);
+	btMultiBodyLinkCollider* fcB = btMultiBodyLinkCollider::upcast(colObjB);
+	btRigidBody* rbA = btRigidBody::upcast(colObjA);
+	btRigidBody* rbB = btRigidBody::upcast(colObjB);
+
+	solverConstraint.m_contactNormal = normal;
+	solverConstraint.m_multiBodyA = fcA ? fcA->getMultiBody() : 0;
+	solverConstraint.m_multiBodyB = fcB ? fcB->getMultiBody() : 0;
+	solverConstraint.m_linkA = fcA ? fcA->getLink() : -1;
+	solverConstraint.m_linkB = fcB ? fcB->getLink() : -1;
+	solverConstraint.m_solverBodyA = rbA ? rbA : &getFixedBody();
+	solverConstraint.m_solverBodyB = rbB ? rbB : &getFixedBody();
+
+	btScalar denom0 = btScalar(0.);
+	btScalar denom1 = btScalar(0.);
+	btScalar rel_vel = btScalar(0.);
+	int i;
+
+	if (solverConstraint.m_multiBodyA)
+	{
+		btMultiBody* mbA = solverConstraint.m_multiBodyA;
+		int ndofA = 6+mbA->getNumDofs();
+		solverConstraint.m_deltaVelAindex = getOrInitMultiBody(mbA);
+		solverConstraint.m_jacAindex = m_jacobians.size();
+		m_jacobians.resize(solverConstraint.m_jacAindex+ndofA);
+		m_deltaVelocitiesUnitImpulse.resize(solverConstraint.m_jacAindex+ndofA);
+
+		btScalar* jac = &m_jacobians[solverConstraint.m_jacAindex];
+		btScalar* delta = &m_deltaVelocitiesUnitImpulse[solverConstraint.m_jacAindex];
+		mbA->fillContactJacobian(solverConstraint.m_linkA,posA,normal,jac);
+		mbA->calcAccelerationDeltas(jac,delta);
+
+		const btScalar* vel = mbA->getVelocityVector();
+		for (i=0;i<ndofA;i++)
+		{
+			denom0 += jac[i]*delta[i];
+			rel_vel += jac[i]*vel[i];
+		}
+		solverConstraint.m_relpos1CrossNormal.setValue(0,0,0);
+		solverConstraint.m_angularComponentA.setValue(0,0,0);
+	} else
+	{
+		solverConstraint.m_deltaVelAindex = -1;
+		solverConstraint.m_jacAindex = -1;
+		btVector3 rel_pos1 = posA - colObjA->getWorldTransform().getOrigin();
+		btVector3 torqueAxis0 = rel_pos1.cross(normal);
+		solverConstraint.m_relpos1CrossNormal = torqueAxis0;
+		solverConstraint.m_angularComponentA = rbA ? rbA->getInvInertiaTensorWorld()*torqueAxis0*rbA->getAngularFactor() : btVector3(0,0,0);
+		if (rbA)
+		{
+			denom0 = rbA->getInvMass() + normal.dot(solverConstraint.m_angularComponentA.cross(rel_pos1));
+			rel_vel += normal.dot(rbA->getLinearVelocity()) + torqueAxis0.dot(rbA->getAngularVelocity());
+		}
+	}
+
+	if (solverConstraint.m_multiBodyB)
+	{
+		btMultiBody* mbB = solverConstraint.m_multiBodyB;
+		int ndofB = 6+mbB->getNumDofs();
+		solverConstraint.m_deltaVelBindex = getOrInitMultiBody(mbB);
+		solverConstraint.m_jacBindex = m_jacobians.size();
+		m_jacobians.resize(solverConstraint.m_jacBindex+ndofB);
+		m_deltaVelocitiesUnitImpulse.resize(solverConstraint.m_jacBindex+ndofB);
+
+		btScalar* jac = &m_jacobians[solverConstraint.m_jacBindex];
+		btScalar* delta = &m_deltaVelocitiesUnitImpulse[solverConstraint.m_jacBindex];
+		mbB->fillContactJacobian(solverConstraint.m_linkB,posB,-normal,jac);
+		mbB->calcAccelerationDeltas(jac,delta);
+
+		const btScalar* vel = mbB->getVelocityVector();
+		for (i=0;i<ndofB;i++)
+		{
+			denom1 += jac[i]*delta[i];
+			rel_vel += jac[i]*vel[i];
+		}
+		solverConstraint.m_relpos2CrossNormal.setValue(0,0,0);
+		solverConstraint.m_angularComponentB.setValue(0,0,0);
+	} else
+	{
+		solverConstraint.m_deltaVelBindex = -1;
+		solverConstraint.m_jacBindex = -1;
+		btVector3 rel_pos2 = posB - colObjB->getWorldTransform().getOrigin();
+		btVector3 torqueAxis1 = rel_pos2.cross(-normal);
+		solverConstraint.m_relpos2CrossNormal = torqueAxis1;
+		solverConstraint.m_angularComponentB = rbB ? rbB->getInvInertiaTensorWorld()*torqueAxis1*rbB->getAngularFactor() : btVector3(0,0,0);
+		if (rbB)
+		{
+			denom1 = rbB->getInvMass() + normal.dot((-solverConstraint.m_angularComponentB).cross(rel_pos2));
+			rel_vel += -normal.dot(rbB->getLinearVelocity()) + torqueAxis1.dot(rbB->getAngularVelocity());
+		}
+	}
+
+	btScalar denom = denom0+denom1;
+	solverConstraint.m_jacDiagABInv = (denom > SIMD_EPSILON) ? btScalar(1.)/denom : btScalar(0.);
+	return rel_vel;
+}
+
+void	btMultiBodyConstraintSolver::addMultiBodyFrictionConstraint(const btVector3& normalAxis,int frictionIndex,btManifoldPoint& cp,
+																	btCollisionObject* colObjA,btCollisionObject* colObjB,btScalar appliedImpulse)
+{
+	btMultiBodySolverConstraint& solverConstraint = m_multiBodyFrictionContactConstraints.expandNonInitializing();
+	btScalar rel_vel = setupMultiBodyRow(solverConstraint,normalAxis,cp.getPositionWorldOnA(),cp.getPositionWorldOnB(),colObjA,colObjB);
+
+	solverConstraint.m_friction = cp.m_combinedFriction;
+	solverConstraint.m_frictionIndex = frictionIndex;
+	solverConstraint.m_originalContactPoint = 0;
+	solverConstraint.m_rhs = -rel_vel*solverConstraint.m_jacDiagABInv;
+	solverConstraint.m_cfm = btScalar(0.);
+	solverConstraint.m_lowerLimit = btScalar(0.);
+	solverConstraint.m_upperLimit = btScalar(0.);
+	solverConstraint.m_appliedImpulse = appliedImpulse;
+	if (appliedImpulse != btScalar(0.))
+		applyRowImpulse(solverConstraint,appliedImpulse);
+}
+
+void	btMultiBodyConstraintSolver::convertMultiBodyContact(btPersistentManifold* manifold,const btContactSolverInfo& infoGlobal)
+{
+	btCollisionObject* colObj0 = (btCollisionObject*)manifold->getBody0();
+	btCollisionObject* colObj1 = (btCollisionObject*)manifold->getBody1();
+
+	bool warmstart = (infoGlobal.m_solverMode & SOLVER_USE_WARMSTARTING) != 0;
+	bool frictionWarmstart = warmstart && (infoGlobal.m_solverMode & SOLVER_USE_FRICTION_WARMSTARTING);
+
+	for (int j=0;j<manifold->getNumContacts();j++)
+	{
+		btManifoldPoint& cp = manifold->getContactPoint(j);
+
+		if (cp.getDistance() > manifold->getContactProcessingThreshold())
+			continue;
+
+		int frictionIndex = m_multiBodyNormalContactConstraints.size();
+		btMultiBodySolverConstraint& solverConstraint = m_multiBodyNormalContactConstraints.expandNonInitializing();
+		btScalar rel_vel = setupMultiBodyRow(solverConstraint,cp.m_normalWorldOnB,cp.getPositionWorldOnA(),cp.getPositionWorldOnB(),colObj0,colObj1);
+
+		if (solverConstraint.m_jacDiagABInv == btScalar(0.))
+		{
+			//both sides are immovable along the normal, for example a fixed base touching static geometry
+			m_multiBodyNormalContactConstraints.pop_back();
+			continue;
+		}
+
+		solverConstraint.m_originalContactPoint = &cp;
+		solverConstraint.m_friction = cp.m_combinedFriction;
+
+		btScalar penetration = cp.getDistance()+infoGlobal.m_linearSlop;
+
+		btScalar restitution = btScalar(0.);
+		if (cp.m_lifeTime <= infoGlobal.m_restingContactRestitutionThreshold)
+		{
+			restitution = restitutionCurve(rel_vel,cp.m_combinedRestitution);
+			if (restitution <= btScalar(0.))
+				restitution = btScalar(0.);
+		}
+
+		//multibody rows don't take part in the split impulse pass, so the positional error always goes into the rhs
+		btScalar positionalError = btScalar(0.);
+		btScalar velocityError = restitution - rel_vel;
+		if (penetration > btScalar(0.))
+		{
+			velocityError -= penetration / infoGlobal.m_timeStep;
+		} else
+		{
+			positionalError = -penetration * infoGlobal.m_erp/infoGlobal.m_timeStep;
+		}
+
+		solverConstraint.m_rhs = (positionalError+velocityError)*solverConstraint.m_jacDiagABInv;
+		solverConstraint.m_cfm = btScalar(0.);
+		solverConstraint.m_lowerLimit = btScalar(0.);
+		solverConstraint.m_upperLimit = btScalar(1e10f);
+		solverConstraint.m_appliedImpulse = warmstart ? cp.m_appliedImpulse*infoGlobal.m_warmstartingFactor : btScalar(0.);
+		solverConstraint.m_frictionIndex = m_multiBodyFrictionContactConstraints.size();
+
+		if (solverConstraint.m_appliedImpulse != btScalar(0.))
+			applyRowImpulse(solverConstraint,solverConstraint.m_appliedImpulse);
+
+		///the link velocity at the contact point is not available without extra jacobians, so the friction directions
+		///are always taken from the contact normal, and two directions are used to avoid a biased single axis
+		btPlaneSpace1(cp.m_normalWorldOnB,cp.m_lateralFrictionDir1,cp.m_lateralFrictionDir2);
+		applyAnisotropicFriction(colObj0,cp.m_lateralFrictionDir1);
+		applyAnisotropicFriction(colObj1,cp.m_lateralFrictionDir1);
+		applyAnisotropicFriction(colObj0,cp.m_lateralFrictionDir2);
+		applyAnisotropicFriction(colObj1,cp.m_lateralFrictionDir2);
+
+		addMultiBodyFrictionConstraint(cp.m_lateralFrictionDir1,frictionIndex,cp,colObj0,colObj1,
+			frictionWarmstart ? cp.m_appliedImpulseLateral1*infoGlobal.m_warmstartingFactor : btScalar(0.));
+		addMultiBodyFrictionConstraint(cp.m_lateralFrictionDir2,frictionIndex,cp,colObj0,colObj1,
+			frictionWarmstart ? cp.m_appliedImpulseLateral2*infoGlobal.m_warmstartingFactor : btScalar(0.));
+		cp.m_lateralFrictionInitialized = true;
+	}
+}
+
+void	btMultiBodyConstraintSolver::convertJointLimits(btMultiBody* multiBody,const btContactSolverInfo& infoGlobal)
+{
+	for (int i=0;i<multiBody->getNumLinks();i++)
+	{
+		const btMultibodyLink& link = multiBody->getLink(i);
+		if (!link.m_jointLimitEnabled || link.m_dofCount != 1)
+			continue;
+
+		int dof = 6+link.m_dofOffset;
+		btScalar q = link.m_jointPos[0];
+		btScalar qdot = multiBody->getJointVel(i);
+
+		//one row per side, both are speculative so a joint approaching its limit stops exactly at the limit
+		for (int side=0;side<2;side++)
+		{
+			btScalar sign = side ? btScalar(-1.) : btScalar(1.);
+			btScalar distance = side ? link.m_jointUpperLimit - q : q - link.m_jointLowerLimit;
+
+			int ndof = 6+multiBody->getNumDofs();
+			btMultiBodySolverConstraint& solverConstraint = m_multiBodyNonContactConstraints.expandNonInitializing();
+			solverConstraint.m_multiBodyA = multiBody;
+			solverConstraint.m_multiBodyB = 0;
+			solverConstraint.m_linkA = i;
+			solverConstraint.m_linkB = -1;
+			solverConstraint.m_solverBodyA = &getFixedBody();
+			solverConstraint.m_solverBodyB = &getFixedBody();
+			solverConstraint.m_deltaVelAindex = getOrInitMultiBody(multiBody);
+			solverConstraint.m_deltaVelBindex = -1;
+			solverConstraint.m_jacAindex = m_jacobians.size();
+			solverConstraint.m_jacBindex = -1;
+			m_jacobians.resize(solverConstraint.m_jacAindex+ndof,btScalar(0.));
+			m_deltaVelocitiesUnitImpulse.resize(solverConstraint.m_jacAindex+ndof);
+
+			btScalar* jac = &m_jacobians[solverConstraint.m_jacAindex];
+			btScalar* delta = &m_deltaVelocitiesUnitImpulse[solverConstraint.m_jacAindex];
+			jac[dof] = sign;
+			multiBody->calcAccelerationDeltas(jac,delta);
+
+			btScalar denom = sign*delta[dof];
+			solverConstraint.m_jacDiagABInv = (denom > SIMD_EPSILON) ? btScalar(1.)/denom : btScalar(0.);
+
+			solverConstraint.m_contactNormal.setValue(0,0,0);
+			solverConstraint.m_relpos1CrossNormal.setValue(0,0,0);
+			solverConstraint.m_relpos2CrossNormal.setValue(0,0,0);
+			solverConstraint.m_angularComponentA.setValue(0,0,0);
+			solverConstraint.m_angularComponentB.setValue(0,0,0);
+
+			btScalar positionalError = btScalar(0.);
+			btScalar velocityError = -sign*qdot;
+			if (distance > btScalar(0.))
+			{
+				velocityError -= distance / infoGlobal.m_timeStep;
+			} else
+			{
+				positionalError = -distance * infoGlobal.m_erp/infoGlobal.m_timeStep;
+			}
+
+			solverConstraint.m_rhs = (positionalError+velocityError)*solverConstraint.m_jacDiagABInv;
+			solverConstraint.m_cfm = btScalar(0.);
+			solverConstraint.m_lowerLimit = btScalar(0.);
+			solverConstraint.m_upperLimit = btScalar(1e10f);
+			solverConstraint.m_appliedImpulse = btScalar(0.);
+			solverConstraint.m_friction = btScalar(0.);
+			solverConstraint.m_frictionIndex = -1;
+			solverConstraint.m_originalContactPoint = 0;
+		}
+	}
+}
+
+void	btMultiBodyConstraintSolver::applyRowImpulse(const btMultiBodySolverConstraint& c,btScalar impulse)
+{
+	int i;
+	if (c.m_multiBodyA)
+	{
+		int ndofA = 6+c.m_multiBodyA->getNumDofs();
+		btScalar* deltaVel = &m_deltaVelocities[c.m_deltaVelAindex];
+		const btScalar* unit = &m_deltaVelocitiesUnitImpulse[c.m_jacAindex];
+		for (i=0;i<ndofA;i++)
+			deltaVel[i] += unit[i]*impulse;
+	} else
+	{
+		c.m_solverBodyA->internalApplyImpulse(c.m_contactNormal*c.m_solverBodyA->internalGetInvMass(),c.m_angularComponentA,impulse);
+	}
+
+	if (c.m_multiBodyB)
+	{
+		int ndofB = 6+c.m_multiBodyB->getNumDofs();
+		btScalar* deltaVel = &m_deltaVelocities[c.m_deltaVelBindex];
+		const btScalar* unit = &m_deltaVelocitiesUnitImpulse[c.m_jacBindex];
+		for (i=0;i<ndofB;i++)
+			deltaVel[i] += unit[i]*impulse;
+	} else
+	{
+		c.m_solverBodyB->internalApplyImpulse(-c.m_contactNormal*c.m_solverBodyB->internalGetInvMass(),c.m_angularComponentB,impulse);
+	}
+}
+
+void	btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(btMultiBodySolverConstraint& c)
+{
+	btScalar deltaImpulse = c.m_rhs-c.m_appliedImpulse*c.m_cfm;
+	btScalar deltaVelADotn = btScalar(0.);
+	btScalar deltaVelBDotn = btScalar(0.);
+	int i;
+
+	if (c.m_multiBodyA)
+	{
+		int ndofA = 6+c.m_multiBodyA->getNumDofs();
+		const btScalar* jac = &m_jacobians[c.m_jacAindex];
+		const btScalar* deltaVel = &m_deltaVelocities[c.m_deltaVelAindex];
+		for (i=0;i<ndofA;i++)
+			deltaVelADotn += jac[i]*deltaVel[i];
+	} else
+	{
+		deltaVelADotn = c.m_contactNormal.dot(c.m_solverBodyA->internalGetDeltaLinearVelocity()) + c.m_relpos1CrossNormal.dot(c.m_solverBodyA->internalGetDeltaAngularVelocity());
+	}
+
+	if (c.m_multiBodyB)
+	{
+		int ndofB = 6+c.m_multiBodyB->getNumDofs();
+		const btScalar* jac = &m_jacobians[c.m_jacBindex];
+		const btScalar* deltaVel = &m_deltaVelocities[c.m_deltaVelBindex];
+		for (i=0;i<ndofB;i++)
+			deltaVelBDotn += jac[i]*deltaVel[i];
+	} else
+	{
+		deltaVelBDotn = -c.m_contactNormal.dot(c.m_solverBodyB->internalGetDeltaLinearVelocity()) + c.m_relpos2CrossNormal.dot(c.m_solverBodyB->internalGetDeltaAngularVelocity());
+	}
+
+	deltaImpulse -= deltaVelADotn*c.m_jacDiagABInv;
+	deltaImpulse -= deltaVelBDotn*c.m_jacDiagABInv;
+
+	const btScalar sum = c.m_appliedImpulse + deltaImpulse;
+	if (sum < c.m_lowerLimit)
+	{
+		deltaImpulse = c.m_lowerLimit-c.m_appliedImpulse;
+		c.m_appliedImpulse = c.m_lowerLimit;
+	}
+	else if (sum > c.m_upperLimit)
+	{
+		deltaImpulse = c.m_upperLimit-c.m_appliedImpulse;
+		c.m_appliedImpulse = c.m_upperLimit;
+	}
+	else
+	{
+		c.m_appliedImpulse = sum;
+	}
+
+	applyRowImpulse(c,deltaImpulse);
+}
+
+btScalar btMultiBodyConstraintSolver::solveGroupCacheFriendlySetup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc)
+{
+	BT_PROFILE("btMultiBodyConstraintSolver::solveGroupCacheFriendlySetup");
+	int i;
+
+	//the base setup skips this when there are no rigid body rows, but multibody rows can still push rigid bodies
+	for (i=0;i<numBodies;i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(bodies[i]);
+		if (body)
+		{
+			body->internalGetDeltaLinearVelocity().setZero();
+			body->internalGetDeltaAngularVelocity().setZero();
+			body->internalGetPushVelocity().setZero();
+			body->internalGetTurnVelocity().setZero();
+		}
+	}
+
+	m_tmpRigidManifolds.resize(0);
+	for (i=0;i<numManifolds;i++)
+	{
+		btPersistentManifold* manifold = manifoldPtr[i];
+		if (!btMultiBodyLinkCollider::upcast((btCollisionObject*)manifold->getBody0()) &&
+			!btMultiBodyLinkCollider::upcast((btCollisionObject*)manifold->getBody1()))
+		{
+			m_tmpRigidManifolds.push_back(manifold);
+		}
+	}
+
+	btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(bodies,numBodies,
+		m_tmpRigidManifolds.size() ? &m_tmpRigidManifolds[0] : 0,m_tmpRigidManifolds.size(),
+		constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+
+	for (i=0;i<numManifolds;i++)
+	{
+		btPersistentManifold* manifold = manifoldPtr[i];
+		if (btMultiBodyLinkCollider::upcast((btCollisionObject*)manifold->getBody0()) ||
+			btMultiBodyLinkCollider::upcast((btCollisionObject*)manifold->getBody1()))
+		{
+			convertMultiBodyContact(manifold,infoGlobal);
+		}
+	}
+
+	for (i=0;i<m_numGroupMultiBodies;i++)
+	{
+		convertJointLimits(m_groupMultiBodies[i],infoGlobal);
+	}
+
+	return 0.f;
+}
+
+btScalar btMultiBodyConstraintSolver::solveSingleIteration(int iteration, btCollisionObject** bodies ,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc)
+{
+	btSequentialImpulseConstraintSolver::solveSingleIteration(iteration,bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+
+	int j;
+	for (j=0;j<m_multiBodyNonContactConstraints.size();j++)
+	{
+		resolveSingleConstraintRowGeneric(m_multiBodyNonContactConstraints[j]);
+	}
+
+	for (j=0;j<m_multiBodyNormalContactConstraints.size();j++)
+	{
+		resolveSingleConstraintRowGeneric(m_multiBodyNormalContactConstraints[j]);
+	}
+
+	for (j=0;j<m_multiBodyFrictionContactConstraints.size();j++)
+	{
+		btMultiBodySolverConstraint& frictionConstraint = m_multiBodyFrictionContactConstraints[j];
+		btScalar totalImpulse = m_multiBodyNormalContactConstraints[frictionConstraint.m_frictionIndex].m_appliedImpulse;
+		if (totalImpulse>btScalar(0))
+		{
+			frictionConstraint.m_lowerLimit = -(frictionConstraint.m_friction*totalImpulse);
+			frictionConstraint.m_upperLimit = frictionConstraint.m_friction*totalImpulse;
+			resolveSingleConstraintRowGeneric(frictionConstraint);
+		}
+	}
+	return 0.f;
+}
+
+btScalar btMultiBodyConstraintSolver::solveGroupCacheFriendlyFinish(btCollisionObject** bodies ,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc)
+{
+	int j;
+	for (j=0;j<m_multiBodyNormalContactConstraints.size();j++)
+	{
+		const btMultiBodySolverConstraint& solverConstraint = m_multiBodyNormalContactConstraints[j];
+		btManifoldPoint* pt = (btManifoldPoint*) solverConstraint.m_originalContactPoint;
+		btAssert(pt);
+		pt->m_appliedImpulse = solverConstraint.m_appliedImpulse;
+		pt->m_appliedImpulseLateral1 = m_multiBodyFrictionContactConstraints[solverConstraint.m_frictionIndex].m_appliedImpulse;
+		pt->m_appliedImpulseLateral2 = m_multiBodyFrictionContactConstraints[solverConstraint.m_frictionIndex+1].m_appliedImpulse;
+	}
+
+	for (j=0;j<m_tmpMultiBodies.size();j++)
+	{
+		btMultiBody* multiBody = m_tmpMultiBodies[j];
+		multiBody->applyDeltaVee(&m_deltaVelocities[multiBody->getCompanionId()],btScalar(1.));
+		multiBody->setCompanionId(-1);
+	}
+
+	m_multiBodyNonContactConstraints.resize(0);
+	m_multiBodyNormalContactConstraints.resize(0);
+	m_multiBodyFrictionContactConstraints.resize(0);
+	m_jacobians.resize(0);
+	m_deltaVelocitiesUnitImpulse.resize(0);
+	m_deltaVelocities.resize(0);
+	m_tmpMultiBodies.resize(0);
+	m_tmpRigidManifolds.resize(0);
+
+	return btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyFinish(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+}
+
+btScalar btMultiBodyConstraintSolver::solveGroup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr,int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal, btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,btDispatcher* dispatcher)
+{
+	solveMultiBodyGroup(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,0,0,infoGlobal,debugDrawer,stackAlloc,dispatcher);
+	return 0.f;
+}
+
+void	btMultiBodyConstraintSolver::solveMultiBodyGroup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr,int numManifolds,btTypedConstraint** constraints,int numConstraints,
+														 btMultiBody** multiBodies,int numMultiBodies,const btContactSolverInfo& infoGlobal, btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,btDispatcher* /*dispatcher*/)
+{
+	BT_PROFILE("btMultiBodyConstraintSolver::solveMultiBodyGroup");
+	m_groupMultiBodies = multiBodies;
+	m_numGroupMultiBodies = numMultiBodies;
+
+	solveGroupCacheFriendlySetup(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+
+	solveGroupCacheFriendlyIterations(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+
+	solveGroupCacheFriendlyFinish(bodies,numBodies,manifoldPtr,numManifolds,constraints,numConstraints,infoGlobal,debugDrawer,stackAlloc);
+
+	m_groupMultiBodies = 0;
+	m_numGroupMultiBodies = 0;
+}
@@ -0,0 +1,81 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_CONSTRAINT_SOLVER_H
+#define BT_MULTIBODY_CONSTRAINT_SOLVER_H
+
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "btMultiBodySolverConstraint.h"
+
+class btMultiBody;
+
+///The btMultiBodyConstraintSolver extends the btSequentialImpulseConstraintSolver with contact and joint limit rows for btMultiBody links.
+///Contacts between multibody links and rigid bodies are solved in the same Gauss-Seidel iterations as the rigid body contacts and joints.
+///The joints inside a multibody are exact, so only contacts and joint limits need iterations.
+class btMultiBodyConstraintSolver : public btSequentialImpulseConstraintSolver
+{
+protected:
+
+	btMultiBodyConstraintArray			m_multiBodyNonContactConstraints;
+	btMultiBodyConstraintArray			m_multiBodyNormalContactConstraints;
+	btMultiBodyConstraintArray			m_multiBodyFrictionContactConstraints;
+
+	btAlignedObjectArray<btScalar>		m_jacobians;
+	btAlignedObjectArray<btScalar>		m_deltaVelocitiesUnitImpulse;
+	btAlignedObjectArray<btScalar>		m_deltaVelocities;
+
+	btAlignedObjectArray<btMultiBody*>	m_tmpMultiBodies;
+	btAlignedObjectArray<btPersistentManifold*>	m_tmpRigidManifolds;
+
+	btMultiBody**	m_groupMultiBodies;
+	int				m_numGroupMultiBodies;
+
+	int		getOrInitMultiBody(btMultiBody* multiBody);
+
+	///fills the jacobians and effective mass of a row along normal, returns the current relative velocity
+	btScalar	setupMultiBodyRow(btMultiBodySolverConstraint& solverConstraint,const btVector3& normal,
+								  const btVector3& posA,const btVector3& posB,btCollisionObject* colObjA,btCollisionObject* colObjB);
+
+	void	convertMultiBodyContact(btPersistentManifold* manifold,const btContactSolverInfo& infoGlobal);
+
+	void	convertJointLimits(btMultiBody* multiBody,const btContactSolverInfo& infoGlobal);
+
+	void	addMultiBodyFrictionConstraint(const btVector3& normalAxis,int frictionIndex,btManifoldPoint& cp,
+										   btCollisionObject* colObjA,btCollisionObject* colObjB,btScalar appliedImpulse);
+
+	void	applyRowImpulse(const btMultiBodySolverConstraint& c,btScalar impulse);
+
+	void	resolveSingleConstraintRowGeneric(btMultiBodySolverConstraint& c);
+
+	virtual btScalar solveGroupCacheFriendlySetup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc);
+
+	virtual btScalar solveSingleIteration(int iteration, btCollisionObject** bodies ,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc);
+
+	virtual btScalar solveGroupCacheFriendlyFinish(btCollisionObject** bodies ,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc);
+
+public:
+
+	btMultiBodyConstraintSolver();
+
+	virtual ~btMultiBodyConstraintSolver();
+
+	virtual btScalar solveGroup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifold,int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& info, btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,btDispatcher* dispatcher);
+
+	///solve one island, including the joint limits of the given multibodies. Contacts with multibody links are recognized from the manifolds.
+	void	solveMultiBodyGroup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifold,int numManifolds,btTypedConstraint** constraints,int numConstraints,
+								btMultiBody** multiBodies,int numMultiBodies,const btContactSolverInfo& info, btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,btDispatcher* dispatcher);
+};
+
+#endif //BT_MULTIBODY_CONSTRAINT_SOLVER_H
@@ -0,0 +1,456 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btMultiBodyDynamicsWorld.h"
+#include "btMultiBody.h"
+#include "btMultiBodyLinkCollider.h"
+#include "btMultiBodyConstraintSolver.h"
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "LinearMath/btQuickprof.h"
+
+static btCollisionObject*	btGetMultiBodyCollider(const btMultiBody* multiBody,int index)
+{
+	return index<0 ? (btCollisionObject*)multiBody->getBaseCollider() : (btCollisionObject*)multiBody->getLinkCollider(index);
+}
+
+///first non-static collider of the multibody, or 0 when it has no colliders that take part in the islands
+static btCollisionObject*	btGetMultiBodyIslandCollider(const btMultiBody* multiBody)
+{
+	for (int i=-1;i<multiBody->getNumLinks();i++)
+	{
+		btCollisionObject* col = btGetMultiBodyCollider(multiBody,i);
+		if (col && col->getIslandTag()>=0)
+			return col;
+	}
+	return 0;
+}
+
+SIMD_FORCE_INLINE	int	btGetMultiBodyIslandId(const btMultiBody* multiBody)
+{
+	btCollisionObject* col = btGetMultiBodyIslandCollider(multiBody);
+	return col ? col->getIslandTag() : -1;
+}
+
+SIMD_FORCE_INLINE	int	btGetConstraintIslandId(const btTypedConstraint* lhs)
+{
+	const btCollisionObject& rcolObj0 = lhs->getRigidBodyA();
+	const btCollisionObject& rcolObj1 = lhs->getRigidBodyB();
+	return rcolObj0.getIslandTag()>=0?rcolObj0.getIslandTag():rcolObj1.getIslandTag();
+}
+
+class btSortConstraintOnIslandPredicate2
+{
+	public:
+
+		bool operator() ( const btTypedConstraint* lhs, const btTypedConstraint* rhs )
+		{
+			return btGetConstraintIslandId(lhs) < btGetConstraintIslandId(rhs);
+		}
+};
+
+class btSortMultiBodyOnIslandPredicate
+{
+	public:
+
+		bool operator() ( const btMultiBody* lhs, const btMultiBody* rhs )
+		{
+			return btGetMultiBodyIslandId(lhs) < btGetMultiBodyIslandId(rhs);
+		}
+};
+
+btMultiBodyDynamicsWorld::btMultiBodyDynamicsWorld(btDispatcher* dispatcher,btBroadphaseInterface* pairCache,btMultiBodyConstraintSolver* constraintSolver,btCollisionConfiguration* collisionConfiguration)
+:btDiscreteDynamicsWorld(dispatcher,pairCache,constraintSolver,collisionConfiguration),
+m_multiBodyConstraintSolver(constraintSolver)
+{
+}
+
+btMultiBodyDynamicsWorld::~btMultiBodyDynamicsWorld()
+{
+}
+
+void	btMultiBodyDynamicsWorld::addMultiBody(btMultiBody* multiBody)
+{
+	m_multiBodies.push_back(multiBody);
+	multiBody->updateLinkTransforms();
+	multiBody->updateCollisionObjectWorldTransforms();
+}
+
+void	btMultiBodyDynamicsWorld::removeMultiBody(btMultiBody* multiBody)
+{
+	m_multiBodies.remove(multiBody);
+	getSimulationIslandManager()->notifyConstraintRemoved();
+}
+
+void	btMultiBodyDynamicsWorld::predictUnconstraintMotion(btScalar timeStep)
+{
+	btDiscreteDynamicsWorld::predictUnconstraintMotion(timeStep);
+
+	BT_PROFILE("btMultiBody stepVelocities");
+	for (int i=0;i<m_multiBodies.size();i++)
+	{
+		btMultiBody* multiBody = m_multiBodies[i];
+		if (multiBody->isAwake())
+			multiBody->stepVelocities(timeStep,m_gravity);
+	}
+}
+
+void	btMultiBodyDynamicsWorld::integrateTransforms(btScalar timeStep)
+{
+	btDiscreteDynamicsWorld::integrateTransforms(timeStep);
+
+	BT_PROFILE("btMultiBody stepPositions");
+	for (int i=0;i<m_multiBodies.size();i++)
+	{
+		btMultiBody* multiBody = m_multiBodies[i];
+		if (multiBody->isAwake())
+			multiBody->stepPositions(timeStep);
+	}
+}
+
+void	btMultiBodyDynamicsWorld::calculateSimulationIslands()
+{
+	BT_PROFILE("calculateSimulationIslands");
+
+	getSimulationIslandManager()->updateActivationState(getCollisionWorld(),getCollisionWorld()->getDispatcher());
+
+	{
+		int i;
+		int numConstraints = int(m_constraints.size());
+		int numConstraintUnions = 0;
+		for (i=0;i< numConstraints ; i++ )
+		{
+			btTypedConstraint* constraint = m_constraints[i];
+
+			const btRigidBody* colObj0 = &constraint->getRigidBodyA();
+			const btRigidBody* colObj1 = &constraint->getRigidBodyB();
+
+			if (((colObj0) && (!(colObj0)->isStaticOrKinematicObject())) &&
+				((colObj1) && (!(colObj1)->isStaticOrKinematicObject())))
+			{
+				if (colObj0->isActive() || colObj1->isActive())
+				{
+
+					getSimulationIslandManager()->getUnionFind().unite((colObj0)->getIslandTag(),
+						(colObj1)->getIslandTag());
+					numConstraintUnions++;
+				}
+			}
+		}
+
+		//the colliders of one multibody always share an island, the joints are never broken or disabled
+		for (i=0;i<m_multiBodies.size();i++)
+		{
+			btMultiBody* multiBody = m_multiBodies[i];
+			btCollisionObject* prev = 0;
+			for (int c=-1;c<multiBody->getNumLinks();c++)
+			{
+				btCollisionObject* cur = btGetMultiBodyCollider(multiBody,c);
+				if (!cur || cur->isStaticOrKinematicObject())
+					continue;
+				if (prev)
+				{
+					getSimulationIslandManager()->getUnionFind().unite(prev->getIslandTag(),cur->getIslandTag());
+					numConstraintUnions++;
+				}
+				prev = cur;
+			}
+		}
+		getSimulationIslandManager()->notifyConstraintUnions(numConstraintUnions);
+	}
+
+	//Store the island id in each body
+	getSimulationIslandManager()->storeIslandActivationState(getCollisionWorld());
+}
+
+void	btMultiBodyDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
+{
+	BT_PROFILE("solveConstraints");
+
+	struct MultiBodyInplaceSolverIslandCallback : public btSimulationIslandManager::IslandCallback
+	{
+
+		btContactSolverInfo&	m_solverInfo;
+		btMultiBodyConstraintSolver*	m_solver;
+		btTypedConstraint**		m_sortedConstraints;
+		int						m_numConstraints;
+		btMultiBody**			m_sortedMultiBodies;
+		int						m_numMultiBodies;
+		btIDebugDraw*			m_debugDrawer;
+		btStackAlloc*			m_stackAlloc;
+		btDispatcher*			m_dispatcher;
+		bool					m_solvedAllMultiBodies;
+
+		btAlignedObjectArray<btCollisionObject*> m_bodies;
+		btAlignedObjectArray<btPersistentManifold*> m_manifolds;
+		btAlignedObjectArray<btTypedConstraint*> m_constraints;
+		btAlignedObjectArray<btMultiBody*> m_multiBodies;
+
+
+		MultiBodyInplaceSolverIslandCallback(
+			btContactSolverInfo& solverInfo,
+			btMultiBodyConstraintSolver*	solver,
+			btTypedConstraint** sortedConstraints,
+			int	numConstraints,
+			btMultiBody** sortedMultiBodies,
+			int numMultiBodies,
+			btIDebugDraw*	debugDrawer,
+			btStackAlloc*			stackAlloc,
+			btDispatcher* dispatcher)
+			:m_solverInfo(solverInfo),
+			m_solver(solver),
+			m_sortedConstraints(sortedConstraints),
+			m_numConstraints(numConstraints),
+			m_sortedMultiBodies(sortedMultiBodies),
+			m_numMultiBodies(numMultiBodies),
+			m_debugDrawer(debugDrawer),
+			m_stackAlloc(stackAlloc),
+			m_dispatcher(dispatcher),
+			m_solvedAllMultiBodies(false)
+		{
+
+		}
+
+
+		MultiBodyInplaceSolverIslandCallback& operator=(MultiBodyInplaceSolverIslandCallback& other)
+		{
+			btAssert(0);
+			(void)other;
+			return *this;
+		}
+		virtual	void	ProcessIsland(btCollisionObject** bodies,int numBodies,btPersistentManifold**	manifolds,int numManifolds, int islandId)
+		{
+			if (islandId<0)
+			{
+				///we don't split islands, so all constraints/contact manifolds/bodies/multibodies are passed into the solver regardless the island id
+				if (numManifolds + m_numConstraints + m_numMultiBodies)
+				{
+					m_solver->solveMultiBodyGroup( bodies,numBodies,manifolds, numManifolds,m_sortedConstraints,m_numConstraints,
+						m_sortedMultiBodies,m_numMultiBodies,m_solverInfo,m_debugDrawer,m_stackAlloc,m_dispatcher);
+				}
+				m_solvedAllMultiBodies = true;
+			} else
+			{
+				//also add all non-contact constraints/joints and multibodies for this island
+				btTypedConstraint** startConstraint = 0;
+				int numCurConstraints = 0;
+				btMultiBody** startMultiBody = 0;
+				int numCurMultiBodies = 0;
+				int i;
+
+				//find the first constraint for this island
+				for (i=0;i<m_numConstraints;i++)
+				{
+					if (btGetConstraintIslandId(m_sortedConstraints[i]) == islandId)
+					{
+						startConstraint = &m_sortedConstraints[i];
+						break;
+					}
+				}
+				//count the number of constraints in this island
+				for (;i<m_numConstraints;i++)
+				{
+					if (btGetConstraintIslandId(m_sortedConstraints[i]) == islandId)
+					{
+						numCurConstraints++;
+					}
+				}
+
+				for (i=0;i<m_numMultiBodies;i++)
+				{
+					if (btGetMultiBodyIslandId(m_sortedMultiBodies[i]) == islandId)
+					{
+						startMultiBody = &m_sortedMultiBodies[i];
+						break;
+					}
+				}
+				for (;i<m_numMultiBodies;i++)
+				{
+					if (btGetMultiBodyIslandId(m_sortedMultiBodies[i]) == islandId)
+					{
+						numCurMultiBodies++;
+					}
+				}
+
+				if (m_solverInfo.m_minimumSolverBatchSize<=1)
+				{
+					if (numManifolds + numCurConstraints + numCurMultiBodies)
+					{
+						m_solver->solveMultiBodyGroup( bodies,numBodies,manifolds, numManifolds,startConstraint,numCurConstraints,
+							startMultiBody,numCurMultiBodies,m_solverInfo,m_debugDrawer,m_stackAlloc,m_dispatcher);
+					}
+				} else
+				{
+
+					for (i=0;i<numBodies;i++)
+						m_bodies.push_back(bodies[i]);
+					for (i=0;i<numManifolds;i++)
+						m_manifolds.push_back(manifolds[i]);
+					for (i=0;i<numCurConstraints;i++)
+						m_constraints.push_back(startConstraint[i]);
+					for (i=0;i<numCurMultiBodies;i++)
+						m_multiBodies.push_back(startMultiBody[i]);
+					if ((m_constraints.size()+m_manifolds.size())>m_solverInfo.m_minimumSolverBatchSize)
+					{
+						processConstraints();
+					}
+				}
+			}
+		}
+		void	processConstraints()
+		{
+			if (m_manifolds.size() + m_constraints.size() + m_multiBodies.size()>0)
+			{
+
+				btCollisionObject** bodies = m_bodies.size()? &m_bodies[0]:0;
+				btPersistentManifold** manifold = m_manifolds.size()?&m_manifolds[0]:0;
+				btTypedConstraint** constraints = m_constraints.size()?&m_constraints[0]:0;
+				btMultiBody** multiBodies = m_multiBodies.size()?&m_multiBodies[0]:0;
+
+				m_solver->solveMultiBodyGroup( bodies,m_bodies.size(),manifold, m_manifolds.size(),constraints, m_constraints.size(),
+					multiBodies,m_multiBodies.size(),m_solverInfo,m_debugDrawer,m_stackAlloc,m_dispatcher);
+			}
+			m_bodies.resize(0);
+			m_manifolds.resize(0);
+			m_constraints.resize(0);
+			m_multiBodies.resize(0);
+		}
+
+	};
+
+	//sorted version of all btTypedConstraint, based on islandId
+	btAlignedObjectArray<btTypedConstraint*>	sortedConstraints;
+	sortedConstraints.resize( m_constraints.size());
+	int i;
+	for (i=0;i<getNumConstraints();i++)
+	{
+		sortedConstraints[i] = m_constraints[i];
+	}
+	sortedConstraints.quickSort(btSortConstraintOnIslandPredicate2());
+	btTypedConstraint** constraintsPtr = getNumConstraints() ? &sortedConstraints[0] : 0;
+
+	//awake multibodies, also sorted on islandId
+	btAlignedObjectArray<btMultiBody*>	sortedMultiBodies;
+	for (i=0;i<m_multiBodies.size();i++)
+	{
+		btMultiBody* multiBody = m_multiBodies[i];
+		btCollisionObject* col = btGetMultiBodyIslandCollider(multiBody);
+		if (col ? col->isActive() : multiBody->isAwake())
+			sortedMultiBodies.push_back(multiBody);
+	}
+	sortedMultiBodies.quickSort(btSortMultiBodyOnIslandPredicate());
+	btMultiBody** multiBodiesPtr = sortedMultiBodies.size() ? &sortedMultiBodies[0] : 0;
+
+	MultiBodyInplaceSolverIslandCallback	solverCallback(	solverInfo,	m_multiBodyConstraintSolver, constraintsPtr,sortedConstraints.size(),
+		multiBodiesPtr,sortedMultiBodies.size(),m_debugDrawer,m_stackAlloc,m_dispatcher1);
+
+	m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(), getCollisionWorld()->getDispatcher()->getNumManifolds());
+
+	/// solve all the constraints for this island
+	m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(),getCollisionWorld(),&solverCallback);
+
+	//multibodies without colliders in an island only need their joint limits
+	if (!solverCallback.m_solvedAllMultiBodies)
+	{
+		for (i=0;i<sortedMultiBodies.size() && (btGetMultiBodyIslandId(sortedMultiBodies[i])<0);i++)
+		{
+			solverCallback.m_multiBodies.push_back(sortedMultiBodies[i]);
+		}
+	}
+
+	solverCallback.processConstraints();
+
+	m_constraintSolver->allSolved(solverInfo, m_debugDrawer, m_stackAlloc);
+
+	//follow the sleeping state of the island
+	for (i=0;i<m_multiBodies.size();i++)
+	{
+		btMultiBody* multiBody = m_multiBodies[i];
+		btCollisionObject* col = btGetMultiBodyIslandCollider(multiBody);
+		if (!col)
+			continue;
+		if (col->getActivationState() == ISLAND_SLEEPING)
+		{
+			if (multiBody->isAwake())
+				multiBody->goToSleep();
+		} else
+		{
+			if (!multiBody->isAwake())
+				multiBody->wakeUp();
+		}
+	}
+}
+
+void	btMultiBodyDynamicsWorld::updateActivationState(btScalar timeStep)
+{
+	btDiscreteDynamicsWorld::updateActivationState(timeStep);
+
+	for (int i=0;i<m_multiBodies.size();i++)
+	{
+		btMultiBody* multiBody = m_multiBodies[i];
+		if (!multiBody->isAwake())
+			continue;
+
+		multiBody->updateSleepTimer(timeStep);
+		bool wantsSleeping = multiBody->wantsSleeping();
+
+		if (wantsSleeping && !btGetMultiBodyIslandCollider(multiBody))
+		{
+			//nothing else can wake it up, sleeping is only for multibodies in an island
+			continue;
+		}
+
+		for (int c=-1;c<multiBody->getNumLinks();c++)
+		{
+			btCollisionObject* col = btGetMultiBodyCollider(multiBody,c);
+			if (!col || col->isStaticOrKinematicObject())
+				continue;
+			if (wantsSleeping)
+			{
+				if (col->getActivationState() == ACTIVE_TAG)
+					col->setActivationState(WANTS_DEACTIVATION);
+			} else
+			{
+				if (col->getActivationState() != DISABLE_DEACTIVATION)
+					col->setActivationState(ACTIVE_TAG);
+			}
+		}
+	}
+}
+
+void	btMultiBodyDynamicsWorld::clearForces()
+{
+	btDiscreteDynamicsWorld::clearForces();
+
+	for (int i=0;i<m_multiBodies.size();i++)
+	{
+		m_multiBodies[i]->clearForcesAndTorques();
+	}
+}
+
+void	btMultiBodyDynamicsWorld::shiftOrigin(const btVector3& shift)
+{
+	for (int i=0;i<m_multiBodies.size();i++)
+	{
+		btMultiBody* multiBody = m_multiBodies[i];
+		multiBody->setBasePos(multiBody->getBasePos() - shift);
+		for (int link=0;link<multiBody->getNumLinks();link++)
+		{
+			multiBody->getLink(link).m_cachedWorldPosition -= shift;
+		}
+	}
+	btDiscreteDynamicsWorld::shiftOrigin(shift);
+}
@@ -0,0 +1,78 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_DYNAMICS_WORLD_H
+#define BT_MULTIBODY_DYNAMICS_WORLD_H
+
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h"
+
+class btMultiBody;
+class btMultiBodyConstraintSolver;
+
+///The btMultiBodyDynamicsWorld adds btMultiBody articulations to the btDiscreteDynamicsWorld.
+///The link colliders (btMultiBodyLinkCollider) are added separately using addCollisionObject, all colliders of one
+///multibody end up in the same simulation island and the multibody sleeps and wakes up together with that island.
+///The base collider of a fixed base multibody is static, see btMultiBody::setBaseCollider.
+class btMultiBodyDynamicsWorld : public btDiscreteDynamicsWorld
+{
+protected:
+
+	btAlignedObjectArray<btMultiBody*>	m_multiBodies;
+
+	btMultiBodyConstraintSolver*	m_multiBodyConstraintSolver;
+
+	virtual void	predictUnconstraintMotion(btScalar timeStep);
+
+	virtual void	integrateTransforms(btScalar timeStep);
+
+	virtual void	calculateSimulationIslands();
+
+	virtual void	solveConstraints(btContactSolverInfo& solverInfo);
+
+	virtual void	updateActivationState(btScalar timeStep);
+
+public:
+
+	btMultiBodyDynamicsWorld(btDispatcher* dispatcher,btBroadphaseInterface* pairCache,btMultiBodyConstraintSolver* constraintSolver,btCollisionConfiguration* collisionConfiguration);
+
+	virtual ~btMultiBodyDynamicsWorld();
+
+	///the world doesn't own the multibody or its colliders
+	virtual void	addMultiBody(btMultiBody* multiBody);
+
+	virtual void	removeMultiBody(btMultiBody* multiBody);
+
+	int	getNumMultibodies() const
+	{
+		return m_multiBodies.size();
+	}
+
+	btMultiBody*	getMultiBody(int index)
+	{
+		return m_multiBodies[index];
+	}
+
+	const btMultiBody*	getMultiBody(int index) const
+	{
+		return m_multiBodies[index];
+	}
+
+	virtual void	clearForces();
+
+	///moves the multibody bases and the cached link positions by -shift, then the collision objects including the link colliders
+	virtual void	shiftOrigin(const btVector3& shift);
+};
+
+#endif //BT_MULTIBODY_DYNAMICS_WORLD_H
@@ -0,0 +1,159 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_LINK_H
+#define BT_MULTIBODY_LINK_H
+
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btVector3.h"
+#include "btSpatialAlgebra.h"
+
+class btMultiBodyLinkCollider;
+
+enum	btMultiBodyJointType
+{
+	BT_MULTIBODY_REVOLUTE=0,
+	BT_MULTIBODY_PRISMATIC,
+	BT_MULTIBODY_SPHERICAL
+};
+
+#define BT_MULTIBODY_MAX_DOFS_PER_LINK 3
+
+///btMultibodyLink describes one link of a btMultiBody and the joint that connects it to its parent.
+///Each link has a local frame with its origin at the center of mass. At zero joint position, vectors in the parent frame
+///are rotated into the link frame by m_zeroRotParentToThis.
+ATTRIBUTE_ALIGNED16(struct) btMultibodyLink
+{
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btScalar		m_mass;
+	btVector3		m_inertiaLocal;			//diagonal inertia tensor in the link frame
+
+	int				m_parent;				//index of the parent link, -1 for the base
+
+	btQuaternion	m_zeroRotParentToThis;
+	btVector3		m_eVector;				//parent center of mass to joint pivot, in the parent frame
+	btVector3		m_dVector;				//joint pivot to this center of mass, in this frame
+	btVector3		m_axis;					//revolute/prismatic joint axis, in this frame
+
+	int				m_jointType;
+	int				m_dofCount;
+	int				m_dofOffset;			//offset of the first joint velocity in btMultiBody::getVelocityVector, after the 6 base entries
+
+	btScalar		m_jointPos[4];			//angle or displacement, or the relative rotation quaternion for spherical joints
+	btScalar		m_jointTorque[BT_MULTIBODY_MAX_DOFS_PER_LINK];
+	btScalar		m_jointDamping;
+
+	bool			m_jointLimitEnabled;	//revolute and prismatic only
+	btScalar		m_jointLowerLimit;
+	btScalar		m_jointUpperLimit;
+
+	btVector3		m_appliedForce;			//world space, applied at the center of mass
+	btVector3		m_appliedTorque;		//world space
+
+	btSpatialVector	m_axes[BT_MULTIBODY_MAX_DOFS_PER_LINK];	//joint motion subspace in this frame
+
+	btMultiBodyLinkCollider*	m_collider;
+
+	//cached kinematics, updated by btMultiBody::updateLinkTransforms
+	btQuaternion	m_cachedRotParentToThis;
+	btMatrix3x3		m_cachedRotParentToThisMatrix;
+	btVector3		m_cachedRVector;		//parent center of mass to this center of mass, in this frame
+	btQuaternion	m_cachedWorldRotation;	//rotates link frame vectors into world space
+	btMatrix3x3		m_cachedWorldRotationMatrix;
+	btVector3		m_cachedWorldPosition;
+
+	btMultibodyLink()
+		:m_mass(btScalar(1.)),
+		m_inertiaLocal(btScalar(1.),btScalar(1.),btScalar(1.)),
+		m_parent(-1),
+		m_zeroRotParentToThis(btScalar(0.),btScalar(0.),btScalar(0.),btScalar(1.)),
+		m_eVector(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_dVector(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_axis(btScalar(1.),btScalar(0.),btScalar(0.)),
+		m_jointType(BT_MULTIBODY_REVOLUTE),
+		m_dofCount(1),
+		m_dofOffset(0),
+		m_jointDamping(btScalar(0.)),
+		m_jointLimitEnabled(false),
+		m_jointLowerLimit(btScalar(0.)),
+		m_jointUpperLimit(btScalar(0.)),
+		m_appliedForce(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_appliedTorque(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_collider(0),
+		m_cachedRotParentToThis(btScalar(0.),btScalar(0.),btScalar(0.),btScalar(1.)),
+		m_cachedRVector(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_cachedWorldRotation(btScalar(0.),btScalar(0.),btScalar(0.),btScalar(1.)),
+		m_cachedWorldPosition(btScalar(0.),btScalar(0.),btScalar(0.))
+	{
+		m_jointPos[0] = m_jointPos[1] = m_jointPos[2] = btScalar(0.);
+		m_jointPos[3] = btScalar(1.);
+		m_jointTorque[0] = m_jointTorque[1] = m_jointTorque[2] = btScalar(0.);
+		m_cachedRotParentToThisMatrix.setIdentity();
+		m_cachedWorldRotationMatrix.setIdentity();
+		updateAxes();
+	}
+
+	///recompute the joint motion subspace from the joint type, axis and pivot offset
+	void	updateAxes()
+	{
+		switch (m_jointType)
+		{
+		case BT_MULTIBODY_REVOLUTE:
+			{
+				m_dofCount = 1;
+				m_axes[0] = btSpatialVector(m_axis,m_axis.cross(m_dVector));
+				break;
+			}
+		case BT_MULTIBODY_PRISMATIC:
+			{
+				m_dofCount = 1;
+				m_axes[0] = btSpatialVector(btVector3(btScalar(0.),btScalar(0.),btScalar(0.)),m_axis);
+				break;
+			}
+		case BT_MULTIBODY_SPHERICAL:
+			{
+				m_dofCount = 3;
+				for (int i=0;i<3;i++)
+				{
+					btVector3 axis(btScalar(0.),btScalar(0.),btScalar(0.));
+					axis[i] = btScalar(1.);
+					m_axes[i] = btSpatialVector(axis,axis.cross(m_dVector));
+				}
+				break;
+			}
+		default:
+			{
+				btAssert(0);
+			}
+		}
+	}
+
+	///relative rotation of the joint, rotating parent frame vectors into this frame on top of m_zeroRotParentToThis
+	btQuaternion	getJointRotation() const
+	{
+		switch (m_jointType)
+		{
+		case BT_MULTIBODY_REVOLUTE:
+			return btQuaternion(m_axis,-m_jointPos[0]);
+		case BT_MULTIBODY_SPHERICAL:
+			return btQuaternion(m_jointPos[0],m_jointPos[1],m_jointPos[2],m_jointPos[3]);
+		default:
+			return btQuaternion(btScalar(0.),btScalar(0.),btScalar(0.),btScalar(1.));
+		}
+	}
+};
+
+#endif //BT_MULTIBODY_LINK_H
@@ -0,0 +1,78 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_LINK_COLLIDER_H
+#define BT_MULTIBODY_LINK_COLLIDER_H
+
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+
+class btMultiBody;
+
+///btMultiBodyLinkCollider is the collision object for the base (link index -1) or one link of a btMultiBody.
+///Its world transform is driven by the multibody, and its collision shape is positioned relative to the link center of mass frame.
+///Colliders of the same btMultiBody never collide with each other.
+///Unlike a plain btCollisionObject, a link collider is not static by default.
+class btMultiBodyLinkCollider : public btCollisionObject
+{
+	btMultiBody*	m_multiBody;
+	int				m_link;
+
+protected:
+
+	virtual bool	checkCollideWithOverride(btCollisionObject* co)
+	{
+		btMultiBodyLinkCollider* other = btMultiBodyLinkCollider::upcast(co);
+		if (other && other->m_multiBody == m_multiBody)
+			return false;
+		return true;
+	}
+
+public:
+
+	btMultiBodyLinkCollider(btMultiBody* multiBody,int link)
+		:m_multiBody(multiBody),
+		m_link(link)
+	{
+		m_internalType = CO_FEATHERSTONE_LINK;
+		m_checkCollideWith = true;
+		//link colliders are dynamic, btMultiBody::setBaseCollider makes the base collider of a fixed base static
+		m_collisionFlags = 0;
+	}
+
+	btMultiBody*	getMultiBody() const
+	{
+		return m_multiBody;
+	}
+
+	int	getLink() const
+	{
+		return m_link;
+	}
+
+	static const btMultiBodyLinkCollider*	upcast(const btCollisionObject* colObj)
+	{
+		if (colObj->getInternalType()==btCollisionObject::CO_FEATHERSTONE_LINK)
+			return (const btMultiBodyLinkCollider*)colObj;
+		return 0;
+	}
+	static btMultiBodyLinkCollider*	upcast(btCollisionObject* colObj)
+	{
+		if (colObj->getInternalType()==btCollisionObject::CO_FEATHERSTONE_LINK)
+			return (btMultiBodyLinkCollider*)colObj;
+		return 0;
+	}
+};
+
+#endif //BT_MULTIBODY_LINK_COLLIDER_H
@@ -0,0 +1,65 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_SOLVER_CONSTRAINT_H
+#define BT_MULTIBODY_SOLVER_CONSTRAINT_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+class btMultiBody;
+class btRigidBody;
+
+///1D constraint row between two sides, each either a btMultiBody link or a btRigidBody (possibly the fixed body).
+///For a multibody side the jacobian and the velocity change for a unit impulse are stored in the solver, at m_jacAindex/m_jacBindex,
+///for a rigid body side the same layout as btSolverConstraint is used.
+ATTRIBUTE_ALIGNED16 (struct)	btMultiBodySolverConstraint
+{
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	int				m_deltaVelAindex;	//offset of the multibody delta velocities in the solver
+	int				m_jacAindex;
+	int				m_deltaVelBindex;
+	int				m_jacBindex;
+
+	btMultiBody*	m_multiBodyA;
+	btMultiBody*	m_multiBodyB;
+	int				m_linkA;
+	int				m_linkB;
+
+	btRigidBody*	m_solverBodyA;
+	btRigidBody*	m_solverBodyB;
+
+	btVector3		m_contactNormal;
+	btVector3		m_relpos1CrossNormal;
+	btVector3		m_relpos2CrossNormal;
+	btVector3		m_angularComponentA;
+	btVector3		m_angularComponentB;
+
+	btScalar		m_appliedImpulse;
+	btScalar		m_friction;
+	btScalar		m_jacDiagABInv;
+	btScalar		m_rhs;
+	btScalar		m_cfm;
+	btScalar		m_lowerLimit;
+	btScalar		m_upperLimit;
+
+	int				m_frictionIndex;
+	void*			m_originalContactPoint;
+};
+
+typedef btAlignedObjectArray<btMultiBodySolverConstraint>	btMultiBodyConstraintArray;
+
+#endif //BT_MULTIBODY_SOLVER_CONSTRAINT_H
@@ -0,0 +1,187 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_SPATIAL_ALGEBRA_H
+#define BT_SPATIAL_ALGEBRA_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btMatrix3x3.h"
+
+///6D spatial vector used by the articulated body algorithm.
+///Motion vectors store (angular velocity, linear velocity of the frame origin), force vectors store (torque about the frame origin, force).
+///All spatial quantities of a btMultiBody are expressed in the local frame of a body, with its origin at the center of mass.
+ATTRIBUTE_ALIGNED16(struct) btSpatialVector
+{
+	btVector3	m_top;
+	btVector3	m_bottom;
+
+	SIMD_FORCE_INLINE btSpatialVector()
+	{
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector(const btVector3& top,const btVector3& bottom)
+		:m_top(top),
+		m_bottom(bottom)
+	{
+	}
+
+	SIMD_FORCE_INLINE void	setZero()
+	{
+		m_top.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+		m_bottom.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector& operator+=(const btSpatialVector& other)
+	{
+		m_top += other.m_top;
+		m_bottom += other.m_bottom;
+		return *this;
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector& operator-=(const btSpatialVector& other)
+	{
+		m_top -= other.m_top;
+		m_bottom -= other.m_bottom;
+		return *this;
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector operator+(const btSpatialVector& other) const
+	{
+		return btSpatialVector(m_top+other.m_top,m_bottom+other.m_bottom);
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector operator-(const btSpatialVector& other) const
+	{
+		return btSpatialVector(m_top-other.m_top,m_bottom-other.m_bottom);
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector operator-() const
+	{
+		return btSpatialVector(-m_top,-m_bottom);
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector operator*(btScalar s) const
+	{
+		return btSpatialVector(m_top*s,m_bottom*s);
+	}
+
+	///pairing of a motion vector with a force vector (power)
+	SIMD_FORCE_INLINE btScalar	dot(const btSpatialVector& other) const
+	{
+		return m_top.dot(other.m_top) + m_bottom.dot(other.m_bottom);
+	}
+
+	///motion x motion cross product
+	SIMD_FORCE_INLINE btSpatialVector	crossMotion(const btSpatialVector& m) const
+	{
+		return btSpatialVector(m_top.cross(m.m_top),m_top.cross(m.m_bottom) + m_bottom.cross(m.m_top));
+	}
+
+	///motion x force cross product
+	SIMD_FORCE_INLINE btSpatialVector	crossForce(const btSpatialVector& f) const
+	{
+		return btSpatialVector(m_top.cross(f.m_top) + m_bottom.cross(f.m_bottom),m_top.cross(f.m_bottom));
+	}
+};
+
+SIMD_FORCE_INLINE btMatrix3x3	btSpatialOuterProduct(const btVector3& a,const btVector3& b)
+{
+	return btMatrix3x3(	a.x()*b.x(),a.x()*b.y(),a.x()*b.z(),
+						a.y()*b.x(),a.y()*b.y(),a.y()*b.z(),
+						a.z()*b.x(),a.z()*b.y(),a.z()*b.z());
+}
+
+SIMD_FORCE_INLINE btMatrix3x3	btSpatialSkew(const btVector3& v)
+{
+	return btMatrix3x3(	btScalar(0.),-v.z(),v.y(),
+						v.z(),btScalar(0.),-v.x(),
+						-v.y(),v.x(),btScalar(0.));
+}
+
+///6x6 spatial (articulated) inertia, stored as four 3x3 blocks. It maps motion vectors to force vectors.
+ATTRIBUTE_ALIGNED16(struct) btSpatialInertia
+{
+	btMatrix3x3	m_topLeft;
+	btMatrix3x3	m_topRight;
+	btMatrix3x3	m_bottomLeft;
+	btMatrix3x3	m_bottomRight;
+
+	btSpatialInertia()
+	{
+		setZero();
+	}
+
+	void	setZero()
+	{
+		m_topLeft.setValue(0,0,0, 0,0,0, 0,0,0);
+		m_topRight.setValue(0,0,0, 0,0,0, 0,0,0);
+		m_bottomLeft.setValue(0,0,0, 0,0,0, 0,0,0);
+		m_bottomRight.setValue(0,0,0, 0,0,0, 0,0,0);
+	}
+
+	///rigid body inertia about the center of mass, with a diagonal local inertia tensor
+	void	setRigidBody(btScalar mass,const btVector3& inertiaDiag)
+	{
+		m_topLeft.setValue(inertiaDiag.x(),0,0, 0,inertiaDiag.y(),0, 0,0,inertiaDiag.z());
+		m_topRight.setValue(0,0,0, 0,0,0, 0,0,0);
+		m_bottomLeft.setValue(0,0,0, 0,0,0, 0,0,0);
+		m_bottomRight.setValue(mass,0,0, 0,mass,0, 0,0,mass);
+	}
+
+	SIMD_FORCE_INLINE btSpatialVector	operator*(const btSpatialVector& m) const
+	{
+		return btSpatialVector(m_topLeft*m.m_top + m_topRight*m.m_bottom,m_bottomLeft*m.m_top + m_bottomRight*m.m_bottom);
+	}
+
+	///subtract the rank one update a*b^T
+	SIMD_FORCE_INLINE void	subtractOuterProduct(const btSpatialVector& a,const btSpatialVector& b)
+	{
+		m_topLeft -= btSpatialOuterProduct(a.m_top,b.m_top);
+		m_topRight -= btSpatialOuterProduct(a.m_top,b.m_bottom);
+		m_bottomLeft -= btSpatialOuterProduct(a.m_bottom,b.m_top);
+		m_bottomRight -= btSpatialOuterProduct(a.m_bottom,b.m_bottom);
+	}
+
+	///adds X^T * inertia * X, where X transforms motion vectors from the parent frame into the child frame.
+	///rot rotates parent vectors into the child frame, r is the offset from parent origin to child origin in the child frame.
+	void	addTransformedToParent(const btSpatialInertia& inertia,const btMatrix3x3& rot,const btVector3& r)
+	{
+		btMatrix3x3 skew = btSpatialSkew(r);
+		btMatrix3x3 skewRot = skew*rot;
+		btMatrix3x3 p11 = inertia.m_topLeft*rot - inertia.m_topRight*skewRot;
+		btMatrix3x3 p12 = inertia.m_topRight*rot;
+		btMatrix3x3 p21 = inertia.m_bottomLeft*rot - inertia.m_bottomRight*skewRot;
+		btMatrix3x3 p22 = inertia.m_bottomRight*rot;
+		m_topLeft += rot.transposeTimes(p11 + skew*p21);
+		m_topRight += rot.transposeTimes(p12 + skew*p22);
+		m_bottomLeft += rot.transposeTimes(p21);
+		m_bottomRight += rot.transposeTimes(p22);
+	}
+};
+
+///transform a motion vector from the parent frame into the child frame
+SIMD_FORCE_INLINE btSpatialVector	btSpatialTransformMotion(const btMatrix3x3& rot,const btVector3& r,const btSpatialVector& m)
+{
+	btVector3 top = rot*m.m_top;
+	return btSpatialVector(top,rot*m.m_bottom - r.cross(top));
+}
+
+///transform a force vector from the child frame into the parent frame
+SIMD_FORCE_INLINE btSpatialVector	btSpatialTransformForceToParent(const btMatrix3x3& rot,const btVector3& r,const btSpatialVector& f)
+{
+	return btSpatialVector((f.m_top + r.cross(f.m_bottom))*rot,f.m_bottom*rot);
+}
+
+#endif //BT_SPATIAL_ALGEBRA_H
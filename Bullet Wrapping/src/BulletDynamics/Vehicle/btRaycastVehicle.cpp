@@ -25,10 +25,10 @@
 #define ROLLING_INFLUENCE_FIX
 
 
+///the body is shared by all worlds and only set up once, the solvers don't write to it (see btSequentialImpulseConstraintSolver::m_fixedBody)
 btRigidBody& btActionInterface::getFixedBody()
 {
 	static btRigidBody s_fixed(0, 0,0);
-	s_fixed.setMassProps(btScalar(0.),btVector3(btScalar(0.),btScalar(0.),btScalar(0.)));
 	return s_fixed;
 }
 
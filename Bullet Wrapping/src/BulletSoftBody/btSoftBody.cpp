@@ -18,6 +18,7 @@ subject to the following restrictions:
 #include "BulletSoftBody/btSoftBodySolvers.h"
 #include "btSoftBodyData.h"
 #include "LinearMath/btSerializer.h"
+#include "LinearMath/btThreads.h"
 
 //
 btSoftBody::btSoftBody(btSoftBodyWorldInfo*	worldInfo,int node_count,  const btVector3* x,  const btScalar* m)
@@ -625,6 +626,31 @@ void			btSoftBody::translate(const btVector3& trs)
 	transform(t);
 }
 
+//
+void			btSoftBody::shiftOrigin(const btVector3& shift)
+{
+	int i,ni;
+	for(i=0,ni=m_nodes.size();i<ni;++i)
+	{
+		Node&	n=m_nodes[i];
+		n.m_x-=shift;
+		n.m_q-=shift;
+	}
+	for(i=0,ni=m_clusters.size();i<ni;++i)
+	{
+		Cluster&	c=*m_clusters[i];
+		c.m_com-=shift;
+		c.m_framexform.getOrigin()-=shift;
+	}
+	m_ndbvt.translate(-shift);
+	m_fdbvt.translate(-shift);
+	m_cdbvt.translate(-shift);
+	m_pose.m_com-=shift;
+	m_bounds[0]-=shift;
+	m_bounds[1]-=shift;
+	m_initialWorldTransform.getOrigin()-=shift;
+}
+
 //
 void			btSoftBody::rotate(	const btQuaternion& rot)
 {
@@ -809,13 +835,14 @@ void			btSoftBody::clusterDCImpulse(Cluster* cluster,const btVector3& impulse)
 	cluster->m_ndimpulses++;
 }
 
-struct NodeLinks
+struct btIntLessPredicate
 {
-    btAlignedObjectArray<int> m_links;
+	bool operator() (int a,int b) const
+	{
+		return a<b;
+	}
 };
 
-
-
 //
 int				btSoftBody::generateBendingConstraints(int distance,Material* mat)
 {
@@ -823,114 +850,76 @@ int				btSoftBody::generateBendingConstraints(int distance,Material* mat)
 
 	if(distance>1)
 	{
-		/* Build graph	*/ 
-		const int		n=m_nodes.size();
-		const unsigned	inf=(~(unsigned)0)>>1;
-		unsigned*		adj=new unsigned[n*n];
-		
-
-#define IDX(_x_,_y_)	((_y_)*n+(_x_))
-		for(j=0;j<n;++j)
+		/* Build graph, adjacency lists of the existing links	*/ 
+		const int					n=m_nodes.size();
+		const int					nl=m_links.size();
+		btAlignedObjectArray<int>	offsets;
+		btAlignedObjectArray<int>	fill;
+		btAlignedObjectArray<int>	adjacent;
+		offsets.resize(n+1,0);
+		adjacent.resize(nl*2);
+		for(i=0;i<nl;++i)
 		{
-			for(i=0;i<n;++i)
-			{
-				if(i!=j)
-				{
-					adj[IDX(i,j)]=adj[IDX(j,i)]=inf;
-				}
-				else
-				{
-					adj[IDX(i,j)]=adj[IDX(j,i)]=0;
-				}
-			}
+			++offsets[int(m_links[i].m_n[0]-&m_nodes[0])+1];
+			++offsets[int(m_links[i].m_n[1]-&m_nodes[0])+1];
 		}
-		for( i=0;i<m_links.size();++i)
+		for(i=0;i<n;++i)
 		{
-			const int	ia=(int)(m_links[i].m_n[0]-&m_nodes[0]);
-			const int	ib=(int)(m_links[i].m_n[1]-&m_nodes[0]);
-			adj[IDX(ia,ib)]=1;
-			adj[IDX(ib,ia)]=1;
+			offsets[i+1]+=offsets[i];
 		}
-
-
-		//special optimized case for distance == 2
-		if (distance == 2)
+		fill.copyFromArray(offsets);
+		for(i=0;i<nl;++i)
 		{
+			const int	ia=int(m_links[i].m_n[0]-&m_nodes[0]);
+			const int	ib=int(m_links[i].m_n[1]-&m_nodes[0]);
+			adjacent[fill[ia]++]=ib;
+			adjacent[fill[ib]++]=ia;
+		}
 
-			btAlignedObjectArray<NodeLinks> nodeLinks;
-
-
-			/* Build node links */
-			nodeLinks.resize(m_nodes.size());
-
-			for( i=0;i<m_links.size();++i)
-			{
-				const int	ia=(int)(m_links[i].m_n[0]-&m_nodes[0]);
-				const int	ib=(int)(m_links[i].m_n[1]-&m_nodes[0]);
-				if (nodeLinks[ia].m_links.findLinearSearch(ib)==nodeLinks[ia].m_links.size())
-					nodeLinks[ia].m_links.push_back(ib);
-
-				if (nodeLinks[ib].m_links.findLinearSearch(ia)==nodeLinks[ib].m_links.size())
-					nodeLinks[ib].m_links.push_back(ia);
-			}
-			for (int ii=0;ii<nodeLinks.size();ii++)
+		/* Breadth first search from each node, up to distance links deep.
+		Links the node to the nodes after it at exactly that graph distance, the memory stays linear in the mesh size	*/ 
+		btAlignedObjectArray<int>	depth;
+		btAlignedObjectArray<int>	queue;
+		btAlignedObjectArray<int>	found;
+		depth.resize(n,-1);
+		int	nlinks=0;
+		for(j=0;j<n;++j)
+		{
+			queue.resize(0);
+			found.resize(0);
+			queue.push_back(j);
+			depth[j]=0;
+			for(int q=0;q<queue.size();++q)
 			{
-				int i=ii;
-
-				for (int jj=0;jj<nodeLinks[ii].m_links.size();jj++)
+				const int	node=queue[q];
+				const int	d=depth[node];
+				if(d==distance)
 				{
-					int k = nodeLinks[ii].m_links[jj];
-					for (int kk=0;kk<nodeLinks[k].m_links.size();kk++)
-					{
-						int j = nodeLinks[k].m_links[kk];
-						if (i!=j)
-						{
-							const unsigned	sum=adj[IDX(i,k)]+adj[IDX(k,j)];
-							btAssert(sum==2);
-							if(adj[IDX(i,j)]>sum)
-							{
-								adj[IDX(i,j)]=adj[IDX(j,i)]=sum;
-							}
-						}
-
-					}
+					if(node>j) found.push_back(node);
+					continue;
 				}
-			}
-		} else
-		{
-			///generic Floyd's algorithm
-			for(int k=0;k<n;++k)
-			{
-				for(j=0;j<n;++j)
+				for(int e=offsets[node];e<offsets[node+1];++e)
 				{
-					for(i=j+1;i<n;++i)
+					const int	other=adjacent[e];
+					if(depth[other]<0)
 					{
-						const unsigned	sum=adj[IDX(i,k)]+adj[IDX(k,j)];
-						if(adj[IDX(i,j)]>sum)
-						{
-							adj[IDX(i,j)]=adj[IDX(j,i)]=sum;
-						}
+						depth[other]=d+1;
+						queue.push_back(other);
 					}
 				}
 			}
-		}
-
-
-		/* Build links	*/ 
-		int	nlinks=0;
-		for(j=0;j<n;++j)
-		{
-			for(i=j+1;i<n;++i)
+			for(int q=0;q<queue.size();++q)
 			{
-				if(adj[IDX(i,j)]==(unsigned)distance)
-				{
-					appendLink(i,j,mat);
-					m_links[m_links.size()-1].m_bbending=1;
-					++nlinks;
-				}
+				depth[queue[q]]=-1;
+			}
+			found.quickSort(btIntLessPredicate());
+			for(i=0;i<found.size();++i)
+			{
+				appendLink(found[i],j,mat);
+				m_links[m_links.size()-1].m_bbending=1;
+				++nlinks;
 			}
 		}
-		delete[] adj;		
 		return(nlinks);
 	}
 	return(0);
@@ -971,7 +960,68 @@ void			btSoftBody::releaseClusters()
 }
 
 //
-int				btSoftBody::generateClusters(int k,int maxiterations)
+static inline unsigned	spreadBits10(unsigned x)
+{
+	x&=0x3ff;
+	x=(x|(x<<16))&0x030000FF;
+	x=(x|(x<<8))&0x0300F00F;
+	x=(x|(x<<4))&0x030C30C3;
+	x=(x|(x<<2))&0x09249249;
+	return(x);
+}
+
+struct	btClusterSeed
+{
+	unsigned	m_code;
+	int			m_node;
+};
+
+struct	btClusterSeedSortPredicate
+{
+	bool operator() (const btClusterSeed& a,const btClusterSeed& b) const
+	{
+		return (a.m_code<b.m_code)||((a.m_code==b.m_code)&&(a.m_node<b.m_node));
+	}
+};
+
+struct	btClusterAssignLoop : public btIParallelForBody
+{
+	const btSoftBody::Node*	m_nodes;
+	const btVector3*		m_centers;
+	int						m_numCenters;
+	int*					m_assignment;
+
+	btClusterAssignLoop(const btSoftBody::Node* nodes,const btVector3* centers,int numCenters,int* assignment)
+		:m_nodes(nodes),
+		m_centers(centers),
+		m_numCenters(numCenters),
+		m_assignment(assignment)
+	{
+	}
+
+	virtual void	forLoop(int iBegin,int iEnd) const
+	{
+		for(int i=iBegin;i<iEnd;++i)
+		{
+			const btVector3	nx=m_nodes[i].m_x;
+			int				kbest=0;
+			btScalar		kdist=ClusterMetric(m_centers[0],nx);
+			for(int j=1;j<m_numCenters;++j)
+			{
+				const btScalar	d=ClusterMetric(m_centers[j],nx);
+				if(d<kdist)
+				{
+					kbest=j;
+					kdist=d;
+				}
+			}
+			m_assignment[i]=kbest;
+		}
+	}
+};
+
+//
+int				btSoftBody::generateClusters(int k,int maxiterations,bool spatialSeeding)
 {
 	int i;
 	releaseClusters();
@@ -985,69 +1035,100 @@ int				btSoftBody::generateClusters(int k,int maxiterations)
 	if(k>0)
 	{
 		/* Initialize		*/ 
+		const int						n=m_nodes.size();
 		btAlignedObjectArray<btVector3>	centers;
-		btVector3						cog(0,0,0);
-		int								i;
-		for(i=0;i<m_nodes.size();++i)
+		btAlignedObjectArray<int>		assignment;
+		assignment.resize(n);
+		if(spatialSeeding)
+		{
+			/* the nodes are sorted along a space filling curve and split in k runs of equal size	*/ 
+			btAlignedObjectArray<btClusterSeed>	seeds;
+			btVector3						bmin=m_nodes[0].m_x;
+			btVector3						bmax=m_nodes[0].m_x;
+			for(i=1;i<n;++i)
+			{
+				bmin.setMin(m_nodes[i].m_x);
+				bmax.setMax(m_nodes[i].m_x);
+			}
+			const btVector3					extent=bmax-bmin;
+			const btScalar					scale=1023/btMax(btMax(extent.x(),extent.y()),btMax(extent.z(),SIMD_EPSILON));
+			seeds.resize(n);
+			for(i=0;i<n;++i)
+			{
+				const btVector3	q=(m_nodes[i].m_x-bmin)*scale;
+				seeds[i].m_code=(spreadBits10(unsigned(q.x()))<<2)|(spreadBits10(unsigned(q.y()))<<1)|spreadBits10(unsigned(q.z()));
+				seeds[i].m_node=i;
+			}
+			seeds.quickSort(btClusterSeedSortPredicate());
+			centers.resize(k,btVector3(0,0,0));
+			for(i=0;i<k;++i)
+			{
+				const int	begin=i*(n/k)+btMin(i,n%k);
+				const int	end=begin+n/k+(i<n%k?1:0);
+				for(int j=begin;j<end;++j)
+				{
+					centers[i]+=m_nodes[seeds[j].m_node].m_x;
+				}
+				centers[i]/=(btScalar)(end-begin);
+			}
+			btClusterAssignLoop	seedLoop(&m_nodes[0],&centers[0],k,&assignment[0]);
+			btParallelFor(0,n,256,seedLoop);
+		}
+		else
 		{
-			cog+=m_nodes[i].m_x;
-			m_clusters[(i*29873)%m_clusters.size()]->m_nodes.push_back(&m_nodes[i]);
+			/* all centers start at the center of mass, the nodes are spread over the clusters	*/ 
+			btVector3						cog(0,0,0);
+			for(i=0;i<n;++i)
+			{
+				cog+=m_nodes[i].m_x;
+				assignment[i]=(i*29873)%k;
+			}
+			cog/=(btScalar)n;
+			centers.resize(k,cog);
 		}
-		cog/=(btScalar)m_nodes.size();
-		centers.resize(k,cog);
-		/* Iterate			*/ 
+		/* Iterate, the nodes are assigned to the closest center in parallel	*/ 
+		btAlignedObjectArray<btVector3>	sums;
+		btAlignedObjectArray<int>		counts;
+		sums.resize(k);
+		counts.resize(k);
 		const btScalar	slope=16;
 		bool			changed;
 		int				iterations=0;
 		do	{
 			const btScalar	w=2-btMin<btScalar>(1,iterations/slope);
 			changed=false;
-			iterations++;	
-			int i;
+			iterations++;
 
 			for(i=0;i<k;++i)
 			{
-				btVector3	c(0,0,0);
-				for(int j=0;j<m_clusters[i]->m_nodes.size();++j)
-				{
-					c+=m_clusters[i]->m_nodes[j]->m_x;
-				}
-				if(m_clusters[i]->m_nodes.size())
+				sums[i].setValue(0,0,0);
+				counts[i]=0;
+			}
+			for(i=0;i<n;++i)
+			{
+				sums[assignment[i]]+=m_nodes[i].m_x;
+				counts[assignment[i]]++;
+			}
+			for(i=0;i<k;++i)
+			{
+				if(counts[i])
 				{
-					c			/=	(btScalar)m_clusters[i]->m_nodes.size();
+					btVector3	c=sums[i]/(btScalar)counts[i];
 					c			=	centers[i]+(c-centers[i])*w;
 					changed		|=	((c-centers[i]).length2()>SIMD_EPSILON);
 					centers[i]	=	c;
-					m_clusters[i]->m_nodes.resize(0);
-				}			
-			}
-			for(i=0;i<m_nodes.size();++i)
-			{
-				const btVector3	nx=m_nodes[i].m_x;
-				int				kbest=0;
-				btScalar		kdist=ClusterMetric(centers[0],nx);
-				for(int j=1;j<k;++j)
-				{
-					const btScalar	d=ClusterMetric(centers[j],nx);
-					if(d<kdist)
-					{
-						kbest=j;
-						kdist=d;
-					}
 				}
-				m_clusters[kbest]->m_nodes.push_back(&m_nodes[i]);
-			}		
+			}
+
+			btClusterAssignLoop	assignLoop(&m_nodes[0],&centers[0],k,&assignment[0]);
+			btParallelFor(0,n,256,assignLoop);
 		} while(changed&&(iterations<maxiterations));
-		/* Merge		*/ 
-		btAlignedObjectArray<int>	cids;
-		cids.resize(m_nodes.size(),-1);
-		for(i=0;i<m_clusters.size();++i)
+		for(i=0;i<n;++i)
 		{
-			for(int j=0;j<m_clusters[i]->m_nodes.size();++j)
-			{
-				cids[int(m_clusters[i]->m_nodes[j]-&m_nodes[0])]=i;
-			}
+			m_clusters[assignment[i]]->m_nodes.push_back(&m_nodes[i]);
 		}
+		/* Merge		*/ 
+		btHashMap<btSoftBodyPairKey,int>	merged;
 		for(i=0;i<m_faces.size();++i)
 		{
 			const int idx[]={	int(m_faces[i].m_n[0]-&m_nodes[0]),
@@ -1055,14 +1136,16 @@ int				btSoftBody::generateClusters(int k,int maxiterations)
 				int(m_faces[i].m_n[2]-&m_nodes[0])};
 			for(int j=0;j<3;++j)
 			{
-				const int cid=cids[idx[j]];
+				const int cid=assignment[idx[j]];
 				for(int q=1;q<3;++q)
 				{
 					const int kid=idx[(j+q)%3];
-					if(cids[kid]!=cid)
+					if(assignment[kid]!=cid)
 					{
-						if(m_clusters[cid]->m_nodes.findLinearSearch(&m_nodes[kid])==m_clusters[cid]->m_nodes.size())
+						const btSoftBodyPairKey	key(cid,kid);
+						if(!merged.find(key))
 						{
+							merged.insert(key,1);
 							m_clusters[cid]->m_nodes.push_back(&m_nodes[kid]);
 						}
 					}
@@ -1131,30 +1214,49 @@ int				btSoftBody::generateClusters(int k,int maxiterations)
 		updateClusters();
 
 
-		//for self-collision
-		m_clusterConnectivity.resize(m_clusters.size()*m_clusters.size());
+		//for self-collision, clusters are connected when they share a node.
+		//The clusters of each node are listed first, so this is linear in the total cluster size
+		const int					nc=m_clusters.size();
+		btAlignedObjectArray<int>	offsets;
+		btAlignedObjectArray<int>	fill;
+		btAlignedObjectArray<int>	nodeClusters;
+		offsets.resize(m_nodes.size()+1,0);
+		int c0,c1;
+		for (c0=0;c0<nc;c0++)
+		{
+			m_clusters[c0]->m_clusterIndex=c0;
+			for (i=0;i<m_clusters[c0]->m_nodes.size();i++)
+			{
+				++offsets[int(m_clusters[c0]->m_nodes[i]-&m_nodes[0])+1];
+			}
+		}
+		for (i=0;i<m_nodes.size();i++)
+		{
+			offsets[i+1]+=offsets[i];
+		}
+		fill.copyFromArray(offsets);
+		nodeClusters.resize(offsets[m_nodes.size()]);
+		for (c0=0;c0<nc;c0++)
+		{
+			for (i=0;i<m_clusters[c0]->m_nodes.size();i++)
+			{
+				nodeClusters[fill[int(m_clusters[c0]->m_nodes[i]-&m_nodes[0])]++]=c0;
+			}
+		}
+		m_clusterConnectivity.resize(nc*nc);
+		for (i=0;i<nc*nc;i++)
 		{
-			for (int c0=0;c0<m_clusters.size();c0++)
+			m_clusterConnectivity[i]=false;
+		}
+		for (i=0;i<m_nodes.size();i++)
+		{
+			for (int a=offsets[i];a<offsets[i+1];a++)
 			{
-				m_clusters[c0]->m_clusterIndex=c0;
-				for (int c1=0;c1<m_clusters.size();c1++)
+				c0=nodeClusters[a];
+				for (int b=offsets[i];b<offsets[i+1];b++)
 				{
-					
-					bool connected=false;
-					Cluster* cla = m_clusters[c0];
-					Cluster* clb = m_clusters[c1];
-					for (int i=0;!connected&&i<cla->m_nodes.size();i++)
-					{
-						for (int j=0;j<clb->m_nodes.size();j++)
-						{
-							if (cla->m_nodes[i] == clb->m_nodes[j])
-							{
-								connected=true;
-								break;
-							}
-						}
-					}
-					m_clusterConnectivity[c0+c1*m_clusters.size()]=connected;
+					c1=nodeClusters[b];
+					m_clusterConnectivity[c0+c1*nc]=true;
 				}
 			}
 		}
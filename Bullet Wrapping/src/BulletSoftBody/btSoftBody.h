@@ -797,6 +797,8 @@ public:
 	void				transform(		const btTransform& trs);
 	/* Translate															*/ 
 	void				translate(		const btVector3& trs);
+	/* Move by -shift, keeping the rest state (see btCollisionWorld::shiftOrigin) */
+	void				shiftOrigin(	const btVector3& shift);
 	/* Rotate															*/ 
 	void				rotate(	const btQuaternion& rot);
 	/* Scale																*/ 
@@ -832,7 +834,9 @@ public:
 	/* Generate clusters (K-mean)											*/ 
 	///generateClusters with k=0 will create a convex cluster for each tetrahedron or triangle
 	///otherwise an approximation will be used (better performance)
-	int					generateClusters(int k,int maxiterations=8192);
+	///The centers start at the center of mass. With spatialSeeding they start at k runs of nodes along a space filling curve instead,
+	///which converges in fewer iterations on large meshes but gives different clusters.
+	int					generateClusters(int k,int maxiterations=8192,bool spatialSeeding=false);
 	/* Refine																*/ 
 	void				refine(ImplicitFn* ifn,btScalar accurary,bool cut);
 	/* CutLink																*/ 
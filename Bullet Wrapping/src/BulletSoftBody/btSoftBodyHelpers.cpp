@@ -864,9 +864,8 @@ btSoftBody*		btSoftBodyHelpers::CreateFromTriMesh(btSoftBodyWorldInfo& worldInfo
 		maxidx=btMax(triangles[i],maxidx);
 	}
 	++maxidx;
-	btAlignedObjectArray<bool>		chks;
+	btHashMap<btSoftBodyPairKey,int>	edges;
 	btAlignedObjectArray<btVector3>	vtx;
-	chks.resize(maxidx*maxidx,false);
 	vtx.resize(maxidx);
 	for(i=0,j=0,ni=maxidx*3;i<ni;++j,i+=3)
 	{
@@ -876,17 +875,15 @@ btSoftBody*		btSoftBodyHelpers::CreateFromTriMesh(btSoftBodyWorldInfo& worldInfo
 	for( i=0,ni=ntriangles*3;i<ni;i+=3)
 	{
 		const int idx[]={triangles[i],triangles[i+1],triangles[i+2]};
-#define IDX(_x_,_y_) ((_y_)*maxidx+(_x_))
 		for(int j=2,k=0;k<3;j=k++)
 		{
-			if(!chks[IDX(idx[j],idx[k])])
+			const btSoftBodyPairKey	edge(btMin(idx[j],idx[k]),btMax(idx[j],idx[k]));
+			if(!edges.find(edge))
 			{
-				chks[IDX(idx[j],idx[k])]=true;
-				chks[IDX(idx[k],idx[j])]=true;
+				edges.insert(edge,1);
 				psb->appendLink(idx[j],idx[k]);
 			}
 		}
-#undef IDX
 		psb->appendFace(idx[0],idx[1],idx[2]);
 	}
 
@@ -21,6 +21,7 @@ subject to the following restrictions:
 
 
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btHashMap.h"
 #include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
 #include "BulletCollision/CollisionShapes/btConvexInternalShape.h"
@@ -42,6 +43,18 @@ struct btSymMatrix
 	int						dim;
 };	
 
+//
+// btSoftBodyPairKey, btHashMap key for a pair of indices
+//
+struct	btSoftBodyPairKey
+{
+	int		m_first;
+	int		m_second;
+	btSoftBodyPairKey(int first,int second) : m_first(first),m_second(second)	{}
+	bool					equals(const btSoftBodyPairKey& other) const	{ return(m_first==other.m_first&&m_second==other.m_second); }
+	unsigned int			getHash() const									{ return(btHashInt(int(unsigned(m_first)*0x9E3779B1u^unsigned(m_second))).getHash()); }
+};
+
 //
 // btSoftBodyCollisionShape
 //
@@ -155,6 +155,26 @@ void	btSoftRigidDynamicsWorld::removeCollisionObject(btCollisionObject* collisio
 		btDiscreteDynamicsWorld::removeCollisionObject(collisionObject);
 }
 
+void	btSoftRigidDynamicsWorld::removeCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects)
+{
+	for (int i=0;i<numObjects;i++)
+	{
+		btSoftBody* body = btSoftBody::upcast(collisionObjects[i]);
+		if (body)
+			m_softBodies.remove(body);
+	}
+	btDiscreteDynamicsWorld::removeCollisionObjects(collisionObjects,numObjects);
+}
+
+void	btSoftRigidDynamicsWorld::shiftOrigin(const btVector3& shift)
+{
+	for (int i=0;i<m_softBodies.size();i++)
+	{
+		m_softBodies[i]->shiftOrigin(shift);
+	}
+	btDiscreteDynamicsWorld::shiftOrigin(shift);
+}
+
 void	btSoftRigidDynamicsWorld::debugDrawWorld()
 {
 	btDiscreteDynamicsWorld::debugDrawWorld();
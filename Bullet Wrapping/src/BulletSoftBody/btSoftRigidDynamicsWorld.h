@@ -61,6 +61,12 @@ public:
 	///removeCollisionObject will first check if it is a rigid body, if so call removeRigidBody otherwise call btDiscreteDynamicsWorld::removeCollisionObject
 	virtual void	removeCollisionObject(btCollisionObject* collisionObject);
 
+	///removes the soft bodies among the objects from the soft body array, then removes all objects like btDiscreteDynamicsWorld::removeCollisionObjects
+	virtual void	removeCollisionObjects(btCollisionObject* const* collisionObjects,int numObjects);
+
+	///moves the soft body nodes by -shift, then the other collision objects
+	virtual void	shiftOrigin(const btVector3& shift);
+
 	int		getDrawFlags() const { return(m_drawFlags); }
 	void	setDrawFlags(int f)	{ m_drawFlags=f; }
 
@@ -14,6 +14,7 @@ subject to the following restrictions:
 */
 
 #include "btAlignedAllocator.h"
+#include "btThreads.h"
 
 int gNumAlignedAllocs = 0;
 int gNumAlignedFree = 0;
@@ -112,8 +113,8 @@ void*   btAlignedAllocInternal  (size_t size, int alignment,int line,char* filen
  char *real;
  unsigned long offset;
 
- gTotalBytesAlignedAllocs += size;
- gNumAlignedAllocs++;
+ btAtomicAdd(gTotalBytesAlignedAllocs,int(size));
+ btAtomicAdd(gNumAlignedAllocs,1);
 
  
  real = (char *)sAllocFunc(size + 2*sizeof(void *) + (alignment-1));
@@ -139,12 +140,12 @@ void    btAlignedFreeInternal   (void* ptr,int line,char* filename)
 {
 
  void* real;
- gNumAlignedFree++;
+ btAtomicAdd(gNumAlignedFree,1);
 
  if (ptr) {
    real = *((void **)(ptr)-1);
        int size = *((int*)(ptr)-2);
-       gTotalBytesAlignedAllocs -= size;
+       btAtomicAdd(gTotalBytesAlignedAllocs,-int(size));
 
 	   printf("free #%d at address %x, from %s,line %d, size %d\n",gNumAlignedFree,real, filename,line,size);
 
@@ -159,7 +160,7 @@ void    btAlignedFreeInternal   (void* ptr,int line,char* filename)
 
 void*	btAlignedAllocInternal	(size_t size, int alignment)
 {
-	gNumAlignedAllocs++;
+	btAtomicAdd(gNumAlignedAllocs,1);
 	void* ptr;
 	ptr = sAlignedAllocFunc(size, alignment);
 //	printf("btAlignedAllocInternal %d, %x\n",size,ptr);
@@ -173,7 +174,7 @@ void	btAlignedFreeInternal	(void* ptr)
 		return;
 	}
 
-	gNumAlignedFree++;
+	btAtomicAdd(gNumAlignedFree,1);
 //	printf("btAlignedFreeInternal %x\n",ptr);
 	sAlignedFreeFunc(ptr);
 }
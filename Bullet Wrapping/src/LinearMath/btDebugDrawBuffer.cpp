@@ -0,0 +1,155 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btDebugDrawBuffer.h"
+#include "btAlignedAllocator.h"
+
+#include <string.h>
+#include <new>
+
+///the 12 edges of a box, as pairs of corner indices. Bit 0, 1 and 2 of a corner index select the maximum x, y and z.
+static const int sBoxEdges[12][2] =
+{
+	{0,1},{1,3},{3,2},{2,0},
+	{4,5},{5,7},{7,6},{6,4},
+	{0,4},{1,5},{3,7},{2,6}
+};
+
+void	btDebugDrawLineArray::drawSphere(btScalar radius,const btTransform& transform,const btVector3& color)
+{
+	const btVector3& start = transform.getOrigin();
+	const btVector3 xoffs = transform.getBasis() * btVector3(radius,0,0);
+	const btVector3 yoffs = transform.getBasis() * btVector3(0,radius,0);
+	const btVector3 zoffs = transform.getBasis() * btVector3(0,0,radius);
+
+	btDebugDrawVertex* v = allocateVertices(24);
+
+	// XY
+	setVertex(v[0],start-xoffs,color);	setVertex(v[1],start+yoffs,color);
+	setVertex(v[2],start+yoffs,color);	setVertex(v[3],start+xoffs,color);
+	setVertex(v[4],start+xoffs,color);	setVertex(v[5],start-yoffs,color);
+	setVertex(v[6],start-yoffs,color);	setVertex(v[7],start-xoffs,color);
+
+	// XZ
+	setVertex(v[8],start-xoffs,color);	setVertex(v[9],start+zoffs,color);
+	setVertex(v[10],start+zoffs,color);	setVertex(v[11],start+xoffs,color);
+	setVertex(v[12],start+xoffs,color);	setVertex(v[13],start-zoffs,color);
+	setVertex(v[14],start-zoffs,color);	setVertex(v[15],start-xoffs,color);
+
+	// YZ
+	setVertex(v[16],start-yoffs,color);	setVertex(v[17],start+zoffs,color);
+	setVertex(v[18],start+zoffs,color);	setVertex(v[19],start+yoffs,color);
+	setVertex(v[20],start+yoffs,color);	setVertex(v[21],start-zoffs,color);
+	setVertex(v[22],start-zoffs,color);	setVertex(v[23],start-yoffs,color);
+}
+
+void	btDebugDrawLineArray::drawAabb(const btVector3& from,const btVector3& to,const btVector3& color)
+{
+	btVector3 corners[8];
+	for (int i=0;i<8;i++)
+	{
+		corners[i].setValue((i&1) ? to.getX() : from.getX(),(i&2) ? to.getY() : from.getY(),(i&4) ? to.getZ() : from.getZ());
+	}
+	btDebugDrawVertex* v = allocateVertices(24);
+	for (int e=0;e<12;e++)
+	{
+		setVertex(v[2*e],corners[sBoxEdges[e][0]],color);
+		setVertex(v[2*e+1],corners[sBoxEdges[e][1]],color);
+	}
+}
+
+void	btDebugDrawLineArray::drawBox(const btVector3& bbMin,const btVector3& bbMax,const btTransform& trans,const btVector3& color)
+{
+	btVector3 corners[8];
+	for (int i=0;i<8;i++)
+	{
+		corners[i] = trans * btVector3((i&1) ? bbMax.getX() : bbMin.getX(),(i&2) ? bbMax.getY() : bbMin.getY(),(i&4) ? bbMax.getZ() : bbMin.getZ());
+	}
+	btDebugDrawVertex* v = allocateVertices(24);
+	for (int e=0;e<12;e++)
+	{
+		setVertex(v[2*e],corners[sBoxEdges[e][0]],color);
+		setVertex(v[2*e+1],corners[sBoxEdges[e][1]],color);
+	}
+}
+
+void	btDebugDrawLineArray::drawTransform(const btTransform& transform,btScalar orthoLen)
+{
+	const btVector3& start = transform.getOrigin();
+	const btMatrix3x3& basis = transform.getBasis();
+	btDebugDrawVertex* v = allocateVertices(6);
+	setVertex(v[0],start,btVector3(btScalar(0.7),0,0));
+	setVertex(v[1],start+basis.getColumn(0)*orthoLen,btVector3(btScalar(0.7),0,0));
+	setVertex(v[2],start,btVector3(0,btScalar(0.7),0));
+	setVertex(v[3],start+basis.getColumn(1)*orthoLen,btVector3(0,btScalar(0.7),0));
+	setVertex(v[4],start,btVector3(0,0,btScalar(0.7)));
+	setVertex(v[5],start+basis.getColumn(2)*orthoLen,btVector3(0,0,btScalar(0.7)));
+}
+
+void	btDebugDrawLineArray::appendLines(const btDebugDrawLineArray& other)
+{
+	int numVertices = other.getNumVertices();
+	if (numVertices)
+	{
+		btDebugDrawVertex* v = allocateVertices(numVertices);
+		memcpy(v,other.getVertices(),sizeof(btDebugDrawVertex)*numVertices);
+	}
+}
+
+
+btDebugDrawBuffer::btDebugDrawBuffer()
+	:m_staticLinesKey(0),
+	m_staticLinesValid(false),
+	m_staticRevision(0)
+{
+}
+
+btDebugDrawBuffer::~btDebugDrawBuffer()
+{
+	for (int i=0;i<m_taskLines.size();i++)
+	{
+		m_taskLines[i]->~btDebugDrawLineArray();
+		btAlignedFree(m_taskLines[i]);
+	}
+}
+
+void	btDebugDrawBuffer::flush()
+{
+	flushLines(m_staticLines.getVertices(),m_staticLines.getNumVertices(),m_staticRevision,getVertices(),getNumVertices());
+	clear();
+}
+
+void	btDebugDrawBuffer::prepareTaskLines(int numTasks)
+{
+	while (m_taskLines.size() < numTasks)
+	{
+		void* mem = btAlignedAlloc(sizeof(btDebugDrawLineArray),16);
+		m_taskLines.push_back(new (mem) btDebugDrawLineArray());
+	}
+	m_staticLines.setDebugMode(m_debugMode);
+	for (int i=0;i<numTasks;i++)
+	{
+		m_taskLines[i]->setDebugMode(m_debugMode);
+		m_taskLines[i]->clear();
+	}
+}
+
+void	btDebugDrawBuffer::gatherTaskLines(int numTasks,btDebugDrawLineArray& target)
+{
+	for (int i=0;i<numTasks;i++)
+	{
+		target.appendLines(*m_taskLines[i]);
+	}
+}
@@ -0,0 +1,235 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_DEBUG_DRAW_BUFFER_H
+#define BT_DEBUG_DRAW_BUFFER_H
+
+#include "btIDebugDraw.h"
+#include "btAlignedObjectArray.h"
+#include "btMinMax.h"
+
+///vertex of a debug line, in single precision so it can be uploaded to a vertex buffer as is
+struct	btDebugDrawVertex
+{
+	float	m_position[3];
+	float	m_color[3];
+};
+
+///btDebugDrawLineArray appends all lines to a contiguous vertex array, two vertices per line.
+///Text and error warnings are ignored. It is not thread safe, each thread needs its own line array.
+class	btDebugDrawLineArray : public btIDebugDraw
+{
+protected:
+
+	btAlignedObjectArray<btDebugDrawVertex>	m_vertices;
+	int		m_debugMode;
+
+	SIMD_FORCE_INLINE static void	setVertex(btDebugDrawVertex& vertex,const btVector3& position,const btVector3& color)
+	{
+		vertex.m_position[0] = float(position.getX());
+		vertex.m_position[1] = float(position.getY());
+		vertex.m_position[2] = float(position.getZ());
+		vertex.m_color[0] = float(color.getX());
+		vertex.m_color[1] = float(color.getY());
+		vertex.m_color[2] = float(color.getZ());
+	}
+
+	///grows the array by numVertices and returns the first new vertex, the capacity is doubled so appending is amortized constant time
+	btDebugDrawVertex*	allocateVertices(int numVertices)
+	{
+		int size = m_vertices.size();
+		if (size+numVertices > m_vertices.capacity())
+		{
+			m_vertices.reserve(btMax(size+numVertices,2*m_vertices.capacity()));
+		}
+		m_vertices.resize(size+numVertices);
+		return &m_vertices[size];
+	}
+
+public:
+
+	btDebugDrawLineArray()
+		:m_debugMode(DBG_DrawWireframe)
+	{
+	}
+
+	virtual ~btDebugDrawLineArray()
+	{
+	}
+
+	SIMD_FORCE_INLINE void	addLine(const btVector3& from,const btVector3& to,const btVector3& fromColor,const btVector3& toColor)
+	{
+		btDebugDrawVertex* v = allocateVertices(2);
+		setVertex(v[0],from,fromColor);
+		setVertex(v[1],to,toColor);
+	}
+
+	virtual void	drawLine(const btVector3& from,const btVector3& to,const btVector3& color)
+	{
+		addLine(from,to,color,color);
+	}
+
+	virtual void	drawLine(const btVector3& from,const btVector3& to,const btVector3& fromColor,const btVector3& toColor)
+	{
+		addLine(from,to,fromColor,toColor);
+	}
+
+	virtual void	drawSphere(btScalar radius,const btTransform& transform,const btVector3& color);
+
+	virtual void	drawSphere(const btVector3& p,btScalar radius,const btVector3& color)
+	{
+		btIDebugDraw::drawSphere(p,radius,color);
+	}
+
+	virtual void	drawAabb(const btVector3& from,const btVector3& to,const btVector3& color);
+
+	virtual void	drawBox(const btVector3& bbMin,const btVector3& bbMax,const btVector3& color)
+	{
+		drawAabb(bbMin,bbMax,color);
+	}
+
+	virtual void	drawBox(const btVector3& bbMin,const btVector3& bbMax,const btTransform& trans,const btVector3& color);
+
+	virtual void	drawTransform(const btTransform& transform,btScalar orthoLen);
+
+	///draws the contact normal, with unit length
+	virtual void	drawContactPoint(const btVector3& PointOnB,const btVector3& normalOnB,btScalar distance,int lifeTime,const btVector3& color)
+	{
+		(void)distance;
+		(void)lifeTime;
+		addLine(PointOnB,PointOnB+normalOnB,color,color);
+	}
+
+	virtual void	reportErrorWarning(const char* warningString)
+	{
+		(void)warningString;
+	}
+
+	virtual void	draw3dText(const btVector3& location,const char* textString)
+	{
+		(void)location;
+		(void)textString;
+	}
+
+	virtual void	setDebugMode(int debugMode)
+	{
+		m_debugMode = debugMode;
+	}
+
+	virtual int		getDebugMode() const
+	{
+		return m_debugMode;
+	}
+
+	///removes all lines but keeps the capacity
+	void	clear()
+	{
+		m_vertices.resize(0);
+	}
+
+	void	appendLines(const btDebugDrawLineArray& other);
+
+	int		getNumVertices() const
+	{
+		return m_vertices.size();
+	}
+
+	const btDebugDrawVertex*	getVertices() const
+	{
+		return m_vertices.size() ? &m_vertices[0] : 0;
+	}
+};
+
+///btDebugDrawBuffer is a retained mode debug drawer. Instead of a virtual drawLine call per line into the renderer,
+///the lines are collected in vertex arrays and handed to the renderer with a single flushLines call per frame.
+///When it is the debug drawer of a btCollisionWorld, debugDrawWorld generates the collision object lines in parallel with btParallelFor,
+///and keeps the lines of the static objects in a separate array that is only regenerated when a static object changed.
+///Typical use: derive from btDebugDrawBuffer, implement flushLines, and call flush after debugDrawWorld.
+class	btDebugDrawBuffer : public btDebugDrawLineArray
+{
+protected:
+
+	btDebugDrawLineArray	m_staticLines;
+	unsigned int	m_staticLinesKey;
+	bool	m_staticLinesValid;
+	int		m_staticRevision;
+
+	btAlignedObjectArray<btDebugDrawLineArray*>	m_taskLines;
+
+public:
+
+	btDebugDrawBuffer();
+
+	virtual ~btDebugDrawBuffer();
+
+	virtual btDebugDrawBuffer*	getDebugDrawBuffer()
+	{
+		return this;
+	}
+
+	///called by flush with the cached lines of the static objects and the lines drawn since the last flush, two vertices per line.
+	///staticRevision changes whenever the static lines were regenerated, so the renderer can keep them in a vertex buffer of its own.
+	virtual void	flushLines(const btDebugDrawVertex* staticVertices,int numStaticVertices,int staticRevision,const btDebugDrawVertex* vertices,int numVertices) = 0;
+
+	///hands all lines to flushLines, and clears the lines that are not cached
+	void	flush();
+
+	btDebugDrawLineArray&	getStaticLines()
+	{
+		return m_staticLines;
+	}
+
+	const btDebugDrawLineArray&	getStaticLines() const
+	{
+		return m_staticLines;
+	}
+
+	///the key summarizes the static objects that were drawn into the static lines
+	bool	isStaticLinesValid(unsigned int key) const
+	{
+		return m_staticLinesValid && m_staticLinesKey == key;
+	}
+
+	void	setStaticLinesKey(unsigned int key)
+	{
+		m_staticLinesKey = key;
+		m_staticLinesValid = true;
+		m_staticRevision++;
+	}
+
+	///forces the static lines to be regenerated, for changes that the key doesn't cover, such as editing the mesh of a static object
+	void	invalidateStaticLines()
+	{
+		m_staticLinesValid = false;
+	}
+
+	int		getStaticRevision() const
+	{
+		return m_staticRevision;
+	}
+
+	///makes sure there is a line array for each of numTasks parallel tasks, with the debug mode of this buffer. Not thread safe.
+	void	prepareTaskLines(int numTasks);
+
+	btDebugDrawLineArray*	getTaskLines(int task)
+	{
+		return m_taskLines[task];
+	}
+
+	///appends the lines of the first numTasks tasks to target, in task order
+	void	gatherTaskLines(int numTasks,btDebugDrawLineArray& target);
+};
+
+#endif //BT_DEBUG_DRAW_BUFFER_H
@@ -20,6 +20,7 @@ subject to the following restrictions:
 #include "btVector3.h"
 #include "btTransform.h"
 
+class	btDebugDrawBuffer;
 
 ///The btIDebugDraw interface class allows hooking up a debug renderer to visually debug simulations.
 ///Typical use case: create a debug drawer object, and assign it to a btCollisionWorld or btDynamicsWorld using setDebugDrawer and call debugDrawWorld.
@@ -115,6 +116,12 @@ class	btIDebugDraw
 	
 	virtual int		getDebugMode() const = 0;
 
+	///returns the drawer when it is a btDebugDrawBuffer, which lets btCollisionWorld::debugDrawWorld generate the lines in parallel
+	virtual btDebugDrawBuffer*	getDebugDrawBuffer()
+	{
+		return 0;
+	}
+
 	virtual void drawAabb(const btVector3& from,const btVector3& to,const btVector3& color)
 	{
 
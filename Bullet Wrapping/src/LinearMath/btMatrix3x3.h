@@ -527,15 +527,29 @@ public:
 SIMD_FORCE_INLINE btMatrix3x3& 
 btMatrix3x3::operator*=(const btMatrix3x3& m)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btSimdFloat4 m0 = m.m_el[0].mVec128;
+	btSimdFloat4 m1 = m.m_el[1].mVec128;
+	btSimdFloat4 m2 = m.m_el[2].mVec128;
+	m_el[0].mVec128 = btSimdCombine3(m0,m1,m2,m_el[0].mVec128);
+	m_el[1].mVec128 = btSimdCombine3(m0,m1,m2,m_el[1].mVec128);
+	m_el[2].mVec128 = btSimdCombine3(m0,m1,m2,m_el[2].mVec128);
+#else
 	setValue(m.tdotx(m_el[0]), m.tdoty(m_el[0]), m.tdotz(m_el[0]),
 		m.tdotx(m_el[1]), m.tdoty(m_el[1]), m.tdotz(m_el[1]),
 		m.tdotx(m_el[2]), m.tdoty(m_el[2]), m.tdotz(m_el[2]));
+#endif
 	return *this;
 }
 
 SIMD_FORCE_INLINE btMatrix3x3& 
 btMatrix3x3::operator+=(const btMatrix3x3& m)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	m_el[0].mVec128 = btSimdClearW(btSimdAdd(m_el[0].mVec128,m.m_el[0].mVec128));
+	m_el[1].mVec128 = btSimdClearW(btSimdAdd(m_el[1].mVec128,m.m_el[1].mVec128));
+	m_el[2].mVec128 = btSimdClearW(btSimdAdd(m_el[2].mVec128,m.m_el[2].mVec128));
+#else
 	setValue(
 		m_el[0][0]+m.m_el[0][0], 
 		m_el[0][1]+m.m_el[0][1],
@@ -546,21 +560,37 @@ btMatrix3x3::operator+=(const btMatrix3x3& m)
 		m_el[2][0]+m.m_el[2][0], 
 		m_el[2][1]+m.m_el[2][1],
 		m_el[2][2]+m.m_el[2][2]);
+#endif
 	return *this;
 }
 
 SIMD_FORCE_INLINE btMatrix3x3
 operator*(const btMatrix3x3& m, const btScalar & k)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdClearW(btSimdMul(m[0].mVec128,btSimdSplat(k)));
+	result[1].mVec128 = btSimdClearW(btSimdMul(m[1].mVec128,btSimdSplat(k)));
+	result[2].mVec128 = btSimdClearW(btSimdMul(m[2].mVec128,btSimdSplat(k)));
+	return result;
+#else
 	return btMatrix3x3(
 		m[0].x()*k,m[0].y()*k,m[0].z()*k,
 		m[1].x()*k,m[1].y()*k,m[1].z()*k,
 		m[2].x()*k,m[2].y()*k,m[2].z()*k);
+#endif
 }
 
  SIMD_FORCE_INLINE btMatrix3x3 
 operator+(const btMatrix3x3& m1, const btMatrix3x3& m2)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdClearW(btSimdAdd(m1[0].mVec128,m2[0].mVec128));
+	result[1].mVec128 = btSimdClearW(btSimdAdd(m1[1].mVec128,m2[1].mVec128));
+	result[2].mVec128 = btSimdClearW(btSimdAdd(m1[2].mVec128,m2[2].mVec128));
+	return result;
+#else
 	return btMatrix3x3(
 	m1[0][0]+m2[0][0], 
 	m1[0][1]+m2[0][1],
@@ -571,11 +601,19 @@ operator+(const btMatrix3x3& m1, const btMatrix3x3& m2)
 	m1[2][0]+m2[2][0], 
 	m1[2][1]+m2[2][1],
 	m1[2][2]+m2[2][2]);
+#endif
 }
 
 SIMD_FORCE_INLINE btMatrix3x3 
 operator-(const btMatrix3x3& m1, const btMatrix3x3& m2)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdClearW(btSimdSub(m1[0].mVec128,m2[0].mVec128));
+	result[1].mVec128 = btSimdClearW(btSimdSub(m1[1].mVec128,m2[1].mVec128));
+	result[2].mVec128 = btSimdClearW(btSimdSub(m1[2].mVec128,m2[2].mVec128));
+	return result;
+#else
 	return btMatrix3x3(
 	m1[0][0]-m2[0][0], 
 	m1[0][1]-m2[0][1],
@@ -586,12 +624,18 @@ operator-(const btMatrix3x3& m1, const btMatrix3x3& m2)
 	m1[2][0]-m2[2][0], 
 	m1[2][1]-m2[2][1],
 	m1[2][2]-m2[2][2]);
+#endif
 }
 
 
 SIMD_FORCE_INLINE btMatrix3x3& 
 btMatrix3x3::operator-=(const btMatrix3x3& m)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	m_el[0].mVec128 = btSimdClearW(btSimdSub(m_el[0].mVec128,m.m_el[0].mVec128));
+	m_el[1].mVec128 = btSimdClearW(btSimdSub(m_el[1].mVec128,m.m_el[1].mVec128));
+	m_el[2].mVec128 = btSimdClearW(btSimdSub(m_el[2].mVec128,m.m_el[2].mVec128));
+#else
 	setValue(
 	m_el[0][0]-m.m_el[0][0], 
 	m_el[0][1]-m.m_el[0][1],
@@ -602,6 +646,7 @@ btMatrix3x3::operator-=(const btMatrix3x3& m)
 	m_el[2][0]-m.m_el[2][0], 
 	m_el[2][1]-m.m_el[2][1],
 	m_el[2][2]-m.m_el[2][2]);
+#endif
 	return *this;
 }
 
@@ -616,18 +661,36 @@ btMatrix3x3::determinant() const
 SIMD_FORCE_INLINE btMatrix3x3 
 btMatrix3x3::absolute() const
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdAbsolute3(m_el[0].mVec128);
+	result[1].mVec128 = btSimdAbsolute3(m_el[1].mVec128);
+	result[2].mVec128 = btSimdAbsolute3(m_el[2].mVec128);
+	return result;
+#else
 	return btMatrix3x3(
 		btFabs(m_el[0].x()), btFabs(m_el[0].y()), btFabs(m_el[0].z()),
 		btFabs(m_el[1].x()), btFabs(m_el[1].y()), btFabs(m_el[1].z()),
 		btFabs(m_el[2].x()), btFabs(m_el[2].y()), btFabs(m_el[2].z()));
+#endif
 }
 
 SIMD_FORCE_INLINE btMatrix3x3 
 btMatrix3x3::transpose() const 
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btSimdFloat4 x,y,z;
+	btSimdTranspose3(m_el[0].mVec128,m_el[1].mVec128,m_el[2].mVec128,x,y,z);
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdClearW(x);
+	result[1].mVec128 = btSimdClearW(y);
+	result[2].mVec128 = btSimdClearW(z);
+	return result;
+#else
 	return btMatrix3x3(m_el[0].x(), m_el[1].x(), m_el[2].x(),
 		m_el[0].y(), m_el[1].y(), m_el[2].y(),
 		m_el[0].z(), m_el[1].z(), m_el[2].z());
+#endif
 }
 
 SIMD_FORCE_INLINE btMatrix3x3 
@@ -653,6 +716,15 @@ btMatrix3x3::inverse() const
 SIMD_FORCE_INLINE btMatrix3x3 
 btMatrix3x3::transposeTimes(const btMatrix3x3& m) const
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btSimdFloat4 x,y,z;
+	btSimdTranspose3(m_el[0].mVec128,m_el[1].mVec128,m_el[2].mVec128,x,y,z);
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdCombine3(m[0].mVec128,m[1].mVec128,m[2].mVec128,x);
+	result[1].mVec128 = btSimdCombine3(m[0].mVec128,m[1].mVec128,m[2].mVec128,y);
+	result[2].mVec128 = btSimdCombine3(m[0].mVec128,m[1].mVec128,m[2].mVec128,z);
+	return result;
+#else
 	return btMatrix3x3(
 		m_el[0].x() * m[0].x() + m_el[1].x() * m[1].x() + m_el[2].x() * m[2].x(),
 		m_el[0].x() * m[0].y() + m_el[1].x() * m[1].y() + m_el[2].x() * m[2].y(),
@@ -663,38 +735,69 @@ btMatrix3x3::transposeTimes(const btMatrix3x3& m) const
 		m_el[0].z() * m[0].x() + m_el[1].z() * m[1].x() + m_el[2].z() * m[2].x(),
 		m_el[0].z() * m[0].y() + m_el[1].z() * m[1].y() + m_el[2].z() * m[2].y(),
 		m_el[0].z() * m[0].z() + m_el[1].z() * m[1].z() + m_el[2].z() * m[2].z());
+#endif
 }
 
 SIMD_FORCE_INLINE btMatrix3x3 
 btMatrix3x3::timesTranspose(const btMatrix3x3& m) const
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btSimdFloat4 x,y,z;
+	btSimdTranspose3(m[0].mVec128,m[1].mVec128,m[2].mVec128,x,y,z);
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdCombine3(x,y,z,m_el[0].mVec128);
+	result[1].mVec128 = btSimdCombine3(x,y,z,m_el[1].mVec128);
+	result[2].mVec128 = btSimdCombine3(x,y,z,m_el[2].mVec128);
+	return result;
+#else
 	return btMatrix3x3(
 		m_el[0].dot(m[0]), m_el[0].dot(m[1]), m_el[0].dot(m[2]),
 		m_el[1].dot(m[0]), m_el[1].dot(m[1]), m_el[1].dot(m[2]),
 		m_el[2].dot(m[0]), m_el[2].dot(m[1]), m_el[2].dot(m[2]));
 
+#endif
 }
 
 SIMD_FORCE_INLINE btVector3 
 operator*(const btMatrix3x3& m, const btVector3& v) 
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdDotRowsXYZ(m[0].mVec128,m[1].mVec128,m[2].mVec128,v.mVec128);
+	return result;
+#else
 	return btVector3(m[0].dot(v), m[1].dot(v), m[2].dot(v));
+#endif
 }
 
 
 SIMD_FORCE_INLINE btVector3
 operator*(const btVector3& v, const btMatrix3x3& m)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdCombine3(m[0].mVec128,m[1].mVec128,m[2].mVec128,v.mVec128);
+	return result;
+#else
 	return btVector3(m.tdotx(v), m.tdoty(v), m.tdotz(v));
+#endif
 }
 
 SIMD_FORCE_INLINE btMatrix3x3 
 operator*(const btMatrix3x3& m1, const btMatrix3x3& m2)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btMatrix3x3 result;
+	result[0].mVec128 = btSimdCombine3(m2[0].mVec128,m2[1].mVec128,m2[2].mVec128,m1[0].mVec128);
+	result[1].mVec128 = btSimdCombine3(m2[0].mVec128,m2[1].mVec128,m2[2].mVec128,m1[1].mVec128);
+	result[2].mVec128 = btSimdCombine3(m2[0].mVec128,m2[1].mVec128,m2[2].mVec128,m1[2].mVec128);
+	return result;
+#else
 	return btMatrix3x3(
 		m2.tdotx( m1[0]), m2.tdoty( m1[0]), m2.tdotz( m1[0]),
 		m2.tdotx( m1[1]), m2.tdoty( m1[1]), m2.tdotz( m1[1]),
 		m2.tdotx( m1[2]), m2.tdoty( m1[2]), m2.tdotz( m1[2]));
+#endif
 }
 
 /*
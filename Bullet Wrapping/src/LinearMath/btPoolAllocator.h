@@ -18,8 +18,11 @@ subject to the following restrictions:
 
 #include "btScalar.h"
 #include "btAlignedAllocator.h"
+#include "btAlignedObjectArray.h"
+#include "btMinMax.h"
 
 ///The btPoolAllocator class allows to efficiently allocate a large pool of objects, instead of dynamically allocating them separately.
+///A growable pool allocates another block, as large as all its blocks together, when it runs out of elements. This way a pool can start small.
 class btPoolAllocator
 {
 	int				m_elemSize;
@@ -27,31 +30,72 @@ class btPoolAllocator
 	int				m_freeCount;
 	void*			m_firstFree;
 	unsigned char*	m_pool;
+	int				m_poolElements;
+	bool			m_growable;
+
+	struct	btPoolBlock
+	{
+		unsigned char*	m_memory;
+		int				m_numElements;
+	};
+	///the blocks added by growing, m_pool is the first block
+	btAlignedObjectArray<btPoolBlock>	m_extraBlocks;
+
+	void*	linkFreeElements(unsigned char* p, int count, void* next)
+	{
+		void* first = p;
+		while (--count) {
+			*(void**)p = (p + m_elemSize);
+			p += m_elemSize;
+		}
+		*(void**)p = next;
+		return first;
+	}
+
+	void	grow()
+	{
+		btPoolBlock block;
+		block.m_numElements = m_maxElements;
+		block.m_memory = (unsigned char*) btAlignedAlloc( static_cast<unsigned int>(m_elemSize*block.m_numElements),16);
+		m_extraBlocks.push_back(block);
+		m_firstFree = linkFreeElements(block.m_memory,block.m_numElements,m_firstFree);
+		m_freeCount += block.m_numElements;
+		m_maxElements += block.m_numElements;
+	}
 
 public:
 
-	btPoolAllocator(int elemSize, int maxElements)
+	btPoolAllocator(int elemSize, int maxElements, bool growable = false)
 		:m_elemSize(elemSize),
-		m_maxElements(maxElements)
+		m_maxElements(btMax(maxElements,1)),
+		m_growable(growable)
 	{
 		m_pool = (unsigned char*) btAlignedAlloc( static_cast<unsigned int>(m_elemSize*m_maxElements),16);
-
-		unsigned char* p = m_pool;
-        m_firstFree = p;
-        m_freeCount = m_maxElements;
-        int count = m_maxElements;
-        while (--count) {
-            *(void**)p = (p + m_elemSize);
-            p += m_elemSize;
-        }
-        *(void**)p = 0;
+		m_firstFree = linkFreeElements(m_pool,m_maxElements,0);
+		m_freeCount = m_maxElements;
+		m_poolElements = m_maxElements;
     }
 
 	~btPoolAllocator()
 	{
+		for (int i=0;i<m_extraBlocks.size();i++)
+		{
+			btAlignedFree( m_extraBlocks[i].m_memory);
+		}
 		btAlignedFree( m_pool);
 	}
 
+	bool	isGrowable() const
+	{
+		return m_growable;
+	}
+
+	///true when allocate can return an element, either from the free elements or by growing
+	bool	canAllocate() const
+	{
+		return m_freeCount > 0 || m_growable;
+	}
+
 	int	getFreeCount() const
 	{
 		return m_freeCount;
@@ -67,11 +111,21 @@ public:
 		return m_maxElements;
 	}
 
+	///size in bytes of all blocks
+	int	getCapacityInBytes() const
+	{
+		return m_maxElements * m_elemSize;
+	}
+
 	void*	allocate(int size)
 	{
 		// release mode fix
 		(void)size;
 		btAssert(!size || size<=m_elemSize);
+		if (!m_freeCount && m_growable)
+		{
+			grow();
+		}
 		btAssert(m_freeCount>0);
         void* result = m_firstFree;
         m_firstFree = *(void**)m_firstFree;
@@ -82,10 +136,18 @@ public:
 	bool validPtr(void* ptr)
 	{
 		if (ptr) {
-			if (((unsigned char*)ptr >= m_pool && (unsigned char*)ptr < m_pool + m_maxElements * m_elemSize))
+			if (((unsigned char*)ptr >= m_pool && (unsigned char*)ptr < m_pool + m_poolElements * m_elemSize))
 			{
 				return true;
 			}
+			for (int i=0;i<m_extraBlocks.size();i++)
+			{
+				const btPoolBlock& block = m_extraBlocks[i];
+				if ((unsigned char*)ptr >= block.m_memory && (unsigned char*)ptr < block.m_memory + block.m_numElements * m_elemSize)
+				{
+					return true;
+				}
+			}
 		}
 		return false;
 	}
@@ -93,7 +155,7 @@ public:
 	void	freeMemory(void* ptr)
 	{
 		 if (ptr) {
-            btAssert((unsigned char*)ptr >= m_pool && (unsigned char*)ptr < m_pool + m_maxElements * m_elemSize);
+            btAssert(validPtr(ptr));
 
             *(void**)ptr = m_firstFree;
             m_firstFree = ptr;
@@ -106,6 +168,7 @@ public:
 		return m_elemSize;
 	}
 
+	///address of the first block
 	unsigned char*	getPoolAddress()
 	{
 		return m_pool;
@@ -115,7 +178,6 @@ public:
 	{
 		return m_pool;
 	}
-
 };
 
 #endif //_BT_POOL_ALLOCATOR_H
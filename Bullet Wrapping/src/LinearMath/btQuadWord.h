@@ -18,6 +18,7 @@ subject to the following restrictions:
 
 #include "btScalar.h"
 #include "btMinMax.h"
+#include "btSimdFloat4.h"
 
 
 #if defined (__CELLOS_LV2) && defined (__SPU__)
@@ -47,7 +48,24 @@ public:
 	}
 protected:
 #else //__CELLOS_LV2__ __SPU__
+#ifdef BT_USE_SIMD_FLOAT4
+	union {
+		btSimdFloat4 mVec128;
+		btScalar	m_floats[4];
+	};
+public:
+	SIMD_FORCE_INLINE	btSimdFloat4	get128() const
+	{
+		return mVec128;
+	}
+	SIMD_FORCE_INLINE	void	set128(btSimdFloat4 v128)
+	{
+		mVec128 = v128;
+	}
+protected:
+#else
 	btScalar	m_floats[4];
+#endif //BT_USE_SIMD_FLOAT4
 #endif //__CELLOS_LV2__ __SPU__
 
 	public:
@@ -107,7 +107,11 @@ public:
    * @param q The quaternion to add to this one */
 	SIMD_FORCE_INLINE	btQuaternion& operator+=(const btQuaternion& q)
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdAdd(mVec128,q.mVec128);
+#else
 		m_floats[0] += q.x(); m_floats[1] += q.y(); m_floats[2] += q.z(); m_floats[3] += q.m_floats[3];
+#endif
 		return *this;
 	}
 
@@ -115,7 +119,11 @@ public:
    * @param q The quaternion to subtract from this one */
 	btQuaternion& operator-=(const btQuaternion& q) 
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdSub(mVec128,q.mVec128);
+#else
 		m_floats[0] -= q.x(); m_floats[1] -= q.y(); m_floats[2] -= q.z(); m_floats[3] -= q.m_floats[3];
+#endif
 		return *this;
 	}
 
@@ -123,7 +131,11 @@ public:
    * @param s The scalar to scale by */
 	btQuaternion& operator*=(const btScalar& s)
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdMul(mVec128,btSimdSplat(s));
+#else
 		m_floats[0] *= s; m_floats[1] *= s; m_floats[2] *= s; m_floats[3] *= s;
+#endif
 		return *this;
 	}
 
@@ -132,17 +144,25 @@ public:
    * Equivilant to this = this * q */
 	btQuaternion& operator*=(const btQuaternion& q)
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdQuaternionMul(mVec128,q.mVec128);
+#else
 		setValue(m_floats[3] * q.x() + m_floats[0] * q.m_floats[3] + m_floats[1] * q.z() - m_floats[2] * q.y(),
 			m_floats[3] * q.y() + m_floats[1] * q.m_floats[3] + m_floats[2] * q.x() - m_floats[0] * q.z(),
 			m_floats[3] * q.z() + m_floats[2] * q.m_floats[3] + m_floats[0] * q.y() - m_floats[1] * q.x(),
 			m_floats[3] * q.m_floats[3] - m_floats[0] * q.x() - m_floats[1] * q.y() - m_floats[2] * q.z());
+#endif
 		return *this;
 	}
   /**@brief Return the dot product between this quaternion and another
    * @param q The other quaternion */
 	btScalar dot(const btQuaternion& q) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		return btSimdDotXYZW(mVec128,q.mVec128);
+#else
 		return m_floats[0] * q.x() + m_floats[1] * q.y() + m_floats[2] * q.z() + m_floats[3] * q.m_floats[3];
+#endif
 	}
 
   /**@brief Return the length squared of the quaternion */
@@ -169,7 +189,13 @@ public:
 	SIMD_FORCE_INLINE btQuaternion
 	operator*(const btScalar& s) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btQuaternion result;
+		result.mVec128 = btSimdMul(mVec128,btSimdSplat(s));
+		return result;
+#else
 		return btQuaternion(x() * s, y() * s, z() * s, m_floats[3] * s);
+#endif
 	}
 
 
@@ -222,7 +248,13 @@ public:
 	/**@brief Return the inverse of this quaternion */
 	btQuaternion inverse() const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btQuaternion result;
+		result.mVec128 = btSimdNegateW(btSimdNegate4(mVec128));
+		return result;
+#else
 		return btQuaternion(-m_floats[0], -m_floats[1], -m_floats[2], m_floats[3]);
+#endif
 	}
 
   /**@brief Return the sum of this quaternion and the other 
@@ -230,8 +262,14 @@ public:
 	SIMD_FORCE_INLINE btQuaternion
 	operator+(const btQuaternion& q2) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btQuaternion result;
+		result.mVec128 = btSimdAdd(mVec128,q2.mVec128);
+		return result;
+#else
 		const btQuaternion& q1 = *this;
 		return btQuaternion(q1.x() + q2.x(), q1.y() + q2.y(), q1.z() + q2.z(), q1.m_floats[3] + q2.m_floats[3]);
+#endif
 	}
 
   /**@brief Return the difference between this quaternion and the other 
@@ -239,16 +277,28 @@ public:
 	SIMD_FORCE_INLINE btQuaternion
 	operator-(const btQuaternion& q2) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btQuaternion result;
+		result.mVec128 = btSimdSub(mVec128,q2.mVec128);
+		return result;
+#else
 		const btQuaternion& q1 = *this;
 		return btQuaternion(q1.x() - q2.x(), q1.y() - q2.y(), q1.z() - q2.z(), q1.m_floats[3] - q2.m_floats[3]);
+#endif
 	}
 
   /**@brief Return the negative of this quaternion 
    * This simply negates each element */
 	SIMD_FORCE_INLINE btQuaternion operator-() const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btQuaternion result;
+		result.mVec128 = btSimdNegate4(mVec128);
+		return result;
+#else
 		const btQuaternion& q2 = *this;
 		return btQuaternion( - q2.x(), - q2.y(),  - q2.z(),  - q2.m_floats[3]);
+#endif
 	}
   /**@todo document this and it's use */
 	SIMD_FORCE_INLINE btQuaternion farthest( const btQuaternion& qd) const 
@@ -319,7 +369,13 @@ public:
 SIMD_FORCE_INLINE btQuaternion
 operator-(const btQuaternion& q)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btQuaternion result;
+	result.set128(btSimdNegate4(q.get128()));
+	return result;
+#else
 	return btQuaternion(-q.x(), -q.y(), -q.z(), -q.w());
+#endif
 }
 
 
@@ -327,19 +383,31 @@ operator-(const btQuaternion& q)
 /**@brief Return the product of two quaternions */
 SIMD_FORCE_INLINE btQuaternion
 operator*(const btQuaternion& q1, const btQuaternion& q2) {
+#ifdef BT_USE_SIMD_FLOAT4
+	btQuaternion result;
+	result.set128(btSimdQuaternionMul(q1.get128(),q2.get128()));
+	return result;
+#else
 	return btQuaternion(q1.w() * q2.x() + q1.x() * q2.w() + q1.y() * q2.z() - q1.z() * q2.y(),
 		q1.w() * q2.y() + q1.y() * q2.w() + q1.z() * q2.x() - q1.x() * q2.z(),
 		q1.w() * q2.z() + q1.z() * q2.w() + q1.x() * q2.y() - q1.y() * q2.x(),
 		q1.w() * q2.w() - q1.x() * q2.x() - q1.y() * q2.y() - q1.z() * q2.z()); 
+#endif
 }
 
 SIMD_FORCE_INLINE btQuaternion
 operator*(const btQuaternion& q, const btVector3& w)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btQuaternion result;
+	result.set128(btSimdQuaternionMulVector3(q.get128(),w.get128()));
+	return result;
+#else
 	return btQuaternion( q.w() * w.x() + q.y() * w.z() - q.z() * w.y(),
 		q.w() * w.y() + q.z() * w.x() - q.x() * w.z(),
 		q.w() * w.z() + q.x() * w.y() - q.y() * w.x(),
 		-q.x() * w.x() - q.y() * w.y() - q.z() * w.z()); 
+#endif
 }
 
 SIMD_FORCE_INLINE btQuaternion
@@ -425,6 +425,7 @@ CProfileNode	CProfileManager::Root( "Root", NULL );
 CProfileNode *	CProfileManager::CurrentNode = &CProfileManager::Root;
 int				CProfileManager::FrameCounter = 0;
 unsigned long int			CProfileManager::ResetTime = 0;
+bool						CProfileManager::Enabled = true;
 
 
 /***********************************************************************************************
@@ -470,6 +471,8 @@ void	CProfileManager::Stop_Profile( void )
  *=============================================================================================*/
 void	CProfileManager::Reset( void )
 { 
+	if (!Enabled)
+		return;
 	gProfileClock.reset();
 	Root.Reset();
     Root.Call();
@@ -483,6 +486,8 @@ void	CProfileManager::Reset( void )
  *=============================================================================================*/
 void CProfileManager::Increment_Frame_Counter( void )
 {
+	if (!Enabled)
+		return;
 	FrameCounter++;
 }
 
@@ -157,26 +157,36 @@ public:
 
 	static void	dumpAll();
 
+	///the profile tree is not thread safe. Disable profiling while several threads run code with BT_PROFILE samples,
+	///for example while btDynamicsWorldHost steps worlds in parallel. While disabled, samples, Reset and Increment_Frame_Counter do nothing.
+	static	void						Set_Enabled( bool enabled )	{ Enabled = enabled; }
+	static	bool						Is_Enabled( void )			{ return Enabled; }
+
 private:
 	static	CProfileNode			Root;
 	static	CProfileNode *			CurrentNode;
 	static	int						FrameCounter;
 	static	unsigned long int					ResetTime;
+	static	bool						Enabled;
 };
 
 
 ///ProfileSampleClass is a simple way to profile a function's scope
 ///Use the BT_PROFILE macro at the start of scope to time
 class	CProfileSample {
+	bool	m_started;
 public:
 	CProfileSample( const char * name )
+		:m_started(CProfileManager::Is_Enabled())
 	{ 
-		CProfileManager::Start_Profile( name ); 
+		if (m_started)
+			CProfileManager::Start_Profile( name ); 
 	}
 
 	~CProfileSample( void )					
 	{ 
-		CProfileManager::Stop_Profile(); 
+		if (m_started)
+			CProfileManager::Stop_Profile(); 
 	}
 };
 
@@ -0,0 +1,202 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_RADIX_SORT_H
+#define BT_RADIX_SORT_H
+
+#include "btAlignedObjectArray.h"
+#include "btMinMax.h"
+#include "btThreads.h"
+
+///number of elements per chunk of the parallel radix sort
+#define BT_RADIX_SORT_CHUNK_SIZE 4096
+///the parallel radix sort is used from this number of elements on, when a task scheduler is set
+#define BT_RADIX_SORT_PARALLEL_THRESHOLD 16384
+
+struct	btRadixSortHistogramLoop : public btIParallelForBody
+{
+	const int*	m_keys;
+	int			m_numElements;
+	int			m_shift;
+	int*		m_counts;
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int chunk=iBegin;chunk<iEnd;chunk++)
+		{
+			int* counts = &m_counts[chunk*256];
+			for (int d=0;d<256;d++)
+			{
+				counts[d] = 0;
+			}
+			int end = btMin(m_numElements,(chunk+1)*BT_RADIX_SORT_CHUNK_SIZE);
+			for (int i=chunk*BT_RADIX_SORT_CHUNK_SIZE;i<end;i++)
+			{
+				counts[(m_keys[i] >> m_shift) & 255]++;
+			}
+		}
+	}
+};
+
+template <typename T>
+struct	btRadixSortScatterLoop : public btIParallelForBody
+{
+	const T*	m_values;
+	const int*	m_keys;
+	T*			m_sortedValues;
+	int*		m_sortedKeys;
+	int			m_numElements;
+	int			m_shift;
+	int*		m_offsets;
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int chunk=iBegin;chunk<iEnd;chunk++)
+		{
+			int* offsets = &m_offsets[chunk*256];
+			int end = btMin(m_numElements,(chunk+1)*BT_RADIX_SORT_CHUNK_SIZE);
+			for (int i=chunk*BT_RADIX_SORT_CHUNK_SIZE;i<end;i++)
+			{
+				int dst = offsets[(m_keys[i] >> m_shift) & 255]++;
+				m_sortedValues[dst] = m_values[i];
+				m_sortedKeys[dst] = m_keys[i];
+			}
+		}
+	}
+};
+
+///btRadixSort is a stable sort of values by small non-negative integer keys, such as island ids, in linear time.
+///It keeps its scratch buffers, so sorting every step doesn't allocate once the buffers are large enough.
+///A single counting sort pass is used, or a parallel radix sort on 8 bit digits when a task scheduler is set and there are many values.
+///Both are stable, so they produce the same order.
+template <typename T>
+class	btRadixSort
+{
+	btAlignedObjectArray<T>		m_tmpValues;
+	btAlignedObjectArray<int>	m_tmpKeys;
+	btAlignedObjectArray<int>	m_counts;
+
+	void	countingSort(btAlignedObjectArray<T>& values,btAlignedObjectArray<int>& keys,int numKeys)
+	{
+		int n = values.size();
+		m_counts.resize(numKeys+1);
+		int i;
+		for (i=0;i<=numKeys;i++)
+		{
+			m_counts[i] = 0;
+		}
+		for (i=0;i<n;i++)
+		{
+			btAssert(keys[i] >= 0 && keys[i] < numKeys);
+			m_counts[keys[i]+1]++;
+		}
+		for (i=0;i<numKeys;i++)
+		{
+			m_counts[i+1] += m_counts[i];
+		}
+		for (i=0;i<n;i++)
+		{
+			int dst = m_counts[keys[i]]++;
+			m_tmpValues[dst] = values[i];
+			m_tmpKeys[dst] = keys[i];
+		}
+		for (i=0;i<n;i++)
+		{
+			values[i] = m_tmpValues[i];
+			keys[i] = m_tmpKeys[i];
+		}
+	}
+
+	void	parallelRadixSort(btAlignedObjectArray<T>& values,btAlignedObjectArray<int>& keys,int numKeys)
+	{
+		int n = values.size();
+		int numChunks = (n + BT_RADIX_SORT_CHUNK_SIZE - 1) / BT_RADIX_SORT_CHUNK_SIZE;
+		m_counts.resize(numChunks*256);
+
+		T* values0 = &values[0];
+		int* keys0 = &keys[0];
+		T* values1 = &m_tmpValues[0];
+		int* keys1 = &m_tmpKeys[0];
+
+		int numPasses = 0;
+		for (int shift=0;shift==0 || (shift < 32 && ((numKeys-1) >> shift));shift+=8)
+		{
+			btRadixSortHistogramLoop histogramLoop;
+			histogramLoop.m_keys = keys0;
+			histogramLoop.m_numElements = n;
+			histogramLoop.m_shift = shift;
+			histogramLoop.m_counts = &m_counts[0];
+			btParallelFor(0,numChunks,1,histogramLoop);
+
+			///digit major, chunk minor offsets keep the order of equal digits
+			int offset = 0;
+			for (int d=0;d<256;d++)
+			{
+				for (int chunk=0;chunk<numChunks;chunk++)
+				{
+					int count = m_counts[chunk*256+d];
+					m_counts[chunk*256+d] = offset;
+					offset += count;
+				}
+			}
+
+			btRadixSortScatterLoop<T> scatterLoop;
+			scatterLoop.m_values = values0;
+			scatterLoop.m_keys = keys0;
+			scatterLoop.m_sortedValues = values1;
+			scatterLoop.m_sortedKeys = keys1;
+			scatterLoop.m_numElements = n;
+			scatterLoop.m_shift = shift;
+			scatterLoop.m_offsets = &m_counts[0];
+			btParallelFor(0,numChunks,1,scatterLoop);
+
+			btSwap(values0,values1);
+			btSwap(keys0,keys1);
+			numPasses++;
+		}
+
+		if (numPasses & 1)
+		{
+			for (int i=0;i<n;i++)
+			{
+				values[i] = m_tmpValues[i];
+				keys[i] = m_tmpKeys[i];
+			}
+		}
+	}
+
+public:
+
+	///sorts values by keys, both arrays are reordered. The keys have to be in [0,numKeys).
+	void	sort(btAlignedObjectArray<T>& values,btAlignedObjectArray<int>& keys,int numKeys)
+	{
+		btAssert(values.size() == keys.size());
+		int n = values.size();
+		if (n < 2)
+			return;
+		m_tmpValues.resize(n);
+		m_tmpKeys.resize(n);
+
+		if (n >= BT_RADIX_SORT_PARALLEL_THRESHOLD && btGetTaskScheduler() != btGetSequentialTaskScheduler())
+		{
+			parallelRadixSort(values,keys,numKeys);
+		} else
+		{
+			countingSort(values,keys,numKeys);
+		}
+	}
+};
+
+#endif //BT_RADIX_SORT_H
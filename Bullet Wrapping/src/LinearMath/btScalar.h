@@ -169,7 +169,29 @@ inline int	btGetVersion()
 
 #else
 
+	///The SIMD backend is chosen at compile time: GCC and Clang use SSE when building for SSE 4.1 (-msse4.1, or a -march that includes it).
+	///FMA is used on top of SSE when building with -mfma (or -march=haswell and later). Define BT_NO_SIMD to use the scalar code.
+	///The NEON backend has not been validated on device yet, so AArch64 builds use the scalar code unless BT_USE_NEON_EXPERIMENTAL is defined.
+	#if (defined (__x86_64__) || defined (__i386__)) && defined (__SSE4_1__) && (!defined (BT_USE_DOUBLE_PRECISION)) && (!defined (BT_NO_SIMD))
+		#define BT_USE_SSE
+		#include <smmintrin.h>
+		#ifdef __FMA__
+			#define BT_USE_FMA
+			#include <immintrin.h>
+		#endif //__FMA__
+	#elif defined (BT_USE_NEON_EXPERIMENTAL) && defined (__aarch64__) && defined (__ARM_NEON) && (!defined (BT_USE_DOUBLE_PRECISION)) && (!defined (BT_NO_SIMD))
+		#define BT_USE_NEON
+		#include <arm_neon.h>
+	#endif
+
 		#define SIMD_FORCE_INLINE inline
+	#if defined (BT_USE_SSE) || defined (BT_USE_NEON)
+		///btAlignedAlloc, btAlignedObjectArray and the pool allocators only guarantee 16 byte alignment,
+		///so a larger alignment is not promised to the compiler, it could use wider aligned loads and stores
+		#define ATTRIBUTE_ALIGNED16(a) a __attribute__ ((aligned (16)))
+		#define ATTRIBUTE_ALIGNED64(a) a __attribute__ ((aligned (16)))
+		#define ATTRIBUTE_ALIGNED128(a) a __attribute__ ((aligned (16)))
+	#else
 		///@todo: check out alignment methods for other platforms/compilers
 		///#define ATTRIBUTE_ALIGNED16(a) a __attribute__ ((aligned (16)))
 		///#define ATTRIBUTE_ALIGNED64(a) a __attribute__ ((aligned (64)))
@@ -177,6 +199,7 @@ inline int	btGetVersion()
 		#define ATTRIBUTE_ALIGNED16(a) a
 		#define ATTRIBUTE_ALIGNED64(a) a
 		#define ATTRIBUTE_ALIGNED128(a) a
+	#endif
 		#ifndef assert
 		#include <assert.h>
 		#endif
@@ -0,0 +1,280 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_SIMD_FLOAT4_H
+#define BT_SIMD_FLOAT4_H
+
+#include "btScalar.h"
+
+///The btSimdFloat4 functions are the SSE and NEON backend of btVector3, btQuaternion and btMatrix3x3.
+///The 3 component functions ignore w on input and clear it on output, like the scalar code does, and they add and multiply
+///in the same order as the scalar code, so without BT_USE_FMA the results are bit-identical to the scalar build.
+#if defined (BT_USE_SSE) || defined (BT_USE_NEON)
+#define BT_USE_SIMD_FLOAT4
+
+#ifdef BT_USE_SSE
+
+typedef __m128	btSimdFloat4;
+
+///_mm_shuffle_ps mask, listing the source lanes of x, y, z and w
+#define BT_SHUFFLE(x,y,z,w) ((w)<<6 | (z)<<4 | (y)<<2 | (x))
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSplat(float s)						{ return _mm_set1_ps(s); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdAdd(btSimdFloat4 a,btSimdFloat4 b)	{ return _mm_add_ps(a,b); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSub(btSimdFloat4 a,btSimdFloat4 b)	{ return _mm_sub_ps(a,b); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMul(btSimdFloat4 a,btSimdFloat4 b)	{ return _mm_mul_ps(a,b); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdDiv(btSimdFloat4 a,btSimdFloat4 b)	{ return _mm_div_ps(a,b); }
+///a < b ? a : b per lane, like btSetMin
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMin(btSimdFloat4 a,btSimdFloat4 b)	{ return _mm_min_ps(a,b); }
+///a > b ? a : b per lane, like btSetMax
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMax(btSimdFloat4 a,btSimdFloat4 b)	{ return _mm_max_ps(a,b); }
+
+///a * b + c
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMulAdd(btSimdFloat4 a,btSimdFloat4 b,btSimdFloat4 c)
+{
+#ifdef BT_USE_FMA
+	return _mm_fmadd_ps(a,b,c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a,b),c);
+#endif
+}
+
+template <int x,int y,int z,int w>
+SIMD_FORCE_INLINE btSimdFloat4	btSimdShuffle(btSimdFloat4 v)
+{
+	return _mm_shuffle_ps(v,v,BT_SHUFFLE(x,y,z,w));
+}
+
+template <int i>
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSplatLane(btSimdFloat4 v)
+{
+	return _mm_shuffle_ps(v,v,BT_SHUFFLE(i,i,i,i));
+}
+
+///clears w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdClearW(btSimdFloat4 v)
+{
+	return _mm_and_ps(v,_mm_castsi128_ps(_mm_set_epi32(0,-1,-1,-1)));
+}
+
+///x, y and z of xyz and w of w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSetW(btSimdFloat4 xyz,btSimdFloat4 w)
+{
+#ifdef __SSE4_1__
+	return _mm_blend_ps(xyz,w,8);
+#else
+	return _mm_shuffle_ps(xyz,_mm_unpackhi_ps(xyz,w),BT_SHUFFLE(0,1,0,3));
+#endif
+}
+
+///absolute x, y and z, clears w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdAbsolute3(btSimdFloat4 v)
+{
+	return _mm_and_ps(v,_mm_castsi128_ps(_mm_set_epi32(0,0x7fffffff,0x7fffffff,0x7fffffff)));
+}
+
+///negated x, y and z, clears w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdNegate3(btSimdFloat4 v)
+{
+	return btSimdClearW(_mm_xor_ps(v,_mm_set1_ps(-0.f)));
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdNegate4(btSimdFloat4 v)
+{
+	return _mm_xor_ps(v,_mm_set1_ps(-0.f));
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdNegateW(btSimdFloat4 v)
+{
+	return _mm_xor_ps(v,_mm_set_ps(-0.f,0.f,0.f,0.f));
+}
+
+///x * y + z of the products, in the order of btVector3::dot
+SIMD_FORCE_INLINE float	btSimdDotXYZ(btSimdFloat4 a,btSimdFloat4 b)
+{
+	__m128 m = _mm_mul_ps(a,b);
+	__m128 s = _mm_add_ss(m,btSimdSplatLane<1>(m));
+	s = _mm_add_ss(s,_mm_movehl_ps(m,m));
+	return _mm_cvtss_f32(s);
+}
+
+SIMD_FORCE_INLINE float	btSimdDotXYZW(btSimdFloat4 a,btSimdFloat4 b)
+{
+	__m128 m = _mm_mul_ps(a,b);
+	__m128 s = _mm_add_ss(m,btSimdSplatLane<1>(m));
+	s = _mm_add_ss(s,_mm_movehl_ps(m,m));
+	s = _mm_add_ss(s,btSimdSplatLane<3>(m));
+	return _mm_cvtss_f32(s);
+}
+
+SIMD_FORCE_INLINE bool	btSimdEqual4(btSimdFloat4 a,btSimdFloat4 b)
+{
+	return _mm_movemask_ps(_mm_cmpeq_ps(a,b)) == 15;
+}
+
+///the x, y and z lanes of the results are the x, y and z components of a, b and c
+SIMD_FORCE_INLINE void	btSimdTranspose3(btSimdFloat4 a,btSimdFloat4 b,btSimdFloat4 c,btSimdFloat4& x,btSimdFloat4& y,btSimdFloat4& z)
+{
+	__m128 ab0 = _mm_unpacklo_ps(a,b);
+	__m128 ab1 = _mm_unpackhi_ps(a,b);
+	__m128 cc0 = _mm_unpacklo_ps(c,c);
+	__m128 cc1 = _mm_unpackhi_ps(c,c);
+	x = _mm_movelh_ps(ab0,cc0);
+	y = _mm_movehl_ps(cc0,ab0);
+	z = _mm_movelh_ps(ab1,cc1);
+}
+
+#else //BT_USE_NEON
+
+typedef float32x4_t	btSimdFloat4;
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSplat(float s)						{ return vdupq_n_f32(s); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdAdd(btSimdFloat4 a,btSimdFloat4 b)	{ return vaddq_f32(a,b); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSub(btSimdFloat4 a,btSimdFloat4 b)	{ return vsubq_f32(a,b); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMul(btSimdFloat4 a,btSimdFloat4 b)	{ return vmulq_f32(a,b); }
+SIMD_FORCE_INLINE btSimdFloat4	btSimdDiv(btSimdFloat4 a,btSimdFloat4 b)	{ return vdivq_f32(a,b); }
+///a < b ? a : b per lane, like btSetMin. vminq_f32 would return NaN for NaN input
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMin(btSimdFloat4 a,btSimdFloat4 b)	{ return vbslq_f32(vcltq_f32(a,b),a,b); }
+///a > b ? a : b per lane, like btSetMax
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMax(btSimdFloat4 a,btSimdFloat4 b)	{ return vbslq_f32(vcgtq_f32(a,b),a,b); }
+
+///a * b + c, the multiply and add are not fused
+SIMD_FORCE_INLINE btSimdFloat4	btSimdMulAdd(btSimdFloat4 a,btSimdFloat4 b,btSimdFloat4 c)
+{
+	return vaddq_f32(vmulq_f32(a,b),c);
+}
+
+template <int x,int y,int z,int w>
+SIMD_FORCE_INLINE btSimdFloat4	btSimdShuffle(btSimdFloat4 v)
+{
+	const uint8x16_t table = {	x*4,x*4+1,x*4+2,x*4+3,
+								y*4,y*4+1,y*4+2,y*4+3,
+								z*4,z*4+1,z*4+2,z*4+3,
+								w*4,w*4+1,w*4+2,w*4+3};
+	return vreinterpretq_f32_u8(vqtbl1q_u8(vreinterpretq_u8_f32(v),table));
+}
+
+template <int i>
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSplatLane(btSimdFloat4 v)
+{
+	return vdupq_laneq_f32(v,i);
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdClearW(btSimdFloat4 v)
+{
+	return vsetq_lane_f32(0.f,v,3);
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdSetW(btSimdFloat4 xyz,btSimdFloat4 w)
+{
+	return vcopyq_laneq_f32(xyz,3,w,3);
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdAbsolute3(btSimdFloat4 v)
+{
+	return btSimdClearW(vabsq_f32(v));
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdNegate3(btSimdFloat4 v)
+{
+	return btSimdClearW(vnegq_f32(v));
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdNegate4(btSimdFloat4 v)
+{
+	return vnegq_f32(v);
+}
+
+SIMD_FORCE_INLINE btSimdFloat4	btSimdNegateW(btSimdFloat4 v)
+{
+	return vsetq_lane_f32(-vgetq_lane_f32(v,3),v,3);
+}
+
+SIMD_FORCE_INLINE float	btSimdDotXYZ(btSimdFloat4 a,btSimdFloat4 b)
+{
+	float32x4_t m = vmulq_f32(a,b);
+	float32x2_t lo = vget_low_f32(m);
+	return vget_lane_f32(vpadd_f32(lo,lo),0) + vgetq_lane_f32(m,2);
+}
+
+SIMD_FORCE_INLINE float	btSimdDotXYZW(btSimdFloat4 a,btSimdFloat4 b)
+{
+	float32x4_t m = vmulq_f32(a,b);
+	float32x2_t lo = vget_low_f32(m);
+	return (vget_lane_f32(vpadd_f32(lo,lo),0) + vgetq_lane_f32(m,2)) + vgetq_lane_f32(m,3);
+}
+
+SIMD_FORCE_INLINE bool	btSimdEqual4(btSimdFloat4 a,btSimdFloat4 b)
+{
+	return vminvq_u32(vceqq_f32(a,b)) != 0;
+}
+
+SIMD_FORCE_INLINE void	btSimdTranspose3(btSimdFloat4 a,btSimdFloat4 b,btSimdFloat4 c,btSimdFloat4& x,btSimdFloat4& y,btSimdFloat4& z)
+{
+	float32x4_t ab0 = vtrn1q_f32(a,b);
+	float32x4_t ab1 = vtrn2q_f32(a,b);
+	x = vcombine_f32(vget_low_f32(ab0),vget_low_f32(c));
+	y = vcombine_f32(vget_low_f32(ab1),vget_low_f32(vextq_f32(c,c,1)));
+	z = vcombine_f32(vget_high_f32(ab0),vget_high_f32(c));
+}
+
+#endif //BT_USE_SSE
+
+///the cross product of the x, y and z components, clears w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdCross3(btSimdFloat4 a,btSimdFloat4 b)
+{
+	btSimdFloat4 ayzx = btSimdShuffle<1,2,0,3>(a);
+	btSimdFloat4 byzx = btSimdShuffle<1,2,0,3>(b);
+	btSimdFloat4 c = btSimdSub(btSimdMul(byzx,a),btSimdMul(ayzx,b));
+	return btSimdClearW(btSimdShuffle<1,2,0,3>(c));
+}
+
+///the x, y and z lanes are a.dot(v), b.dot(v) and c.dot(v), clears w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdDotRowsXYZ(btSimdFloat4 a,btSimdFloat4 b,btSimdFloat4 c,btSimdFloat4 v)
+{
+	btSimdFloat4 x,y,z;
+	btSimdTranspose3(btSimdMul(a,v),btSimdMul(b,v),btSimdMul(c,v),x,y,z);
+	return btSimdClearW(btSimdAdd(btSimdAdd(x,y),z));
+}
+
+///a * v.x + b * v.y + c * v.z, clears w
+SIMD_FORCE_INLINE btSimdFloat4	btSimdCombine3(btSimdFloat4 a,btSimdFloat4 b,btSimdFloat4 c,btSimdFloat4 v)
+{
+	btSimdFloat4 r = btSimdMul(a,btSimdSplatLane<0>(v));
+	r = btSimdMulAdd(b,btSimdSplatLane<1>(v),r);
+	r = btSimdMulAdd(c,btSimdSplatLane<2>(v),r);
+	return btSimdClearW(r);
+}
+
+///the quaternion product a * b
+SIMD_FORCE_INLINE btSimdFloat4	btSimdQuaternionMul(btSimdFloat4 a,btSimdFloat4 b)
+{
+	btSimdFloat4 r = btSimdMul(btSimdSplatLane<3>(a),b);
+	r = btSimdAdd(r,btSimdNegateW(btSimdMul(btSimdShuffle<0,1,2,0>(a),btSimdShuffle<3,3,3,0>(b))));
+	r = btSimdAdd(r,btSimdNegateW(btSimdMul(btSimdShuffle<1,2,0,1>(a),btSimdShuffle<2,0,1,1>(b))));
+	return btSimdSub(r,btSimdMul(btSimdShuffle<2,0,1,2>(a),btSimdShuffle<1,2,0,2>(b)));
+}
+
+///the quaternion product of a and the pure quaternion (v.x, v.y, v.z, 0)
+SIMD_FORCE_INLINE btSimdFloat4	btSimdQuaternionMulVector3(btSimdFloat4 a,btSimdFloat4 v)
+{
+	btSimdFloat4 r = btSimdNegateW(btSimdMul(btSimdShuffle<3,3,3,0>(a),btSimdShuffle<0,1,2,0>(v)));
+	r = btSimdAdd(r,btSimdNegateW(btSimdMul(btSimdShuffle<1,2,0,1>(a),btSimdShuffle<2,0,1,1>(v))));
+	return btSimdSub(r,btSimdMul(btSimdShuffle<2,0,1,2>(a),btSimdShuffle<1,2,0,2>(v)));
+}
+
+#endif //BT_USE_SSE || BT_USE_NEON
+
+#endif //BT_SIMD_FLOAT4_H
@@ -0,0 +1,128 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btThreads.h"
+#include "btMinMax.h"
+
+#ifdef __APPLE__
+#include <dispatch/dispatch.h>
+#endif
+
+
+class btSequentialTaskScheduler : public btITaskScheduler
+{
+public:
+
+	virtual const char*	getName() const
+	{
+		return "Sequential";
+	}
+
+	virtual void	parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+	{
+		(void)grainSize;
+		if (iBegin < iEnd)
+		{
+			body.forLoop(iBegin,iEnd);
+		}
+	}
+};
+
+btITaskScheduler*	btGetSequentialTaskScheduler()
+{
+	static btSequentialTaskScheduler sSequentialScheduler;
+	return &sSequentialScheduler;
+}
+
+
+#ifdef __APPLE__
+
+///splits the loop in chunks of grainSize iterations and hands them to dispatch_apply_f on the global concurrent queue
+class btDispatchTaskScheduler : public btITaskScheduler
+{
+	struct	btDispatchLoop
+	{
+		const btIParallelForBody*	m_body;
+		int		m_begin;
+		int		m_end;
+		int		m_grainSize;
+	};
+
+	static void	dispatchChunk(void* context, size_t chunk)
+	{
+		const btDispatchLoop* loop = (const btDispatchLoop*)context;
+		int iBegin = loop->m_begin + int(chunk)*loop->m_grainSize;
+		int iEnd = btMin(iBegin + loop->m_grainSize, loop->m_end);
+		loop->m_body->forLoop(iBegin,iEnd);
+	}
+
+public:
+
+	virtual const char*	getName() const
+	{
+		return "Dispatch";
+	}
+
+	virtual void	parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+	{
+		if (iBegin >= iEnd)
+			return;
+		btDispatchLoop loop;
+		loop.m_body = &body;
+		loop.m_begin = iBegin;
+		loop.m_end = iEnd;
+		loop.m_grainSize = btMax(grainSize,1);
+		int numChunks = (iEnd - iBegin + loop.m_grainSize - 1) / loop.m_grainSize;
+		if (numChunks == 1)
+		{
+			body.forLoop(iBegin,iEnd);
+			return;
+		}
+		dispatch_apply_f(size_t(numChunks), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), &loop, dispatchChunk);
+	}
+};
+
+btITaskScheduler*	btGetDispatchTaskScheduler()
+{
+	static btDispatchTaskScheduler sDispatchScheduler;
+	return &sDispatchScheduler;
+}
+
+#else
+
+btITaskScheduler*	btGetDispatchTaskScheduler()
+{
+	return 0;
+}
+
+#endif //__APPLE__
+
+
+static btITaskScheduler*	gTaskScheduler = 0;
+
+void	btSetTaskScheduler(btITaskScheduler* taskScheduler)
+{
+	gTaskScheduler = taskScheduler;
+}
+
+btITaskScheduler*	btGetTaskScheduler()
+{
+	return gTaskScheduler ? gTaskScheduler : btGetSequentialTaskScheduler();
+}
+
+void	btParallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+{
+	btGetTaskScheduler()->parallelFor(iBegin,iEnd,grainSize,body);
+}
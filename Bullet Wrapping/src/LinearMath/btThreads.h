@@ -0,0 +1,75 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_THREADS_H
+#define BT_THREADS_H
+
+#include "btScalar.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif //_MSC_VER
+
+///btIParallelForBody is the body of a btParallelFor loop. forLoop can be called concurrently for disjoint ranges,
+///so it may only write to data that belongs to the iterations in [iBegin,iEnd).
+class btIParallelForBody
+{
+public:
+	virtual ~btIParallelForBody() {}
+
+	virtual void	forLoop(int iBegin, int iEnd) const = 0;
+};
+
+///btITaskScheduler distributes the iterations of a btParallelFor over threads.
+///parallelFor returns after all iterations completed. It is called from one thread at a time, and not recursively.
+class btITaskScheduler
+{
+public:
+	virtual ~btITaskScheduler() {}
+
+	virtual const char*	getName() const = 0;
+
+	virtual void	parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) = 0;
+};
+
+///the default scheduler runs all iterations on the calling thread
+btITaskScheduler*	btGetSequentialTaskScheduler();
+
+///returns a scheduler that uses Grand Central Dispatch on Apple platforms, and 0 elsewhere
+btITaskScheduler*	btGetDispatchTaskScheduler();
+
+///the scheduler is not owned, it has to outlive its use. Passing 0 restores the sequential scheduler.
+void	btSetTaskScheduler(btITaskScheduler* taskScheduler);
+
+btITaskScheduler*	btGetTaskScheduler();
+
+///runs body.forLoop over [iBegin,iEnd) in ranges of at least grainSize iterations, using the current task scheduler
+void	btParallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body);
+
+///adds delta to value atomically. The global statistics counters (gNumManifold, gOverlappingPairs, gNumGjkChecks and the others)
+///are updated from btParallelFor loops and from worlds stepped concurrently by btDynamicsWorldHost::stepWorlds, so they use this.
+///Reading a counter while worlds step gives an approximate value, read them between steps.
+SIMD_FORCE_INLINE void	btAtomicAdd(int& value, int delta)
+{
+#if defined(_MSC_VER)
+	_InterlockedExchangeAdd((volatile long*)&value,delta);
+#elif defined(__GNUC__)
+	__sync_fetch_and_add(&value,delta);
+#else
+	value += delta;
+#endif
+}
+
+#endif //BT_THREADS_H
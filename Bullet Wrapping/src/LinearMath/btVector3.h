@@ -20,6 +20,7 @@ subject to the following restrictions:
 
 #include "btScalar.h"
 #include "btMinMax.h"
+#include "btSimdFloat4.h"
 
 #ifdef BT_USE_DOUBLE_PRECISION
 #define btVector3Data btVector3DoubleData
@@ -49,16 +50,16 @@ public:
 	}
 public:
 #else //__CELLOS_LV2__ __SPU__
-#ifdef BT_USE_SSE // _WIN32
+#ifdef BT_USE_SIMD_FLOAT4
 	union {
-		__m128 mVec128;
+		btSimdFloat4 mVec128;
 		btScalar	m_floats[4];
 	};
-	SIMD_FORCE_INLINE	__m128	get128() const
+	SIMD_FORCE_INLINE	btSimdFloat4	get128() const
 	{
 		return mVec128;
 	}
-	SIMD_FORCE_INLINE	void	set128(__m128 v128)
+	SIMD_FORCE_INLINE	void	set128(btSimdFloat4 v128)
 	{
 		mVec128 = v128;
 	}
@@ -69,8 +70,14 @@ public:
 
 	public:
 
-  /**@brief No initialization constructor */
+  /**@brief No initialization constructor, except with the SIMD backend: its operations read all four lanes, so the vector
+   * is cleared there instead of leaving lanes that are written one by one uninitialized. The compiler drops the clear when the
+   * whole vector is written before it is read. */
+#ifdef BT_USE_SIMD_FLOAT4
+	SIMD_FORCE_INLINE btVector3() : mVec128(btSimdSplat(0.f)) {}
+#else
 	SIMD_FORCE_INLINE btVector3() {}
+#endif
 
  
 	
@@ -92,8 +99,11 @@ public:
  * @param The vector to add to this one */
 	SIMD_FORCE_INLINE btVector3& operator+=(const btVector3& v)
 	{
-
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdSetW(btSimdAdd(mVec128,v.mVec128),mVec128);
+#else
 		m_floats[0] += v.m_floats[0]; m_floats[1] += v.m_floats[1];m_floats[2] += v.m_floats[2];
+#endif
 		return *this;
 	}
 
@@ -102,14 +112,22 @@ public:
    * @param The vector to subtract */
 	SIMD_FORCE_INLINE btVector3& operator-=(const btVector3& v) 
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdSetW(btSimdSub(mVec128,v.mVec128),mVec128);
+#else
 		m_floats[0] -= v.m_floats[0]; m_floats[1] -= v.m_floats[1];m_floats[2] -= v.m_floats[2];
+#endif
 		return *this;
 	}
   /**@brief Scale the vector
    * @param s Scale factor */
 	SIMD_FORCE_INLINE btVector3& operator*=(const btScalar& s)
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdSetW(btSimdMul(mVec128,btSimdSplat(s)),mVec128);
+#else
 		m_floats[0] *= s; m_floats[1] *= s;m_floats[2] *= s;
+#endif
 		return *this;
 	}
 
@@ -125,7 +143,11 @@ public:
    * @param v The other vector in the dot product */
 	SIMD_FORCE_INLINE btScalar dot(const btVector3& v) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		return btSimdDotXYZ(mVec128,v.mVec128);
+#else
 		return m_floats[0] * v.m_floats[0] + m_floats[1] * v.m_floats[1] +m_floats[2] * v.m_floats[2];
+#endif
 	}
 
   /**@brief Return the length of the vector squared */
@@ -187,26 +209,42 @@ public:
   /**@brief Return a vector will the absolute values of each element */
 	SIMD_FORCE_INLINE btVector3 absolute() const 
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btVector3 result;
+		result.mVec128 = btSimdAbsolute3(mVec128);
+		return result;
+#else
 		return btVector3(
 			btFabs(m_floats[0]), 
 			btFabs(m_floats[1]), 
 			btFabs(m_floats[2]));
+#endif
 	}
   /**@brief Return the cross product between this and another vector 
    * @param v The other vector */
 	SIMD_FORCE_INLINE btVector3 cross(const btVector3& v) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btVector3 result;
+		result.mVec128 = btSimdCross3(mVec128,v.mVec128);
+		return result;
+#else
 		return btVector3(
 			m_floats[1] * v.m_floats[2] -m_floats[2] * v.m_floats[1],
 			m_floats[2] * v.m_floats[0] - m_floats[0] * v.m_floats[2],
 			m_floats[0] * v.m_floats[1] - m_floats[1] * v.m_floats[0]);
+#endif
 	}
 
 	SIMD_FORCE_INLINE btScalar triple(const btVector3& v1, const btVector3& v2) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		return btSimdDotXYZ(mVec128,btSimdCross3(v1.mVec128,v2.mVec128));
+#else
 		return m_floats[0] * (v1.m_floats[1] * v2.m_floats[2] - v1.m_floats[2] * v2.m_floats[1]) + 
 			m_floats[1] * (v1.m_floats[2] * v2.m_floats[0] - v1.m_floats[0] * v2.m_floats[2]) + 
 			m_floats[2] * (v1.m_floats[0] * v2.m_floats[1] - v1.m_floats[1] * v2.m_floats[0]);
+#endif
 	}
 
   /**@brief Return the axis with the smallest value 
@@ -236,9 +274,13 @@ public:
 	SIMD_FORCE_INLINE void setInterpolate3(const btVector3& v0, const btVector3& v1, btScalar rt)
 	{
 		btScalar s = btScalar(1.0) - rt;
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdSetW(btSimdMulAdd(btSimdSplat(rt),v1.mVec128,btSimdMul(btSimdSplat(s),v0.mVec128)),mVec128);
+#else
 		m_floats[0] = s * v0.m_floats[0] + rt * v1.m_floats[0];
 		m_floats[1] = s * v0.m_floats[1] + rt * v1.m_floats[1];
 		m_floats[2] = s * v0.m_floats[2] + rt * v1.m_floats[2];
+#endif
 		//don't do the unused w component
 		//		m_co[3] = s * v0[3] + rt * v1[3];
 	}
@@ -248,16 +290,26 @@ public:
    * @param t The ration of this to v (t = 0 => return this, t=1 => return other) */
 	SIMD_FORCE_INLINE btVector3 lerp(const btVector3& v, const btScalar& t) const 
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		btVector3 result;
+		result.mVec128 = btSimdClearW(btSimdMulAdd(btSimdSub(v.mVec128,mVec128),btSimdSplat(t),mVec128));
+		return result;
+#else
 		return btVector3(m_floats[0] + (v.m_floats[0] - m_floats[0]) * t,
 			m_floats[1] + (v.m_floats[1] - m_floats[1]) * t,
 			m_floats[2] + (v.m_floats[2] -m_floats[2]) * t);
+#endif
 	}
 
   /**@brief Elementwise multiply this vector by the other 
    * @param v The other vector */
 	SIMD_FORCE_INLINE btVector3& operator*=(const btVector3& v)
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		mVec128 = btSimdSetW(btSimdMul(mVec128,v.mVec128),mVec128);
+#else
 		m_floats[0] *= v.m_floats[0]; m_floats[1] *= v.m_floats[1];m_floats[2] *= v.m_floats[2];
+#endif
 		return *this;
 	}
 
@@ -292,7 +344,11 @@ public:
 
 	SIMD_FORCE_INLINE	bool	operator==(const btVector3& other) const
 	{
+#ifdef BT_USE_SIMD_FLOAT4
+		return btSimdEqual4(mVec128,other.mVec128);
+#else
 		return ((m_floats[3]==other.m_floats[3]) && (m_floats[2]==other.m_floats[2]) && (m_floats[1]==other.m_floats[1]) && (m_floats[0]==other.m_floats[0]));
+#endif
 	}
 
 	SIMD_FORCE_INLINE	bool	operator!=(const btVector3& other) const
@@ -305,20 +361,28 @@ public:
    */
 		SIMD_FORCE_INLINE void	setMax(const btVector3& other)
 		{
+#ifdef BT_USE_SIMD_FLOAT4
+			mVec128 = btSimdMax(other.mVec128,mVec128);
+#else
 			btSetMax(m_floats[0], other.m_floats[0]);
 			btSetMax(m_floats[1], other.m_floats[1]);
 			btSetMax(m_floats[2], other.m_floats[2]);
 			btSetMax(m_floats[3], other.w());
+#endif
 		}
   /**@brief Set each element to the min of the current values and the values of another btVector3
    * @param other The other btVector3 to compare with 
    */
 		SIMD_FORCE_INLINE void	setMin(const btVector3& other)
 		{
+#ifdef BT_USE_SIMD_FLOAT4
+			mVec128 = btSimdMin(other.mVec128,mVec128);
+#else
 			btSetMin(m_floats[0], other.m_floats[0]);
 			btSetMin(m_floats[1], other.m_floats[1]);
 			btSetMin(m_floats[2], other.m_floats[2]);
 			btSetMin(m_floats[3], other.w());
+#endif
 		}
 
 		SIMD_FORCE_INLINE void 	setValue(const btScalar& x, const btScalar& y, const btScalar& z)
@@ -369,34 +433,64 @@ public:
 SIMD_FORCE_INLINE btVector3 
 operator+(const btVector3& v1, const btVector3& v2) 
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdClearW(btSimdAdd(v1.mVec128,v2.mVec128));
+	return result;
+#else
 	return btVector3(v1.m_floats[0] + v2.m_floats[0], v1.m_floats[1] + v2.m_floats[1], v1.m_floats[2] + v2.m_floats[2]);
+#endif
 }
 
 /**@brief Return the elementwise product of two vectors */
 SIMD_FORCE_INLINE btVector3 
 operator*(const btVector3& v1, const btVector3& v2) 
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdClearW(btSimdMul(v1.mVec128,v2.mVec128));
+	return result;
+#else
 	return btVector3(v1.m_floats[0] * v2.m_floats[0], v1.m_floats[1] * v2.m_floats[1], v1.m_floats[2] * v2.m_floats[2]);
+#endif
 }
 
 /**@brief Return the difference between two vectors */
 SIMD_FORCE_INLINE btVector3 
 operator-(const btVector3& v1, const btVector3& v2)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdClearW(btSimdSub(v1.mVec128,v2.mVec128));
+	return result;
+#else
 	return btVector3(v1.m_floats[0] - v2.m_floats[0], v1.m_floats[1] - v2.m_floats[1], v1.m_floats[2] - v2.m_floats[2]);
+#endif
 }
 /**@brief Return the negative of the vector */
 SIMD_FORCE_INLINE btVector3 
 operator-(const btVector3& v)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdNegate3(v.mVec128);
+	return result;
+#else
 	return btVector3(-v.m_floats[0], -v.m_floats[1], -v.m_floats[2]);
+#endif
 }
 
 /**@brief Return the vector scaled by s */
 SIMD_FORCE_INLINE btVector3 
 operator*(const btVector3& v, const btScalar& s)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdClearW(btSimdMul(v.mVec128,btSimdSplat(s)));
+	return result;
+#else
 	return btVector3(v.m_floats[0] * s, v.m_floats[1] * s, v.m_floats[2] * s);
+#endif
 }
 
 /**@brief Return the vector scaled by s */
@@ -418,7 +512,13 @@ operator/(const btVector3& v, const btScalar& s)
 SIMD_FORCE_INLINE btVector3
 operator/(const btVector3& v1, const btVector3& v2)
 {
+#ifdef BT_USE_SIMD_FLOAT4
+	btVector3 result;
+	result.mVec128 = btSimdClearW(btSimdDiv(v1.mVec128,v2.mVec128));
+	return result;
+#else
 	return btVector3(v1.m_floats[0] / v2.m_floats[0],v1.m_floats[1] / v2.m_floats[1],v1.m_floats[2] / v2.m_floats[2]);
+#endif
 }
 
 /**@brief Return the dot product between two vectors */